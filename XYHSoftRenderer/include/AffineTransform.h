@@ -0,0 +1,57 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix.h"
+#include "Quaternion.h"
+
+
+// 仿射变换：只存储4x4矩阵的前三行（最后一行总是0 0 0 1），复合和求逆都不计算最后一行
+class Affine3
+{
+public:
+    alignas(16) float m[3][4]; // 前三列为线性部分，第四列为平移
+
+public:
+    Affine3(); // 单位变换
+    explicit Affine3(const Matrix& matrix); // 取矩阵的前三行（矩阵须为仿射矩阵）
+
+    Affine3 operator*(const Affine3& affine) const; // 复合：先应用右边的变换
+    Vector4f operator*(const Vector4f& vector) const; // 变换齐次坐标（w不变）
+
+    static Affine3 identity(); // 单位变换
+
+    // 由平移、旋转和缩放构建：先缩放，再旋转，最后平移（与Transformer一致）
+    static Affine3 fromTRS(const Vector3f& translation, const Quaternion& rotation, const Vector3f& scale);
+
+    Vector3f transformPoint(const Vector3f& point) const; // 变换位置（带平移）
+    Vector3f transformVector(const Vector3f& vector) const; // 变换方向（不带平移）
+
+    Affine3 inverse() const; // 逆：线性部分用伴随矩阵求逆，平移为 -A^-1 * t；不可逆时返回单位变换
+    Affine3 normalMatrix() const; // 法线矩阵：线性部分的逆转置，平移为0
+
+    Matrix toMatrix() const; // 转为4x4矩阵
+};
+
+
+// 刚体变换（旋转 + 平移）：线性部分为正交矩阵，逆只需转置
+class RigidTransform
+{
+public:
+    RigidTransform(); // 单位变换
+    RigidTransform(const Quaternion& rotation, const Vector3f& translation); // 先旋转，再平移
+
+    RigidTransform operator*(const RigidTransform& transform) const; // 复合：先应用右边的变换，结果仍为刚体变换
+
+    // 相机视图变换（世界空间到相机空间，与Matrix::lookAt一致）
+    static RigidTransform lookAt(const Vector3f& eye, const Vector3f& center, const Vector3f& up);
+
+    Vector3f transformPoint(const Vector3f& point) const { return m_affine.transformPoint(point); }
+    Vector3f transformVector(const Vector3f& vector) const { return m_affine.transformVector(vector); }
+
+    RigidTransform inverse() const; // 逆：旋转部分转置，平移为 -R^T * t
+
+    const Affine3& toAffine() const { return m_affine; }
+    Matrix toMatrix() const { return m_affine.toMatrix(); }
+
+private:
+    Affine3 m_affine;
+};
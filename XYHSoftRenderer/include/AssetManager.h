@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "Object.h"
+#include "Texture.h"
+#include "ObjFileReader.h"
+
+// 资源加载状态
+enum class AssetState {
+    Loading,    // 后台加载中（使用占位资源）
+    Ready,      // 加载完成
+    Failed      // 加载失败（保留占位资源）
+};
+
+// 异步加载的网格资源（加载完成前为空网格）
+struct MeshAsset {
+    std::string path;
+    ObjLoadOptions options;
+    Mesh mesh;
+    AssetState state;
+
+    MeshAsset() : state(AssetState::Loading) {}
+};
+
+// 异步加载的纹理资源（加载完成前为棋盘格纹理）
+struct TextureAsset {
+    std::string path;
+    bool generateMipmaps;
+    Texture texture;
+    AssetState state;
+
+    TextureAsset() : generateMipmaps(false), state(AssetState::Loading) {}
+};
+
+// 资源管理器：在后台线程池中加载网格和纹理，加载结果在渲染线程调用Update时交付
+// 资源句柄中的数据只在渲染线程上修改，渲染时可以直接使用（加载完成前是占位资源）
+class AssetManager {
+public:
+    typedef std::function<void(MeshAsset&)> MeshCallback;
+    typedef std::function<void(TextureAsset&)> TextureCallback;
+
+private:
+    static AssetManager* s_instance;  // 单例实例
+
+    // 后台任务完成后的结果，通过无锁队列交给渲染线程
+    struct Completion {
+        Completion* next;
+        std::string key;
+        std::shared_ptr<MeshAsset> meshAsset;
+        std::shared_ptr<TextureAsset> textureAsset;
+        Mesh mesh;
+        Texture texture;
+        bool success;
+
+        Completion() : next(nullptr), success(false) {}
+    };
+
+    // 同一路径的请求共享一个资源，回调在加载完成时依次执行
+    struct MeshEntry {
+        std::shared_ptr<MeshAsset> asset;
+        std::vector<MeshCallback> callbacks;
+    };
+    struct TextureEntry {
+        std::shared_ptr<TextureAsset> asset;
+        std::vector<TextureCallback> callbacks;
+    };
+
+    std::vector<std::thread> m_workers;             // 加载线程池
+    std::deque<std::function<void()>> m_jobs;       // 待执行的加载任务
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobCondition;
+    bool m_stopping;
+
+    std::atomic<Completion*> m_completions;         // 已完成结果（多生产者单消费者的无锁栈）
+    std::atomic<int> m_pendingCount;                // 尚未交付的请求数量
+
+    std::unordered_map<std::string, MeshEntry> m_meshes;        // 网格资源（键为路径和加载选项）
+    std::unordered_map<std::string, TextureEntry> m_textures;   // 纹理资源（键为路径和Mipmap设置）
+    std::mutex m_decodeMutex;                       // GDI+的启动和关闭不能并发，图片解码串行执行
+
+    // 构造和析构函数
+    explicit AssetManager(int threadCount);
+    ~AssetManager();
+
+    // 工作线程主循环
+    void WorkerLoop();
+
+    // 提交后台任务
+    void Enqueue(const std::function<void()>& job);
+
+    // 将结果放入完成队列（工作线程调用）
+    void PushCompletion(Completion* completion);
+
+public:
+    // 获取单例实例（线程数为0时使用硬件线程数-1）
+    static AssetManager* GetInstance();
+    static void DeleteInstance();
+
+    // 异步加载网格，相同路径和选项的请求只加载一次
+    // 回调在渲染线程的Update中执行（资源已加载完成时立即执行）
+    std::shared_ptr<MeshAsset> LoadMeshAsync(const std::string& path, const ObjLoadOptions& options,
+                                             const MeshCallback& callback = MeshCallback());
+
+    // 异步加载纹理（解码并按需生成Mipmap），相同路径的请求只加载一次
+    std::shared_ptr<TextureAsset> LoadTextureAsync(const std::string& path, bool generateMipmaps = false,
+                                                   const TextureCallback& callback = TextureCallback());
+
+    // 在渲染线程每帧调用：交付已完成的资源并执行回调，返回本次交付的数量
+    int Update();
+
+    // 阻塞等待所有请求完成并交付（用于退出前和性能测试）
+    void WaitAll();
+
+    // 尚未交付的请求数量
+    int GetPendingCount() const { return m_pendingCount.load(); }
+
+    // 工作线程数量
+    int GetThreadCount() const { return static_cast<int>(m_workers.size()); }
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+
+// 性能测试（通过命令行参数 --benchmark 运行，结果以文本报告返回）
+class Benchmark {
+public:
+    // 运行全部性能测试
+    static std::string RunAll(const std::string& modelDirectory);
+
+    // OBJ加载性能测试：对比逐行流式解析与内存映射解析的吞吐量(MB/s)
+    static std::string RunObjLoaderBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // OBJ多线程解析测试：不同线程数下的吞吐量，并检查结果与单线程一致
+    static std::string RunObjParallelBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // 顶点合并测试：合并前后的顶点数量和网格内存占用
+    static std::string RunVertexWeldBenchmark(const std::string& modelDirectory);
+
+    // 二进制网格缓存测试：对比解析OBJ与加载缓存（含内容哈希）的耗时
+    static std::string RunMeshCacheBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // 网格优化测试：优化前后的ACMR（FIFO 16）和重复绘制率，以及优化耗时
+    static std::string RunMeshOptimizerBenchmark(const std::string& modelDirectory);
+
+    // 打包网格测试：SoA/量化格式的内存占用、解码误差，以及逐顶点解码与批量解码的吞吐量
+    static std::string RunPackedMeshBenchmark(const std::string& modelDirectory, int iterations = 5);
+
+    // 顶点着色测试：逐三角形调用VertexShader、逐顶点调用VertexShader与批量SIMD着色的吞吐量和结果差异
+    static std::string RunVertexShadingBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // 着色器绘制流程测试：虚函数绘制流程(DrawMesh)与模板绘制流程(DrawMeshT)的耗时和画面差异
+    static std::string RunShaderPipelineBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // 每帧分配器测试：逐帧绘制全部模型，报告分配器的峰值占用、容量和每帧的malloc次数（稳定后应为0）
+    static std::string RunFrameArenaBenchmark(const std::string& modelDirectory, int frames = 5);
+
+    // 视锥体剔除测试：大量对象中只有一部分可见时，开启与关闭对象级剔除的耗时、剔除数量和画面是否一致
+    static std::string RunFrustumCullingBenchmark(const std::string& modelDirectory, int gridSize = 20, int iterations = 3);
+
+    // 场景BVH测试：大量对象时逐个测试与BVH遍历的剔除/包围盒查询耗时（结果须一致），射线拾取吞吐量，以及少量对象移动后refit与重建的耗时
+    static std::string RunSceneBvhBenchmark(const std::string& modelDirectory, int gridSize = 64, int iterations = 5);
+
+    // 簇剔除测试：簇的数量和大小，从一侧观察模型时开启与关闭簇剔除的耗时、剔除的簇数和画面是否一致
+    static std::string RunMeshletBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // LOD测试：building_04.obj的LOD链（三角形数、误差、生成耗时），不同距离下开启与关闭LOD选择的耗时、提交的三角形数和画面差异，
+    // 以及距离在切换点附近抖动时有无滞后的LOD切换次数
+    static std::string RunLodBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // 实例化绘制测试：tree.obj按1k/10k/100k个实例摆成方阵，逐实例调用DrawMesh（先测试包围体）与DrawMeshInstanced的耗时、
+    // 绘制和剔除的实例数、画面是否一致，以及带实例颜色的绘制耗时；分别测试按簇绘制和整体着色
+    static std::string RunInstancingBenchmark(const std::string& modelDirectory, int iterations = 3);
+
+    // 变换测试：欧拉角四次矩阵乘法与四元数直接生成局部矩阵的耗时和误差，缓存的模型矩阵的读取耗时，
+    // 以及层级场景中移动不同比例的根对象时UpdateTransforms更新的对象数和耗时
+    static std::string RunTransformBenchmark(int objectCount = 10000, int iterations = 5);
+
+    // 矩阵运算测试：修改前的标量实现与SIMD实现的矩阵乘矩阵、矩阵乘向量、批量变换点的耗时和最大差值，
+    // 以及通用求逆与仿射求逆、transpose().inverse()与normalMatrix()的耗时和差值
+    static std::string RunMathBenchmark(int count = 100000, int iterations = 5);
+
+    // 仿射/刚体变换测试：Matrix的通用求逆和4x4乘法与Affine3、RigidTransform的逆和复合的耗时和相对误差，
+    // 以及正确性检查（与通用求逆一致、乘以逆为单位矩阵、不可逆时返回单位矩阵、视图变换和相机射线与原实现一致）
+    static std::string RunAffineBenchmark(int count = 100000, int iterations = 5);
+
+    // 性能分析器测试：逐帧绘制全部模型，关闭与开启记录时的每帧耗时和开销、画面是否一致，
+    // 导出的trace的事件数、大小和各阶段的每帧耗时，以及多线程解析OBJ时各线程的事件
+    static std::string RunProfilerBenchmark(const std::string& modelDirectory, int frames = 10);
+
+    // 管线统计测试：逐帧绘制全部模型，关闭与开启统计时的每帧耗时和开销、画面是否一致，
+    // 每个模型单次绘制的统计（查询之和与整帧统计一致、各计数之间的关系）以及多线程计数器的合并
+    static std::string RunPipelineStatisticsBenchmark(const std::string& modelDirectory, int frames = 5);
+
+    // 调试视图测试：逐帧绘制全部模型，各调试视图的每帧耗时、逐像素计数的最大值和平均值，
+    // 以及正确性检查（计数之和与管线统计一致、深度测试次数不少于着色次数、关闭后画面与开启前一致）
+    static std::string RunDebugViewBenchmark(const std::string& modelDirectory, int frames = 3);
+};
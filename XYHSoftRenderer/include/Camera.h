@@ -2,6 +2,8 @@
 
 #include "Vector.h"
 #include "Matrix.h"
+#include "AffineTransform.h"
+#include "Frustum.h"
 
 class Camera {
 public:
@@ -17,7 +19,7 @@ public:
     float farZ;               // 远平面距离
     
     // 矩阵
-    Matrix viewMatrix;        // 视图矩阵
+    RigidTransform viewTransform; // 视图变换（刚体变换，求逆只需转置），视图矩阵由它生成（GetViewMatrix）
     Matrix projMatrix;        // 投影矩阵
     
 public:
@@ -45,10 +47,16 @@ public:
     void UpdateViewMatrix();
     void UpdateProjectionMatrix();
     
-    // 获取矩阵
+    // 获取矩阵（视图矩阵由viewTransform生成，渲染、剔除和拾取使用同一个视图变换）
     Matrix GetViewMatrix() const;
     Matrix GetProjectionMatrix() const;
     
+    // 获取视锥体（世界空间）
+    Frustum GetFrustum() const;
+    
+    // 屏幕坐标（像素，左上角为原点）对应的世界空间射线，用于拾取；direction已归一化
+    void ScreenPointToRay(float x, float y, int width, int height, Vector3f& origin, Vector3f& direction) const;
+    
     // 相机移动方法
     void MoveForward(float distance);
     void MoveRight(float distance);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// 每帧的线性分配器：绘制过程中的临时数据（着色后的顶点、文本位图等）从这里分配，
+// 每帧开始时整体重置，不逐个释放。稳定状态下每帧不再调用malloc
+class FrameArena {
+public:
+    // 分配位置（用于在一次绘制结束后回退，复用这次绘制使用的内存）
+    struct Marker {
+        size_t block;
+        size_t used;
+    };
+
+    explicit FrameArena(size_t initialCapacity = 1 << 20);
+    ~FrameArena();
+
+    // 禁止拷贝（内存块只能有一个所有者）
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 分配bytes字节，alignment必须是2的幂；内存不足时抛出std::bad_alloc（与std::vector相同），不会返回nullptr
+    void* Allocate(size_t bytes, size_t alignment = 16);
+
+    // 分配count个T并默认构造（不会调用析构函数，只能用于析构函数没有副作用的类型）
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        T* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; i++) {
+            new (data + i) T();
+        }
+        return data;
+    }
+
+    // 当前分配位置
+    Marker GetMarker() const;
+
+    // 回退到之前的分配位置，之后分配的内存全部作废
+    void Rewind(const Marker& marker);
+
+    // 每帧开始时调用：作废所有分配；上一帧使用了多个内存块时合并为一个足够大的块
+    void Reset();
+
+    // 当前已分配的字节数（包括对齐填充）
+    size_t GetBytesUsed() const;
+
+    // 本帧已分配字节数的最大值
+    size_t GetHighWaterMark() const { return m_highWaterMark; }
+
+    // 所有内存块的总容量
+    size_t GetCapacity() const;
+
+    // 本帧调用malloc的次数（容量不足时增加内存块）
+    int GetMallocCount() const { return m_mallocCount; }
+
+    // 上一帧的统计
+    size_t GetLastFrameHighWaterMark() const { return m_lastFrameHighWaterMark; }
+    int GetLastFrameMallocCount() const { return m_lastFrameMallocCount; }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+        size_t used;
+    };
+
+    // 分配一个新内存块并设为当前块
+    void AddBlock(size_t size);
+
+    std::vector<Block> m_blocks;
+    size_t m_currentBlock;
+    size_t m_highWaterMark;
+    int m_mallocCount;
+    size_t m_lastFrameHighWaterMark;
+    int m_lastFrameMallocCount;
+};
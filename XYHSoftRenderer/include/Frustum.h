@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+// 视锥体（世界空间的6个平面），用于对象级别的可见性剔除
+class Frustum {
+public:
+    // 平面顺序（NEAR/FAR在Windows.h中是宏，因此加上前缀）
+    enum Plane {
+        PLANE_LEFT,
+        PLANE_RIGHT,
+        PLANE_BOTTOM,
+        PLANE_TOP,
+        PLANE_NEAR,
+        PLANE_FAR,
+        PLANE_COUNT
+    };
+
+    Frustum();
+
+    // 从投影矩阵 * 视图矩阵提取平面（裁剪空间-w <= x,y,z <= w）
+    static Frustum FromMatrix(const Matrix& viewProjection);
+
+    // 平面：(a, b, c, d)，a*x + b*y + c*z + d >= 0 表示在内侧，(a, b, c)为单位向量
+    const Vector4f& GetPlane(int plane) const { return m_planes[plane]; }
+
+    // 包围球是否与视锥体相交（保守测试：在视锥体外的角落处可能误判为相交）
+    bool IntersectsSphere(const Vector3f& center, float radius) const;
+
+    // 包围盒是否与视锥体相交（保守测试）
+    bool IntersectsAABB(const Vector3f& min, const Vector3f& max) const;
+
+    // 包围盒是否完全在视锥体内
+    bool ContainsAABB(const Vector3f& min, const Vector3f& max) const;
+
+private:
+    Vector4f m_planes[PLANE_COUNT];
+};
+
+// 把包围盒变换到另一个空间，结果为包含变换后包围盒的轴对齐包围盒
+void TransformAABB(const Vector3f& min, const Vector3f& max, const Matrix& matrix, Vector3f& outMin, Vector3f& outMax);
+
+// 矩阵对长度的最大缩放倍数（用于变换包围球半径）
+float GetMaxScale(const Matrix& matrix);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// 只读内存映射文件（用于模型等大文件的零拷贝读取）
+class MappedFile {
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+
+    // 禁止拷贝（映射句柄只能有一个所有者）
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射文件，成功返回true
+    bool Open(const std::string& filePath);
+
+    // 解除映射并关闭文件
+    void Close();
+
+    // 是否已成功映射
+    bool IsOpen() const { return m_opened; }
+
+    // 映射的数据
+    const char* Data() const { return m_data; }
+    const char* End() const { return m_data + m_size; }
+    size_t Size() const { return m_size; }
+
+private:
+    const char* m_data;   // 映射视图起始地址
+    size_t m_size;        // 文件大小（字节）
+    bool m_opened;        // 文件是否已打开（空文件没有映射视图）
+
+#ifdef _WIN32
+    void* m_fileHandle;     // 文件句柄
+    void* m_mappingHandle;  // 映射对象句柄
+#else
+    int m_fd;               // 文件描述符
+#endif
+};
@@ -1,11 +1,12 @@
 #pragma once
+#include <cstddef>
 #include "Vector.h"
 
 
 class Matrix
 {
 public:
-    float m[4][4];
+    alignas(16) float m[4][4]; // 16字节对齐，每行可以直接用SSE加载
 
 public:
     Matrix();
@@ -27,6 +28,13 @@ public:
 
     Matrix transpose() const; // 矩阵转置
     Matrix inverse() const; // 矩阵逆
+    Matrix inverseAffine() const; // 仿射矩阵（最后一行为0 0 0 1）的逆，比inverse快
+    Matrix normalMatrix() const; // 法线矩阵：左上3x3的逆转置（仿射矩阵），对w为0的法线与transpose().inverse()等价
+
+    // 批量变换：result[i] = (*this) * points[i]，result可以与points相同
+    void transformPoints(const Vector4f* points, Vector4f* result, size_t count) const;
+    // 批量变换位置（w为1），结果取齐次坐标的xyz（不做透视除法）
+    void transformPoints(const Vector3f* points, Vector3f* result, size_t count) const;
 
     static Matrix translate(const Vector3f& translation); // 平移矩阵
     static Matrix rotate(float angle, char axis); // xyz轴旋转矩阵
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Object.h"
+#include "ObjFileReader.h"
+
+// 二进制网格缓存（保存在OBJ文件旁边，避免每次启动都重新解析OBJ文本）
+// 文件结构：文件头 + 段表 + 各段数据（位置、法线、纹理坐标、索引、子网格、簇、LOD），段数据按16字节对齐
+// 原网格和各级LOD的数据依次存放在同一组段中，由LOD段记录每一级的范围
+class MeshCache {
+public:
+    // 缓存文件路径（OBJ路径后加.meshcache）
+    static std::string GetCachePath(const std::string& objPath);
+
+    // 计算文件内容的64位哈希
+    static uint64_t HashContent(const char* data, size_t size);
+
+    // 影响网格结果的加载选项对应的键（线程数等不影响结果的选项不计入）
+    static uint64_t GetOptionsKey(const ObjLoadOptions& options);
+
+    // 从缓存文件加载网格，文件不存在、损坏或哈希/选项不匹配时返回false
+    // 子网格只恢复三角形范围和材质名称，材质本身由调用者从materialLibraries（OBJ中的mtllib）读取
+    // 簇和LOD链（Mesh::meshlets、Mesh::lods）与网格一起恢复，不需要重新生成
+    static bool Load(const std::string& cachePath, uint64_t contentHash, uint64_t optionsKey, Mesh& mesh,
+                     std::vector<std::string>& materialLibraries);
+
+    // 将网格（包括簇和LOD链）写入缓存文件
+    static bool Save(const std::string& cachePath, uint64_t contentHash, uint64_t optionsKey, const Mesh& mesh,
+                     const std::vector<std::string>& materialLibraries);
+};
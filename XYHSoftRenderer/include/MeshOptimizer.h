@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "Object.h"
+#include "Vector.h"
+
+// 网格优化（加载时执行）：顶点缓存顺序 -> 减少重复绘制的簇顺序 -> 顶点读取顺序
+// 只调整三角形和顶点的顺序，不改变网格的形状，每个子网格单独优化（子网格范围保持不变）
+class MeshOptimizer {
+public:
+    // 执行全部优化
+    static void Optimize(Mesh& mesh);
+
+    // 顶点缓存优化（Forsyth线性时间算法），让相邻三角形尽量复用最近变换过的顶点
+    static void OptimizeVertexCache(Vector3i* triangles, size_t triangleCount, size_t vertexCount);
+
+    // 重复绘制优化（Tipsify的簇排序）：在顶点缓存顺序的基础上切分为簇，朝外的簇先绘制
+    // threshold为允许的ACMR增长比例（1.05表示最多增加5%）
+    static void OptimizeOverdraw(Vector3i* triangles, size_t triangleCount, const std::vector<Vertex>& vertices,
+                                 float threshold = 1.05f);
+
+    // 顶点读取优化：按三角形首次引用的顺序重排顶点数组，未被引用的顶点被移除
+    static void OptimizeVertexFetch(Mesh& mesh);
+
+    // 平均缓存未命中率（每个三角形需要变换的顶点数，范围0.5~3.0，越小越好）
+    // 使用cacheSize大小的FIFO缓存模拟GPU的变换后顶点缓存
+    static float CalculateACMR(const std::vector<Vector3i>& indices, size_t vertexCount, int cacheSize = 16);
+
+    // 平均重复绘制率（通过深度测试的片元数/覆盖的像素数，1.0为没有重复绘制）
+    // 从六个轴向做正交投影光栅化（开启背面剔除和深度测试）后取平均
+    static float CalculateOverdraw(const Mesh& mesh, int resolution = 256);
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include "Object.h"
+
+// 网格简化（加载时执行）：二次误差度量（QEM）的边折叠，顶点折叠到相邻顶点的位置上，不计算新的位置
+// 位置相同的顶点（法线或纹理坐标的接缝两侧）作为一组一起折叠，开放边界和子网格的分界保持不变
+class MeshSimplifier {
+public:
+    // 默认的LOD级数
+    static const int kMaxLodLevels = 4;
+
+    // 简化网格，直到三角形数不超过targetTriangleCount，或下一次折叠的误差超过targetError（物体空间距离）
+    // 结果只包含用到的顶点，子网格按简化后的三角形重新计算范围；resultError不为空时返回实际的最大误差
+    static Mesh Simplify(const Mesh& mesh, size_t targetTriangleCount, float targetError, float* resultError = nullptr);
+
+    // 生成LOD链写入mesh.lods：每一级从上一级简化，三角形数约为上一级的ratio倍，误差逐级累加
+    // 三角形减少不明显时（受边界和接缝限制）停止；原网格带有簇时各级也生成簇
+    static void BuildLods(Mesh& mesh, int maxLevels = kMaxLodLevels, float ratio = 0.5f);
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include "Object.h"
+
+// 簇生成（加载时执行）：把网格切分为顶点数和三角形数有上限的簇，并计算包围球和法线锥
+// 簇从相邻且朝向一致的三角形贪心生长，三角形在子网格内按簇重新排列（子网格范围不变），簇不跨越子网格
+class MeshletBuilder {
+public:
+    // 默认上限（与常见GPU网格着色器的簇大小一致）
+    static const int kMaxVertices = 64;
+    static const int kMaxTriangles = 124;
+
+    // 生成簇，结果写入mesh.meshlets和mesh.meshletVertices
+    static void Build(Mesh& mesh, int maxVertices = kMaxVertices, int maxTriangles = kMaxTriangles);
+
+    // 计算簇的包围球和法线锥（簇的三角形和顶点范围已设置）
+    static void ComputeBounds(const Mesh& mesh, Meshlet& meshlet);
+
+    // 查找正好覆盖三角形范围[triangleStart, triangleEnd)的簇[firstMeshlet, endMeshlet)
+    // 网格没有簇、簇已过期或范围与簇的边界不对齐时返回false
+    static bool FindMeshlets(const Mesh& mesh, size_t triangleStart, size_t triangleEnd,
+                             size_t& firstMeshlet, size_t& endMeshlet);
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Object.h"
+
+// MTL材质文件读取（只解析渲染器用到的颜色、高光指数、不透明度和漫反射贴图）
+class MtlFileReader {
+public:
+    // 从文件加载全部材质，追加到materials中，文件无法打开时返回false
+    // 贴图路径相对MTL文件所在目录解析，找不到时在该目录下按文件名搜索
+    static bool LoadFromFile(const std::string& filePath, std::vector<Material>& materials);
+
+    // 取路径所在的目录（包含末尾的分隔符，没有目录时返回空字符串）
+    static std::string GetDirectory(const std::string& filePath);
+
+private:
+    // 按文件名（小写）索引目录下的全部文件，用于查找导出时写入了其他机器绝对路径的贴图
+    typedef std::unordered_map<std::string, std::string> FileIndex;
+
+    // 去掉map_Kd等命令的选项（-bm 0.3、-s 1 1 1等），返回贴图文件名
+    static std::string StripMapOptions(const std::string& value);
+
+    // 将贴图路径解析为实际存在的文件，找不到时返回空字符串
+    static std::string ResolveTexturePath(const std::string& directory, const std::string& texturePath,
+                                          FileIndex& fileIndex);
+};
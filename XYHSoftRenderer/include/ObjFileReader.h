@@ -5,6 +5,19 @@
 #include "Object.h"
 #include "Vector.h"
 
+// OBJ加载选项
+struct ObjLoadOptions {
+    bool flipNormals = false;   // 翻转法线
+    bool flipFaces = false;     // 翻转面片环绕顺序
+    int threadCount = 1;        // 解析线程数（1为单线程，0为使用全部硬件线程）
+    bool weldVertices = true;   // 合并(位置,纹理坐标,法线)相同的顶点，生成带索引的网格
+    float weldEpsilon = 0.0f;   // 位置合并容差（大于0时距离相近的位置视为同一位置）
+    bool useMeshCache = false;  // 使用OBJ文件旁边的二进制缓存（不存在或已过期时自动生成）
+    bool optimizeMesh = true;   // 优化三角形和顶点顺序（顶点缓存、重复绘制、顶点读取）
+    bool buildMeshlets = true;  // 生成簇（绘制时按簇剔除），在优化之后生成，与网格一起写入缓存
+    bool buildLods = true;      // 生成LOD链（Mesh::lods，绘制对象时按屏幕大小选择），与网格一起写入缓存
+};
+
 class ObjFileReader {
 public:
     ObjFileReader();
@@ -18,6 +31,9 @@ public:
                                          bool flipNormals = false, 
                                          bool flipFaces = false);
     
+    // 从文件加载OBJ模型，使用指定的加载选项
+    static Object LoadFromFile(const std::string& filePath, const ObjLoadOptions& options);
+    
     // 从文件加载OBJ模型，并构建Mesh
     static Mesh LoadMeshFromFile(const std::string& filePath);
     
@@ -26,7 +42,51 @@ public:
                                           bool flipNormals = false, 
                                           bool flipFaces = false);
     
+    // 从文件加载OBJ模型并构建Mesh，使用指定的加载选项（多线程解析的结果与单线程完全一致）
+    static Mesh LoadMeshFromFile(const std::string& filePath, const ObjLoadOptions& options);
+    
+    // 使用逐行std::getline + std::istringstream解析的旧实现（保留用于性能对比）
+    static Mesh LoadMeshFromFileLegacy(const std::string& filePath, 
+                                     bool flipNormals = false, 
+                                     bool flipFaces = false);
+    
 private:
+    // OBJ文件解析出的原始数据（索引从0开始，纹理坐标索引为-1表示缺失）
+    struct ObjRawData {
+        std::vector<Vector3f> positions;    // v
+        std::vector<Vector2f> texcoords;    // vt
+        std::vector<Vector3f> normals;      // vn
+        std::vector<int> positionIndices;   // f v1/vt1/vn1 的v1部分
+        std::vector<int> texcoordIndices;   // f v1/vt1/vn1 的vt1部分
+        std::vector<int> normalIndices;     // f v1/vt1/vn1 的vn1部分
+        std::vector<int> triangleMaterials; // 每个三角形的材质（materialNames的下标，-1表示未指定）
+        std::vector<std::string> materialNames;     // usemtl（按首次出现的顺序）
+        std::vector<std::string> materialLibraries; // mtllib
+        int lastMaterial;                   // 解析结束时的当前材质（分块解析时由下一块沿用）
+        
+        ObjRawData() : lastMaterial(-1) {}
+    };
+    
+    // 各类顶点数据的数量（用于分块解析时确定每块的起始编号）
+    struct ObjElementCounts {
+        size_t positions;
+        size_t texcoords;
+        size_t normals;
+        
+        ObjElementCounts() : positions(0), texcoords(0), normals(0) {}
+    };
+    
+    // 在内存中原地解析OBJ文本（用于内存映射的文件，无逐行内存分配）
+    // base为该段文本之前已有的顶点数据数量，用于解析负索引
+    static void ParseBuffer(const char* begin, const char* end, ObjRawData& data,
+                            const ObjElementCounts& base = ObjElementCounts());
+    
+    // 按行边界将文本分块，多线程解析后按顺序合并
+    static void ParseBufferParallel(const char* begin, const char* end, ObjRawData& data, int threadCount);
+    
+    // 统计文本中v、vt、vn行的数量
+    static ObjElementCounts CountElements(const char* begin, const char* end);
+    
     // 解析OBJ文件中的一行数据
     static void ParseLine(const std::string& line, 
                    std::vector<Vector3f>& positions,
@@ -36,13 +96,22 @@ private:
                    std::vector<int>& texcoordIndices,
                    std::vector<int>& normalIndices);
     
-    // 从已解析的数据构建Mesh
+    // 从已解析的数据构建Mesh，三角形按材质排序并拆分为子网格
+    // triangleMaterials为空时整个网格作为一个没有材质名称的子网格
     static Mesh BuildMesh(const std::vector<Vector3f>& positions,
                    const std::vector<Vector2f>& texcoords,
                    const std::vector<Vector3f>& normals,
                    const std::vector<int>& positionIndices,
                    const std::vector<int>& texcoordIndices,
                    const std::vector<int>& normalIndices,
-                   bool flipNormals = false,
-                   bool flipFaces = false);
+                   const ObjLoadOptions& options,
+                   const std::vector<int>& triangleMaterials = std::vector<int>(),
+                   const std::vector<std::string>& materialNames = std::vector<std::string>());
+    
+    // 读取mtllib引用的MTL文件（相对OBJ文件所在目录），按名称为子网格（包括各级LOD）设置材质
+    static void AssignMaterials(Mesh& mesh, const std::string& filePath,
+                                const std::vector<std::string>& materialLibraries);
+    
+    // 按容差合并位置，返回每个位置对应的代表位置索引
+    static std::vector<int> WeldPositions(const std::vector<Vector3f>& positions, float epsilon);
 };
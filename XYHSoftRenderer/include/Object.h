@@ -1,11 +1,16 @@
 #pragma once
 
 #include "Matrix.h"
+#include "Quaternion.h"
+#include "AffineTransform.h"
 #include "MyMath.h"
 #include "Vector.h"
 #include "Color.h"
 #include <vector>
 #include <string>
+#include <utility>
+
+class Texture;
 
 // 顶点
 class Vertex
@@ -56,23 +61,116 @@ public:
     
 };
 
+// 材质类
+class Material {
+public:
+    std::string name;           // 材质名称（MTL文件中newmtl的名称）
+    Color ambient;      // 环境光颜色
+    Color diffuse;      // 漫反射颜色
+    Color specular;     // 镜面反射颜色
+    float shininess;    // 高光指数
+    float opacity;      // 不透明度
+    std::string diffuseMapPath; // 漫反射贴图路径（map_Kd，为空表示没有贴图）
+    Texture* diffuseMap;        // 漫反射贴图（不持有，为空时使用着色器自身的纹理）
+
+    Material() 
+        : name(),
+          ambient(Color::white), 
+          diffuse(Color::white), 
+          specular(Color::white), 
+          shininess(32.0f),
+          opacity(1.0f),
+          diffuseMapPath(),
+          diffuseMap(nullptr) {}
+
+    Material(const Color& ambient, const Color& diffuse, const Color& specular, float shininess, float opacity = 1.0f)
+        : name(),
+          ambient(ambient), 
+          diffuse(diffuse), 
+          specular(specular), 
+          shininess(shininess),
+          opacity(opacity),
+          diffuseMapPath(),
+          diffuseMap(nullptr) {}
+};
+
+// 子网格：使用同一材质的一段连续三角形
+class SubMesh {
+public:
+    size_t triangleStart;   // 起始三角形（Mesh::indices中的下标）
+    size_t triangleCount;   // 三角形数量
+    Material material;      // 材质
+
+    SubMesh() : triangleStart(0), triangleCount(0), material() {}
+    SubMesh(size_t triangleStart, size_t triangleCount, const Material& material)
+        : triangleStart(triangleStart), triangleCount(triangleCount), material(material) {}
+};
+
+// 网格的包围体（物体空间）
+struct MeshBounds
+{
+    Vector3f min;       // 包围盒最小点
+    Vector3f max;       // 包围盒最大点
+    Vector3f center;    // 包围球球心（包围盒中心）
+    float radius;       // 包围球半径
+
+    MeshBounds() : min(Vector3f::zero), max(Vector3f::zero), center(Vector3f::zero), radius(0.0f) {}
+};
+
+// 簇（meshlet）：网格中一段连续的三角形，带有包围球和法线锥，绘制时可以在顶点着色之前整体剔除
+struct Meshlet
+{
+    size_t triangleStart;   // 起始三角形（Mesh::indices中的下标）
+    size_t triangleCount;   // 三角形数量
+    size_t vertexOffset;    // 引用的顶点在Mesh::meshletVertices中的起始位置
+    size_t vertexCount;     // 引用的顶点数量
+    Vector3f center;        // 包围球球心（物体空间）
+    float radius;           // 包围球半径
+    Vector3f coneApex;      // 法线锥顶点
+    Vector3f coneAxis;      // 法线锥轴（单位向量）
+    float coneCutoff;       // dot(normalize(coneApex - 相机位置), coneAxis) >= coneCutoff时全部三角形背向相机，1表示不能剔除
+
+    Meshlet()
+        : triangleStart(0), triangleCount(0), vertexOffset(0), vertexCount(0),
+          center(Vector3f::zero), radius(0.0f), coneApex(Vector3f::zero), coneAxis(Vector3f::zero), coneCutoff(1.0f) {}
+};
+
 // 网格
 class Mesh
 {
 public:
     std::vector<Vertex> vertices; // 顶点数组
     std::vector<Vector3i> indices; // 顶点索引数组
+    std::vector<SubMesh> subMeshes; // 子网格（按材质排序，为空时整个网格作为一个整体绘制）
+    std::vector<Meshlet> meshlets;  // 簇（MeshletBuilder::Build生成，为空时不做簇剔除；修改顶点位置或indices后需要重新生成）
+    std::vector<int> meshletVertices; // 各簇引用的顶点下标
+    std::vector<Mesh> lods;         // 细节层次（MeshSimplifier::BuildLods生成，三角形数依次减少，为空时总是绘制原网格；修改顶点位置后需要重新生成）
+    float lodError;                 // 作为LOD时相对原网格的几何误差（物体空间距离，原网格为0）
     
 public:
-    Mesh() : vertices(), indices() {}
+    Mesh() : vertices(), indices(), subMeshes(), lodError(0.0f), m_boundsValid(false), m_boundsVertexData(nullptr), m_boundsVertexCount(0) {}
     
     Mesh(const std::vector<Vertex>& verts, const std::vector<Vector3i>& inds)
-        : vertices(verts), indices(inds) {}
+        : vertices(verts), indices(inds), subMeshes(), lodError(0.0f), m_boundsValid(false), m_boundsVertexData(nullptr), m_boundsVertexCount(0) {}
     
     // 拷贝构造函数
     Mesh(const Mesh& other)
-        : vertices(other.vertices), indices(other.indices) {}
-    
+        : vertices(other.vertices), indices(other.indices), subMeshes(other.subMeshes),
+          meshlets(other.meshlets), meshletVertices(other.meshletVertices),
+          lods(other.lods), lodError(other.lodError),
+          m_boundsValid(false), m_boundsVertexData(nullptr), m_boundsVertexCount(0) {}
+
+    // 移动构造函数（加载大模型时避免复制顶点数组）
+    Mesh(Mesh&& other) noexcept
+        : vertices(std::move(other.vertices)), indices(std::move(other.indices)),
+          subMeshes(std::move(other.subMeshes)),
+          meshlets(std::move(other.meshlets)), meshletVertices(std::move(other.meshletVertices)),
+          lods(std::move(other.lods)), lodError(other.lodError),
+          m_boundsValid(false), m_boundsVertexData(nullptr), m_boundsVertexCount(0) {}
+
+    Mesh& operator=(const Mesh& other) = default;
+    Mesh& operator=(Mesh&& other) noexcept = default;
+
     // 添加顶点
     void AddVertex(const Vertex& vertex) {
         vertices.push_back(vertex);
@@ -97,6 +195,11 @@ public:
     void Clear() {
         vertices.clear();
         indices.clear();
+        subMeshes.clear();
+        meshlets.clear();
+        meshletVertices.clear();
+        lods.clear();
+        lodError = 0.0f;
     }
     
     // 获取顶点数量
@@ -141,6 +244,30 @@ public:
         return sum / static_cast<float>(vertices.size());
     }
 
+    // 获取缓存的包围体（第一次调用时计算）
+    // 顶点数组重新分配或数量变化时自动重新计算；直接修改已有顶点的位置后需要调用InvalidateBounds
+    const MeshBounds& GetBounds() const {
+        if (!m_boundsValid || m_boundsVertexData != vertices.data() || m_boundsVertexCount != vertices.size()) {
+            CalculateBounds(m_bounds.min, m_bounds.max);
+            m_bounds.center = (m_bounds.min + m_bounds.max) * 0.5f;
+            m_bounds.radius = 0.0f;
+            for (const auto& vertex : vertices) {
+                Vector3f pos(vertex.pos.x, vertex.pos.y, vertex.pos.z);
+                m_bounds.radius = (std::max)(m_bounds.radius, (pos - m_bounds.center).magnitudeSquared());
+            }
+            m_bounds.radius = std::sqrt(m_bounds.radius);
+            m_boundsValid = true;
+            m_boundsVertexData = vertices.data();
+            m_boundsVertexCount = vertices.size();
+        }
+        return m_bounds;
+    }
+
+    // 使缓存的包围体失效
+    void InvalidateBounds() {
+        m_boundsValid = false;
+    }
+
     // 计算网格的包围球
     void CalculateBoundingSphere(Vector3f& center, float& radius) const {
         center = CalculateCenter();
@@ -184,89 +311,103 @@ public:
             vertex.normal = vertex.normal.normalize();
         }
     }
-};
-
-// 材质类
-class Material {
-public:
-    Color ambient;      // 环境光颜色
-    Color diffuse;      // 漫反射颜色
-    Color specular;     // 镜面反射颜色
-    float shininess;    // 高光指数
-    float opacity;      // 不透明度
 
-    Material() 
-        : ambient(Color::white), 
-          diffuse(Color::white), 
-          specular(Color::white), 
-          shininess(32.0f),
-          opacity(1.0f) {}
-
-    Material(const Color& ambient, const Color& diffuse, const Color& specular, float shininess, float opacity = 1.0f)
-        : ambient(ambient), 
-          diffuse(diffuse), 
-          specular(specular), 
-          shininess(shininess),
-          opacity(opacity) {}
+private:
+    // 包围体缓存
+    mutable MeshBounds m_bounds;
+    mutable bool m_boundsValid;
+    mutable const Vertex* m_boundsVertexData;   // 计算时的顶点数组地址和数量，用于发现顶点数组的修改
+    mutable size_t m_boundsVertexCount;
 };
 
-// 矩阵变换类
+// 矩阵变换类：位置、旋转（内部为四元数）和缩放
+// 局部矩阵在变换修改后第一次使用时重新计算并缓存，之后的读取不再计算（缓存不是线程安全的，多线程读取前需要先读取一次）
 class Transformer {
 public:
-    Vector3f position;      // 位置
-    Vector3f rotation;      // 旋转（欧拉角，单位：度）
-    Vector3f scale;         // 缩放
-
     Transformer() 
-        : position(Vector3f::zero), 
-          rotation(Vector3f::zero), 
-          scale(Vector3f::one) {}
-
-    // 获取模型矩阵
-    Matrix GetModelMatrix() const {
-        // 按照缩放->旋转->平移的顺序构建矩阵
-        // 注意：矩阵乘法顺序很重要，后乘的变换先应用
-        Matrix result = Matrix::identity();
-        Matrix scaleMatrix = Matrix::scale(scale);
-        Matrix rotationMatrixX = Matrix::rotate(rotation.x, 'x');
-        Matrix rotationMatrixY = Matrix::rotate(rotation.y, 'y');
-        Matrix rotationMatrixZ = Matrix::rotate(rotation.z, 'z');
-        Matrix translationMatrix = Matrix::translate(position);
-        
-        // 正确的矩阵乘法顺序：平移 * 旋转Z * 旋转Y * 旋转X * 缩放
-        result = translationMatrix * rotationMatrixZ * rotationMatrixY * rotationMatrixX * scaleMatrix;
-        return result;
+        : m_position(Vector3f::zero), 
+          m_eulerAngles(Vector3f::zero), 
+          m_scale(Vector3f::one),
+          m_localMatrix(Matrix::identity()),
+          m_dirty(false) {}
+
+    // 获取模型矩阵（局部矩阵：平移 * 旋转 * 缩放）
+    const Matrix& GetModelMatrix() const {
+        if (m_dirty) {
+            UpdateLocalMatrix();
+        }
+        return m_localMatrix;
     }
 
+    // 位置、旋转（欧拉角，单位：度；或四元数）和缩放
+    const Vector3f& GetPosition() const { return m_position; }
+    const Vector3f& GetRotation() const { return m_eulerAngles; }
+    const Quaternion& GetRotationQuaternion() const { return m_rotation; }
+    const Vector3f& GetScale() const { return m_scale; }
+
     // 设置位置
     void SetPosition(const Vector3f& pos) {
-        position = pos;
+        m_position = pos;
+        m_dirty = true;
     }
 
-    // 设置旋转
+    // 设置旋转（欧拉角，先绕X轴，再绕Y轴，最后绕Z轴）
     void SetRotation(const Vector3f& rot) {
-        rotation = rot;
+        m_eulerAngles = rot;
+        m_rotation = Quaternion::fromEuler(rot);
+        m_dirty = true;
+    }
+
+    // 设置旋转（四元数）
+    void SetRotation(const Quaternion& rot) {
+        m_rotation = rot.normalize();
+        m_eulerAngles = m_rotation.toEuler();
+        m_dirty = true;
     }
 
     // 设置缩放
     void SetScale(const Vector3f& scl) {
-        scale = scl;
+        m_scale = scl;
+        m_dirty = true;
     }
 
     // 平移
     void Translate(const Vector3f& translation) {
-        position += translation;
+        SetPosition(m_position + translation);
     }
 
-    // 旋转
+    // 旋转（欧拉角相加）
     void Rotate(const Vector3f& rotation) {
-        this->rotation += rotation;
+        SetRotation(m_eulerAngles + rotation);
+    }
+
+    // 旋转（在当前旋转之后再应用rotation）
+    void Rotate(const Quaternion& rotation) {
+        SetRotation(rotation * m_rotation);
     }
 
     // 缩放
     void Scale(const Vector3f& scale) {
-        this->scale *= scale;
+        Vector3f newScale = m_scale;
+        newScale *= scale;
+        SetScale(newScale);
     }
+
+private:
+    // 由位置、旋转和缩放直接写出局部矩阵：旋转矩阵的每一列乘以对应的缩放，最后一列为平移
+    void UpdateLocalMatrix() const {
+        m_localMatrix = Affine3::fromTRS(m_position, m_rotation, m_scale).toMatrix();
+        m_dirty = false;
+    }
+
+    Vector3f m_position;        // 位置
+    Vector3f m_eulerAngles;     // 旋转的欧拉角（单位：度），用于编辑和显示
+    Quaternion m_rotation;      // 旋转
+    Vector3f m_scale;           // 缩放
+
+    // 局部矩阵缓存
+    mutable Matrix m_localMatrix;
+    mutable bool m_dirty;
 };
 
 // 对象类
@@ -276,13 +417,28 @@ public:
     Material material;      // 材质
     Transformer transform;  // 变换
 
-    Object() : mesh(), material(), transform() {}
+    Object() : mesh(), material(), transform(), m_lodIndex(0), m_worldMatrix(Matrix::identity()), m_hasParent(false) {}
     Object(const Mesh& mesh, const Material& material, const Transformer& transform)
-        : mesh(mesh), material(material), transform(transform) {}
+        : mesh(mesh), material(material), transform(transform), m_lodIndex(0), m_worldMatrix(Matrix::identity()), m_hasParent(false) {}
+
+    // 上一次绘制使用的LOD（0为原网格，i为mesh.lods[i - 1]），LOD选择根据它做滞后，避免在阈值附近来回切换
+    int GetLodIndex() const { return m_lodIndex; }
+    void SetLodIndex(int index) const { m_lodIndex = index; }
 
-    // 获取模型矩阵
-    Matrix GetModelMatrix() const {
-        return transform.GetModelMatrix();
+    // 获取模型矩阵：没有父对象时为变换的局部矩阵，有父对象时为缓存的世界矩阵（父对象的模型矩阵 * 局部矩阵）
+    const Matrix& GetModelMatrix() const {
+        return m_hasParent ? m_worldMatrix : transform.GetModelMatrix();
+    }
+
+    // 由父对象的模型矩阵计算并缓存世界矩阵（Scene更新层级时调用）
+    void SetParentMatrix(const Matrix& parentMatrix) {
+        m_worldMatrix = parentMatrix * transform.GetModelMatrix();
+        m_hasParent = true;
+    }
+
+    // 解除父对象，模型矩阵恢复为局部矩阵
+    void ClearParentMatrix() {
+        m_hasParent = false;
     }
 
     // 设置位置
@@ -319,7 +475,7 @@ public:
     void CalculateBounds(Vector3f& min, Vector3f& max) const {
         mesh.CalculateBounds(min, max);
         // 应用变换
-        Matrix modelMatrix = GetModelMatrix();
+        const Matrix& modelMatrix = GetModelMatrix();
         Vector4f minVec(min, 1.0f);
         Vector4f maxVec(max, 1.0f);
         minVec = modelMatrix * minVec;
@@ -331,7 +487,7 @@ public:
     // 计算对象的中心点
     Vector3f CalculateCenter() const {
         Vector3f center = mesh.CalculateCenter();
-        Matrix modelMatrix = GetModelMatrix();
+        const Matrix& modelMatrix = GetModelMatrix();
         Vector4f centerVec(center.x, center.y, center.z, 1.0f);
         centerVec = modelMatrix * centerVec;
         return Vector3f(centerVec.x, centerVec.y, centerVec.z);
@@ -341,12 +497,18 @@ public:
     void CalculateBoundingSphere(Vector3f& center, float& radius) const {
         mesh.CalculateBoundingSphere(center, radius);
         // 应用变换
-        Matrix modelMatrix = GetModelMatrix();
+        const Matrix& modelMatrix = GetModelMatrix();
         Vector4f centerVec(center.x, center.y, center.z, 1.0f);
         centerVec = modelMatrix * centerVec;
         center = Vector3f(centerVec.x, centerVec.y, centerVec.z);
         // 考虑缩放对半径的影响
-        float maxScale = (std::max)((std::max)(transform.scale.x, transform.scale.y), transform.scale.z);
+        const Vector3f& scale = transform.GetScale();
+        float maxScale = (std::max)((std::max)(scale.x, scale.y), scale.z);
         radius *= maxScale;
     }
+
+private:
+    mutable int m_lodIndex;
+    Matrix m_worldMatrix;   // 有父对象时的世界矩阵
+    bool m_hasParent;       // 是否有父对象（模型矩阵使用m_worldMatrix）
 };
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Object.h"
+#include "Vector.h"
+
+// 法线存储格式
+enum class NormalFormat {
+    Float3,         // 3个float（12字节）
+    Octahedral16    // 八面体映射，2个int16（4字节，最大角度误差约0.04度）
+};
+
+// 纹理坐标存储格式
+enum class TexcoordFormat {
+    Float2,         // 2个float（8字节）
+    Half2,          // 2个半精度浮点（4字节，适合[0,1]附近的坐标）
+    Unorm16         // 2个uint16，按网格的纹理坐标范围量化（4字节，误差均匀）
+};
+
+// 打包格式
+struct PackedMeshFormat {
+    NormalFormat normalFormat;
+    TexcoordFormat texcoordFormat;
+    bool includeColor;          // 保存顶点颜色（RGBA8），不保存时解码为白色
+
+    PackedMeshFormat()
+        : normalFormat(NormalFormat::Octahedral16),
+          texcoordFormat(TexcoordFormat::Half2),
+          includeColor(false) {}
+};
+
+// 一批顶点的解码结果（SoA布局，可以直接用SIMD指令处理）
+struct VertexBatch {
+    static const int kSize = 8;
+
+    alignas(32) float positionX[kSize];
+    alignas(32) float positionY[kSize];
+    alignas(32) float positionZ[kSize];
+    alignas(32) float normalX[kSize];
+    alignas(32) float normalY[kSize];
+    alignas(32) float normalZ[kSize];
+    alignas(32) float texcoordU[kSize];
+    alignas(32) float texcoordV[kSize];
+    alignas(32) float colorR[kSize];
+    alignas(32) float colorG[kSize];
+    alignas(32) float colorB[kSize];
+    alignas(32) float colorA[kSize];
+    int count;  // 有效顶点数（最后一批可能不足kSize个）
+
+    // 取出第i个顶点（用于逐三角形的绘制流程）
+    Vertex GetVertex(int i) const {
+        return Vertex(Vector4f(positionX[i], positionY[i], positionZ[i], 1.0f),
+                      Vector4f(colorR[i], colorG[i], colorB[i], colorA[i]),
+                      Vector3f(normalX[i], normalY[i], normalZ[i]),
+                      Vector2f(texcoordU[i], texcoordV[i]));
+    }
+
+    // 从Vertex数组加载vertexCount个顶点（不超过kSize，剩余的通道重复最后一个顶点）
+    void LoadVertices(const Vertex* vertices, int vertexCount);
+
+    // 按indices中的下标从Vertex数组加载vertexCount个顶点（用于按簇着色）
+    void LoadVertices(const Vertex* vertices, const int* indices, int vertexCount);
+};
+
+// 按属性分开存储（SoA）并可量化的网格，用于减少大模型的内存占用和带宽
+// 每个属性分量是一个独立的数组，长度补齐到VertexBatch::kSize的倍数，一次可以加载4个或8个顶点
+class PackedMesh {
+public:
+    PackedMesh();
+
+    // 从Mesh打包（索引和子网格保持不变）
+    static PackedMesh FromMesh(const Mesh& mesh, const PackedMeshFormat& format = PackedMeshFormat());
+
+    // 解码为Mesh
+    Mesh ToMesh() const;
+
+    // 解码单个顶点
+    Vertex GetVertex(size_t index) const;
+
+    // 解码从first开始的一批顶点（AVX2一次8个，SSE一次4个）
+    void LoadBatch(size_t first, VertexBatch& batch) const;
+
+    // 顶点数量
+    size_t GetVertexCount() const { return m_vertexCount; }
+
+    // 打包格式
+    const PackedMeshFormat& GetFormat() const { return m_format; }
+
+    // 顶点和索引占用的内存（字节）
+    size_t GetMemoryBytes() const;
+
+    std::vector<Vector3i> indices;      // 顶点索引数组（与Mesh相同）
+    std::vector<SubMesh> subMeshes;     // 子网格（与Mesh相同）
+
+private:
+    PackedMeshFormat m_format;
+    size_t m_vertexCount;
+
+    // 位置
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_positionZ;
+
+    // 法线（Float3使用m_normalX/Y/Z，Octahedral16使用m_normalOctX/Y）
+    std::vector<float> m_normalX;
+    std::vector<float> m_normalY;
+    std::vector<float> m_normalZ;
+    std::vector<int16_t> m_normalOctX;
+    std::vector<int16_t> m_normalOctY;
+
+    // 纹理坐标（Float2使用m_texcoordU/V，Half2和Unorm16使用m_texcoordQuantizedU/V）
+    std::vector<float> m_texcoordU;
+    std::vector<float> m_texcoordV;
+    std::vector<uint16_t> m_texcoordQuantizedU;
+    std::vector<uint16_t> m_texcoordQuantizedV;
+    Vector2f m_texcoordOffset;          // Unorm16的反量化参数：uv = offset + q * scale
+    Vector2f m_texcoordScale;
+
+    // 颜色（RGBA8，R在最低字节）
+    std::vector<uint32_t> m_colors;
+};
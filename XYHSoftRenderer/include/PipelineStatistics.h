@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 管线统计（类似GPU的pipeline statistics查询）：各阶段处理的顶点、三角形、像素和纹理采样数量
+struct PipelineStatistics {
+    static const int kFilterModes = 3;   // 与TextureFilterMode一一对应
+    static const int kMipLevels = 16;    // 统计的Mipmap级别数，更小的级别计入最后一级
+
+    uint64_t verticesShaded;            // 执行顶点着色器的顶点数
+    uint64_t trianglesSubmitted;        // 进入剔除和裁剪的三角形数（簇剔除之后）
+    uint64_t trianglesBackfaceCulled;   // 被背面剔除的三角形数
+    uint64_t trianglesClipRejected;     // 完全在视锥体外（或裁剪后为空）的三角形数
+    uint64_t trianglesClipped;          // 跨越近平面、远平面或保护带，需要真正裁剪的三角形数
+    uint64_t trianglesZeroArea;         // 裁剪后面积为0被跳过的三角形数（按扇形拆分后）
+    uint64_t trianglesRasterized;       // 光栅化的三角形数（按扇形拆分后）
+    uint64_t pixelsTested;              // 覆盖测试的像素数（包围盒内的quad，每个quad4个像素）
+    uint64_t pixelsCovered;             // 被三角形覆盖的像素数
+    uint64_t depthTestsPassed;          // 通过深度测试的像素数
+    uint64_t depthTestsFailed;          // 未通过深度测试的像素数
+    uint64_t fragmentsShaded;           // 执行片元着色器的像素数
+    uint64_t textureSamples[kFilterModes];  // 按实际使用的过滤方式统计的纹理采样数
+    uint64_t mipLevelSamples[kMipLevels];   // 按Mipmap级别统计的纹理采样数（三线性取较精细的一级，其余为第0级）
+
+    PipelineStatistics() { Reset(); }
+
+    void Reset();
+    uint64_t GetTextureSampleCount() const;
+
+    PipelineStatistics& operator+=(const PipelineStatistics& other);
+    PipelineStatistics operator-(const PipelineStatistics& other) const;
+};
+
+// 管线统计的计数器：每个线程只累加自己的计数器（不加锁、没有竞争），
+// 线程在帧结束（或任务结束）时调用FlushLocal把计数合并到总数，读取时再一次性取走
+class PipelineCounters {
+public:
+    // 开启后才计数（默认关闭，关闭时每个三角形只多一次判断）
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // 当前线程的计数器（只能由当前线程修改）
+    static PipelineStatistics& Local();
+
+    // 开启统计时把count加到当前线程的计数器上
+    static void Add(uint64_t PipelineStatistics::* counter, uint64_t count)
+    {
+        if (IsEnabled()) {
+            Local().*counter += count;
+        }
+    }
+
+    // 把当前线程的计数合并到总数并清零
+    static void FlushLocal();
+
+    // 合并当前线程的计数，取走总数（总数清零）
+    static PipelineStatistics Collect();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
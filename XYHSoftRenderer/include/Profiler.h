@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// 性能分析开关：项目中定义 XYH_PROFILER=0 时计时宏全部展开为空，绘制流程中不留下任何代码
+#ifndef XYH_PROFILER
+#define XYH_PROFILER 1
+#endif
+
+// 光栅化管线的阶段：逐三角形和逐quad的阶段太细，不逐个记录事件，只累计每帧的总时间
+enum class ProfileStage {
+    VertexShading,  // 顶点着色
+    Clipping,       // 背面剔除和裁剪
+    Setup,          // 三角形设置（透视除法、视口变换、包围盒和面积）
+    Raster,         // 像素循环（覆盖测试、插值和深度测试）
+    Fragment,       // 片元着色和写入缓冲区
+    Count
+};
+
+// CPU性能分析器：每个线程把计时事件写入自己的环形缓冲区（只有这个线程写入，不加锁），
+// 按帧范围导出为Chrome trace_event格式的JSON（用chrome://tracing或Perfetto打开）
+// 默认不记录，只在SetEnabled(true)或StartCapture期间读取时钟
+class Profiler {
+public:
+    // 计时事件
+    struct Event {
+        const char* name;   // 名称（必须是静态字符串）
+        int64_t start;      // 开始时间（纳秒，相对于程序启动）
+        int64_t value;      // 持续时间（纳秒），计数器事件为计数值
+        int frame;          // 所在帧
+        char phase;         // 'X'：时间段，'C'：计数器
+    };
+
+    // 每个线程的环形缓冲区容量（事件数），写满后覆盖最早的事件
+    static const size_t kBufferCapacity = 1 << 16;
+
+    // 逐三角形的阶段计时每隔多少个三角形计时一次（每次读取时钟约几十纳秒，逐quad切换阶段时全部计时的开销太大）
+    static const int kStageSampleRate = 8;
+
+    // 持续记录（只保留每个线程最近的kBufferCapacity个事件，可以随时导出最近几帧）
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return s_active.load(std::memory_order_relaxed); }
+
+    // 每帧开始时由渲染线程调用：记录上一帧的时间段和各阶段的总时间，帧号加一，
+    // 正在捕获且已到达最后一帧时写出文件
+    static void BeginFrame();
+    static int GetFrameIndex();
+
+    // 从下一帧开始记录frameCount帧，结束后写入path
+    static void StartCapture(int frameCount, const std::string& path);
+    static bool IsCapturing();
+
+    // 当前线程在trace中显示的名称（name必须是静态字符串；不分配缓冲区，可以在每个新线程开始时调用）
+    static void SetThreadName(const char* name);
+
+    // 导出[firstFrame, lastFrame]帧内的事件；已被环形缓冲区覆盖的事件不会导出
+    static std::string ExportChromeTrace(int firstFrame, int lastFrame);
+    static bool WriteChromeTrace(const std::string& path, int firstFrame, int lastFrame);
+
+    // 当前时间（纳秒，相对于程序启动）
+    static int64_t Now();
+
+    // CPU时间戳计数器（rdtsc，单位为周期；开销比Now小，只用于比较同一线程上很短的时间段）
+    static uint64_t ReadCycleCounter() { return __rdtsc(); }
+
+    // 读取一次时钟的耗时（纳秒，开始记录时测量），阶段计时从每段时间中减去
+    static int64_t GetClockOverhead() { return s_clockOverhead.load(std::memory_order_relaxed); }
+
+    // 记录一个时间段（由ProfileScope调用）
+    static void RecordScope(const char* name, int64_t start, int64_t end);
+
+    // 累加当前线程本帧各阶段的时间（由ProfileStageTimer调用，在下一次BeginFrame时输出为计数器事件）
+    static void AddStageTimes(const int64_t* stageTimes, int scale);
+
+    // 当前线程每sampleRate次调用返回一次true
+    static bool NextStageSample(int sampleRate);
+
+    static const char* GetStageName(ProfileStage stage);
+
+private:
+    static void CalibrateClock();
+
+    static std::atomic<bool> s_active; // 正在记录（持续记录或捕获中）
+    static std::atomic<int64_t> s_clockOverhead;
+};
+
+// 作用域计时：构造时记录开始时间，析构时写入事件
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : m_name(name), m_start(Profiler::IsEnabled() ? Profiler::Now() : -1) {}
+    ~ProfileScope()
+    {
+        if (m_start >= 0) {
+            Profiler::RecordScope(m_name, m_start, Profiler::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_start;
+};
+
+// 阶段计时：每次切换阶段读取一次时钟，经过的时间计入前一个阶段（各阶段互不重叠）
+// 时间先累计在对象中，析构时一次性加到线程的每帧总时间上
+// sampleRate大于1时只有每sampleRate个计时器中的一个计时，时间乘以sampleRate作为估计值
+class ProfileStageTimer {
+public:
+    explicit ProfileStageTimer(int sampleRate = 1)
+        : m_active(Profiler::IsEnabled() && (sampleRate <= 1 || Profiler::NextStageSample(sampleRate))),
+          m_scale(sampleRate), m_overhead(m_active ? Profiler::GetClockOverhead() : 0),
+          m_stage(ProfileStage::Count), m_last(0), m_times() {}
+    ~ProfileStageTimer()
+    {
+        if (m_active) {
+            Switch(ProfileStage::Count);
+            Profiler::AddStageTimes(m_times, m_scale);
+        }
+    }
+
+    // 切换到stage，ProfileStage::Count表示停止计时
+    void Switch(ProfileStage stage)
+    {
+        if (!m_active) {
+            return;
+        }
+        int64_t now = Profiler::Now();
+        if (m_stage != ProfileStage::Count) {
+            m_times[static_cast<int>(m_stage)] += (std::max)(now - m_last - m_overhead, static_cast<int64_t>(0));
+        }
+        m_stage = stage;
+        m_last = now;
+    }
+
+    ProfileStageTimer(const ProfileStageTimer&) = delete;
+    ProfileStageTimer& operator=(const ProfileStageTimer&) = delete;
+
+private:
+    bool m_active;
+    int m_scale;
+    int64_t m_overhead;
+    ProfileStage m_stage;
+    int64_t m_last;
+    int64_t m_times[static_cast<int>(ProfileStage::Count)];
+};
+
+#if XYH_PROFILER
+#define XYH_PROFILE_CONCAT_INNER(a, b) a##b
+#define XYH_PROFILE_CONCAT(a, b) XYH_PROFILE_CONCAT_INNER(a, b)
+// 计时当前作用域，name必须是静态字符串
+#define XYH_PROFILE_SCOPE(name) ProfileScope XYH_PROFILE_CONCAT(profileScope, __LINE__)(name)
+// 声明阶段计时器，之后用XYH_PROFILE_STAGE切换阶段，XYH_PROFILE_STAGE_END停止计时（析构时也会停止）
+#define XYH_PROFILE_STAGES(timer) ProfileStageTimer timer
+// 逐三角形的阶段计时器（按Profiler::kStageSampleRate抽样）
+#define XYH_PROFILE_SAMPLED_STAGES(timer) ProfileStageTimer timer(Profiler::kStageSampleRate)
+#define XYH_PROFILE_STAGE(timer, stage) timer.Switch(ProfileStage::stage)
+#define XYH_PROFILE_STAGE_END(timer) timer.Switch(ProfileStage::Count)
+#else
+#define XYH_PROFILE_SCOPE(name) ((void)0)
+#define XYH_PROFILE_STAGES(timer) ((void)0)
+#define XYH_PROFILE_SAMPLED_STAGES(timer) ((void)0)
+#define XYH_PROFILE_STAGE(timer, stage) ((void)0)
+#define XYH_PROFILE_STAGE_END(timer) ((void)0)
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix.h"
+
+
+// 单位四元数表示的旋转（x, y, z为虚部，w为实部）
+class Quaternion
+{
+public:
+    float x, y, z, w;
+
+public:
+    Quaternion();
+    Quaternion(float x, float y, float z, float w);
+
+    Quaternion operator*(const Quaternion& quaternion) const; // 旋转复合：先应用右边的旋转
+
+    static Quaternion identity(); // 单位四元数（不旋转）
+
+    // 绕任意轴旋转（角度单位：度）
+    static Quaternion fromAxisAngle(const Vector3f& axis, float angle);
+
+    // 欧拉角（单位：度）转四元数，旋转顺序与Transformer一致：先绕X轴，再绕Y轴，最后绕Z轴
+    static Quaternion fromEuler(const Vector3f& angles);
+
+    // 转回欧拉角（单位：度），Y轴旋转在[-90, 90]范围内
+    Vector3f toEuler() const;
+
+    Quaternion normalize() const; // 归一化
+    Quaternion conjugate() const; // 共轭（单位四元数的逆）
+
+    Vector3f rotate(const Vector3f& vector) const; // 旋转向量
+
+    // 3x3部分为旋转矩阵的4x4矩阵（与Matrix::rotate组合的结果一致）
+    Matrix toMatrix() const;
+
+    // 球面线性插值，t = 0时为a，t = 1时为b（沿较短的弧）
+    static Quaternion slerp(const Quaternion& a, const Quaternion& b, float t);
+};
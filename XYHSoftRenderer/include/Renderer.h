@@ -3,10 +3,17 @@
 #include <Windows.h>
 #include <string>
 #include <memory>
+#include <vector>
 #include "Buffer.h"
 #include "Color.h"
 #include "Object.h"
 #include "Shader.h"
+#include "PackedMesh.h"
+#include "FrameArena.h"
+#include "Frustum.h"
+#include "PipelineStatistics.h"
+
+class Scene;
 
 class Renderer {
 public:
@@ -27,12 +34,24 @@ public:
     // 3D绘制功能
     void DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3, Shader* shader);
     void DrawMesh(const Mesh& mesh, const Matrix& modelMatrix, Shader* shader);
+    void DrawMesh(const Mesh& mesh, const Matrix& modelMatrix, Shader* shader, size_t triangleStart, size_t triangleCount);
+    void DrawMesh(const PackedMesh& mesh, const Matrix& modelMatrix, Shader* shader);
     void DrawObject(const Object& object, Shader* shader);
     
+    // 绘制场景：通过场景的BVH做视锥体剔除，只绘制可见的对象
+    void DrawScene(Scene& scene, Shader* shader);
+    
+    // 实例化绘制：同一个网格按多个模型矩阵（或带颜色和参数的实例数据）绘制，网格数据只有一份，在实例之间保持在缓存中
+    // 网格的包围体只取一次，逐实例做视锥体剔除（开启时）；网格不能按簇绘制时顶点只读取并转换为SoA一次，所有实例共用
+    // 网格带有子网格时每个实例按子网格切换材质，绘制后恢复着色器原来的材质；不做LOD选择
+    void DrawMeshInstanced(const Mesh& mesh, const Matrix* modelMatrices, size_t count, Shader* shader);
+    void DrawMeshInstanced(const Mesh& mesh, const InstanceData* instances, size_t count, Shader* shader);
+    void DrawMeshInstanced(const Mesh& mesh, const std::vector<InstanceData>& instances, Shader* shader) { DrawMeshInstanced(mesh, instances.data(), instances.size(), shader); }
+    
     // 矩阵设置
     void SetModelMatrix(const Matrix& matrix) { m_modelMatrix = matrix; }
-    void SetViewMatrix(const Matrix& matrix) { m_viewMatrix = matrix; }
-    void SetProjectionMatrix(const Matrix& matrix) { m_projMatrix = matrix; }
+    void SetViewMatrix(const Matrix& matrix) { m_viewMatrix = matrix; m_frustumDirty = true; }
+    void SetProjectionMatrix(const Matrix& matrix) { m_projMatrix = matrix; m_frustumDirty = true; }
     
     // 相机位置设置
     void SetViewPosition(const Vector3f& position) { m_viewPosition = position; }
@@ -60,6 +79,91 @@ public:
     void SetFrontFace(FrontFace order) { m_frontFace = order; }
     FrontFace GetFrontFace() const { return m_frontFace; }
     
+    // 对象级视锥体剔除（DrawObject在顶点着色前用对象的包围体测试，默认开启）
+    void SetFrustumCulling(bool enabled) { m_frustumCulling = enabled; }
+    bool GetFrustumCulling() const { return m_frustumCulling; }
+    
+    // 簇级剔除（网格带有簇时，绘制前按簇做视锥体剔除和背面锥剔除，被剔除的簇不执行顶点着色，默认开启）
+    void SetMeshletCulling(bool enabled) { m_meshletCulling = enabled; }
+    bool GetMeshletCulling() const { return m_meshletCulling; }
+    
+    // LOD选择（对象的网格带有LOD链时，按包围球投影到屏幕上的大小选择误差不超过pixelError像素的最粗糙一级，默认开启）
+    // 滞后：换成更粗糙的LOD要求误差低于pixelError * (1 - hysteresis)，当前LOD误差超过pixelError * (1 + hysteresis)才换回更精细的
+    void SetLodSelection(bool enabled) { m_lodSelection = enabled; }
+    bool GetLodSelection() const { return m_lodSelection; }
+    void SetLodPixelError(float pixels) { m_lodPixelError = pixels; }
+    float GetLodPixelError() const { return m_lodPixelError; }
+    void SetLodHysteresis(float hysteresis) { m_lodHysteresis = hysteresis; }
+    float GetLodHysteresis() const { return m_lodHysteresis; }
+    
+    // 当前视图和投影矩阵对应的视锥体（世界空间）
+    const Frustum& GetFrustum();
+    
+    // 每帧的绘制统计（ClearBackBuffer时清零）
+    struct RenderStats {
+        int objectsDrawn;       // 绘制的对象数
+        int objectsCulled;      // 被视锥体剔除的对象数
+        int meshletsDrawn;              // 绘制的簇数
+        int meshletsFrustumCulled;      // 被视锥体剔除的簇数
+        int meshletsBackfaceCulled;     // 被背面锥剔除的簇数
+        size_t trianglesSubmitted;      // 绘制的对象按所选LOD提交的三角形数
+        size_t trianglesFullDetail;     // 这些对象都使用原网格时的三角形数
+        int instancesDrawn;             // 实例化绘制的实例数
+        int instancesCulled;            // 被视锥体剔除的实例数
+        
+        RenderStats()
+            : objectsDrawn(0), objectsCulled(0),
+              meshletsDrawn(0), meshletsFrustumCulled(0), meshletsBackfaceCulled(0),
+              trianglesSubmitted(0), trianglesFullDetail(0),
+              instancesDrawn(0), instancesCulled(0) {}
+    };
+    const RenderStats& GetStats() const { return m_stats; }
+    
+    // 管线统计（类似GPU的pipeline statistics查询，默认关闭）：顶点、三角形、像素、深度测试和纹理采样的数量
+    // GetPipelineStatistics返回本帧（ClearBackBuffer之后）到目前为止的统计，合并各线程的计数器
+    // Begin/EndPipelineQuery返回两次调用之间的绘制的统计（可以查询单次绘制，不能跨越ClearBackBuffer）
+    void SetPipelineStatisticsEnabled(bool enabled) { PipelineCounters::SetEnabled(enabled); }
+    bool IsPipelineStatisticsEnabled() const { return PipelineCounters::IsEnabled(); }
+    const PipelineStatistics& GetPipelineStatistics();
+    void BeginPipelineQuery();
+    PipelineStatistics EndPipelineQuery();
+    
+    // 调试视图：逐像素累计计数，ResolveDebugView时按热度调色板（黑-蓝-青-绿-黄-红，超出满量程为白色）代替着色结果写入颜色缓冲区
+    enum class DebugView {
+        NONE,               // 正常显示（默认）
+        OVERDRAW,           // 通过深度测试的片元着色次数
+        DEPTH_COMPLEXITY,   // 深度测试次数
+        SHADER_COST         // 片元着色器的CPU周期（rdtsc，quad的周期平均分给着色的像素）
+    };
+    void SetDebugView(DebugView view);
+    DebugView GetDebugView() const { return m_debugView; }
+    static const char* GetDebugViewName(DebugView view);
+    
+    // 调色板满量程对应的计数（或周期数），0表示自动：计数视图为kDebugViewCountScale，周期视图为本帧着色像素的99百分位
+    static const int kDebugViewCountScale = 8;
+    void SetDebugViewScale(float scale) { m_debugViewScale = scale; }
+    float GetDebugViewScale() const { return m_debugViewScale; }
+    
+    // 在绘制完场景之后、绘制文字之前调用，返回使用的满量程（没有开启调试视图时不做任何事，返回0）
+    float ResolveDebugView();
+    
+    // 本帧逐像素的计数（行优先，开启调试视图时才有数据，ClearBackBuffer时清零）
+    const std::vector<uint32_t>& GetDebugCounts() const { return m_debugCounts; }
+    
+    // 编译期渲染状态（DrawMeshT的模板参数）
+    template <CullMode Cull = CullMode::CULL_BACK, bool DepthTest = true, bool AlphaBlend = false>
+    struct RenderState {
+        static constexpr CullMode cullMode = Cull;      // 剔除模式
+        static constexpr bool depthTest = DepthTest;    // 深度测试和深度写入
+        static constexpr bool alphaBlend = AlphaBlend;  // 按片元颜色的alpha混合
+    };
+    
+    // 模板绘制流程：着色器类型、插值属性（ShaderT::kVaryings）和渲染状态在编译期确定，
+    // 片元着色器直接调用而不经过虚函数，整个光栅化循环可以内联
+    // 剔除模式使用State::cullMode而不是SetCullMode的设置，面的朝向仍由SetFrontFace决定
+    template <typename ShaderT, typename State = RenderState<>>
+    void DrawMeshT(const Mesh& mesh, const Matrix& modelMatrix, ShaderT& shader);
+    
     // 缓冲区操作
     void ClearBackBuffer(COLORREF color);
     void ClearBackBuffer(const Color& color);
@@ -70,6 +174,12 @@ public:
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
     
+    // 获取当前绘制的帧缓冲区
+    const FrameBuffer* GetFrameBuffer() const { return m_currentFrameBuffer; }
+    
+    // 每帧临时数据的分配器（ClearBackBuffer时重置），可以查询峰值占用和本帧的malloc次数
+    const FrameArena& GetFrameArena() const { return m_frameArena; }
+    
     // 设置背景颜色
     void SetBackgroundColor(COLORREF color);
     void SetBackgroundColor(const Color& color);
@@ -84,14 +194,102 @@ private:
     // 判断点是否在三角形内，并返回重心坐标
     bool PointInTriangle(float x, float y, const Vector2f& v1, const Vector2f& v2, const Vector2f& v3, float& w1, float& w2, float& w3);
     
-    // 插值顶点数据
-    VertexOutput InterpolateVertex(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, float w1, float w2, float w3);
+    // 插值顶点数据（只插值varyings中的属性）
+    VertexOutput InterpolateVertex(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, float w1, float w2, float w3, int varyings = VARYING_ALL);
+    
+    // 裁剪后的凸多边形（固定大小，放在栈上，避免每个三角形分配内存）
+    struct ClipPolygon {
+        static const int kMaxVertices = 9;  // 3个顶点，每个裁剪平面最多增加1个
+        VertexOutput vertices[kMaxVertices];
+        int count;
+    };
+    
+    // 在裁剪空间裁剪三角形：outcode平凡拒绝/接受，只对跨越近平面、远平面或保护带的三角形真正裁剪
+    // 返回false表示三角形被完全剔除，否则polygon为需要光栅化的凸多边形（按扇形拆分为三角形）
+    bool ClipTriangle(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, int varyings, ClipPolygon& polygon);
+    
+    // 包围盒内的quad的像素数（光栅化循环中覆盖测试的像素数，用于管线统计）
+    static uint64_t CountBoundingQuadPixels(int minX, int maxX, int minY, int maxY)
+    {
+        int startX = minX & ~1;
+        int startY = minY & ~1;
+        if (maxX < startX || maxY < startY) {
+            return 0;
+        }
+        return static_cast<uint64_t>((maxX - startX) / 2 + 1) * ((maxY - startY) / 2 + 1) * FragmentQuad::kLanes;
+    }
+    
+    // 调试视图：把value加到quad中coverageMask对应的像素上
+    void AddDebugCounts(uint32_t* counts, int coverageMask, int quadX, int quadY, uint32_t value)
+    {
+        for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+            if (coverageMask & (1 << lane)) {
+                counts[(quadY + (lane >> 1)) * m_width + quadX + (lane & 1)] += value;
+            }
+        }
+    }
     
-    // 对三角形进行近平面裁剪，返回0-2个新的三角形
-    std::vector<std::array<VertexOutput, 3>> ClipTriangleAgainstNearPlane(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3);
+    // 线段上的裁剪点：v1 + t*(v2-v1)
+    VertexOutput ClipEdge(const VertexOutput& v1, const VertexOutput& v2, float t, int varyings = VARYING_ALL);
     
-    // 线段与近平面求交点
-    VertexOutput ClipAgainstNearPlane(const VertexOutput& v1, const VertexOutput& v2);
+    // 绘制对象（不做视锥体剔除）
+    void DrawObjectInternal(const Object& object, const Matrix& modelMatrix, Shader* shader);
+    
+    // 选择对象要绘制的网格（原网格或mesh.lods中的一级），记录到对象上用于下一帧的滞后
+    const Mesh& SelectLod(const Object& object, const Matrix& modelMatrix);
+    
+    // 绘制整个网格：有子网格时按子网格切换材质，所有子网格共用一次顶点着色的结果
+    // batches不为空时从预先转换的顶点批着色（实例化绘制共用），否则能按簇绘制时按簇绘制
+    void DrawMeshMaterials(const Mesh& mesh, const Matrix& modelMatrix, const VertexBatch* batches, Shader* shader);
+    
+    // 网格是否可以整体按簇绘制（整个网格或每个子网格都与簇的边界对齐）
+    bool CanDrawMeshlets(const Mesh& mesh) const;
+    
+    // 实例化绘制的实现（modelMatrices和instances只有一个不为空）
+    void DrawInstances(const Mesh& mesh, const Matrix* modelMatrices, const InstanceData* instances, size_t count, Shader* shader);
+    
+    // 物体空间包围体经过modelMatrix变换后是否与视锥体相交
+    bool IsVisible(const MeshBounds& bounds, const Matrix& modelMatrix);
+    
+    // 绘制已执行顶点着色器的三角形（剔除、裁剪、光栅化和片元着色）
+    void RasterizeTriangle(const VertexOutput& vs_out1, const VertexOutput& vs_out2, const VertexOutput& vs_out3, Shader* shader);
+    
+    // 批量执行顶点着色器（每个顶点只着色一次），结果保存到m_shadedVertices（从m_frameArena分配）
+    void ShadeVertices(const std::vector<Vertex>& vertices, Shader* shader);
+    void ShadeVertices(const VertexBatch* batches, size_t vertexCount, Shader* shader);
+    
+    // 顶点着色器使用的参数（当前的矩阵和实例数据）
+    VertexUniforms GetVertexUniforms() const;
+    
+    // 使用m_shadedVertices绘制[triangleStart, triangleEnd)范围内的三角形
+    void DrawShadedTriangles(const std::vector<Vector3i>& indices, size_t triangleStart, size_t triangleEnd, Shader* shader);
+    
+    // 按簇绘制时一次绘制共用的数据（簇的包围体在物体空间，把视锥体和相机变换到物体空间测试）
+    struct MeshletDrawState {
+        VertexUniforms uniforms;                    // 顶点着色器的矩阵
+        Vector4f planes[Frustum::PLANE_COUNT];      // 物体空间的视锥体平面（平面方程的值为世界空间距离）
+        float radiusScale;                          // 包围球半径从物体空间到世界空间的缩放倍数
+        Vector3f viewPosition;                      // 物体空间的相机位置
+        bool coneCulling;                           // 是否做背面锥剔除（取决于剔除模式、正面朝向和模型矩阵是否镜像）
+    };
+    
+    // 准备按簇绘制：分配m_shadedVertices和m_vertexShaded（从m_frameArena分配），计算state
+    void BeginMeshlets(const Mesh& mesh, CullMode cullMode, MeshletDrawState& state);
+    
+    // 簇是否需要绘制（更新簇的统计）
+    bool IsMeshletVisible(const Meshlet& meshlet, const MeshletDrawState& state);
+    
+    // 对簇引用的、还没有着色的顶点批量执行顶点着色器
+    void ShadeMeshletVertices(const Mesh& mesh, const Meshlet& meshlet, const MeshletDrawState& state, Shader* shader);
+    
+    // 绘制[firstMeshlet, endMeshlet)范围内可见的簇
+    void DrawMeshlets(const Mesh& mesh, size_t firstMeshlet, size_t endMeshlet, const MeshletDrawState& state, Shader* shader);
+    
+    // 模板版本的三角形绘制和插值（实现在RendererTemplate.h）
+    template <typename ShaderT, typename State>
+    void RasterizeTriangleT(const VertexOutput& vs_out1, const VertexOutput& vs_out2, const VertexOutput& vs_out3, ShaderT& shader);
+    template <int Varyings>
+    static VertexOutput InterpolateVaryings(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, float w1, float w2, float w3);
 
 private:
     // 尺寸
@@ -106,10 +304,36 @@ private:
     // 相机位置
     Vector3f m_viewPosition;
     
+    // 当前实例的颜色和参数（实例化绘制之外为白色和0）
+    Vector4f m_instanceColor;
+    Vector4f m_instanceParams;
+    
     // 绘制状态
     CullMode m_cullMode;    // 剔除模式
     FrontFace m_frontFace;  // 面的朝向判定
     
+    // 视锥体剔除
+    bool m_frustumCulling;  // 是否开启
+    bool m_frustumDirty;    // 视图或投影矩阵改变后需要重新计算视锥体
+    bool m_meshletCulling;  // 是否开启簇级剔除
+    bool m_lodSelection;    // 是否按屏幕大小选择LOD
+    float m_lodPixelError;  // LOD允许的屏幕空间误差（像素）
+    float m_lodHysteresis;  // LOD切换的滞后比例
+    Frustum m_frustum;      // 世界空间视锥体
+    
+    // 每帧的绘制统计
+    RenderStats m_stats;
+    PipelineStatistics m_pipelineStats;     // 本帧已合并的管线统计
+    PipelineStatistics m_queryStart;        // BeginPipelineQuery时的管线统计
+    
+    // 调试视图
+    DebugView m_debugView;
+    float m_debugViewScale;                 // 满量程，0表示自动
+    std::vector<uint32_t> m_debugCounts;    // 逐像素的计数
+    
+    // DrawScene查询到的可见对象（复用容量）
+    std::vector<size_t> m_visibleObjects;
+    
     // GDI绘图相关（仅用于文本绘制）
     HDC m_memDC;           // 内存DC
     HBITMAP m_hOldBitmap;  // 旧位图句柄
@@ -119,4 +343,15 @@ private:
     
     // 当前绘制帧缓冲区
     FrameBuffer* m_currentFrameBuffer;
-}; 
\ No newline at end of file
+    
+    // 每帧临时数据的分配器
+    FrameArena m_frameArena;
+    
+    // 顶点着色器的输出（当前绘制使用，绘制结束后回退m_frameArena）
+    VertexOutput* m_shadedVertices;
+    
+    // 按簇绘制时顶点是否已着色（与m_shadedVertices对应）
+    unsigned char* m_vertexShaded;
+}; 
+
+#include "RendererTemplate.h"
@@ -0,0 +1,285 @@
+#pragma once
+
+// Renderer模板绘制流程的实现（由Renderer.h包含）
+#include "Renderer.h"
+#include "MeshletBuilder.h"
+#include "Profiler.h"
+#include "PipelineStatistics.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// 模板绘制网格：每个顶点只着色一次，再逐三角形光栅化
+template <typename ShaderT, typename State>
+void Renderer::DrawMeshT(const Mesh& mesh, const Matrix& modelMatrix, ShaderT& shader)
+{
+    XYH_PROFILE_SCOPE("DrawMeshT");
+    m_modelMatrix = modelMatrix;
+    FrameArena::Marker marker = m_frameArena.GetMarker();
+
+    // 网格带有簇时先按簇剔除，只对可见簇的顶点执行顶点着色器
+    size_t firstMeshlet, endMeshlet;
+    if (m_meshletCulling && MeshletBuilder::FindMeshlets(mesh, 0, mesh.indices.size(), firstMeshlet, endMeshlet)) {
+        MeshletDrawState state;
+        BeginMeshlets(mesh, State::cullMode, state);
+        for (size_t i = firstMeshlet; i < endMeshlet; i++) {
+            const Meshlet& meshlet = mesh.meshlets[i];
+            if (!IsMeshletVisible(meshlet, state)) {
+                continue;
+            }
+            ShadeMeshletVertices(mesh, meshlet, state, &shader);
+            for (size_t t = meshlet.triangleStart; t < meshlet.triangleStart + meshlet.triangleCount; t++) {
+                const Vector3i& index = mesh.indices[t];
+                RasterizeTriangleT<ShaderT, State>(m_shadedVertices[index.x], m_shadedVertices[index.y], m_shadedVertices[index.z], shader);
+            }
+        }
+        m_frameArena.Rewind(marker);
+        return;
+    }
+
+    ShadeVertices(mesh.vertices, &shader);
+
+    for (const Vector3i& index : mesh.indices) {
+        RasterizeTriangleT<ShaderT, State>(m_shadedVertices[index.x], m_shadedVertices[index.y], m_shadedVertices[index.z], shader);
+    }
+    m_frameArena.Rewind(marker);
+}
+
+// 只插值Varyings中的属性，其余属性保持默认值
+template <int Varyings>
+VertexOutput Renderer::InterpolateVaryings(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, float w1, float w2, float w3)
+{
+    VertexOutput result;
+
+    // 深度和屏幕坐标线性插值
+    result.position.z = w1 * v1.position.z + w2 * v2.position.z + w3 * v3.position.z;
+    result.position.x = w1 * v1.position.x + w2 * v2.position.x + w3 * v3.position.x;
+    result.position.y = w1 * v1.position.y + w2 * v2.position.y + w3 * v3.position.y;
+    result.position.w = 1.0f;
+
+    // 透视校正因子
+    float correctionW1 = w1 / v1.position.w;
+    float correctionW2 = w2 / v2.position.w;
+    float correctionW3 = w3 / v3.position.w;
+    float normalizer = 1.0f / (correctionW1 + correctionW2 + correctionW3);
+
+    if constexpr ((Varyings & VARYING_COLOR) != 0) {
+        result.color.x = (correctionW1 * v1.color.x + correctionW2 * v2.color.x + correctionW3 * v3.color.x) * normalizer;
+        result.color.y = (correctionW1 * v1.color.y + correctionW2 * v2.color.y + correctionW3 * v3.color.y) * normalizer;
+        result.color.z = (correctionW1 * v1.color.z + correctionW2 * v2.color.z + correctionW3 * v3.color.z) * normalizer;
+        result.color.w = (correctionW1 * v1.color.w + correctionW2 * v2.color.w + correctionW3 * v3.color.w) * normalizer;
+    }
+    if constexpr ((Varyings & VARYING_NORMAL) != 0) {
+        result.normal.x = (correctionW1 * v1.normal.x + correctionW2 * v2.normal.x + correctionW3 * v3.normal.x) * normalizer;
+        result.normal.y = (correctionW1 * v1.normal.y + correctionW2 * v2.normal.y + correctionW3 * v3.normal.y) * normalizer;
+        result.normal.z = (correctionW1 * v1.normal.z + correctionW2 * v2.normal.z + correctionW3 * v3.normal.z) * normalizer;
+        result.normal = result.normal.normalize();
+    }
+    if constexpr ((Varyings & VARYING_TEXCOORD) != 0) {
+        result.texcoord.x = (correctionW1 * v1.texcoord.x + correctionW2 * v2.texcoord.x + correctionW3 * v3.texcoord.x) * normalizer;
+        result.texcoord.y = (correctionW1 * v1.texcoord.y + correctionW2 * v2.texcoord.y + correctionW3 * v3.texcoord.y) * normalizer;
+    }
+    if constexpr ((Varyings & VARYING_WORLD_POS) != 0) {
+        result.worldPos.x = (correctionW1 * v1.worldPos.x + correctionW2 * v2.worldPos.x + correctionW3 * v3.worldPos.x) * normalizer;
+        result.worldPos.y = (correctionW1 * v1.worldPos.y + correctionW2 * v2.worldPos.y + correctionW3 * v3.worldPos.y) * normalizer;
+        result.worldPos.z = (correctionW1 * v1.worldPos.z + correctionW2 * v2.worldPos.z + correctionW3 * v3.worldPos.z) * normalizer;
+    }
+
+    return result;
+}
+
+// 模板版本的三角形绘制，流程与RasterizeTriangle相同
+template <typename ShaderT, typename State>
+void Renderer::RasterizeTriangleT(const VertexOutput& vs_out1, const VertexOutput& vs_out2, const VertexOutput& vs_out3, ShaderT& shader)
+{
+    XYH_PROFILE_SAMPLED_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, Clipping);
+    
+    PipelineStatistics* statistics = PipelineCounters::IsEnabled() ? &PipelineCounters::Local() : nullptr;
+    if (statistics) {
+        statistics->trianglesSubmitted++;
+    }
+    uint32_t* debugCounts = m_debugView != DebugView::NONE ? m_debugCounts.data() : nullptr;
+    
+    // 背面剔除
+    if constexpr (State::cullMode != CullMode::CULL_NONE) {
+        Vector3f edge1 = Vector3f(vs_out2.worldPos - vs_out1.worldPos);
+        Vector3f edge2 = Vector3f(vs_out3.worldPos - vs_out1.worldPos);
+        Vector3f normal = Vector3f::cross(edge1, edge2).normalize();
+        Vector3f triangleCenter = (vs_out1.worldPos + vs_out2.worldPos + vs_out3.worldPos) / 3.0f;
+        float dotProduct = Vector3f::dot(normal, m_viewPosition - triangleCenter);
+
+        bool isFrontFacing = (m_frontFace == FrontFace::COUNTER_CLOCKWISE) ? (dotProduct > EPSILON) : (dotProduct < -EPSILON);
+        bool culled;
+        if constexpr (State::cullMode == CullMode::CULL_BACK) {
+            culled = !isFrontFacing;
+        } else {
+            culled = isFrontFacing;
+        }
+        if (culled) {
+            if (statistics) {
+                statistics->trianglesBackfaceCulled++;
+            }
+            return;
+        }
+    }
+
+    // 裁剪（只插值着色器使用的属性）
+    ClipPolygon polygon;
+    if (!ClipTriangle(vs_out1, vs_out2, vs_out3, ShaderT::kVaryings, polygon)) {
+        if (statistics) {
+            statistics->trianglesClipRejected++;
+        }
+        return;
+    }
+
+    for (int i = 1; i + 1 < polygon.count; i++) {
+        XYH_PROFILE_STAGE(stages, Setup);
+        
+        // 保存原始W值用于透视校正插值
+        float w1 = polygon.vertices[0].position.w;
+        float w2 = polygon.vertices[i].position.w;
+        float w3 = polygon.vertices[i + 1].position.w;
+
+        // 透视除法和视口变换
+        VertexOutput screenVs_out1 = polygon.vertices[0];
+        VertexOutput screenVs_out2 = polygon.vertices[i];
+        VertexOutput screenVs_out3 = polygon.vertices[i + 1];
+        ProcessVertexOutput(screenVs_out1);
+        ProcessVertexOutput(screenVs_out2);
+        ProcessVertexOutput(screenVs_out3);
+        screenVs_out1.position.w = w1;
+        screenVs_out2.position.w = w2;
+        screenVs_out3.position.w = w3;
+
+        int minX = (std::max)(0, (int)std::floor((std::min)({screenVs_out1.position.x, screenVs_out2.position.x, screenVs_out3.position.x})));
+        int maxX = (std::min)(m_width - 1, (int)std::ceil((std::max)({screenVs_out1.position.x, screenVs_out2.position.x, screenVs_out3.position.x})));
+        int minY = (std::max)(0, (int)std::floor((std::min)({screenVs_out1.position.y, screenVs_out2.position.y, screenVs_out3.position.y})));
+        int maxY = (std::min)(m_height - 1, (int)std::ceil((std::max)({screenVs_out1.position.y, screenVs_out2.position.y, screenVs_out3.position.y})));
+
+        Vector2f v1Pos(screenVs_out1.position.x, screenVs_out1.position.y);
+        Vector2f v2Pos(screenVs_out2.position.x, screenVs_out2.position.y);
+        Vector2f v3Pos(screenVs_out3.position.x, screenVs_out3.position.y);
+
+        // 三角形面积每个三角形只计算一次
+        const float area = (v3Pos.x - v1Pos.x) * (v2Pos.y - v1Pos.y) - (v3Pos.y - v1Pos.y) * (v2Pos.x - v1Pos.x);
+        if (std::abs(area) < 0.00001f) {
+            if (statistics) {
+                statistics->trianglesZeroArea++;
+            }
+            continue;
+        }
+        const float invArea = 1.0f / area;
+        if (statistics) {
+            statistics->trianglesRasterized++;
+            statistics->pixelsTested += CountBoundingQuadPixels(minX, maxX, minY, maxY);
+        }
+
+        // 以2x2像素块为单位光栅化，流程与RasterizeTriangle相同
+        XYH_PROFILE_STAGE(stages, Raster);
+        for (int quadY = minY & ~1; quadY <= maxY; quadY += 2) {
+            for (int quadX = minX & ~1; quadX <= maxX; quadX += 2) {
+                FragmentQuad quad;
+                quad.coverageMask = 0;
+                std::array<float, FragmentQuad::kLanes> alpha, beta, gamma;
+
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    int x = quadX + (lane & 1);
+                    int y = quadY + (lane >> 1);
+                    float pixelX = x + 0.5f;
+                    float pixelY = y + 0.5f;
+
+                    // 重心坐标（与PointInTriangle相同）
+                    alpha[lane] = ((pixelX - v2Pos.x) * (v3Pos.y - v2Pos.y) - (pixelY - v2Pos.y) * (v3Pos.x - v2Pos.x)) * invArea;
+                    beta[lane] = ((pixelX - v3Pos.x) * (v1Pos.y - v3Pos.y) - (pixelY - v3Pos.y) * (v1Pos.x - v3Pos.x)) * invArea;
+                    gamma[lane] = 1.0f - alpha[lane] - beta[lane];
+
+                    if (alpha[lane] >= 0.0f && beta[lane] >= 0.0f && gamma[lane] >= 0.0f &&
+                        x >= minX && x <= maxX && y >= minY && y <= maxY) {
+                        quad.coverageMask |= 1 << lane;
+                    }
+                }
+                if (quad.coverageMask == 0) {
+                    continue;
+                }
+                int coveredCount = statistics ? quad.CoveredCount() : 0;
+
+                // 辅助像素也插值，用于求导
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    quad.lanes[lane] = InterpolateVaryings<ShaderT::kVaryings>(screenVs_out1, screenVs_out2, screenVs_out3, alpha[lane], beta[lane], gamma[lane]);
+                }
+
+                if constexpr (State::depthTest) {
+                    if (debugCounts && m_debugView == DebugView::DEPTH_COMPLEXITY) {
+                        AddDebugCounts(debugCounts, quad.coverageMask, quadX, quadY, 1);
+                    }
+                    for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                        if (quad.IsCovered(lane) &&
+                            quad.lanes[lane].position.z > m_currentFrameBuffer->depthBuffer.GetDepth(quadX + (lane & 1), quadY + (lane >> 1))) {
+                            quad.coverageMask &= ~(1 << lane);
+                        }
+                    }
+                }
+                if (statistics) {
+                    int passedCount = quad.CoveredCount();
+                    statistics->pixelsCovered += coveredCount;
+                    if constexpr (State::depthTest) {
+                        statistics->depthTestsPassed += passedCount;
+                        statistics->depthTestsFailed += coveredCount - passedCount;
+                    }
+                    statistics->fragmentsShaded += passedCount;
+                }
+                if constexpr (State::depthTest) {
+                    if (quad.coverageMask == 0) {
+                        continue;
+                    }
+                }
+
+                // 纹理坐标导数每个quad计算一次
+                float duvdx = 0.0f, duvdy = 0.0f;
+                if constexpr ((ShaderT::kVaryings & VARYING_TEXCOORD) != 0) {
+                    duvdx = quad.TexcoordDdxLength();
+                    duvdy = quad.TexcoordDdyLength();
+                }
+                XYH_PROFILE_STAGE(stages, Fragment);
+                Color pixelColors[FragmentQuad::kLanes];
+                bool measureShader = debugCounts && m_debugView == DebugView::SHADER_COST;
+                uint64_t shaderStart = measureShader ? Profiler::ReadCycleCounter() : 0;
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    // 直接调用ShaderT的片元着色器（不经过虚函数表，因此不会调用FragmentShaderQuad）
+                    if (quad.IsCovered(lane)) {
+                        pixelColors[lane] = shader.ShaderT::FragmentShader(quad.lanes[lane], duvdx, duvdy);
+                    }
+                }
+                // 与虚函数流程相同：整个quad计时一次，平均到覆盖的像素上
+                if (measureShader) {
+                    uint64_t cycles = (Profiler::ReadCycleCounter() - shaderStart) / quad.CoveredCount();
+                    AddDebugCounts(debugCounts, quad.coverageMask, quadX, quadY, static_cast<uint32_t>(cycles));
+                } else if (debugCounts && m_debugView == DebugView::OVERDRAW) {
+                    AddDebugCounts(debugCounts, quad.coverageMask, quadX, quadY, 1);
+                }
+
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    if (!quad.IsCovered(lane)) {
+                        continue;
+                    }
+                    int x = quadX + (lane & 1);
+                    int y = quadY + (lane >> 1);
+                    Color pixelColor = pixelColors[lane];
+
+                    if constexpr (State::alphaBlend) {
+                        Color dstColor = m_currentFrameBuffer->colorBuffer.GetPixelColor(x, y);
+                        float srcAlpha = pixelColor.a;
+                        pixelColor = pixelColor * srcAlpha + dstColor * (1.0f - srcAlpha);
+                    }
+
+                    m_currentFrameBuffer->colorBuffer.SetPixel(x, y, pixelColor);
+                    if constexpr (State::depthTest) {
+                        m_currentFrameBuffer->depthBuffer.SetDepth(x, y, quad.lanes[lane].position.z);
+                    }
+                }
+                XYH_PROFILE_STAGE(stages, Raster);
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "Object.h"
+#include "Frustum.h"
+
+// 射线检测结果
+struct RaycastHit {
+    size_t objectId;        // 命中的对象
+    size_t triangleIndex;   // 命中的三角形（网格indices中的下标）
+    float distance;         // 沿射线方向的距离（方向已归一化）
+    Vector3f point;         // 世界空间命中点
+
+    RaycastHit() : objectId(0), triangleIndex(0), distance(0.0f), point(Vector3f::zero) {}
+};
+
+// 场景：持有对象，并在对象的世界空间包围盒上维护一棵BVH（包围体层次）
+// 用于视锥体剔除遍历（Renderer::DrawScene）以及射线/包围盒查询（拾取）
+// 对象移动后调用SetTransform或MarkTransformChanged，Update时只重新计算变化对象所在叶子到根的路径（refit）
+// 对象可以有父对象：子对象的模型矩阵 = 父对象的模型矩阵 * 子对象的局部矩阵，世界矩阵缓存在对象上，
+// 每帧UpdateTransforms（Update会调用）只更新变换改变的对象所在的子树
+class Scene {
+public:
+    static const size_t kInvalidId = static_cast<size_t>(-1);
+
+    Scene();
+
+    // 添加对象，返回对象ID（删除其他对象后ID保持不变）
+    size_t AddObject(const Object& object);
+    size_t AddObject(Object&& object);
+
+    // 删除对象（下次Update时重建BVH）
+    void RemoveObject(size_t id);
+
+    // 删除全部对象
+    void Clear();
+
+    // 获取对象（ID无效时返回nullptr）；修改对象的变换后需要调用MarkTransformChanged
+    Object* GetObjectById(size_t id);
+    const Object* GetObjectById(size_t id) const;
+
+    // 对象数量和ID的上界（遍历时ID < GetObjectCapacity()，需要用GetObjectById检查是否有效）
+    size_t GetObjectCount() const { return m_objectCount; }
+    size_t GetObjectCapacity() const { return m_entries.size(); }
+
+    // 设置对象的变换
+    void SetTransform(size_t id, const Transformer& transform);
+
+    // 标记对象的变换（或网格顶点）已被直接修改，子对象随之更新
+    void MarkTransformChanged(size_t id);
+
+    // 设置父对象（parent为kInvalidId时解除），parent在id的子树中（形成环）或ID无效时返回false
+    // 删除对象时它的子对象成为没有父对象的对象
+    bool SetParent(size_t id, size_t parent);
+    size_t GetParent(size_t id) const;
+    const std::vector<size_t>& GetChildren(size_t id) const;
+
+    // 更新世界矩阵：从变换改变的最上层对象开始更新整个子树，子树很多时多线程更新
+    void UpdateTransforms();
+
+    // 上一次UpdateTransforms更新的对象数
+    size_t GetUpdatedTransformCount() const { return m_updatedTransforms.size(); }
+
+    // 更新世界矩阵和BVH：对象增删后重建，只有变换变化时refit
+    void Update();
+
+    // 强制重建BVH
+    void Rebuild();
+
+    // 查询与视锥体相交的对象（会先调用Update）
+    void QueryFrustum(const Frustum& frustum, std::vector<size_t>& result);
+
+    // 查询世界包围盒与给定包围盒相交的对象
+    void QueryBox(const Vector3f& min, const Vector3f& max, std::vector<size_t>& result);
+
+    // 射线与场景中三角形的最近交点（direction不需要归一化），maxDistance之外的交点忽略
+    bool Raycast(const Vector3f& origin, const Vector3f& direction, RaycastHit& hit, float maxDistance = 1e30f);
+
+    // 对象的世界空间包围盒
+    void GetWorldBounds(size_t id, Vector3f& min, Vector3f& max) const;
+
+    // BVH统计
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    int GetRebuildCount() const { return m_rebuildCount; }
+    int GetRefitCount() const { return m_refitCount; }
+
+private:
+    struct Entry {
+        std::unique_ptr<Object> object;     // 对象（unique_ptr保证对象地址在添加其他对象后不变）
+        Vector3f worldMin;                  // 世界空间包围盒
+        Vector3f worldMax;
+        int leaf;                           // 所在叶子节点，-1表示不在BVH中
+        bool dirty;                         // 变换已改变，等待refit
+        size_t parent;                      // 父对象，kInvalidId表示没有
+        std::vector<size_t> children;       // 子对象
+        bool transformDirty;                // 变换已改变，等待更新世界矩阵
+    };
+
+    // BVH节点：叶子节点的对象为m_leafObjects[first, first + count)，内部节点的子节点为left和left + 1
+    struct Node {
+        Vector3f min;
+        Vector3f max;
+        int parent;
+        int left;
+        int first;
+        int count;
+
+        bool IsLeaf() const { return count > 0; }
+    };
+
+    // 叶子节点最多包含的对象数
+    static const int kMaxLeafObjects = 4;
+
+    // 需要更新的子树至少有这么多时才多线程更新世界矩阵
+    static const size_t kParallelTransformSubtrees = 1024;
+
+    // 由父对象的模型矩阵更新对象的世界矩阵
+    void UpdateWorldMatrix(Entry& entry);
+
+    // 更新roots中每个对象及其整个子树的世界矩阵，更新的对象追加到updated
+    void UpdateSubtrees(const size_t* roots, size_t count, std::vector<size_t>& updated);
+
+    // 计算对象的世界空间包围盒
+    void UpdateWorldBounds(Entry& entry);
+
+    // 递归构建[first, first + count)范围内对象的子树
+    void BuildNode(int nodeIndex, int first, int count);
+
+    // 由子节点或叶子中的对象重新计算节点包围盒
+    void RecomputeNodeBounds(int nodeIndex);
+
+    // 对变换改变的对象进行refit
+    void Refit();
+
+    std::vector<Entry> m_entries;
+    std::vector<size_t> m_freeIds;          // 已删除对象的ID，添加对象时复用
+    size_t m_objectCount;
+
+    std::vector<Node> m_nodes;
+    std::vector<size_t> m_leafObjects;      // 按叶子顺序排列的对象ID
+    std::vector<size_t> m_dirtyObjects;     // 等待refit的对象
+    std::vector<size_t> m_dirtyTransforms;  // 等待更新世界矩阵的对象
+    std::vector<size_t> m_transformRoots;   // 更新世界矩阵的子树（复用容量）
+    std::vector<size_t> m_nextTransformRoots;
+    std::vector<size_t> m_updatedTransforms;    // 上一次更新了世界矩阵的对象
+    std::vector<int> m_traversalStack;      // 遍历时复用的栈
+    bool m_needsRebuild;
+    float m_builtRootArea;                  // 构建时根节点的表面积，refit使其超过2倍时重建
+
+    int m_rebuildCount;
+    int m_refitCount;
+};
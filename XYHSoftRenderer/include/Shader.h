@@ -6,6 +6,7 @@
 #include "Object.h"
 #include "MyMath.h"
 #include "Texture.h"
+#include "PackedMesh.h"
 
 // 顶点着色器输入
 struct VertexShaderInput
@@ -17,6 +18,8 @@ struct VertexShaderInput
     Matrix modelMatrix;   // 模型矩阵(M)（局部坐标系到世界坐标系）
     Matrix viewMatrix;    // 视图矩阵(V)（世界坐标系到相机坐标系）
     Matrix projMatrix;    // 投影矩阵(P)（相机坐标系到裁剪坐标系）
+    Vector4f instanceColor = Vector4f(1.0f, 1.0f, 1.0f, 1.0f);   // 实例颜色（与顶点颜色相乘）
+    Vector4f instanceParams = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);  // 实例参数（含义由着色器决定）
 };
 
 // 顶点着色器输出/片元着色器输入
@@ -29,6 +32,143 @@ struct VertexOutput
     Vector3f worldPos;    // 世界空间位置
 };
 
+// 插值属性（片元着色器使用的顶点着色器输出）
+enum Varying
+{
+    VARYING_COLOR = 1 << 0,       // 颜色
+    VARYING_NORMAL = 1 << 1,      // 法线
+    VARYING_TEXCOORD = 1 << 2,    // 纹理坐标
+    VARYING_WORLD_POS = 1 << 3,   // 世界空间位置
+    VARYING_ALL = VARYING_COLOR | VARYING_NORMAL | VARYING_TEXCOORD | VARYING_WORLD_POS
+};
+
+// 2x2像素块（quad）的片元着色器输入，与GPU一样按quad着色以得到屏幕空间导数
+// 像素顺序：0(x,y) 1(x+1,y) 2(x,y+1) 3(x+1,y+1)
+struct FragmentQuad
+{
+    static const int kLanes = 4;
+
+    VertexOutput lanes[kLanes];   // 插值结果（辅助像素也会插值，只用于求导）
+    int coverageMask;             // 需要着色的像素（覆盖且通过深度测试），其余为辅助像素
+
+    bool IsCovered(int lane) const { return (coverageMask & (1 << lane)) != 0; }
+    int CoveredCount() const { return (coverageMask & 1) + ((coverageMask >> 1) & 1) + ((coverageMask >> 2) & 1) + ((coverageMask >> 3) & 1); }
+
+    // 任意插值属性对屏幕x/y的导数（同一行/列相邻像素之差）
+    VertexOutput Ddx(int lane) const { return Difference(lanes[(lane & 2) | 1], lanes[lane & 2]); }
+    VertexOutput Ddy(int lane) const { return Difference(lanes[(lane & 1) | 2], lanes[lane & 1]); }
+
+    // 纹理坐标导数的长度（整个quad共用，用于选择MipMap级别）
+    float TexcoordDdxLength() const { return (lanes[1].texcoord - lanes[0].texcoord).magnitude(); }
+    float TexcoordDdyLength() const { return (lanes[2].texcoord - lanes[0].texcoord).magnitude(); }
+
+    static VertexOutput Difference(const VertexOutput& a, const VertexOutput& b)
+    {
+        VertexOutput result;
+        result.position = a.position - b.position;
+        result.color = a.color - b.color;
+        result.normal = a.normal - b.normal;
+        result.texcoord = a.texcoord - b.texcoord;
+        result.worldPos = a.worldPos - b.worldPos;
+        return result;
+    }
+};
+
+// 批量顶点着色器输出（SoA布局，与VertexBatch一一对应）
+struct VertexOutputBatch
+{
+    alignas(32) float positionX[VertexBatch::kSize];   // 裁剪空间位置
+    alignas(32) float positionY[VertexBatch::kSize];
+    alignas(32) float positionZ[VertexBatch::kSize];
+    alignas(32) float positionW[VertexBatch::kSize];
+    alignas(32) float worldX[VertexBatch::kSize];      // 世界空间位置
+    alignas(32) float worldY[VertexBatch::kSize];
+    alignas(32) float worldZ[VertexBatch::kSize];
+    alignas(32) float normalX[VertexBatch::kSize];     // 世界空间法线
+    alignas(32) float normalY[VertexBatch::kSize];
+    alignas(32) float normalZ[VertexBatch::kSize];
+    alignas(32) float texcoordU[VertexBatch::kSize];
+    alignas(32) float texcoordV[VertexBatch::kSize];
+    alignas(32) float colorR[VertexBatch::kSize];
+    alignas(32) float colorG[VertexBatch::kSize];
+    alignas(32) float colorB[VertexBatch::kSize];
+    alignas(32) float colorA[VertexBatch::kSize];
+    int count;  // 有效顶点数
+
+    // 取出第i个顶点的输出
+    VertexOutput GetOutput(int i) const
+    {
+        VertexOutput output;
+        output.position = Vector4f(positionX[i], positionY[i], positionZ[i], positionW[i]);
+        output.color = Vector4f(colorR[i], colorG[i], colorB[i], colorA[i]);
+        output.normal = Vector3f(normalX[i], normalY[i], normalZ[i]);
+        output.texcoord = Vector2f(texcoordU[i], texcoordV[i]);
+        output.worldPos = Vector3f(worldX[i], worldY[i], worldZ[i]);
+        return output;
+    }
+
+    // 写入第i个顶点的输出（用于逐顶点调用VertexShader的默认实现）
+    void SetOutput(int i, const VertexOutput& output)
+    {
+        positionX[i] = output.position.x;
+        positionY[i] = output.position.y;
+        positionZ[i] = output.position.z;
+        positionW[i] = output.position.w;
+        worldX[i] = output.worldPos.x;
+        worldY[i] = output.worldPos.y;
+        worldZ[i] = output.worldPos.z;
+        normalX[i] = output.normal.x;
+        normalY[i] = output.normal.y;
+        normalZ[i] = output.normal.z;
+        texcoordU[i] = output.texcoord.x;
+        texcoordV[i] = output.texcoord.y;
+        colorR[i] = output.color.x;
+        colorG[i] = output.color.y;
+        colorB[i] = output.color.z;
+        colorA[i] = output.color.w;
+    }
+};
+
+// 批量顶点着色器的参数（每次绘制只计算一次，不必逐顶点计算MVP和法线矩阵）
+struct VertexUniforms
+{
+    Matrix modelMatrix;   // 模型矩阵(M)
+    Matrix viewMatrix;    // 视图矩阵(V)
+    Matrix projMatrix;    // 投影矩阵(P)
+    Matrix mvpMatrix;     // P * V * M
+    Matrix normalMatrix;  // 模型矩阵的逆转置
+    Vector4f instanceColor;   // 实例颜色（默认白色）
+    Vector4f instanceParams;  // 实例参数（默认为0）
+
+    VertexUniforms() : instanceColor(1.0f, 1.0f, 1.0f, 1.0f), instanceParams(0.0f, 0.0f, 0.0f, 0.0f) {}
+    VertexUniforms(const Matrix& model, const Matrix& view, const Matrix& proj)
+        : modelMatrix(model), viewMatrix(view), projMatrix(proj),
+          mvpMatrix(proj * view * model),
+          normalMatrix(Affine3(model).normalMatrix().toMatrix()),
+          instanceColor(1.0f, 1.0f, 1.0f, 1.0f), instanceParams(0.0f, 0.0f, 0.0f, 0.0f) {}
+};
+
+// 实例化绘制的每个实例的数据（Renderer::DrawMeshInstanced）
+// 颜色和参数通过VertexUniforms/VertexShaderInput的instanceColor和instanceParams传给着色器
+struct InstanceData
+{
+    Matrix modelMatrix;   // 模型矩阵
+    Vector4f color;       // 实例颜色（内置着色器与顶点颜色相乘）
+    Vector4f params;      // 自定义参数
+
+    InstanceData() : color(1.0f, 1.0f, 1.0f, 1.0f), params(0.0f, 0.0f, 0.0f, 0.0f) {}
+    InstanceData(const Matrix& model, const Vector4f& color = Vector4f(1.0f, 1.0f, 1.0f, 1.0f),
+                 const Vector4f& params = Vector4f(0.0f, 0.0f, 0.0f, 0.0f))
+        : modelMatrix(model), color(color), params(params) {}
+};
+
+// 批量顶点变换（内置着色器共用的顶点程序）：
+// 裁剪空间位置 = MVP * 位置，世界坐标 = M * 位置，颜色乘以实例颜色，纹理坐标原样传递
+// transformNormal为true时法线 = normalize(法线矩阵 * 法线)，否则原样传递
+// 使用AVX2一次处理8个顶点，SSE2一次处理4个顶点
+void TransformVertexBatch(const VertexBatch& input, const VertexUniforms& uniforms, bool transformNormal,
+                          VertexOutputBatch& output);
+
 // 光照参数
 struct LightParams
 {
@@ -43,26 +183,80 @@ struct LightParams
 class Shader
 {
 public:
+    // 片元着色器使用的插值属性（Varying的组合），裁剪和插值只处理这些属性
+    // 模板绘制流程使用kVaryings，虚函数绘制流程使用GetVaryings()
+    static const int kVaryings = VARYING_ALL;
+
     Shader() {}
     virtual ~Shader() {}
 
     // 顶点着色器接口
     virtual VertexOutput VertexShader(const VertexShaderInput& input) = 0;
 
+    // 批量顶点着色器接口（一次处理一批顶点，位置的w分量视为1）
+    // 默认逐顶点调用VertexShader，内置着色器使用SIMD实现
+    virtual void VertexShaderBatch(const VertexBatch& input, const VertexUniforms& uniforms, VertexOutputBatch& output)
+    {
+        VertexShaderInput vertexInput;
+        vertexInput.modelMatrix = uniforms.modelMatrix;
+        vertexInput.viewMatrix = uniforms.viewMatrix;
+        vertexInput.projMatrix = uniforms.projMatrix;
+        vertexInput.instanceColor = uniforms.instanceColor;
+        vertexInput.instanceParams = uniforms.instanceParams;
+        for (int i = 0; i < input.count; i++) {
+            Vertex vertex = input.GetVertex(i);
+            vertexInput.position = vertex.pos;
+            vertexInput.color = vertex.color;
+            vertexInput.normal = vertex.normal;
+            vertexInput.texcoord = vertex.texcoord;
+            output.SetOutput(i, VertexShader(vertexInput));
+        }
+        output.count = input.count;
+    }
+
     // 片元着色器接口
     virtual Color FragmentShader(const VertexOutput& input, float dudx, float dvdy) = 0;
 
+    // 按quad着色的片元着色器接口，只需写入quad.coverageMask中的像素
+    // 默认每个quad计算一次纹理坐标导数，再逐像素调用FragmentShader；需要其他属性导数时可以重写并使用quad.Ddx/Ddy
+    virtual void FragmentShaderQuad(const FragmentQuad& quad, Color output[FragmentQuad::kLanes])
+    {
+        float duvdx = quad.TexcoordDdxLength();
+        float duvdy = quad.TexcoordDdyLength();
+        for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+            if (quad.IsCovered(lane)) {
+                output[lane] = FragmentShader(quad.lanes[lane], duvdx, duvdy);
+            }
+        }
+    }
+
     // 设置光照参数
     void SetLight(const LightParams& light) { m_light = light; }
 
+    // 设置材质（绘制每个子网格前调用一次），派生类在OnMaterialChanged中使用材质
+    void SetMaterial(const Material& material) { m_material = material; OnMaterialChanged(material); }
+
+    // 当前材质（绘制后用于恢复调用者设置的材质）
+    const Material& GetMaterial() const { return m_material; }
+
+    // 片元着色器使用的插值属性（派生类声明了kVaryings时需要同时重写）
+    virtual int GetVaryings() const { return kVaryings; }
+
 protected:
+    // 材质改变时调用（默认忽略材质）
+    virtual void OnMaterialChanged(const Material& material) {}
+
     LightParams m_light;
+    Material m_material;
 };
 
 // 简单颜色着色器
 class ColorShader : public Shader
 {
 public:
+    static const int kVaryings = VARYING_COLOR;
+    virtual int GetVaryings() const override { return kVaryings; }
+
     ColorShader() {}
 
     virtual VertexOutput VertexShader(const VertexShaderInput& input) override
@@ -78,17 +272,23 @@ public:
         output.worldPos = Vector3f(worldPos.x, worldPos.y, worldPos.z);
         
         // 计算世界空间法线
-        Matrix normalMatrix = input.modelMatrix.transpose().inverse();
+        Matrix normalMatrix = input.modelMatrix.normalMatrix();
         Vector4f worldNormal = normalMatrix * Vector4f(input.normal, 0.0f);
         output.normal = Vector3f(worldNormal.x, worldNormal.y, worldNormal.z).normalize();
         
         // 传递颜色和纹理坐标
         output.color = input.color;
+        output.color *= input.instanceColor;
         output.texcoord = input.texcoord;
         
         return output;
     }
 
+    virtual void VertexShaderBatch(const VertexBatch& input, const VertexUniforms& uniforms, VertexOutputBatch& output) override
+    {
+        TransformVertexBatch(input, uniforms, true, output);
+    }
+
     virtual Color FragmentShader(const VertexOutput& input, float dudx, float dvdy) override
     {
         // 直接使用顶点颜色
@@ -100,6 +300,9 @@ public:
 class PhongShader : public Shader
 {
 public:
+    static const int kVaryings = VARYING_COLOR | VARYING_NORMAL | VARYING_WORLD_POS;
+    virtual int GetVaryings() const override { return kVaryings; }
+
     PhongShader() 
         : m_shininess(32.0f), 
           m_viewPosition(Vector3f(0.0f, 0.0f, 10.0f)) 
@@ -125,17 +328,23 @@ public:
         output.worldPos = Vector3f(worldPos.x, worldPos.y, worldPos.z);
         
         // 计算世界空间法线
-        Matrix normalMatrix = input.modelMatrix.transpose().inverse();
+        Matrix normalMatrix = input.modelMatrix.normalMatrix();
         Vector4f worldNormal = normalMatrix * Vector4f(input.normal, 0.0f);
         output.normal = Vector3f(worldNormal.x, worldNormal.y, worldNormal.z).normalize();
         
         // 传递颜色和纹理坐标
         output.color = input.color;
+        output.color *= input.instanceColor;
         output.texcoord = input.texcoord;
         
         return output;
     }
 
+    virtual void VertexShaderBatch(const VertexBatch& input, const VertexUniforms& uniforms, VertexOutputBatch& output) override
+    {
+        TransformVertexBatch(input, uniforms, true, output);
+    }
+
     virtual Color FragmentShader(const VertexOutput& input, float dudx, float dvdy) override
     {
         // 基础颜色
@@ -186,6 +395,9 @@ private:
 class BlinnPhongShader : public Shader
 {
 public:
+    static const int kVaryings = VARYING_COLOR | VARYING_NORMAL | VARYING_WORLD_POS;
+    virtual int GetVaryings() const override { return kVaryings; }
+
     BlinnPhongShader() 
         : m_shininess(32.0f), 
           m_viewPosition(Vector3f(0.0f, 0.0f, 10.0f)) 
@@ -211,17 +423,23 @@ public:
         output.worldPos = Vector3f(worldPos.x, worldPos.y, worldPos.z);
         
         // 计算世界空间法线
-        Matrix normalMatrix = input.modelMatrix.transpose().inverse();
+        Matrix normalMatrix = input.modelMatrix.normalMatrix();
         Vector4f worldNormal = normalMatrix * Vector4f(input.normal, 0.0f);
         output.normal = Vector3f(worldNormal.x, worldNormal.y, worldNormal.z).normalize();
         
         // 传递颜色和纹理坐标
         output.color = input.color;
+        output.color *= input.instanceColor;
         output.texcoord = input.texcoord;
         
         return output;
     }
 
+    virtual void VertexShaderBatch(const VertexBatch& input, const VertexUniforms& uniforms, VertexOutputBatch& output) override
+    {
+        TransformVertexBatch(input, uniforms, true, output);
+    }
+
     virtual Color FragmentShader(const VertexOutput& input, float dudx, float dvdy) override
     {
         // 基础颜色
@@ -272,11 +490,16 @@ private:
 class TextureShader : public Shader
 {
 public:
+    static const int kVaryings = VARYING_TEXCOORD;
+    virtual int GetVaryings() const override { return kVaryings; }
     
-    TextureShader() : m_texture(nullptr) {}
+    TextureShader() : m_texture(nullptr), m_materialTexture(nullptr) {}
     // 设置纹理
     void SetTexture(Texture* texture) { m_texture = texture; }
 
+    // 材质改变时调用（材质有漫反射贴图时代替SetTexture设置的纹理）
+    virtual void OnMaterialChanged(const Material& material) override { m_materialTexture = material.diffuseMap; }
+
     virtual VertexOutput VertexShader(const VertexShaderInput& input) override
     {
         VertexOutput output;
@@ -287,6 +510,7 @@ public:
         
         // 传递其他属性
         output.color = input.color;
+        output.color *= input.instanceColor;
         output.texcoord = input.texcoord;
         output.normal = input.normal;
         
@@ -297,10 +521,16 @@ public:
         return output;
     }
 
+    virtual void VertexShaderBatch(const VertexBatch& input, const VertexUniforms& uniforms, VertexOutputBatch& output) override
+    {
+        TransformVertexBatch(input, uniforms, false, output);
+    }
+
     virtual Color FragmentShader(const VertexOutput& input, float dudx, float dvdy) override
     {
         // 采样纹理
-        Color texColor = m_texture->Sample(input.texcoord.x, input.texcoord.y, dudx, dvdy);
+        Texture* texture = m_materialTexture ? m_materialTexture : m_texture;
+        Color texColor = texture->Sample(input.texcoord.x, input.texcoord.y, dudx, dvdy);
         
         // 直接返回纹理颜色，不与顶点颜色混合
         return texColor;
@@ -308,14 +538,20 @@ public:
 
 private:
     Texture* m_texture;
+    Texture* m_materialTexture;   // 当前材质的漫反射贴图
 };
 
 // 纹理 + Blinn-Phong 光照着色器
 class TexturedBlinnPhongShader : public Shader
 {
 public:
+    // 无纹理时使用顶点颜色，需要全部插值属性
+    static const int kVaryings = VARYING_ALL;
+    virtual int GetVaryings() const override { return kVaryings; }
+
     TexturedBlinnPhongShader() 
         : m_texture(nullptr),
+          m_materialTexture(nullptr),
           m_shininess(32.0f), 
           m_viewPosition(Vector3f(0.0f, 0.0f, 10.0f)) 
     {
@@ -340,24 +576,31 @@ public:
         output.worldPos = Vector3f(worldPos.x, worldPos.y, worldPos.z);
         
         // 计算世界空间法线
-        Matrix normalMatrix = input.modelMatrix.transpose().inverse();
+        Matrix normalMatrix = input.modelMatrix.normalMatrix();
         Vector4f worldNormal = normalMatrix * Vector4f(input.normal, 0.0f);
         output.normal = Vector3f(worldNormal.x, worldNormal.y, worldNormal.z).normalize();
         
         // 传递颜色和纹理坐标
         output.color = input.color;
+        output.color *= input.instanceColor;
         output.texcoord = input.texcoord;
         
         return output;
     }
 
+    virtual void VertexShaderBatch(const VertexBatch& input, const VertexUniforms& uniforms, VertexOutputBatch& output) override
+    {
+        TransformVertexBatch(input, uniforms, true, output);
+    }
+
     virtual Color FragmentShader(const VertexOutput& input, float dudx, float dvdy) override
     {
         // 基础颜色 - 从纹理采样或使用顶点颜色
         Color baseColor;
-        if (m_texture) {
+        Texture* texture = m_materialTexture ? m_materialTexture : m_texture;
+        if (texture) {
             // 采样纹理
-            Color texColor = m_texture->Sample(input.texcoord.x, input.texcoord.y, dudx, dvdy);
+            Color texColor = texture->Sample(input.texcoord.x, input.texcoord.y, dudx, dvdy);
             // 纹理颜色与顶点颜色混合
             // Color vertexColor(input.color.x, input.color.y, input.color.z, input.color.w);
             // baseColor = texColor * vertexColor;
@@ -399,6 +642,9 @@ public:
     // 设置纹理
     void SetTexture(Texture* texture) { m_texture = texture; }
     
+    // 材质改变时调用（材质有漫反射贴图时代替SetTexture设置的纹理）
+    virtual void OnMaterialChanged(const Material& material) override { m_materialTexture = material.diffuseMap; }
+    
     // 设置观察点位置
     void SetViewPosition(const Vector3f& position) { m_viewPosition = position; }
     
@@ -410,6 +656,7 @@ public:
 
 private:
     Texture* m_texture;       // 纹理
+    Texture* m_materialTexture; // 当前材质的漫反射贴图
     float m_shininess;        // 高光指数
     Vector3f m_viewPosition;  // 观察点位置
     LightParams m_light;      // 光照参数
@@ -0,0 +1,21 @@
+#pragma once
+
+// SIMD指令集选择（编译期检测，AVX2需要开启 /arch:AVX2：工程的Release|x64配置已开启，其余配置使用SSE2）
+// XYH_SIMD_AVX2：8路浮点（__m256）
+// XYH_SIMD_SSE2：4路浮点（__m128），x64下总是可用
+// XYH_SIMD_F16C：半精度浮点转换指令（MSVC开启AVX2时可用）
+#if defined(__AVX2__)
+#define XYH_SIMD_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XYH_SIMD_SSE2 1
+#endif
+
+#if defined(XYH_SIMD_AVX2) && (defined(_MSC_VER) || defined(__F16C__))
+#define XYH_SIMD_F16C 1
+#endif
+
+#if defined(XYH_SIMD_AVX2) || defined(XYH_SIMD_SSE2)
+#include <immintrin.h>
+#endif
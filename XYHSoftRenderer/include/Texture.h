@@ -34,6 +34,8 @@ public:
     Texture(int width, int height);
     Texture(const Texture& other); // 拷贝构造函数
     Texture& operator=(const Texture& other); // 赋值运算符
+    Texture(Texture&& other) noexcept; // 移动构造函数（转移像素数据，不复制）
+    Texture& operator=(Texture&& other) noexcept; // 移动赋值运算符
     ~Texture();
 
     // 创建空白纹理
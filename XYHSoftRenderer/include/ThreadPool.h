@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// 常驻工作线程池（单例类）：每帧的并行计算（场景变换更新等）交给同一组线程执行，不再每帧创建和销毁线程
+// 与AssetManager的加载线程分开，长时间的加载任务不会阻塞每帧的计算
+class ThreadPool {
+private:
+    static ThreadPool* s_instance;  // 单例实例
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_runMutex;                  // 同一时间只执行一个ParallelFor
+    std::mutex m_mutex;                     // 保护以下的任务状态
+    std::condition_variable m_workCondition;    // 有新任务或停止
+    std::condition_variable m_doneCondition;    // 当前任务的所有下标已执行完
+    const std::function<void(size_t)>* m_task;  // 当前任务（没有任务时为空）
+    size_t m_taskCount;                     // 下标总数
+    size_t m_nextIndex;                     // 下一个未领取的下标
+    size_t m_remaining;                     // 尚未执行完的下标数
+    bool m_stopping;
+
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    void WorkerLoop();
+
+    // 领取并执行下标直到没有剩余（lock已持有m_mutex）
+    void RunTasks(std::unique_lock<std::mutex>& lock);
+
+public:
+    // 获取单例实例（工作线程数为硬件线程数-1，调用线程也参与计算）
+    static ThreadPool* GetInstance();
+    static void DeleteInstance();
+
+    // 对[0, count)的每个下标执行task，调用线程也领取下标，全部完成后返回
+    // task中不能再调用ParallelFor；下标的执行顺序和所在线程不确定
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    // 工作线程数量（不含调用线程）
+    int GetThreadCount() const { return static_cast<int>(m_workers.size()); }
+};
@@ -0,0 +1,323 @@
+#include "../include/AffineTransform.h"
+#include "../include/Simd.h"
+
+#if defined(XYH_SIMD_SSE2)
+namespace {
+    // 三维叉积（w分量为0）
+    inline __m128 Cross3(__m128 a, __m128 b)
+    {
+        const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    // 只保留xyz分量
+    inline __m128 MaskXYZ()
+    {
+        return _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    }
+
+    // 线性部分的行向量两两的叉积（伴随矩阵的转置的行），返回广播的行列式的倒数（不可逆时返回false）
+    inline bool LoadCofactors(const Affine3& affine, __m128& c0, __m128& c1, __m128& c2, __m128& invDet)
+    {
+        const __m128 mask = MaskXYZ();
+        const __m128 r0 = _mm_and_ps(_mm_load_ps(affine.m[0]), mask);
+        const __m128 r1 = _mm_and_ps(_mm_load_ps(affine.m[1]), mask);
+        const __m128 r2 = _mm_and_ps(_mm_load_ps(affine.m[2]), mask);
+        c0 = Cross3(r1, r2);
+        c1 = Cross3(r2, r0);
+        c2 = Cross3(r0, r1);
+
+        // 行列式 = r0·(r1×r2)，水平求和后广播到四个分量
+        __m128 det = _mm_mul_ps(r0, c0);
+        det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 3, 0, 1)));
+        det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 0, 3, 2)));
+        if (_mm_cvtss_f32(det) == 0.0f) {
+            return false;
+        }
+        invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+        return true;
+    }
+
+    // 由线性部分的三列和平移（w分量为0）转置得到结果的三行
+    inline Affine3 StoreColumns(__m128 c0, __m128 c1, __m128 c2, __m128 translation)
+    {
+        _MM_TRANSPOSE4_PS(c0, c1, c2, translation);
+        Affine3 result;
+        _mm_store_ps(result.m[0], c0);
+        _mm_store_ps(result.m[1], c1);
+        _mm_store_ps(result.m[2], c2);
+        return result;
+    }
+}
+#endif
+
+Affine3::Affine3()
+{
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            m[i][j] = (i == j) ? 1.0f : 0.0f;
+}
+
+Affine3::Affine3(const Matrix& matrix)
+{
+#if defined(XYH_SIMD_SSE2)
+    for (int i = 0; i < 3; i++)
+        _mm_store_ps(m[i], _mm_load_ps(matrix.m[i]));
+#else
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            m[i][j] = matrix.m[i][j];
+#endif
+}
+
+// 复合：结果第i行 = sum(a[i][k] * b的第k行)，b的最后一行为0 0 0 1，因此只需在平移上加a[i][3]
+Affine3 Affine3::operator*(const Affine3& affine) const
+{
+    Affine3 result;
+#if defined(XYH_SIMD_AVX2)
+    // 前两行装入一个__m256，第三行用SSE计算
+    const __m256 wMask = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1));
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(affine.m[0]));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(affine.m[1]));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(affine.m[2]));
+    const __m256 a = _mm256_loadu_ps(m[0]);
+    __m256 rows = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+    rows = _mm256_add_ps(rows, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1));
+    rows = _mm256_add_ps(rows, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), b2));
+    rows = _mm256_add_ps(rows, _mm256_and_ps(a, wMask));
+    _mm256_storeu_ps(result.m[0], rows);
+
+    const __m128 a2 = _mm_load_ps(m[2]);
+    __m128 row = _mm_mul_ps(_mm_shuffle_ps(a2, a2, 0x00), _mm256_castps256_ps128(b0));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a2, a2, 0x55), _mm256_castps256_ps128(b1)));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a2, a2, 0xAA), _mm256_castps256_ps128(b2)));
+    row = _mm_add_ps(row, _mm_and_ps(a2, _mm256_castps256_ps128(wMask)));
+    _mm_store_ps(result.m[2], row);
+#elif defined(XYH_SIMD_SSE2)
+    const __m128 wMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+    const __m128 b0 = _mm_load_ps(affine.m[0]);
+    const __m128 b1 = _mm_load_ps(affine.m[1]);
+    const __m128 b2 = _mm_load_ps(affine.m[2]);
+    for (int i = 0; i < 3; i++) {
+        const __m128 a = _mm_load_ps(m[i]);
+        __m128 row = _mm_mul_ps(_mm_shuffle_ps(a, a, 0x00), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, 0x55), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xAA), b2));
+        row = _mm_add_ps(row, _mm_and_ps(a, wMask));
+        _mm_store_ps(result.m[i], row);
+    }
+#else
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            result.m[i][j] = m[i][0] * affine.m[0][j] + m[i][1] * affine.m[1][j] + m[i][2] * affine.m[2][j];
+        }
+        result.m[i][3] += m[i][3];
+    }
+#endif
+    return result;
+}
+
+Vector4f Affine3::operator*(const Vector4f& vector) const
+{
+    const float x = vector.x, y = vector.y, z = vector.z, w = vector.w;
+    return Vector4f(
+        m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3] * w,
+        m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3] * w,
+        m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3] * w,
+        w
+    );
+}
+
+Affine3 Affine3::identity()
+{
+    return Affine3();
+}
+
+// 旋转矩阵的每一列乘以对应的缩放，最后一列为平移
+Affine3 Affine3::fromTRS(const Vector3f& translation, const Quaternion& rotation, const Vector3f& scale)
+{
+    Matrix rotationMatrix = rotation.toMatrix();
+    const float scales[3] = { scale.x, scale.y, scale.z };
+    Affine3 result;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            result.m[row][column] = rotationMatrix.m[row][column] * scales[column];
+        }
+    }
+    result.m[0][3] = translation.x;
+    result.m[1][3] = translation.y;
+    result.m[2][3] = translation.z;
+    return result;
+}
+
+Vector3f Affine3::transformPoint(const Vector3f& point) const
+{
+    return Vector3f(
+        m[0][0] * point.x + m[0][1] * point.y + m[0][2] * point.z + m[0][3],
+        m[1][0] * point.x + m[1][1] * point.y + m[1][2] * point.z + m[1][3],
+        m[2][0] * point.x + m[2][1] * point.y + m[2][2] * point.z + m[2][3]
+    );
+}
+
+Vector3f Affine3::transformVector(const Vector3f& vector) const
+{
+    return Vector3f(
+        m[0][0] * vector.x + m[0][1] * vector.y + m[0][2] * vector.z,
+        m[1][0] * vector.x + m[1][1] * vector.y + m[1][2] * vector.z,
+        m[2][0] * vector.x + m[2][1] * vector.y + m[2][2] * vector.z
+    );
+}
+
+// 线性部分的伴随矩阵的列是其行向量两两的叉积
+Affine3 Affine3::inverse() const
+{
+#if defined(XYH_SIMD_SSE2)
+    __m128 c0, c1, c2, invDet;
+    if (!LoadCofactors(*this, c0, c1, c2, invDet)) {
+        return identity();
+    }
+    // A^-1的列是叉积除以行列式，平移为各列按t的分量加权求和后取反
+    c0 = _mm_mul_ps(c0, invDet);
+    c1 = _mm_mul_ps(c1, invDet);
+    c2 = _mm_mul_ps(c2, invDet);
+    __m128 translation = _mm_mul_ps(c0, _mm_set1_ps(m[0][3]));
+    translation = _mm_add_ps(translation, _mm_mul_ps(c1, _mm_set1_ps(m[1][3])));
+    translation = _mm_add_ps(translation, _mm_mul_ps(c2, _mm_set1_ps(m[2][3])));
+    return StoreColumns(c0, c1, c2, _mm_sub_ps(_mm_setzero_ps(), translation));
+#else
+    Vector3f r0(m[0][0], m[0][1], m[0][2]);
+    Vector3f r1(m[1][0], m[1][1], m[1][2]);
+    Vector3f r2(m[2][0], m[2][1], m[2][2]);
+    Vector3f c0 = Vector3f::cross(r1, r2);
+    Vector3f c1 = Vector3f::cross(r2, r0);
+    Vector3f c2 = Vector3f::cross(r0, r1);
+
+    // 与Matrix::inverse()一致，不可逆时返回单位变换
+    float det = Vector3f::dot(r0, c0);
+    if (det == 0.0f) {
+        return identity();
+    }
+    float invDet = 1.0f / det;
+
+    Affine3 result;
+    result.m[0][0] = c0.x * invDet; result.m[0][1] = c1.x * invDet; result.m[0][2] = c2.x * invDet;
+    result.m[1][0] = c0.y * invDet; result.m[1][1] = c1.y * invDet; result.m[1][2] = c2.y * invDet;
+    result.m[2][0] = c0.z * invDet; result.m[2][1] = c1.z * invDet; result.m[2][2] = c2.z * invDet;
+
+    const float tx = m[0][3], ty = m[1][3], tz = m[2][3];
+    for (int i = 0; i < 3; i++) {
+        result.m[i][3] = -(result.m[i][0] * tx + result.m[i][1] * ty + result.m[i][2] * tz);
+    }
+    return result;
+#endif
+}
+
+// 逆转置即伴随矩阵的转置除以行列式，行是行向量两两的叉积
+Affine3 Affine3::normalMatrix() const
+{
+#if defined(XYH_SIMD_SSE2)
+    __m128 c0, c1, c2, invDet;
+    if (!LoadCofactors(*this, c0, c1, c2, invDet)) {
+        return identity();
+    }
+    Affine3 result;
+    _mm_store_ps(result.m[0], _mm_mul_ps(c0, invDet));
+    _mm_store_ps(result.m[1], _mm_mul_ps(c1, invDet));
+    _mm_store_ps(result.m[2], _mm_mul_ps(c2, invDet));
+    return result;
+#else
+    Vector3f r0(m[0][0], m[0][1], m[0][2]);
+    Vector3f r1(m[1][0], m[1][1], m[1][2]);
+    Vector3f r2(m[2][0], m[2][1], m[2][2]);
+    Vector3f c0 = Vector3f::cross(r1, r2);
+    Vector3f c1 = Vector3f::cross(r2, r0);
+    Vector3f c2 = Vector3f::cross(r0, r1);
+
+    float det = Vector3f::dot(r0, c0);
+    if (det == 0.0f) {
+        return identity();
+    }
+    float invDet = 1.0f / det;
+
+    Affine3 result;
+    result.m[0][0] = c0.x * invDet; result.m[0][1] = c0.y * invDet; result.m[0][2] = c0.z * invDet; result.m[0][3] = 0.0f;
+    result.m[1][0] = c1.x * invDet; result.m[1][1] = c1.y * invDet; result.m[1][2] = c1.z * invDet; result.m[1][3] = 0.0f;
+    result.m[2][0] = c2.x * invDet; result.m[2][1] = c2.y * invDet; result.m[2][2] = c2.z * invDet; result.m[2][3] = 0.0f;
+    return result;
+#endif
+}
+
+Matrix Affine3::toMatrix() const
+{
+    Matrix result;
+#if defined(XYH_SIMD_SSE2)
+    for (int i = 0; i < 3; i++)
+        _mm_store_ps(result.m[i], _mm_load_ps(m[i]));
+    _mm_store_ps(result.m[3], _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+#else
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            result.m[i][j] = m[i][j];
+    result.m[3][3] = 1.0f;
+#endif
+    return result;
+}
+
+RigidTransform::RigidTransform()
+{
+}
+
+RigidTransform::RigidTransform(const Quaternion& rotation, const Vector3f& translation)
+    : m_affine(Affine3::fromTRS(translation, rotation, Vector3f(1.0f, 1.0f, 1.0f)))
+{
+}
+
+RigidTransform RigidTransform::operator*(const RigidTransform& transform) const
+{
+    RigidTransform result;
+    result.m_affine = m_affine * transform.m_affine;
+    return result;
+}
+
+// 相机坐标系的三个轴作为旋转部分的行，平移为 -R * eye
+RigidTransform RigidTransform::lookAt(const Vector3f& eye, const Vector3f& center, const Vector3f& up)
+{
+    Vector3f zAxis = (eye - center).normalize();
+    Vector3f xAxis = Vector3f::cross(up, zAxis).normalize();
+    Vector3f yAxis = Vector3f::cross(zAxis, xAxis).normalize();
+
+    RigidTransform result;
+    Affine3& affine = result.m_affine;
+    affine.m[0][0] = xAxis.x; affine.m[0][1] = xAxis.y; affine.m[0][2] = xAxis.z; affine.m[0][3] = -Vector3f::dot(xAxis, eye);
+    affine.m[1][0] = yAxis.x; affine.m[1][1] = yAxis.y; affine.m[1][2] = yAxis.z; affine.m[1][3] = -Vector3f::dot(yAxis, eye);
+    affine.m[2][0] = zAxis.x; affine.m[2][1] = zAxis.y; affine.m[2][2] = zAxis.z; affine.m[2][3] = -Vector3f::dot(zAxis, eye);
+    return result;
+}
+
+// 正交矩阵的逆为转置，不需要行列式和除法
+RigidTransform RigidTransform::inverse() const
+{
+    RigidTransform result;
+#if defined(XYH_SIMD_SSE2)
+    // 旋转的三行（w分量清零）即R^T的三列，R^T * t = 各行按t的分量加权求和
+    const __m128 mask = MaskXYZ();
+    const __m128 r0 = _mm_and_ps(_mm_load_ps(m_affine.m[0]), mask);
+    const __m128 r1 = _mm_and_ps(_mm_load_ps(m_affine.m[1]), mask);
+    const __m128 r2 = _mm_and_ps(_mm_load_ps(m_affine.m[2]), mask);
+    __m128 translation = _mm_mul_ps(r0, _mm_set1_ps(m_affine.m[0][3]));
+    translation = _mm_add_ps(translation, _mm_mul_ps(r1, _mm_set1_ps(m_affine.m[1][3])));
+    translation = _mm_add_ps(translation, _mm_mul_ps(r2, _mm_set1_ps(m_affine.m[2][3])));
+    result.m_affine = StoreColumns(r0, r1, r2, _mm_sub_ps(_mm_setzero_ps(), translation));
+#else
+    const float tx = m_affine.m[0][3], ty = m_affine.m[1][3], tz = m_affine.m[2][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            result.m_affine.m[i][j] = m_affine.m[j][i];
+        }
+        result.m_affine.m[i][3] = -(m_affine.m[0][i] * tx + m_affine.m[1][i] * ty + m_affine.m[2][i] * tz);
+    }
+#endif
+    return result;
+}
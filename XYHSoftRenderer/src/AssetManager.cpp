@@ -0,0 +1,271 @@
+#include "../include/AssetManager.h"
+#include "../include/MeshCache.h"
+#include "../include/Profiler.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+// ==================== AssetManager 类 ====================
+// 后台资源加载（单例类）
+AssetManager* AssetManager::s_instance = nullptr;
+
+AssetManager::AssetManager(int threadCount)
+    : m_stopping(false), m_completions(nullptr), m_pendingCount(0)
+{
+    if (threadCount <= 0) {
+        // 保留一个核心给渲染线程
+        threadCount = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&AssetManager::WorkerLoop, this);
+    }
+}
+
+AssetManager::~AssetManager()
+{
+    // 停止工作线程，未开始的任务直接丢弃
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_jobCondition.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+
+    // 释放尚未交付的结果
+    Completion* completion = m_completions.exchange(nullptr);
+    while (completion) {
+        Completion* next = completion->next;
+        delete completion;
+        completion = next;
+    }
+}
+
+AssetManager* AssetManager::GetInstance()
+{
+    if (s_instance == nullptr)
+    {
+        s_instance = new AssetManager(0);
+    }
+    return s_instance;
+}
+
+void AssetManager::DeleteInstance()
+{
+    if (s_instance != nullptr)
+    {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+}
+
+void AssetManager::WorkerLoop()
+{
+    Profiler::SetThreadName("AssetWorker");
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            m_jobCondition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        XYH_PROFILE_SCOPE("AssetJob");
+        job();
+    }
+}
+
+void AssetManager::Enqueue(const std::function<void()>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_jobs.push_back(job);
+    }
+    m_jobCondition.notify_one();
+}
+
+void AssetManager::PushCompletion(Completion* completion)
+{
+    // 无锁入栈：多个工作线程同时写入，渲染线程一次取走全部
+    Completion* head = m_completions.load(std::memory_order_relaxed);
+    do {
+        completion->next = head;
+    } while (!m_completions.compare_exchange_weak(head, completion,
+                                                  std::memory_order_release, std::memory_order_relaxed));
+}
+
+std::shared_ptr<MeshAsset> AssetManager::LoadMeshAsync(const std::string& path, const ObjLoadOptions& options,
+                                                       const MeshCallback& callback)
+{
+    std::string key = path + "|" + std::to_string(MeshCache::GetOptionsKey(options));
+
+    auto found = m_meshes.find(key);
+    if (found != m_meshes.end() && found->second.asset->state != AssetState::Failed) {
+        MeshEntry& entry = found->second;
+        if (entry.asset->state == AssetState::Ready) {
+            if (callback) {
+                callback(*entry.asset);
+            }
+        } else if (callback) {
+            // 正在加载：合并到已有的请求
+            entry.callbacks.push_back(callback);
+        }
+        return entry.asset;
+    }
+
+    // 新请求（或之前加载失败的重试），加载完成前使用空网格
+    std::shared_ptr<MeshAsset> asset = std::make_shared<MeshAsset>();
+    asset->path = path;
+    asset->options = options;
+
+    MeshEntry& entry = m_meshes[key];
+    entry.asset = asset;
+    entry.callbacks.clear();
+    if (callback) {
+        entry.callbacks.push_back(callback);
+    }
+
+    ++m_pendingCount;
+    Enqueue([this, asset, key]() {
+        Completion* completion = new Completion();
+        completion->key = key;
+        completion->meshAsset = asset;
+        completion->mesh = ObjFileReader::LoadMeshFromFile(asset->path, asset->options);
+        completion->success = !completion->mesh.vertices.empty();
+        PushCompletion(completion);
+    });
+    return asset;
+}
+
+std::shared_ptr<TextureAsset> AssetManager::LoadTextureAsync(const std::string& path, bool generateMipmaps,
+                                                             const TextureCallback& callback)
+{
+    std::string key = path + (generateMipmaps ? "|mipmaps" : "");
+
+    auto found = m_textures.find(key);
+    if (found != m_textures.end() && found->second.asset->state != AssetState::Failed) {
+        TextureEntry& entry = found->second;
+        if (entry.asset->state == AssetState::Ready) {
+            if (callback) {
+                callback(*entry.asset);
+            }
+        } else if (callback) {
+            entry.callbacks.push_back(callback);
+        }
+        return entry.asset;
+    }
+
+    // 加载完成前使用棋盘格纹理
+    std::shared_ptr<TextureAsset> asset = std::make_shared<TextureAsset>();
+    asset->path = path;
+    asset->generateMipmaps = generateMipmaps;
+    asset->texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color::black);
+
+    TextureEntry& entry = m_textures[key];
+    entry.asset = asset;
+    entry.callbacks.clear();
+    if (callback) {
+        entry.callbacks.push_back(callback);
+    }
+
+    ++m_pendingCount;
+    Enqueue([this, asset, key]() {
+        Completion* completion = new Completion();
+        completion->key = key;
+        completion->textureAsset = asset;
+        {
+            XYH_PROFILE_SCOPE("WaitTextureDecoder");
+            std::lock_guard<std::mutex> lock(m_decodeMutex);
+            completion->success = completion->texture.LoadFromFile(asset->path);
+        }
+        // Mipmap生成不涉及GDI+，可以与其他任务并行
+        if (completion->success && asset->generateMipmaps) {
+            XYH_PROFILE_SCOPE("GenerateMipmaps");
+            completion->texture.GenerateMipmaps();
+        }
+        PushCompletion(completion);
+    });
+    return asset;
+}
+
+int AssetManager::Update()
+{
+    XYH_PROFILE_SCOPE("AssetManager::Update");
+    
+    // 取走全部结果，并恢复为完成的先后顺序
+    Completion* list = m_completions.exchange(nullptr, std::memory_order_acquire);
+    Completion* ordered = nullptr;
+    while (list) {
+        Completion* next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    int delivered = 0;
+    while (ordered) {
+        Completion* completion = ordered;
+        ordered = completion->next;
+
+        if (completion->meshAsset) {
+            MeshAsset& asset = *completion->meshAsset;
+            if (completion->success) {
+                asset.mesh = std::move(completion->mesh);
+                asset.state = AssetState::Ready;
+            } else {
+                asset.state = AssetState::Failed;
+                std::cerr << "Failed to load mesh asset: " << asset.path << std::endl;
+            }
+
+            // 先取出回调再执行（回调中可能发起新的请求）
+            std::vector<MeshCallback> callbacks;
+            auto found = m_meshes.find(completion->key);
+            if (found != m_meshes.end() && found->second.asset == completion->meshAsset) {
+                callbacks.swap(found->second.callbacks);
+            }
+            --m_pendingCount;
+            for (const MeshCallback& callback : callbacks) {
+                callback(asset);
+            }
+        } else if (completion->textureAsset) {
+            TextureAsset& asset = *completion->textureAsset;
+            if (completion->success) {
+                asset.texture = std::move(completion->texture);
+                asset.state = AssetState::Ready;
+            } else {
+                asset.state = AssetState::Failed;
+                std::cerr << "Failed to load texture asset: " << asset.path << std::endl;
+            }
+
+            std::vector<TextureCallback> callbacks;
+            auto found = m_textures.find(completion->key);
+            if (found != m_textures.end() && found->second.asset == completion->textureAsset) {
+                callbacks.swap(found->second.callbacks);
+            }
+            --m_pendingCount;
+            for (const TextureCallback& callback : callbacks) {
+                callback(asset);
+            }
+        }
+
+        delete completion;
+        ++delivered;
+    }
+    return delivered;
+}
+
+void AssetManager::WaitAll()
+{
+    while (true) {
+        Update();
+        if (m_pendingCount.load() == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
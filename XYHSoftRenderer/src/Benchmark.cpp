@@ -0,0 +1,2223 @@
+#include "../include/Benchmark.h"
+#include "../include/ObjFileReader.h"
+#include "../include/MappedFile.h"
+#include "../include/MeshCache.h"
+#include "../include/MeshOptimizer.h"
+#include "../include/MeshletBuilder.h"
+#include "../include/MeshSimplifier.h"
+#include "../include/PackedMesh.h"
+#include "../include/Shader.h"
+#include "../include/Renderer.h"
+#include "../include/Scene.h"
+#include "../include/Camera.h"
+#include "../include/Simd.h"
+#include "../include/Profiler.h"
+#include "../include/PipelineStatistics.h"
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+namespace {
+
+// 计时：重复执行若干次，返回最短耗时（秒）
+double MeasureSeconds(const std::function<void()>& func, int iterations) {
+    double best = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto stop = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        if (i == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+// 测试使用的模型文件（相对于模型目录）
+const char* const kLoaderBenchmarkFiles[] = {
+    "animal.obj",
+    "building_04.obj",
+    "Container/Container.obj"
+};
+
+// 顶点合并测试使用的模型文件（TestModel目录下的全部OBJ）
+const char* const kWeldBenchmarkFiles[] = {
+    "animal.obj",
+    "building_04.obj",
+    "teapot.obj",
+    "tree.obj",
+    "Car/car.obj",
+    "Container/Container.obj"
+};
+
+// 网格占用的内存（字节）
+size_t MeshMemoryBytes(const Mesh& mesh) {
+    return mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(Vector3i);
+}
+
+// 把网格缩放到原点附近的单位大小
+Matrix FitToUnitMatrix(const Mesh& mesh) {
+    if (mesh.vertices.empty()) {
+        return Matrix::identity();
+    }
+    Vector3f minPos(mesh.vertices[0].pos.x, mesh.vertices[0].pos.y, mesh.vertices[0].pos.z);
+    Vector3f maxPos = minPos;
+    for (const Vertex& vertex : mesh.vertices) {
+        Vector3f pos(vertex.pos.x, vertex.pos.y, vertex.pos.z);
+        minPos = Vector3f::Min(minPos, pos);
+        maxPos = Vector3f::Max(maxPos, pos);
+    }
+    Vector3f size = maxPos - minPos;
+    float extent = (std::max)({size.x, size.y, size.z, 1e-6f});
+    Vector3f center = (minPos + maxPos) * 0.5f;
+    return Matrix::scale(Vector3f(2.0f / extent, 2.0f / extent, 2.0f / extent)) * Matrix::translate(-center);
+}
+
+// 帧缓冲区的颜色数据（RGBA8）
+std::vector<unsigned char> CopyColorBuffer(const FrameBuffer* frameBuffer) {
+    const ColorBuffer& colorBuffer = frameBuffer->colorBuffer;
+    size_t byteCount = static_cast<size_t>(colorBuffer.width) * colorBuffer.height * colorBuffer.channel;
+    return std::vector<unsigned char>(colorBuffer.buffer, colorBuffer.buffer + byteCount);
+}
+
+// 加载kWeldBenchmarkFiles中的全部模型并缩放到单位大小（缺失的模型写入报告），没有可用模型时返回false
+bool LoadBenchmarkScene(std::ostringstream& report, const std::string& modelDirectory, std::vector<Mesh>& meshes,
+                        std::vector<Matrix>& modelMatrices, std::vector<std::string>* names = nullptr) {
+    for (const char* fileName : kWeldBenchmarkFiles) {
+        Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + fileName, ObjLoadOptions());
+        if (mesh.vertices.empty()) {
+            report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+            continue;
+        }
+        if (names) {
+            names->push_back(fileName);
+        }
+        modelMatrices.push_back(FitToUnitMatrix(mesh));
+        meshes.push_back(std::move(mesh));
+    }
+    return !meshes.empty();
+}
+
+// 初始化渲染器，设置从eye看向target的相机（45度视角），初始化失败时写入报告并返回false
+bool SetupBenchmarkRenderer(std::ostringstream& report, Renderer& renderer, const Vector3f& eye,
+                            const Vector3f& target = Vector3f(0.0f, 0.0f, 0.0f)) {
+    if (!renderer.Initialize(nullptr)) {
+        report << "  (renderer initialization failed)" << std::endl;
+        return false;
+    }
+    float aspect = static_cast<float>(renderer.GetWidth()) / renderer.GetHeight();
+    renderer.SetViewMatrix(Matrix::lookAt(eye, target, Vector3f(0.0f, 1.0f, 0.0f)));
+    renderer.SetProjectionMatrix(Matrix::perspective(toRadians(45.0f), aspect, 0.1f, 100.0f));
+    renderer.SetViewPosition(eye);
+    return true;
+}
+
+// 绘制全部模型：第一个模型使用模板绘制流程，其余使用虚函数绘制流程
+template <typename ShaderT>
+void DrawBenchmarkScene(Renderer& renderer, const std::vector<Mesh>& meshes, const std::vector<Matrix>& modelMatrices,
+                        ShaderT& shader) {
+    renderer.DrawMeshT<ShaderT>(meshes[0], modelMatrices[0], shader);
+    for (size_t i = 1; i < meshes.size(); i++) {
+        renderer.DrawMesh(meshes[i], modelMatrices[i], &shader);
+    }
+}
+
+// 多线程解析测试使用的模型文件（选择最大的模型）
+const char* const kParallelBenchmarkFile = "animal.obj";
+
+// 比较两个Mesh的顶点和索引是否完全一致
+bool IsSameMesh(const Mesh& a, const Mesh& b) {
+    if (a.vertices.size() != b.vertices.size() || a.indices.size() != b.indices.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.vertices.size(); ++i) {
+        const Vertex& va = a.vertices[i];
+        const Vertex& vb = b.vertices[i];
+        if (va.pos.x != vb.pos.x || va.pos.y != vb.pos.y || va.pos.z != vb.pos.z ||
+            va.normal.x != vb.normal.x || va.normal.y != vb.normal.y || va.normal.z != vb.normal.z ||
+            va.texcoord.x != vb.texcoord.x || va.texcoord.y != vb.texcoord.y) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.indices.size(); ++i) {
+        if (a.indices[i].x != b.indices[i].x || a.indices[i].y != b.indices[i].y || a.indices[i].z != b.indices[i].z) {
+            return false;
+        }
+    }
+    if (a.subMeshes.size() != b.subMeshes.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.subMeshes.size(); ++i) {
+        const SubMesh& sa = a.subMeshes[i];
+        const SubMesh& sb = b.subMeshes[i];
+        if (sa.triangleStart != sb.triangleStart || sa.triangleCount != sb.triangleCount ||
+            sa.material.name != sb.material.name) {
+            return false;
+        }
+    }
+    if (a.meshlets.size() != b.meshlets.size() || a.meshletVertices != b.meshletVertices) {
+        return false;
+    }
+    for (size_t i = 0; i < a.meshlets.size(); ++i) {
+        const Meshlet& ma = a.meshlets[i];
+        const Meshlet& mb = b.meshlets[i];
+        if (ma.triangleStart != mb.triangleStart || ma.triangleCount != mb.triangleCount ||
+            ma.vertexOffset != mb.vertexOffset || ma.vertexCount != mb.vertexCount ||
+            ma.center.x != mb.center.x || ma.center.y != mb.center.y || ma.center.z != mb.center.z ||
+            ma.radius != mb.radius || ma.coneCutoff != mb.coneCutoff ||
+            ma.coneApex.x != mb.coneApex.x || ma.coneApex.y != mb.coneApex.y || ma.coneApex.z != mb.coneApex.z ||
+            ma.coneAxis.x != mb.coneAxis.x || ma.coneAxis.y != mb.coneAxis.y || ma.coneAxis.z != mb.coneAxis.z) {
+            return false;
+        }
+    }
+    if (a.lodError != b.lodError || a.lods.size() != b.lods.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.lods.size(); ++i) {
+        if (!IsSameMesh(a.lods[i], b.lods[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string Benchmark::RunAll(const std::string& modelDirectory) {
+    std::ostringstream report;
+    report << RunObjLoaderBenchmark(modelDirectory);
+    report << RunObjParallelBenchmark(modelDirectory);
+    report << RunVertexWeldBenchmark(modelDirectory);
+    report << RunMeshCacheBenchmark(modelDirectory);
+    report << RunMeshOptimizerBenchmark(modelDirectory);
+    report << RunPackedMeshBenchmark(modelDirectory);
+    report << RunVertexShadingBenchmark(modelDirectory);
+    report << RunShaderPipelineBenchmark(modelDirectory);
+    report << RunFrameArenaBenchmark(modelDirectory);
+    report << RunFrustumCullingBenchmark(modelDirectory);
+    report << RunSceneBvhBenchmark(modelDirectory);
+    report << RunMeshletBenchmark(modelDirectory);
+    report << RunLodBenchmark(modelDirectory);
+    report << RunInstancingBenchmark(modelDirectory);
+    report << RunTransformBenchmark();
+    report << RunMathBenchmark();
+    report << RunAffineBenchmark();
+    report << RunProfilerBenchmark(modelDirectory);
+    report << RunPipelineStatisticsBenchmark(modelDirectory);
+    report << RunDebugViewBenchmark(modelDirectory);
+    return report.str();
+}
+
+std::string Benchmark::RunObjLoaderBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== OBJ loader benchmark ===" << std::endl;
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(10) << "Size(MB)"
+           << std::setw(14) << "Legacy(MB/s)"
+           << std::setw(14) << "Mapped(MB/s)"
+           << std::setw(10) << "Speedup" << std::endl;
+
+    for (const char* fileName : kLoaderBenchmarkFiles) {
+        std::string path = modelDirectory + fileName;
+
+        // 获取文件大小
+        size_t fileSize = 0;
+        {
+            MappedFile file;
+            if (!file.Open(path)) {
+                report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+                continue;
+            }
+            fileSize = file.Size();
+        }
+        double megabytes = fileSize / (1024.0 * 1024.0);
+
+        size_t triangles = 0;
+        double legacySeconds = MeasureSeconds([&]() {
+            Mesh mesh = ObjFileReader::LoadMeshFromFileLegacy(path);
+            triangles = mesh.GetTriangleCount();
+        }, iterations);
+        double mappedSeconds = MeasureSeconds([&]() {
+            Mesh mesh = ObjFileReader::LoadMeshFromFile(path);
+            triangles = mesh.GetTriangleCount();
+        }, iterations);
+
+        report << std::left << std::setw(26) << fileName
+               << std::right << std::fixed << std::setprecision(2)
+               << std::setw(10) << megabytes
+               << std::setw(14) << megabytes / (std::max)(legacySeconds, 1e-9)
+               << std::setw(14) << megabytes / (std::max)(mappedSeconds, 1e-9)
+               << std::setw(9) << legacySeconds / (std::max)(mappedSeconds, 1e-9) << "x"
+               << "  (" << triangles << " triangles)" << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunObjParallelBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    std::string path = modelDirectory + kParallelBenchmarkFile;
+
+    size_t fileSize = 0;
+    {
+        MappedFile file;
+        if (!file.Open(path)) {
+            report << "=== OBJ parallel parse benchmark ===" << std::endl;
+            report << kParallelBenchmarkFile << "  (missing)" << std::endl;
+            return report.str();
+        }
+        fileSize = file.Size();
+    }
+    double megabytes = fileSize / (1024.0 * 1024.0);
+
+    // 线程数：1、2、4、8……直到硬件线程数
+    int hardwareThreads = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> threadCounts;
+    for (int count = 1; count < hardwareThreads; count *= 2) {
+        threadCounts.push_back(count);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    report << "=== OBJ parallel parse benchmark (" << kParallelBenchmarkFile << ", "
+           << std::fixed << std::setprecision(2) << megabytes << " MB, "
+           << hardwareThreads << " hardware threads) ===" << std::endl;
+    report << std::right << std::setw(8) << "Threads"
+           << std::setw(12) << "Time(ms)"
+           << std::setw(12) << "MB/s"
+           << std::setw(10) << "Speedup"
+           << std::setw(12) << "Identical" << std::endl;
+
+    Mesh reference = ObjFileReader::LoadMeshFromFile(path);
+    double serialSeconds = 0.0;
+    for (int threadCount : threadCounts) {
+        ObjLoadOptions options;
+        options.threadCount = threadCount;
+        options.buildLods = false;  // 只测量解析，LOD生成是单线程的固定开销
+
+        bool identical = true;
+        double seconds = MeasureSeconds([&]() {
+            Mesh mesh = ObjFileReader::LoadMeshFromFile(path, options);
+            identical = identical && IsSameMesh(mesh, reference);
+        }, iterations);
+        if (threadCount == 1) {
+            serialSeconds = seconds;
+        }
+
+        report << std::setw(8) << threadCount
+               << std::setw(12) << seconds * 1000.0
+               << std::setw(12) << megabytes / (std::max)(seconds, 1e-9)
+               << std::setw(9) << serialSeconds / (std::max)(seconds, 1e-9) << "x"
+               << std::setw(12) << (identical ? "yes" : "NO") << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunVertexWeldBenchmark(const std::string& modelDirectory) {
+    std::ostringstream report;
+    report << "=== Vertex weld benchmark ===" << std::endl;
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(12) << "Triangles"
+           << std::setw(12) << "Vertices"
+           << std::setw(12) << "Welded"
+           << std::setw(12) << "Eps 1e-4"
+           << std::setw(12) << "Mem(KB)"
+           << std::setw(12) << "Welded(KB)"
+           << std::setw(9) << "Saving" << std::endl;
+
+    for (const char* fileName : kWeldBenchmarkFiles) {
+        std::string path = modelDirectory + fileName;
+
+        ObjLoadOptions unweldedOptions;
+        unweldedOptions.weldVertices = false;
+        Mesh unwelded = ObjFileReader::LoadMeshFromFile(path, unweldedOptions);
+        if (unwelded.vertices.empty()) {
+            report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+            continue;
+        }
+
+        Mesh welded = ObjFileReader::LoadMeshFromFile(path, ObjLoadOptions());
+
+        ObjLoadOptions epsilonOptions;
+        epsilonOptions.weldEpsilon = 1e-4f;
+        Mesh epsilonWelded = ObjFileReader::LoadMeshFromFile(path, epsilonOptions);
+
+        double unweldedKB = MeshMemoryBytes(unwelded) / 1024.0;
+        double weldedKB = MeshMemoryBytes(welded) / 1024.0;
+
+        report << std::left << std::setw(26) << fileName
+               << std::right << std::setw(12) << unwelded.GetTriangleCount()
+               << std::setw(12) << unwelded.vertices.size()
+               << std::setw(12) << welded.vertices.size()
+               << std::setw(12) << epsilonWelded.vertices.size()
+               << std::fixed << std::setprecision(1)
+               << std::setw(12) << unweldedKB
+               << std::setw(12) << weldedKB
+               << std::setw(8) << 100.0 * (1.0 - weldedKB / (std::max)(unweldedKB, 1e-9)) << "%" << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunMeshCacheBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== Mesh cache benchmark ===" << std::endl;
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(10) << "OBJ(MB)"
+           << std::setw(12) << "Cache(MB)"
+           << std::setw(12) << "Parse(ms)"
+           << std::setw(12) << "Cache(ms)"
+           << std::setw(10) << "Speedup"
+           << std::setw(12) << "Identical" << std::endl;
+
+    for (const char* fileName : kLoaderBenchmarkFiles) {
+        std::string path = modelDirectory + fileName;
+        // 测试使用单独的缓存文件，不影响程序正常使用的缓存
+        std::string cachePath = MeshCache::GetCachePath(path) + ".benchmark";
+
+        size_t fileSize = 0;
+        uint64_t contentHash = 0;
+        {
+            MappedFile file;
+            if (!file.Open(path)) {
+                report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+                continue;
+            }
+            fileSize = file.Size();
+            contentHash = MeshCache::HashContent(file.Data(), file.Size());
+        }
+
+        // 解析时间包括生成簇和LOD链（缓存中已经包含，读缓存时不再生成）
+        ObjLoadOptions options;
+        uint64_t optionsKey = MeshCache::GetOptionsKey(options);
+
+        Mesh parsed;
+        double parseSeconds = MeasureSeconds([&]() {
+            parsed = ObjFileReader::LoadMeshFromFile(path, options);
+        }, iterations);
+
+        // 材质库不影响缓存的读写速度，这里不保存
+        std::vector<std::string> materialLibraries;
+        if (!MeshCache::Save(cachePath, contentHash, optionsKey, parsed, materialLibraries)) {
+            report << std::left << std::setw(26) << fileName << "  (cache write failed)" << std::endl;
+            continue;
+        }
+        size_t cacheSize = 0;
+        {
+            MappedFile cacheFile;
+            if (cacheFile.Open(cachePath)) {
+                cacheSize = cacheFile.Size();
+            }
+        }
+
+        // 缓存加载包含映射OBJ并计算内容哈希（与实际加载流程一致）
+        Mesh cached;
+        bool loaded = true;
+        double cacheSeconds = MeasureSeconds([&]() {
+            MappedFile file(path);
+            uint64_t hash = MeshCache::HashContent(file.Data(), file.Size());
+            loaded = loaded && MeshCache::Load(cachePath, hash, optionsKey, cached, materialLibraries);
+        }, iterations);
+        std::remove(cachePath.c_str());
+
+        report << std::left << std::setw(26) << fileName
+               << std::right << std::fixed << std::setprecision(2)
+               << std::setw(10) << fileSize / (1024.0 * 1024.0)
+               << std::setw(12) << cacheSize / (1024.0 * 1024.0)
+               << std::setw(12) << parseSeconds * 1000.0
+               << std::setw(12) << cacheSeconds * 1000.0
+               << std::setw(9) << parseSeconds / (std::max)(cacheSeconds, 1e-9) << "x"
+               << std::setw(12) << (loaded && IsSameMesh(parsed, cached) ? "yes" : "NO") << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunMeshOptimizerBenchmark(const std::string& modelDirectory) {
+    std::ostringstream report;
+    report << "=== Mesh optimizer benchmark ===" << std::endl;
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(12) << "Triangles"
+           << std::setw(10) << "ACMR"
+           << std::setw(10) << "->"
+           << std::setw(12) << "Overdraw"
+           << std::setw(10) << "->"
+           << std::setw(12) << "Time(ms)" << std::endl;
+
+    for (const char* fileName : kWeldBenchmarkFiles) {
+        std::string path = modelDirectory + fileName;
+
+        // 按OBJ中的原始顺序加载，再单独执行优化
+        ObjLoadOptions options;
+        options.optimizeMesh = false;
+        Mesh mesh = ObjFileReader::LoadMeshFromFile(path, options);
+        if (mesh.vertices.empty()) {
+            report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+            continue;
+        }
+
+        float acmrBefore = MeshOptimizer::CalculateACMR(mesh.indices, mesh.vertices.size());
+        float overdrawBefore = MeshOptimizer::CalculateOverdraw(mesh);
+
+        Mesh optimized = mesh;
+        double seconds = MeasureSeconds([&]() {
+            MeshOptimizer::Optimize(optimized);
+        }, 1);
+
+        float acmrAfter = MeshOptimizer::CalculateACMR(optimized.indices, optimized.vertices.size());
+        float overdrawAfter = MeshOptimizer::CalculateOverdraw(optimized);
+
+        report << std::left << std::setw(26) << fileName
+               << std::right << std::setw(12) << mesh.GetTriangleCount()
+               << std::fixed << std::setprecision(3)
+               << std::setw(10) << acmrBefore
+               << std::setw(10) << acmrAfter
+               << std::setw(12) << overdrawBefore
+               << std::setw(10) << overdrawAfter
+               << std::setprecision(2)
+               << std::setw(12) << seconds * 1000.0 << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunPackedMeshBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== Packed mesh benchmark ===" << std::endl;
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(12) << "Vertices"
+           << std::setw(12) << "Mesh(KB)"
+           << std::setw(12) << "Float(KB)"
+           << std::setw(12) << "Packed(KB)"
+           << std::setw(8) << "Ratio"
+           << std::setw(12) << "Normal(deg)"
+           << std::setw(10) << "UV err"
+           << std::setw(13) << "Single(MV/s)"
+           << std::setw(13) << "Batch(MV/s)" << std::endl;
+
+    for (const char* fileName : kWeldBenchmarkFiles) {
+        std::string path = modelDirectory + fileName;
+        Mesh mesh = ObjFileReader::LoadMeshFromFile(path, ObjLoadOptions());
+        if (mesh.vertices.empty()) {
+            report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+            continue;
+        }
+
+        PackedMeshFormat floatFormat;
+        floatFormat.normalFormat = NormalFormat::Float3;
+        floatFormat.texcoordFormat = TexcoordFormat::Float2;
+        PackedMesh floatPacked = PackedMesh::FromMesh(mesh, floatFormat);
+        PackedMesh packed = PackedMesh::FromMesh(mesh, PackedMeshFormat());
+
+        // 解码误差（法线夹角和纹理坐标的最大误差）
+        float maxNormalError = 0.0f;
+        float maxTexcoordError = 0.0f;
+        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+            const Vertex& original = mesh.vertices[i];
+            Vertex decoded = packed.GetVertex(i);
+            Vector3f normal = original.normal;
+            if (normal.magnitude() > 0.0f) {
+                float cosine = (std::max)(-1.0f, (std::min)(1.0f, normal.normalize().dot(decoded.normal)));
+                maxNormalError = (std::max)(maxNormalError, std::acos(cosine) * 57.29578f);
+            }
+            maxTexcoordError = (std::max)(maxTexcoordError, std::abs(original.texcoord.x - decoded.texcoord.x));
+            maxTexcoordError = (std::max)(maxTexcoordError, std::abs(original.texcoord.y - decoded.texcoord.y));
+        }
+
+        // 解码吞吐量：逐顶点解码 vs 批量解码
+        float checksum = 0.0f;
+        double singleSeconds = MeasureSeconds([&]() {
+            for (size_t i = 0; i < packed.GetVertexCount(); ++i) {
+                checksum += packed.GetVertex(i).normal.z;
+            }
+        }, iterations);
+        VertexBatch batch;
+        double batchSeconds = MeasureSeconds([&]() {
+            for (size_t first = 0; first < packed.GetVertexCount(); first += VertexBatch::kSize) {
+                packed.LoadBatch(first, batch);
+                checksum += batch.normalZ[0];
+            }
+        }, iterations);
+    
+        double megaVertices = mesh.vertices.size() / 1e6;
+        double meshKB = MeshMemoryBytes(mesh) / 1024.0;
+        double packedKB = packed.GetMemoryBytes() / 1024.0;
+        report << std::left << std::setw(26) << fileName
+               << std::right << std::setw(12) << mesh.vertices.size()
+               << std::fixed << std::setprecision(1)
+               << std::setw(12) << meshKB
+               << std::setw(12) << floatPacked.GetMemoryBytes() / 1024.0
+               << std::setw(12) << packedKB
+               << std::setprecision(2)
+               << std::setw(7) << meshKB / (std::max)(packedKB, 1e-9) << "x"
+               << std::setprecision(4)
+               << std::setw(12) << maxNormalError
+               << std::setw(10) << maxTexcoordError
+               << std::setprecision(1)
+               << std::setw(13) << megaVertices / (std::max)(singleSeconds, 1e-9)
+               << std::setw(13) << megaVertices / (std::max)(batchSeconds, 1e-9) << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunVertexShadingBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== Vertex shading benchmark ===" << std::endl;
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(12) << "Vertices"
+           << std::setw(14) << "PerTri(ms)"
+           << std::setw(14) << "PerVert(ms)"
+           << std::setw(12) << "Batch(ms)"
+           << std::setw(10) << "Speedup"
+           << std::setw(12) << "Max diff" << std::endl;
+
+    // 使用带法线变换的内置着色器，模型矩阵包含旋转和非均匀缩放
+    BlinnPhongShader shader;
+    Matrix modelMatrix = Matrix::translate(Vector3f(0.5f, -1.0f, 2.0f)) * Matrix::rotate(30.0f, 'y') *
+                         Matrix::scale(Vector3f(1.0f, 2.0f, 0.5f));
+    Matrix viewMatrix = Matrix::lookAt(Vector3f(0.0f, 0.0f, 10.0f), Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f));
+    Matrix projMatrix = Matrix::perspective(toRadians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+
+    for (const char* fileName : kWeldBenchmarkFiles) {
+        std::string path = modelDirectory + fileName;
+        Mesh mesh = ObjFileReader::LoadMeshFromFile(path, ObjLoadOptions());
+        if (mesh.vertices.empty()) {
+            report << std::left << std::setw(26) << fileName << "  (missing)" << std::endl;
+            continue;
+        }
+
+        VertexShaderInput input;
+        input.modelMatrix = modelMatrix;
+        input.viewMatrix = viewMatrix;
+        input.projMatrix = projMatrix;
+        auto shadeVertex = [&](const Vertex& vertex) {
+            input.position = vertex.pos;
+            input.color = vertex.color;
+            input.normal = vertex.normal;
+            input.texcoord = vertex.texcoord;
+            return shader.VertexShader(input);
+        };
+
+        // 原来的绘制流程：每个三角形对三个顶点分别调用VertexShader
+        float checksum = 0.0f;
+        double perTriangleSeconds = MeasureSeconds([&]() {
+            for (const Vector3i& index : mesh.indices) {
+                checksum += shadeVertex(mesh.vertices[index.x]).position.w;
+                checksum += shadeVertex(mesh.vertices[index.y]).position.w;
+                checksum += shadeVertex(mesh.vertices[index.z]).position.w;
+            }
+        }, iterations);
+
+        // 每个顶点调用一次VertexShader
+        std::vector<VertexOutput> scalarOutputs(mesh.vertices.size());
+        double perVertexSeconds = MeasureSeconds([&]() {
+            for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+                scalarOutputs[i] = shadeVertex(mesh.vertices[i]);
+            }
+        }, iterations);
+
+        // 批量着色
+        std::vector<VertexOutput> batchOutputs(mesh.vertices.size());
+        double batchSeconds = MeasureSeconds([&]() {
+            VertexUniforms uniforms(modelMatrix, viewMatrix, projMatrix);
+            VertexBatch batch;
+            VertexOutputBatch outputBatch;
+            for (size_t first = 0; first < mesh.vertices.size(); first += VertexBatch::kSize) {
+                int count = static_cast<int>((std::min)(static_cast<size_t>(VertexBatch::kSize), mesh.vertices.size() - first));
+                batch.LoadVertices(&mesh.vertices[first], count);
+                shader.VertexShaderBatch(batch, uniforms, outputBatch);
+                for (int i = 0; i < count; ++i) {
+                    batchOutputs[first + i] = outputBatch.GetOutput(i);
+                }
+            }
+        }, iterations);
+    
+        // 批量着色与逐顶点着色的最大差异（相对裁剪空间w）
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+            const VertexOutput& a = scalarOutputs[i];
+            const VertexOutput& b = batchOutputs[i];
+            float scale = (std::max)(1.0f, std::abs(a.position.w));
+            maxDifference = (std::max)({maxDifference,
+                std::abs(a.position.x - b.position.x) / scale, std::abs(a.position.y - b.position.y) / scale,
+                std::abs(a.position.z - b.position.z) / scale, std::abs(a.position.w - b.position.w) / scale,
+                std::abs(a.normal.x - b.normal.x), std::abs(a.normal.y - b.normal.y), std::abs(a.normal.z - b.normal.z),
+                std::abs(a.worldPos.x - b.worldPos.x) / scale, std::abs(a.worldPos.y - b.worldPos.y) / scale,
+                std::abs(a.worldPos.z - b.worldPos.z) / scale});
+        }
+
+        report << std::left << std::setw(26) << fileName
+               << std::right << std::setw(12) << mesh.vertices.size()
+               << std::fixed << std::setprecision(2)
+               << std::setw(14) << perTriangleSeconds * 1000.0
+               << std::setw(14) << perVertexSeconds * 1000.0
+               << std::setw(12) << batchSeconds * 1000.0
+               << std::setprecision(1)
+               << std::setw(9) << perTriangleSeconds / (std::max)(batchSeconds, 1e-9) << "x"
+               << std::scientific << std::setprecision(1)
+               << std::setw(12) << maxDifference << std::defaultfloat << std::endl;
+    }
+
+    return report.str();
+}
+
+namespace {
+
+// 分别用虚函数绘制流程和模板绘制流程绘制一次，输出一行测试结果
+template <typename ShaderT>
+void ReportShaderPipeline(std::ostringstream& report, const char* name, Renderer& renderer, const Mesh& mesh,
+                          const Matrix& modelMatrix, ShaderT& shader, int iterations) {
+    double virtualSeconds = MeasureSeconds([&]() {
+        renderer.ClearBackBuffer(Color::black);
+        renderer.SetCullMode(Renderer::CullMode::CULL_BACK);
+        renderer.DrawMesh(mesh, modelMatrix, &shader);
+    }, iterations);
+    std::vector<unsigned char> virtualImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    double templateSeconds = MeasureSeconds([&]() {
+        renderer.ClearBackBuffer(Color::black);
+        renderer.DrawMeshT<ShaderT, Renderer::RenderState<Renderer::CullMode::CULL_BACK, true, false>>(mesh, modelMatrix, shader);
+    }, iterations);
+    std::vector<unsigned char> templateImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    // 画面差异（编译器对两条流程的浮点运算合并方式可能不同，允许个别像素有1级的差异）
+    size_t differentPixels = 0;
+    int maxDifference = 0;
+    for (size_t i = 0; i + 3 < virtualImage.size(); i += 4) {
+        int difference = 0;
+        for (size_t c = 0; c < 3; ++c) {
+            difference = (std::max)(difference, std::abs(virtualImage[i + c] - templateImage[i + c]));
+        }
+        differentPixels += difference > 0 ? 1 : 0;
+        maxDifference = (std::max)(maxDifference, difference);
+    }
+
+    report << std::left << std::setw(26) << name
+           << std::right << std::fixed << std::setprecision(2)
+           << std::setw(14) << virtualSeconds * 1000.0
+           << std::setw(14) << templateSeconds * 1000.0
+           << std::setw(9) << virtualSeconds / (std::max)(templateSeconds, 1e-9) << "x"
+           << std::setw(12) << differentPixels
+           << std::setw(10) << maxDifference << std::endl;
+}
+
+} // namespace
+
+std::string Benchmark::RunShaderPipelineBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== Shader pipeline benchmark (virtual vs template) ===" << std::endl;
+
+    Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + kParallelBenchmarkFile, ObjLoadOptions());
+    if (mesh.vertices.empty()) {
+        report << kParallelBenchmarkFile << "  (missing)" << std::endl;
+        return report.str();
+    }
+    report << kParallelBenchmarkFile << ": " << mesh.GetTriangleCount() << " triangles, 800x600" << std::endl;
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 0.5f, 3.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye)) {
+        return report.str();
+    }
+    Matrix modelMatrix = FitToUnitMatrix(mesh);
+
+    Texture texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color(0.2f, 0.2f, 0.2f, 1.0f));
+    texture.GenerateMipmaps();
+
+    ColorShader colorShader;
+    PhongShader phongShader;
+    phongShader.SetViewPosition(eye);
+    BlinnPhongShader blinnPhongShader;
+    blinnPhongShader.SetViewPosition(eye);
+    TextureShader textureShader;
+    textureShader.SetTexture(&texture);
+    TexturedBlinnPhongShader texturedBlinnPhongShader;
+    texturedBlinnPhongShader.SetTexture(&texture);
+    texturedBlinnPhongShader.SetViewPosition(eye);
+
+    report << std::left << std::setw(26) << "Shader"
+           << std::right << std::setw(14) << "Virtual(ms)"
+           << std::setw(14) << "Template(ms)"
+           << std::setw(10) << "Speedup"
+           << std::setw(12) << "Diff px"
+           << std::setw(10) << "Max diff" << std::endl;
+    ReportShaderPipeline(report, "ColorShader", renderer, mesh, modelMatrix, colorShader, iterations);
+    ReportShaderPipeline(report, "PhongShader", renderer, mesh, modelMatrix, phongShader, iterations);
+    ReportShaderPipeline(report, "BlinnPhongShader", renderer, mesh, modelMatrix, blinnPhongShader, iterations);
+    ReportShaderPipeline(report, "TextureShader", renderer, mesh, modelMatrix, textureShader, iterations);
+    ReportShaderPipeline(report, "TexturedBlinnPhongShader", renderer, mesh, modelMatrix, texturedBlinnPhongShader, iterations);
+
+    return report.str();
+}
+
+std::string Benchmark::RunFrameArenaBenchmark(const std::string& modelDirectory, int frames) {
+    std::ostringstream report;
+    report << "=== Frame arena benchmark ===" << std::endl;
+
+    // 每帧绘制测试目录下的全部模型
+    std::vector<Mesh> meshes;
+    std::vector<Matrix> modelMatrices;
+    if (!LoadBenchmarkScene(report, modelDirectory, meshes, modelMatrices)) {
+        return report.str();
+    }
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 0.5f, 3.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye)) {
+        return report.str();
+    }
+    BlinnPhongShader shader;
+    shader.SetViewPosition(eye);
+
+    report << meshes.size() << " meshes per frame, 800x600" << std::endl;
+    report << std::left << std::setw(8) << "Frame"
+           << std::right << std::setw(12) << "Time(ms)"
+           << std::setw(16) << "HighWater(KB)"
+           << std::setw(16) << "Capacity(KB)"
+           << std::setw(10) << "Mallocs" << std::endl;
+
+    const FrameArena& arena = renderer.GetFrameArena();
+    for (int frame = 0; frame < frames; frame++) {
+        double seconds = MeasureSeconds([&]() {
+            renderer.ClearBackBuffer(Color::black);
+            for (size_t i = 0; i < meshes.size(); i++) {
+                renderer.DrawMesh(meshes[i], modelMatrices[i], &shader);
+            }
+        }, 1);
+
+        report << std::left << std::setw(8) << frame
+               << std::right << std::fixed << std::setprecision(2)
+               << std::setw(12) << seconds * 1000.0
+               << std::setw(16) << arena.GetHighWaterMark() / 1024.0
+               << std::setw(16) << arena.GetCapacity() / 1024.0
+               << std::setw(10) << arena.GetMallocCount() << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunFrustumCullingBenchmark(const std::string& modelDirectory, int gridSize, int iterations) {
+    std::ostringstream report;
+    report << "=== Frustum culling benchmark ===" << std::endl;
+
+    // 顶点在加载后变换，不生成LOD（LOD不随原网格的顶点变换）
+    ObjLoadOptions options;
+    options.buildLods = false;
+    Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + "teapot.obj", options);
+    if (mesh.vertices.empty()) {
+        report << "teapot.obj  (missing)" << std::endl;
+        return report.str();
+    }
+
+    // 网格缩放到单位大小后摆成gridSize x gridSize的方阵，相机位于方阵中心，只能看到一部分对象
+    Matrix fitMatrix = FitToUnitMatrix(mesh);
+    for (Vertex& vertex : mesh.vertices) {
+        vertex.pos = fitMatrix * vertex.pos;
+    }
+    MeshletBuilder::Build(mesh);
+    std::vector<Object> objects;
+    objects.reserve(static_cast<size_t>(gridSize) * gridSize);
+    float spacing = 3.0f;
+    float offset = (gridSize - 1) * spacing * 0.5f;
+    for (int z = 0; z < gridSize; z++) {
+        for (int x = 0; x < gridSize; x++) {
+            Transformer transform;
+            transform.SetPosition(Vector3f(x * spacing - offset, 0.0f, z * spacing - offset));
+            transform.SetRotation(Vector3f(0.0f, (x * 37 + z * 11) % 360, 0.0f));
+            objects.push_back(Object(mesh, Material(), transform));
+        }
+    }
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 2.0f, 0.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye, Vector3f(0.0f, 1.0f, -10.0f))) {
+        return report.str();
+    }
+    BlinnPhongShader shader;
+    shader.SetViewPosition(eye);
+
+    auto drawFrame = [&]() {
+        renderer.ClearBackBuffer(Color::black);
+        for (const Object& object : objects) {
+            renderer.DrawObject(object, &shader);
+        }
+    };
+
+    renderer.SetFrustumCulling(false);
+    double unculledSeconds = MeasureSeconds(drawFrame, iterations);
+    std::vector<unsigned char> unculledImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    renderer.SetFrustumCulling(true);
+    double culledSeconds = MeasureSeconds(drawFrame, iterations);
+    std::vector<unsigned char> culledImage = CopyColorBuffer(renderer.GetFrameBuffer());
+    const Renderer::RenderStats& stats = renderer.GetStats();
+
+    report << objects.size() << " objects (teapot.obj, " << mesh.GetTriangleCount() << " triangles each), 800x600" << std::endl;
+    report << std::fixed << std::setprecision(2)
+           << "No culling:       " << std::setw(10) << unculledSeconds * 1000.0 << " ms" << std::endl
+           << "Frustum culling:  " << std::setw(10) << culledSeconds * 1000.0 << " ms  ("
+           << unculledSeconds / (std::max)(culledSeconds, 1e-9) << "x)" << std::endl
+           << "Objects drawn:    " << std::setw(10) << stats.objectsDrawn << std::endl
+           << "Objects culled:   " << std::setw(10) << stats.objectsCulled << std::endl
+           << "Image identical:  " << std::setw(10) << (unculledImage == culledImage ? "yes" : "no") << std::endl;
+
+    return report.str();
+}
+
+std::string Benchmark::RunSceneBvhBenchmark(const std::string& modelDirectory, int gridSize, int iterations) {
+    std::ostringstream report;
+    report << "=== Scene BVH benchmark ===" << std::endl;
+
+    // 顶点在加载后变换，不生成LOD（LOD不随原网格的顶点变换）
+    ObjLoadOptions options;
+    options.buildLods = false;
+    Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + "tree.obj", options);
+    if (mesh.vertices.empty()) {
+        report << "tree.obj  (missing)" << std::endl;
+        return report.str();
+    }
+
+    // 网格缩放到单位大小后摆成gridSize x gridSize的方阵
+    Matrix fitMatrix = FitToUnitMatrix(mesh);
+    for (Vertex& vertex : mesh.vertices) {
+        vertex.pos = fitMatrix * vertex.pos;
+    }
+    MeshletBuilder::Build(mesh);
+    Scene scene;
+    float spacing = 3.0f;
+    float offset = (gridSize - 1) * spacing * 0.5f;
+    for (int z = 0; z < gridSize; z++) {
+        for (int x = 0; x < gridSize; x++) {
+            Transformer transform;
+            transform.SetPosition(Vector3f(x * spacing - offset, 0.0f, z * spacing - offset));
+            transform.SetRotation(Vector3f(0.0f, (x * 37 + z * 11) % 360, 0.0f));
+            scene.AddObject(Object(mesh, Material(), transform));
+        }
+    }
+    double buildSeconds = MeasureSeconds([&]() { scene.Rebuild(); }, 1);
+    size_t objectCount = scene.GetObjectCount();
+
+    // 视锥体剔除：逐个对象测试世界包围盒与BVH遍历
+    Vector3f eye(0.0f, 2.0f, 0.0f);
+    Matrix view = Matrix::lookAt(eye, Vector3f(0.0f, 1.0f, -10.0f), Vector3f(0.0f, 1.0f, 0.0f));
+    Matrix projection = Matrix::perspective(toRadians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    Frustum frustum = Frustum::FromMatrix(projection * view);
+
+    std::vector<size_t> linearVisible;
+    std::vector<size_t> bvhVisible;
+    linearVisible.reserve(objectCount);
+    bvhVisible.reserve(objectCount);
+    double linearCullSeconds = MeasureSeconds([&]() {
+        linearVisible.clear();
+        for (size_t id = 0; id < scene.GetObjectCapacity(); id++) {
+            const Object* object = scene.GetObjectById(id);
+            if (!object) continue;
+            const MeshBounds& bounds = object->mesh.GetBounds();
+            Vector3f worldMin, worldMax;
+            TransformAABB(bounds.min, bounds.max, object->GetModelMatrix(), worldMin, worldMax);
+            if (frustum.IntersectsAABB(worldMin, worldMax)) {
+                linearVisible.push_back(id);
+            }
+        }
+    }, iterations);
+    double bvhCullSeconds = MeasureSeconds([&]() {
+        bvhVisible.clear();
+        scene.QueryFrustum(frustum, bvhVisible);
+    }, iterations);
+    std::sort(bvhVisible.begin(), bvhVisible.end());
+
+    // 包围盒查询：相机附近10x10的区域
+    Vector3f boxMin(-15.0f, -1.0f, -15.0f);
+    Vector3f boxMax(15.0f, 1.0f, 15.0f);
+    std::vector<size_t> linearBox;
+    std::vector<size_t> bvhBox;
+    double linearBoxSeconds = MeasureSeconds([&]() {
+        linearBox.clear();
+        for (size_t id = 0; id < scene.GetObjectCapacity(); id++) {
+            if (!scene.GetObjectById(id)) continue;
+            Vector3f worldMin, worldMax;
+            scene.GetWorldBounds(id, worldMin, worldMax);
+            if (worldMin.x <= boxMax.x && worldMax.x >= boxMin.x && worldMin.y <= boxMax.y && worldMax.y >= boxMin.y &&
+                worldMin.z <= boxMax.z && worldMax.z >= boxMin.z) {
+                linearBox.push_back(id);
+            }
+        }
+    }, iterations);
+    double bvhBoxSeconds = MeasureSeconds([&]() {
+        bvhBox.clear();
+        scene.QueryBox(boxMin, boxMax, bvhBox);
+    }, iterations);
+    std::sort(bvhBox.begin(), bvhBox.end());
+
+    // 射线拾取：从相机向800x600屏幕上均匀分布的点发射射线
+    Matrix inverseViewProj = (projection * view).inverse();
+    const int rayGrid = 32;
+    int rayHits = 0;
+    double raycastSeconds = MeasureSeconds([&]() {
+        rayHits = 0;
+        for (int j = 0; j < rayGrid; j++) {
+            for (int i = 0; i < rayGrid; i++) {
+                float ndcX = (i + 0.5f) / rayGrid * 2.0f - 1.0f;
+                float ndcY = (j + 0.5f) / rayGrid * 2.0f - 1.0f;
+                Vector4f farPoint = inverseViewProj * Vector4f(ndcX, ndcY, 1.0f, 1.0f);
+                Vector3f target(farPoint.x / farPoint.w, farPoint.y / farPoint.w, farPoint.z / farPoint.w);
+                RaycastHit hit;
+                if (scene.Raycast(eye, target - eye, hit)) {
+                    rayHits++;
+                }
+            }
+        }
+    }, iterations);
+
+    // 每帧移动1%的对象：refit与完全重建
+    size_t movedCount = (std::max)(objectCount / 100, static_cast<size_t>(1));
+    int frame = 0;
+    auto moveObjects = [&]() {
+        frame++;
+        for (size_t k = 0; k < movedCount; k++) {
+            size_t id = (k * 97 + frame * 13) % objectCount;
+            Object* object = scene.GetObjectById(id);
+            Vector3f position = object->transform.GetPosition();
+            position.y = (frame % 2 == 0) ? 0.0f : 0.5f;
+            object->transform.SetPosition(position);
+            scene.MarkTransformChanged(id);
+        }
+    };
+    int rebuildsBefore = scene.GetRebuildCount();
+    double refitSeconds = MeasureSeconds([&]() { moveObjects(); scene.Update(); }, iterations);
+    int rebuildsDuringRefit = scene.GetRebuildCount() - rebuildsBefore;
+    double rebuildSeconds = MeasureSeconds([&]() { moveObjects(); scene.Rebuild(); }, iterations);
+
+    report << objectCount << " objects (tree.obj, " << mesh.GetTriangleCount() << " triangles each), "
+           << scene.GetNodeCount() << " BVH nodes" << std::endl;
+    report << std::fixed << std::setprecision(3)
+           << "Build:                " << std::setw(10) << buildSeconds * 1000.0 << " ms" << std::endl
+           << "Frustum query linear: " << std::setw(10) << linearCullSeconds * 1000.0 << " ms" << std::endl
+           << "Frustum query BVH:    " << std::setw(10) << bvhCullSeconds * 1000.0 << " ms  ("
+           << linearCullSeconds / (std::max)(bvhCullSeconds, 1e-9) << "x), " << bvhVisible.size() << " visible, "
+           << (linearVisible == bvhVisible ? "same" : "DIFFERENT") << std::endl
+           << "Box query linear:     " << std::setw(10) << linearBoxSeconds * 1000.0 << " ms" << std::endl
+           << "Box query BVH:        " << std::setw(10) << bvhBoxSeconds * 1000.0 << " ms  ("
+           << linearBoxSeconds / (std::max)(bvhBoxSeconds, 1e-9) << "x), " << bvhBox.size() << " found, "
+           << (linearBox == bvhBox ? "same" : "DIFFERENT") << std::endl
+           << "Raycast:              " << std::setw(10) << raycastSeconds * 1000.0 << " ms for " << rayGrid * rayGrid
+           << " rays (" << rayHits << " hits)" << std::endl
+           << "Refit (" << movedCount << " moved):     " << std::setw(10) << refitSeconds * 1000.0 << " ms"
+           << (rebuildsDuringRefit > 0 ? "  (triggered rebuild)" : "") << std::endl
+           << "Full rebuild:         " << std::setw(10) << rebuildSeconds * 1000.0 << " ms" << std::endl;
+
+    return report.str();
+}
+
+std::string Benchmark::RunMeshletBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== Meshlet culling benchmark ===" << std::endl;
+
+    Renderer renderer(800, 600);
+    if (!renderer.Initialize(nullptr)) {
+        report << "  (renderer initialization failed)" << std::endl;
+        return report.str();
+    }
+    renderer.SetProjectionMatrix(Matrix::perspective(toRadians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f));
+    BlinnPhongShader shader;
+
+    // 从一侧观察整个模型，以及靠近后只有一部分在视野内
+    const struct {
+        const char* name;
+        Vector3f eye;
+    } views[] = {
+        { "side", Vector3f(0.0f, 0.5f, 3.0f) },
+        { "close-up", Vector3f(0.3f, 0.2f, 1.2f) }
+    };
+
+    report << std::left << std::setw(26) << "File"
+           << std::right << std::setw(10) << "Meshlets"
+           << std::setw(8) << "Verts"
+           << std::setw(8) << "Tris"
+           << std::setw(8) << "Cones"
+           << std::setw(10) << "Build(ms)" << std::endl;
+    std::ostringstream viewReport;
+    viewReport << std::left << std::setw(26) << "File / view"
+                 << std::right << std::setw(10) << "Off(ms)"
+                 << std::setw(10) << "On(ms)"
+                 << std::setw(8) << "Drawn"
+                 << std::setw(9) << "Frustum"
+                 << std::setw(10) << "Backface"
+                 << std::setw(11) << "Identical" << std::endl;
+
+    for (const char* file : kLoaderBenchmarkFiles) {
+        Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + file, ObjLoadOptions());
+        if (mesh.vertices.empty()) {
+            report << std::left << std::setw(26) << file << "  (missing)" << std::endl;
+            continue;
+        }
+        double buildSeconds = MeasureSeconds([&]() { MeshletBuilder::Build(mesh); }, iterations);
+
+        size_t coneCount = 0;
+        for (const Meshlet& meshlet : mesh.meshlets) {
+            if (meshlet.coneCutoff < 1.0f) {
+                coneCount++;
+            }
+        }
+        size_t meshletCount = (std::max)(mesh.meshlets.size(), static_cast<size_t>(1));
+        report << std::left << std::setw(26) << file
+               << std::right << std::setw(10) << mesh.meshlets.size()
+               << std::fixed << std::setprecision(1)
+               << std::setw(8) << static_cast<double>(mesh.meshletVertices.size()) / meshletCount
+               << std::setw(8) << static_cast<double>(mesh.GetTriangleCount()) / meshletCount
+               << std::setw(8) << coneCount
+               << std::setprecision(2) << std::setw(10) << buildSeconds * 1000.0 << std::endl;
+
+        Matrix modelMatrix = FitToUnitMatrix(mesh);
+        for (const auto& view : views) {
+            renderer.SetViewMatrix(Matrix::lookAt(view.eye, Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f)));
+            renderer.SetViewPosition(view.eye);
+            shader.SetViewPosition(view.eye);
+
+            auto drawFrame = [&]() {
+                renderer.ClearBackBuffer(Color::black);
+                renderer.DrawMesh(mesh, modelMatrix, &shader);
+            };
+
+            renderer.SetMeshletCulling(false);
+            double offSeconds = MeasureSeconds(drawFrame, iterations);
+            std::vector<unsigned char> offImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+            renderer.SetMeshletCulling(true);
+            double onSeconds = MeasureSeconds(drawFrame, iterations);
+            std::vector<unsigned char> onImage = CopyColorBuffer(renderer.GetFrameBuffer());
+            const Renderer::RenderStats& stats = renderer.GetStats();
+
+            viewReport << std::left << std::setw(26) << (std::string(file) + " " + view.name)
+                         << std::right << std::fixed << std::setprecision(2)
+                         << std::setw(10) << offSeconds * 1000.0
+                         << std::setw(10) << onSeconds * 1000.0
+                         << std::setw(8) << stats.meshletsDrawn
+                         << std::setw(9) << stats.meshletsFrustumCulled
+                         << std::setw(10) << stats.meshletsBackfaceCulled
+                         << std::setw(11) << (offImage == onImage ? "yes" : "no") << std::endl;
+        }
+    }
+    report << viewReport.str();
+
+    return report.str();
+}
+
+std::string Benchmark::RunLodBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== LOD benchmark ===" << std::endl;
+
+    // 顶点缩放到单位大小后再生成LOD（误差按缩放后的单位计算）
+    ObjLoadOptions options;
+    options.buildLods = false;
+    Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + "building_04.obj", options);
+    if (mesh.vertices.empty()) {
+        report << "building_04.obj  (missing)" << std::endl;
+        return report.str();
+    }
+    Matrix fitMatrix = FitToUnitMatrix(mesh);
+    for (Vertex& vertex : mesh.vertices) {
+        vertex.pos = fitMatrix * vertex.pos;
+    }
+    MeshletBuilder::Build(mesh);
+    double buildSeconds = MeasureSeconds([&]() { MeshSimplifier::BuildLods(mesh); }, 1);
+
+    report << std::left << std::setw(8) << "Level"
+           << std::right << std::setw(10) << "Tris"
+           << std::setw(10) << "Verts"
+           << std::setw(10) << "Meshlets"
+           << std::setw(12) << "Error" << std::endl;
+    for (size_t level = 0; level <= mesh.lods.size(); level++) {
+        const Mesh& lod = level == 0 ? mesh : mesh.lods[level - 1];
+        report << std::left << std::setw(8) << level
+               << std::right << std::setw(10) << lod.GetTriangleCount()
+               << std::setw(10) << lod.GetVertexCount()
+               << std::setw(10) << lod.meshlets.size()
+               << std::fixed << std::setprecision(5) << std::setw(12) << lod.lodError << std::endl;
+    }
+    report << std::fixed << std::setprecision(2)
+           << "LOD build: " << buildSeconds * 1000.0 << " ms" << std::endl;
+
+    Renderer renderer(800, 600);
+    if (!renderer.Initialize(nullptr)) {
+        report << "  (renderer initialization failed)" << std::endl;
+        return report.str();
+    }
+    float fovY = toRadians(45.0f);
+    renderer.SetProjectionMatrix(Matrix::perspective(fovY, 800.0f / 600.0f, 0.1f, 100.0f));
+    Vector3f eye(0.0f, 0.0f, 0.0f);
+    renderer.SetViewMatrix(Matrix::lookAt(eye, Vector3f(0.0f, 0.0f, -1.0f), Vector3f(0.0f, 1.0f, 0.0f)));
+    renderer.SetViewPosition(eye);
+    BlinnPhongShader shader;
+    shader.SetViewPosition(eye);
+
+    // 模型放在相机正前方的不同距离处，比较原网格与所选LOD
+    report << std::left << std::setw(10) << "Distance"
+           << std::right << std::setw(12) << "Radius(px)"
+           << std::setw(6) << "LOD"
+           << std::setw(10) << "Tris"
+           << std::setw(10) << "Full"
+           << std::setw(10) << "Off(ms)"
+           << std::setw(10) << "On(ms)"
+           << std::setw(10) << "Diff px" << std::endl;
+    const float distances[] = { 1.5f, 3.0f, 6.0f, 12.0f, 24.0f, 48.0f };
+    for (float distance : distances) {
+        Transformer transform;
+        transform.SetPosition(Vector3f(0.0f, 0.0f, -distance));
+        Object object(mesh, Material(), transform);
+        auto drawFrame = [&]() {
+            renderer.ClearBackBuffer(Color::black);
+            renderer.DrawObject(object, &shader);
+        };
+
+        renderer.SetLodSelection(false);
+        double offSeconds = MeasureSeconds(drawFrame, iterations);
+        std::vector<unsigned char> offImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+        renderer.SetLodSelection(true);
+        double onSeconds = MeasureSeconds(drawFrame, iterations);
+        std::vector<unsigned char> onImage = CopyColorBuffer(renderer.GetFrameBuffer());
+        const Renderer::RenderStats& stats = renderer.GetStats();
+
+        // 至少一个通道不同的像素数
+        const FrameBuffer* frameBuffer = renderer.GetFrameBuffer();
+        int channels = frameBuffer->colorBuffer.channel;
+        size_t diffPixels = 0;
+        for (size_t i = 0; i + channels <= offImage.size(); i += channels) {
+            if (!std::equal(offImage.begin() + i, offImage.begin() + i + channels, onImage.begin() + i)) {
+                diffPixels++;
+            }
+        }
+
+        float projectedRadius = mesh.GetBounds().radius / distance / std::tan(fovY * 0.5f) * 0.5f * 600.0f;
+        report << std::left << std::setw(10) << distance
+               << std::right << std::setw(12) << projectedRadius
+               << std::setw(6) << object.GetLodIndex()
+               << std::setw(10) << stats.trianglesSubmitted
+               << std::setw(10) << stats.trianglesFullDetail
+               << std::setw(10) << offSeconds * 1000.0
+               << std::setw(10) << onSeconds * 1000.0
+               << std::setw(10) << diffPixels << std::endl;
+    }
+
+    // 距离从近到远缓慢增加，同时每帧有少量抖动：没有滞后时在切换点附近来回切换
+    const int frames = 200;
+    const float hysteresisValues[] = { 0.0f, renderer.GetLodHysteresis() };
+    for (float hysteresis : hysteresisValues) {
+        renderer.SetLodHysteresis(hysteresis);
+        Object object(mesh, Material(), Transformer());
+        int switches = 0;
+        int lastLod = 0;
+        for (int frame = 0; frame < frames; frame++) {
+            float distance = 2.0f * std::pow(20.0f, static_cast<float>(frame) / (frames - 1));
+            distance *= 1.0f + 0.05f * std::sin(frame * 2.0f);
+            object.transform.SetPosition(Vector3f(0.0f, 0.0f, -distance));
+            renderer.ClearBackBuffer(Color::black);
+            renderer.DrawObject(object, &shader);
+            if (object.GetLodIndex() != lastLod) {
+                switches++;
+                lastLod = object.GetLodIndex();
+            }
+        }
+        report << "Hysteresis " << hysteresis << ": " << switches << " LOD switches over "
+               << frames << " frames (distance 2 -> 40 with 5% jitter)" << std::endl;
+    }
+
+    return report.str();
+}
+
+std::string Benchmark::RunInstancingBenchmark(const std::string& modelDirectory, int iterations) {
+    std::ostringstream report;
+    report << "=== Instancing benchmark ===" << std::endl;
+
+    // 实例化绘制不做LOD选择
+    ObjLoadOptions options;
+    options.buildLods = false;
+    Mesh mesh = ObjFileReader::LoadMeshFromFile(modelDirectory + "tree.obj", options);
+    if (mesh.vertices.empty()) {
+        report << "tree.obj  (missing)" << std::endl;
+        return report.str();
+    }
+    Matrix fitMatrix = FitToUnitMatrix(mesh);
+    for (Vertex& vertex : mesh.vertices) {
+        vertex.pos = fitMatrix * vertex.pos;
+    }
+    MeshletBuilder::Build(mesh);
+    const MeshBounds& bounds = mesh.GetBounds();
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 2.0f, 0.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye, Vector3f(0.0f, 1.0f, -10.0f))) {
+        return report.str();
+    }
+    BlinnPhongShader shader;
+    shader.SetViewPosition(eye);
+
+    report << "tree.obj, " << mesh.GetTriangleCount() << " triangles, " << mesh.GetVertexCount() << " vertices, "
+           << mesh.meshlets.size() << " meshlets, 800x600" << std::endl;
+    report << std::left << std::setw(12) << "Instances"
+           << std::setw(10) << "Path"
+           << std::right << std::setw(12) << "Loop(ms)"
+           << std::setw(12) << "Inst(ms)"
+           << std::setw(10) << "Speedup"
+           << std::setw(13) << "Colored(ms)"
+           << std::setw(8) << "Drawn"
+           << std::setw(9) << "Culled"
+           << std::setw(7) << "Same" << std::endl;
+
+    const size_t instanceCounts[] = { 1000, 10000, 100000 };
+    for (size_t instanceCount : instanceCounts) {
+        // 间距3的方阵，相机位于中心，实例越多视锥体外的比例越高
+        int gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(instanceCount))));
+        float spacing = 3.0f;
+        float offset = (gridSize - 1) * spacing * 0.5f;
+        std::vector<Matrix> matrices;
+        std::vector<InstanceData> instances;
+        matrices.reserve(instanceCount);
+        instances.reserve(instanceCount);
+        for (size_t i = 0; i < instanceCount; i++) {
+            int x = static_cast<int>(i % gridSize);
+            int z = static_cast<int>(i / gridSize);
+            Transformer transform;
+            transform.SetPosition(Vector3f(x * spacing - offset, 0.0f, z * spacing - offset));
+            transform.SetRotation(Vector3f(0.0f, (x * 37 + z * 11) % 360, 0.0f));
+            matrices.push_back(transform.GetModelMatrix());
+            Vector4f color(0.5f + 0.5f * ((x * 7) % 5) / 4.0f, 0.5f + 0.5f * ((z * 3) % 5) / 4.0f, 0.75f, 1.0f);
+            instances.push_back(InstanceData(matrices.back(), color));
+        }
+
+        const bool meshletValues[] = { true, false };
+        for (bool meshlets : meshletValues) {
+            renderer.SetMeshletCulling(meshlets);
+
+            // 不使用实例化：逐个实例测试世界包围盒后调用DrawMesh
+            double loopSeconds = MeasureSeconds([&]() {
+                renderer.ClearBackBuffer(Color::black);
+                const Frustum& frustum = renderer.GetFrustum();
+                for (const Matrix& matrix : matrices) {
+                    Vector3f worldMin, worldMax;
+                    TransformAABB(bounds.min, bounds.max, matrix, worldMin, worldMax);
+                    if (frustum.IntersectsAABB(worldMin, worldMax)) {
+                        renderer.DrawMesh(mesh, matrix, &shader);
+                    }
+                }
+            }, iterations);
+            std::vector<unsigned char> loopImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+            double instancedSeconds = MeasureSeconds([&]() {
+                renderer.ClearBackBuffer(Color::black);
+                renderer.DrawMeshInstanced(mesh, matrices.data(), matrices.size(), &shader);
+            }, iterations);
+            std::vector<unsigned char> instancedImage = CopyColorBuffer(renderer.GetFrameBuffer());
+            Renderer::RenderStats stats = renderer.GetStats();
+
+            double coloredSeconds = MeasureSeconds([&]() {
+                renderer.ClearBackBuffer(Color::black);
+                renderer.DrawMeshInstanced(mesh, instances, &shader);
+            }, iterations);
+
+            report << std::left << std::setw(12) << instanceCount
+                   << std::setw(10) << (meshlets ? "meshlet" : "whole")
+                   << std::right << std::fixed << std::setprecision(2)
+                   << std::setw(12) << loopSeconds * 1000.0
+                   << std::setw(12) << instancedSeconds * 1000.0
+                   << std::setw(9) << loopSeconds / (std::max)(instancedSeconds, 1e-9) << "x"
+                   << std::setw(13) << coloredSeconds * 1000.0
+                   << std::setw(8) << stats.instancesDrawn
+                   << std::setw(9) << stats.instancesCulled
+                   << std::setw(7) << (loopImage == instancedImage ? "yes" : "NO") << std::endl;
+        }
+    }
+    renderer.SetMeshletCulling(true);
+
+    return report.str();
+}
+
+std::string Benchmark::RunTransformBenchmark(int objectCount, int iterations) {
+    std::ostringstream report;
+    report << "=== Transform benchmark ===" << std::endl;
+
+    std::vector<Transformer> transforms(objectCount);
+    for (int i = 0; i < objectCount; i++) {
+        transforms[i].SetPosition(Vector3f(i * 0.1f, (i % 7) * 0.5f, -(i % 13) * 0.25f));
+        transforms[i].SetRotation(Vector3f((i * 13) % 360, (i * 37) % 360, (i * 71) % 360));
+        transforms[i].SetScale(Vector3f(1.0f + (i % 3) * 0.5f, 1.0f, 1.0f + (i % 5) * 0.25f));
+    }
+
+    // 修改前的做法：每次读取都由欧拉角构建5个矩阵并做4次4x4矩阵乘法
+    std::vector<Matrix> eulerMatrices(objectCount);
+    double eulerSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < objectCount; i++) {
+            const Transformer& transform = transforms[i];
+            const Vector3f& rotation = transform.GetRotation();
+            eulerMatrices[i] = Matrix::translate(transform.GetPosition()) * Matrix::rotate(rotation.z, 'z') *
+                Matrix::rotate(rotation.y, 'y') * Matrix::rotate(rotation.x, 'x') * Matrix::scale(transform.GetScale());
+        }
+    }, iterations);
+
+    // 变换改变后重新计算：四元数转旋转矩阵后按列乘以缩放
+    std::vector<Matrix> cachedMatrices(objectCount);
+    double rebuildSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < objectCount; i++) {
+            transforms[i].SetPosition(transforms[i].GetPosition());
+            cachedMatrices[i] = transforms[i].GetModelMatrix();
+        }
+    }, iterations);
+
+    // 变换不变时的读取（绘制、包围盒和中心点各读取一次）
+    float checksum = 0.0f;
+    double cachedSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < objectCount; i++) {
+            for (int read = 0; read < 3; read++) {
+                checksum += transforms[i].GetModelMatrix().m[0][3];
+            }
+        }
+    }, iterations);
+
+    float maxError = 0.0f;
+    for (int i = 0; i < objectCount; i++) {
+        for (int row = 0; row < 4; row++) {
+            for (int column = 0; column < 4; column++) {
+                maxError = (std::max)(maxError, std::abs(eulerMatrices[i].m[row][column] - cachedMatrices[i].m[row][column]));
+            }
+        }
+    }
+
+    report << objectCount << " transforms" << std::endl;
+    report << std::fixed << std::setprecision(3)
+           << "Euler, 4 multiplies:  " << std::setw(10) << eulerSeconds * 1000.0 << " ms" << std::endl
+           << "Quaternion rebuild:   " << std::setw(10) << rebuildSeconds * 1000.0 << " ms  ("
+           << eulerSeconds / (std::max)(rebuildSeconds, 1e-9) << "x), max difference " << std::scientific
+           << std::setprecision(2) << maxError << std::fixed << std::setprecision(3) << std::endl
+           << "Cached, 3 reads:      " << std::setw(10) << cachedSeconds * 1000.0 << " ms  ("
+           << eulerSeconds * 3.0 / (std::max)(cachedSeconds, 1e-9) << "x vs 3 Euler builds)" << std::endl;
+
+    // 层级：每棵树为根 -> 10个子对象 -> 每个子对象9个孙对象，共101个对象
+    Mesh triangle;
+    Vertex vertex;
+    vertex.pos = Vector4f(0.0f, 0.0f, 0.0f, 1.0f);
+    triangle.vertices.push_back(vertex);
+    vertex.pos = Vector4f(1.0f, 0.0f, 0.0f, 1.0f);
+    triangle.vertices.push_back(vertex);
+    vertex.pos = Vector4f(0.0f, 1.0f, 0.0f, 1.0f);
+    triangle.vertices.push_back(vertex);
+    triangle.indices.push_back(Vector3i(0, 1, 2));
+
+    Scene scene;
+    std::vector<size_t> roots;
+    int treeCount = (std::max)(1, objectCount / 101);
+    for (int tree = 0; tree < treeCount; tree++) {
+        Transformer rootTransform;
+        rootTransform.SetPosition(Vector3f((tree % 10) * 20.0f, 0.0f, (tree / 10) * 20.0f));
+        size_t root = scene.AddObject(Object(triangle, Material(), rootTransform));
+        roots.push_back(root);
+        for (int c = 0; c < 10; c++) {
+            Transformer childTransform;
+            childTransform.SetPosition(Vector3f(c * 1.5f, 0.0f, 0.0f));
+            childTransform.SetRotation(Vector3f(0.0f, c * 36.0f, 0.0f));
+            size_t child = scene.AddObject(Object(triangle, Material(), childTransform));
+            scene.SetParent(child, root);
+            for (int g = 0; g < 9; g++) {
+                Transformer grandchildTransform;
+                grandchildTransform.SetPosition(Vector3f(0.0f, g * 0.5f, 0.0f));
+                grandchildTransform.SetScale(Vector3f(0.5f, 0.5f, 0.5f));
+                scene.SetParent(scene.AddObject(Object(triangle, Material(), grandchildTransform)), child);
+            }
+        }
+    }
+    scene.Update();
+
+    report << scene.GetObjectCount() << " objects in " << roots.size() << " hierarchies (root -> 10 -> 90)" << std::endl;
+    report << std::left << std::setw(16) << "Roots moved"
+           << std::right << std::setw(10) << "Updated"
+           << std::setw(14) << "Update(ms)"
+           << std::setw(14) << "Frame(ms)" << std::endl;
+    const size_t movedCounts[] = { 1, roots.size() / 10, roots.size() };
+    int frame = 0;
+    for (size_t movedCount : movedCounts) {
+        auto moveRoots = [&]() {
+            frame++;
+            for (size_t k = 0; k < movedCount; k++) {
+                size_t id = roots[(k + frame) % roots.size()];
+                scene.GetObjectById(id)->transform.Rotate(Vector3f(0.0f, 1.0f, 0.0f));
+                scene.MarkTransformChanged(id);
+            }
+        };
+
+        // 只更新世界矩阵，以及包括BVH refit的整帧更新
+        double updateSeconds = MeasureSeconds([&]() { moveRoots(); scene.UpdateTransforms(); }, iterations);
+        size_t updatedCount = scene.GetUpdatedTransformCount();
+        double frameSeconds = MeasureSeconds([&]() { moveRoots(); scene.Update(); }, iterations);
+        report << std::left << std::setw(16) << movedCount
+               << std::right << std::fixed << std::setprecision(3) << std::setw(10) << updatedCount
+               << std::setw(14) << updateSeconds * 1000.0
+               << std::setw(14) << frameSeconds * 1000.0 << std::endl;
+    }
+
+    // 子对象的世界矩阵与逐级相乘的结果一致
+    float hierarchyError = 0.0f;
+    for (size_t id = 0; id < scene.GetObjectCapacity(); id++) {
+        const Object* object = scene.GetObjectById(id);
+        Matrix expected = object->transform.GetModelMatrix();
+        for (size_t parent = scene.GetParent(id); parent != Scene::kInvalidId; parent = scene.GetParent(parent)) {
+            expected = scene.GetObjectById(parent)->transform.GetModelMatrix() * expected;
+        }
+        for (int row = 0; row < 4; row++) {
+            for (int column = 0; column < 4; column++) {
+                hierarchyError = (std::max)(hierarchyError, std::abs(expected.m[row][column] - object->GetModelMatrix().m[row][column]));
+            }
+        }
+    }
+    report << "World matrices match parent chain: " << (hierarchyError < 1e-4f ? "yes" : "NO")
+           << " (max difference " << std::scientific << std::setprecision(2) << hierarchyError << ")" << std::endl;
+
+    return report.str();
+}
+
+namespace {
+
+// 修改前的标量矩阵乘法（与Matrix.cpp中的非SIMD版本相同），作为对比基准
+Matrix ScalarMultiply(const Matrix& a, const Matrix& b) {
+    Matrix result;
+    for (int i = 0; i < 4; i++) {
+        const float a0 = a.m[i][0], a1 = a.m[i][1], a2 = a.m[i][2], a3 = a.m[i][3];
+        for (int j = 0; j < 4; j++) {
+            result.m[i][j] = a0 * b.m[0][j] + a1 * b.m[1][j] + a2 * b.m[2][j] + a3 * b.m[3][j];
+        }
+    }
+    return result;
+}
+
+Vector4f ScalarTransform(const Matrix& m, const Vector4f& v) {
+    return Vector4f(m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z + m.m[0][3] * v.w,
+                    m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z + m.m[1][3] * v.w,
+                    m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z + m.m[2][3] * v.w,
+                    m.m[3][0] * v.x + m.m[3][1] * v.y + m.m[3][2] * v.z + m.m[3][3] * v.w);
+}
+
+// 两个矩阵前size行size列的最大差值
+float MaxDifference(const Matrix& a, const Matrix& b, int size = 4) {
+    float difference = 0.0f;
+    for (int row = 0; row < size; row++) {
+        for (int column = 0; column < size; column++) {
+            difference = (std::max)(difference, std::abs(a.m[row][column] - b.m[row][column]));
+        }
+    }
+    return difference;
+}
+
+float MaxDifference(const Vector4f& a, const Vector4f& b) {
+    return (std::max)((std::max)(std::abs(a.x - b.x), std::abs(a.y - b.y)),
+                      (std::max)(std::abs(a.z - b.z), std::abs(a.w - b.w)));
+}
+
+// 输出一行测试结果
+void ReportMathRow(std::ostringstream& report, const char* name, double scalarSeconds, double simdSeconds, float maxDifference) {
+    report << std::left << std::setw(24) << name
+           << std::right << std::fixed << std::setprecision(3)
+           << std::setw(12) << scalarSeconds * 1000.0
+           << std::setw(12) << simdSeconds * 1000.0
+           << std::setw(9) << scalarSeconds / (std::max)(simdSeconds, 1e-9) << "x"
+           << std::setw(14) << std::scientific << std::setprecision(2) << maxDifference << std::endl;
+}
+
+} // namespace
+
+std::string Benchmark::RunMathBenchmark(int count, int iterations) {
+    std::ostringstream report;
+    report << "=== Matrix math benchmark ===" << std::endl;
+#if defined(XYH_SIMD_AVX2)
+    report << "SIMD: AVX2" << std::endl;
+#elif defined(XYH_SIMD_SSE2)
+    report << "SIMD: SSE2" << std::endl;
+#else
+    report << "SIMD: none (scalar fallback)" << std::endl;
+#endif
+
+    // 仿射的模型矩阵（旋转、非均匀缩放和平移）和齐次坐标的点
+    std::vector<Matrix> matrices(count);
+    std::vector<Vector4f> points(count);
+    std::vector<Vector3f> positions(count);
+    for (int i = 0; i < count; i++) {
+        Transformer transform;
+        transform.SetPosition(Vector3f((i % 101) * 0.5f, (i % 7) - 3.0f, -(i % 53) * 0.25f));
+        transform.SetRotation(Vector3f((i * 13) % 360, (i * 37) % 360, (i * 71) % 360));
+        transform.SetScale(Vector3f(0.5f + (i % 3) * 0.75f, 1.0f + (i % 4) * 0.5f, 0.25f + (i % 5) * 0.5f));
+        matrices[i] = transform.GetModelMatrix();
+        positions[i] = Vector3f((i % 17) * 0.1f - 0.8f, (i % 29) * 0.05f - 0.7f, (i % 11) * 0.2f - 1.0f);
+        points[i] = Vector4f(positions[i], 1.0f);
+    }
+    const Matrix viewProjection = Matrix::perspective(toRadians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+        Matrix::lookAt(Vector3f(0.0f, 2.0f, 5.0f), Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f));
+
+    report << count << " matrices / points, best of " << iterations << std::endl;
+    report << std::left << std::setw(24) << "Operation"
+           << std::right << std::setw(12) << "Scalar(ms)"
+           << std::setw(12) << "SIMD(ms)"
+           << std::setw(10) << "Speedup"
+           << std::setw(14) << "Max diff" << std::endl;
+
+    // 矩阵乘矩阵（视图投影乘模型矩阵）
+    std::vector<Matrix> scalarMatrices(count);
+    std::vector<Matrix> simdMatrices(count);
+    double scalarSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            scalarMatrices[i] = ScalarMultiply(viewProjection, matrices[i]);
+        }
+    }, iterations);
+    double simdSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            simdMatrices[i] = viewProjection * matrices[i];
+        }
+    }, iterations);
+    float difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxDifference(scalarMatrices[i], simdMatrices[i]));
+    }
+    ReportMathRow(report, "Matrix * Matrix", scalarSeconds, simdSeconds, difference);
+
+    // 矩阵乘向量（每个点用各自的模型矩阵）
+    std::vector<Vector4f> scalarPoints(count);
+    std::vector<Vector4f> simdPoints(count);
+    scalarSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            scalarPoints[i] = ScalarTransform(matrices[i], points[i]);
+        }
+    }, iterations);
+    simdSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            simdPoints[i] = matrices[i] * points[i];
+        }
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxDifference(scalarPoints[i], simdPoints[i]));
+    }
+    ReportMathRow(report, "Matrix * Vector4", scalarSeconds, simdSeconds, difference);
+
+    // 同一矩阵批量变换点
+    scalarSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            scalarPoints[i] = ScalarTransform(viewProjection, points[i]);
+        }
+    }, iterations);
+    simdSeconds = MeasureSeconds([&]() {
+        viewProjection.transformPoints(points.data(), simdPoints.data(), count);
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxDifference(scalarPoints[i], simdPoints[i]));
+    }
+    ReportMathRow(report, "Batch Vector4", scalarSeconds, simdSeconds, difference);
+
+    std::vector<Vector3f> simdPositions(count);
+    simdSeconds = MeasureSeconds([&]() {
+        viewProjection.transformPoints(positions.data(), simdPositions.data(), count);
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxDifference(scalarPoints[i], Vector4f(simdPositions[i], scalarPoints[i].w)));
+    }
+    ReportMathRow(report, "Batch Vector3 (w = 1)", scalarSeconds, simdSeconds, difference);
+
+    // 仿射矩阵求逆：通用的4x4求逆与3x3伴随矩阵求逆
+    scalarSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            scalarMatrices[i] = matrices[i].inverse();
+        }
+    }, iterations);
+    simdSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            simdMatrices[i] = matrices[i].inverseAffine();
+        }
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxDifference(scalarMatrices[i], simdMatrices[i]));
+    }
+    ReportMathRow(report, "inverse / inverseAffine", scalarSeconds, simdSeconds, difference);
+
+    // 法线矩阵：只比较左上3x3（对w为0的法线起作用的部分）
+    scalarSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            scalarMatrices[i] = matrices[i].transpose().inverse();
+        }
+    }, iterations);
+    simdSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            simdMatrices[i] = matrices[i].normalMatrix();
+        }
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxDifference(scalarMatrices[i], simdMatrices[i], 3));
+    }
+    ReportMathRow(report, "Normal matrix", scalarSeconds, simdSeconds, difference);
+
+    return report.str();
+}
+
+namespace {
+
+// 相对误差：|a - b| / max(1, |b|)，平移等较大的元素按相对值比较
+float MaxRelativeDifference(const Matrix& a, const Matrix& b) {
+    float difference = 0.0f;
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            float scale = (std::max)(1.0f, std::abs(b.m[row][column]));
+            difference = (std::max)(difference, std::abs(a.m[row][column] - b.m[row][column]) / scale);
+        }
+    }
+    return difference;
+}
+
+// 输出一行测试结果：通用的Matrix实现与专用变换类型的耗时和最大相对误差
+void ReportAffineRow(std::ostringstream& report, const char* name, double generalSeconds, double specialSeconds, float maxDifference) {
+    report << std::left << std::setw(20) << name
+           << std::right << std::fixed << std::setprecision(3)
+           << std::setw(13) << generalSeconds * 1000.0
+           << std::setw(13) << specialSeconds * 1000.0
+           << std::setw(9) << generalSeconds / (std::max)(specialSeconds, 1e-9) << "x"
+           << std::setw(14) << std::scientific << std::setprecision(2) << maxDifference << std::endl;
+}
+
+} // namespace
+
+std::string Benchmark::RunAffineBenchmark(int count, int iterations) {
+    std::ostringstream report;
+    report << "=== Affine / rigid transform benchmark ===" << std::endl;
+
+    // 仿射变换（旋转、非均匀缩放和平移）与刚体变换（旋转和平移）
+    std::vector<Matrix> affineMatrices(count);
+    std::vector<Matrix> rigidMatrices(count);
+    std::vector<Affine3> affines(count);
+    std::vector<RigidTransform> rigids(count);
+    for (int i = 0; i < count; i++) {
+        Vector3f position((i % 101) * 0.5f, (i % 7) - 3.0f, -(i % 53) * 0.25f);
+        Quaternion rotation = Quaternion::fromEuler(Vector3f((i * 13) % 360, (i * 37) % 360, (i * 71) % 360));
+        Vector3f scale(0.5f + (i % 3) * 0.75f, 1.0f + (i % 4) * 0.5f, 0.25f + (i % 5) * 0.5f);
+        affines[i] = Affine3::fromTRS(position, rotation, scale);
+        affineMatrices[i] = affines[i].toMatrix();
+        rigids[i] = RigidTransform(rotation, position);
+        rigidMatrices[i] = rigids[i].toMatrix();
+    }
+
+    report << count << " transforms, best of " << iterations << ", difference relative to Matrix" << std::endl;
+    report << std::left << std::setw(20) << "Operation"
+           << std::right << std::setw(13) << "Matrix(ms)"
+           << std::setw(13) << "Special(ms)"
+           << std::setw(10) << "Speedup"
+           << std::setw(14) << "Max diff" << std::endl;
+
+    // 求逆：通用的4x4伴随矩阵求逆与专用的逆
+    std::vector<Matrix> generalResults(count);
+    std::vector<Affine3> affineResults(count);
+    std::vector<RigidTransform> rigidResults(count);
+    double generalSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            generalResults[i] = affineMatrices[i].inverse();
+        }
+    }, iterations);
+    double specialSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            affineResults[i] = affines[i].inverse();
+        }
+    }, iterations);
+    float difference = 0.0f;
+    float roundTripError = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxRelativeDifference(affineResults[i].toMatrix(), generalResults[i]));
+        roundTripError = (std::max)(roundTripError, MaxDifference((affines[i] * affineResults[i]).toMatrix(), Matrix::identity()));
+    }
+    ReportAffineRow(report, "Affine3 inverse", generalSeconds, specialSeconds, difference);
+    bool affineInverseOk = difference < 1e-4f && roundTripError < 1e-4f;
+
+    generalSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            generalResults[i] = rigidMatrices[i].inverse();
+        }
+    }, iterations);
+    specialSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            rigidResults[i] = rigids[i].inverse();
+        }
+    }, iterations);
+    difference = 0.0f;
+    float rigidRoundTripError = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxRelativeDifference(rigidResults[i].toMatrix(), generalResults[i]));
+        rigidRoundTripError = (std::max)(rigidRoundTripError, MaxDifference((rigids[i] * rigidResults[i]).toMatrix(), Matrix::identity()));
+    }
+    ReportAffineRow(report, "Rigid inverse", generalSeconds, specialSeconds, difference);
+    bool rigidInverseOk = difference < 1e-4f && rigidRoundTripError < 1e-4f;
+
+    // 复合：相邻两个变换相乘（4x4矩阵乘法与不计算最后一行的复合）
+    generalSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            generalResults[i] = affineMatrices[i] * affineMatrices[(i + 1) % count];
+        }
+    }, iterations);
+    specialSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            affineResults[i] = affines[i] * affines[(i + 1) % count];
+        }
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxRelativeDifference(affineResults[i].toMatrix(), generalResults[i]));
+    }
+    ReportAffineRow(report, "Affine3 compose", generalSeconds, specialSeconds, difference);
+    bool composeOk = difference < 1e-6f;
+
+    generalSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            generalResults[i] = rigidMatrices[i] * rigidMatrices[(i + 1) % count];
+        }
+    }, iterations);
+    specialSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < count; i++) {
+            rigidResults[i] = rigids[i] * rigids[(i + 1) % count];
+        }
+    }, iterations);
+    difference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        difference = (std::max)(difference, MaxRelativeDifference(rigidResults[i].toMatrix(), generalResults[i]));
+    }
+    ReportAffineRow(report, "Rigid compose", generalSeconds, specialSeconds, difference);
+    composeOk = composeOk && difference < 1e-6f;
+
+    // 正确性检查
+    report << std::fixed;
+    report << "Affine3 inverse matches Matrix::inverse: " << (affineInverseOk ? "yes" : "NO")
+           << " (A * A^-1 max deviation from identity " << std::scientific << std::setprecision(2) << roundTripError << ")" << std::endl;
+    report << "Rigid inverse matches Matrix::inverse:   " << (rigidInverseOk ? "yes" : "NO")
+           << " (R * R^-1 max deviation from identity " << std::scientific << std::setprecision(2) << rigidRoundTripError << ")" << std::endl;
+    report << "Composition matches Matrix product:      " << (composeOk ? "yes" : "NO") << std::endl;
+
+    // 不可逆（缩放为0）时与Matrix::inverse一致，返回单位矩阵
+    Affine3 singular = Affine3::fromTRS(Vector3f(1.0f, 2.0f, 3.0f), Quaternion::identity(), Vector3f(1.0f, 0.0f, 1.0f));
+    bool singularOk = MaxDifference(singular.inverse().toMatrix(), singular.toMatrix().inverse()) == 0.0f &&
+                      MaxDifference(singular.inverse().toMatrix(), Matrix::identity()) == 0.0f;
+    report << "Singular transform returns identity:     " << (singularOk ? "yes" : "NO") << std::endl;
+
+    // 视图变换：RigidTransform::lookAt与Matrix::lookAt一致，相机射线与反投影的结果一致
+    Camera camera(Vector3f(3.0f, 2.0f, 6.0f), Vector3f(0.0f, 0.5f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f), 60.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    float lookAtDifference = MaxDifference(camera.viewTransform.toMatrix(),
+        Matrix::lookAt(camera.position, camera.target, camera.up));
+    report << "RigidTransform::lookAt matches Matrix:   " << (lookAtDifference == 0.0f ? "yes" : "NO") << std::endl;
+
+    const int width = 800, height = 600;
+    Matrix inverseViewProj = (camera.projMatrix * camera.GetViewMatrix()).inverse();
+    float rayDifference = 0.0f;
+    for (int y = 0; y <= height; y += 50) {
+        for (int x = 0; x <= width; x += 50) {
+            Vector3f origin, direction;
+            camera.ScreenPointToRay((float)x, (float)y, width, height, origin, direction);
+
+            float ndcX = (float)x / width * 2.0f - 1.0f;
+            float ndcY = 1.0f - (float)y / height * 2.0f;
+            Vector4f nearPoint = inverseViewProj * Vector4f(ndcX, ndcY, -1.0f, 1.0f);
+            Vector4f farPoint = inverseViewProj * Vector4f(ndcX, ndcY, 1.0f, 1.0f);
+            nearPoint /= nearPoint.w;
+            farPoint /= farPoint.w;
+            Vector3f expectedDirection(farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z);
+            expectedDirection.normalize();
+            rayDifference = (std::max)(rayDifference, MaxDifference(Vector4f(origin, 1.0f), Vector4f(nearPoint.x, nearPoint.y, nearPoint.z, 1.0f)));
+            rayDifference = (std::max)(rayDifference, MaxDifference(Vector4f(direction, 0.0f), Vector4f(expectedDirection, 0.0f)));
+        }
+    }
+    report << "Camera rays match unprojection:          " << (rayDifference < 1e-4f ? "yes" : "NO")
+           << " (max difference " << std::scientific << std::setprecision(2) << rayDifference << ")" << std::endl;
+
+    // 汇总：任何一项不一致时在报告中醒目地标出
+    const bool checks[] = { affineInverseOk, rigidInverseOk, composeOk, singularOk, lookAtDifference == 0.0f, rayDifference < 1e-4f };
+    const int checkCount = static_cast<int>(sizeof(checks) / sizeof(checks[0]));
+    int failedChecks = 0;
+    for (bool ok : checks) {
+        failedChecks += ok ? 0 : 1;
+    }
+    if (failedChecks == 0) {
+        report << "Correctness checks: all " << checkCount << " passed" << std::endl;
+    } else {
+        report << "*** Correctness checks FAILED: " << failedChecks << " of " << checkCount << " ***" << std::endl;
+    }
+
+    return report.str();
+}
+
+namespace {
+
+// 字符串中pattern出现的次数
+size_t CountOccurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size())) {
+        count++;
+    }
+    return count;
+}
+
+// trace中名称为name、类型为phase的事件的field字段之和
+double SumTraceField(const std::string& trace, const char* name, const char* phase, const char* field) {
+    std::string key = std::string("{\"name\":\"") + name + "\",\"ph\":\"" + phase + "\"";
+    std::string fieldKey = std::string("\"") + field + "\":";
+    double sum = 0.0;
+    for (size_t pos = trace.find(key); pos != std::string::npos; pos = trace.find(key, pos + key.size())) {
+        size_t value = trace.find(fieldKey, pos);
+        if (value != std::string::npos) {
+            sum += std::atof(trace.c_str() + value + fieldKey.size());
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+std::string Benchmark::RunProfilerBenchmark(const std::string& modelDirectory, int frames) {
+    std::ostringstream report;
+    report << "=== Profiler benchmark ===" << std::endl;
+
+    std::vector<Mesh> meshes;
+    std::vector<Matrix> modelMatrices;
+    if (!LoadBenchmarkScene(report, modelDirectory, meshes, modelMatrices)) {
+        return report.str();
+    }
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 0.5f, 3.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye)) {
+        return report.str();
+    }
+    BlinnPhongShader shader;
+    shader.SetViewPosition(eye);
+
+    auto renderFrame = [&]() {
+        Profiler::BeginFrame();
+        renderer.ClearBackBuffer(Color::black);
+        DrawBenchmarkScene(renderer, meshes, modelMatrices, shader);
+    };
+    report << meshes.size() << " meshes per frame, 800x600, " << frames << " frames" << std::endl;
+
+    Profiler::SetEnabled(false);
+    double offSeconds = MeasureSeconds(renderFrame, frames);
+    std::vector<unsigned char> offImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    // 开启后的下一帧开始完整记录；最后再开始一帧，写入最后一帧的帧事件和阶段计数器
+    Profiler::SetEnabled(true);
+    int firstFrame = Profiler::GetFrameIndex() + 1;
+    double onSeconds = MeasureSeconds(renderFrame, frames);
+    std::vector<unsigned char> onImage = CopyColorBuffer(renderer.GetFrameBuffer());
+    Profiler::BeginFrame();
+    int lastFrame = Profiler::GetFrameIndex() - 1;
+    Profiler::SetEnabled(false);
+
+    report << std::fixed << std::setprecision(2);
+    report << "Frame time, recording off:   " << offSeconds * 1000.0 << " ms" << std::endl;
+    report << "Frame time, recording on:    " << onSeconds * 1000.0 << " ms ("
+           << std::showpos << (onSeconds / (std::max)(offSeconds, 1e-9) - 1.0) * 100.0 << std::noshowpos << "%)" << std::endl;
+    report << "Image identical:             " << (offImage == onImage ? "yes" : "NO") << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string trace = Profiler::ExportChromeTrace(firstFrame, lastFrame);
+    double exportSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    int frameCount = lastFrame - firstFrame + 1;
+    size_t frameEvents = CountOccurrences(trace, "{\"name\":\"Frame\",\"ph\":\"X\"");
+    bool wellFormed = trace.compare(0, 16, "{\"traceEvents\":[") == 0 &&
+                      trace.find("],\"displayTimeUnit\":\"ms\"}") != std::string::npos;
+    report << "Trace frames " << firstFrame << "-" << lastFrame << ": "
+           << CountOccurrences(trace, "\"ph\":\"X\"") << " scopes, "
+           << CountOccurrences(trace, "\"ph\":\"C\"") << " counters, "
+           << trace.size() / 1024.0 << " KB, export " << exportSeconds * 1000.0 << " ms" << std::endl;
+    report << "Frame events / frames:       " << frameEvents << " / " << frameCount
+           << (frameEvents == static_cast<size_t>(frameCount) && wellFormed ? "  (ok)" : "  (MISMATCH)") << std::endl;
+
+    // 各阶段的每帧耗时（阶段互不重叠，总和不超过帧事件的时间）
+    double frameMilliseconds = SumTraceField(trace, "Frame", "X", "dur") / 1000.0 / (std::max)(frameCount, 1);
+    report << std::left << std::setw(16) << "Stage" << std::right << std::setw(14) << "ms/frame" << std::endl;
+    double stageTotal = 0.0;
+    for (int i = 0; i < static_cast<int>(ProfileStage::Count); i++) {
+        const char* name = Profiler::GetStageName(static_cast<ProfileStage>(i));
+        double milliseconds = SumTraceField(trace, name, "C", "ms") / (std::max)(frameCount, 1);
+        stageTotal += milliseconds;
+        report << std::left << std::setw(16) << name << std::right << std::setw(14) << milliseconds << std::endl;
+    }
+    report << std::left << std::setw(16) << "Total" << std::right << std::setw(14) << stageTotal
+           << "  (" << stageTotal / (std::max)(frameMilliseconds, 1e-9) * 100.0 << "% of " << frameMilliseconds << " ms frame event)" << std::endl;
+
+    // 多线程解析：每个解析线程写入自己的缓冲区
+    ObjLoadOptions options;
+    options.threadCount = 4;
+    Profiler::SetEnabled(true);
+    Profiler::BeginFrame();
+    int loadFrame = Profiler::GetFrameIndex();
+    Mesh loaded = ObjFileReader::LoadMeshFromFile(modelDirectory + kParallelBenchmarkFile, options);
+    Profiler::BeginFrame();
+    Profiler::SetEnabled(false);
+    std::string loadTrace = Profiler::ExportChromeTrace(loadFrame, loadFrame);
+    report << kParallelBenchmarkFile << " load (4 threads): "
+           << CountOccurrences(loadTrace, "{\"name\":\"ParseObj\"") << " ParseObj scopes, "
+           << CountOccurrences(loadTrace, "\"args\":{\"name\":\"ObjParser\"") << " buffers named ObjParser, "
+           << CountOccurrences(loadTrace, "\"ph\":\"X\"") << " scopes in total" << std::endl;
+
+    return report.str();
+}
+
+std::string Benchmark::RunPipelineStatisticsBenchmark(const std::string& modelDirectory, int frames) {
+    std::ostringstream report;
+    report << "=== Pipeline statistics benchmark ===" << std::endl;
+
+    std::vector<std::string> names;
+    std::vector<Mesh> meshes;
+    std::vector<Matrix> modelMatrices;
+    if (!LoadBenchmarkScene(report, modelDirectory, meshes, modelMatrices, &names)) {
+        return report.str();
+    }
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 0.5f, 3.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye)) {
+        return report.str();
+    }
+
+    // 三线性过滤的纹理，按Mipmap级别统计采样
+    Texture texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color(0.2f, 0.2f, 0.2f, 1.0f));
+    texture.GenerateMipmaps();
+    texture.SetFilterMode(TextureFilterMode::TRILINEAR);
+    TextureShader shader;
+    shader.SetTexture(&texture);
+
+    // 与DrawBenchmarkScene的绘制方式相同，queries不为空时逐个模型查询
+    auto drawFrame = [&](std::vector<PipelineStatistics>* queries) {
+        renderer.ClearBackBuffer(Color::black);
+        for (size_t i = 0; i < meshes.size(); i++) {
+            if (queries) {
+                renderer.BeginPipelineQuery();
+            }
+            if (i == 0) {
+                renderer.DrawMeshT<TextureShader>(meshes[i], modelMatrices[i], shader);
+            } else {
+                renderer.DrawMesh(meshes[i], modelMatrices[i], &shader);
+            }
+            if (queries) {
+                queries->push_back(renderer.EndPipelineQuery());
+            }
+        }
+    };
+    report << meshes.size() << " meshes per frame, 800x600, " << frames << " frames" << std::endl;
+
+    // 预热一帧（第一次绘制时才分配帧内存）
+    renderer.SetPipelineStatisticsEnabled(false);
+    drawFrame(nullptr);
+    double offSeconds = MeasureSeconds([&]() { drawFrame(nullptr); }, frames);
+    std::vector<unsigned char> offImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    renderer.SetPipelineStatisticsEnabled(true);
+    double onSeconds = MeasureSeconds([&]() { drawFrame(nullptr); }, frames);
+    std::vector<unsigned char> onImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    report << std::fixed << std::setprecision(2);
+    report << "Frame time, statistics off:  " << offSeconds * 1000.0 << " ms" << std::endl;
+    report << "Frame time, statistics on:   " << onSeconds * 1000.0 << " ms ("
+           << std::showpos << (onSeconds / (std::max)(offSeconds, 1e-9) - 1.0) * 100.0 << std::noshowpos << "%)" << std::endl;
+    report << "Image identical:             " << (offImage == onImage ? "yes" : "NO") << std::endl;
+
+    // 单次绘制的查询
+    std::vector<PipelineStatistics> queries;
+    drawFrame(&queries);
+    PipelineStatistics frame = renderer.GetPipelineStatistics();
+    PipelineStatistics total;
+    report << std::left << std::setw(26) << "Mesh"
+           << std::right << std::setw(9) << "VS"
+           << std::setw(9) << "Tris"
+           << std::setw(9) << "Culled"
+           << std::setw(9) << "Clipped"
+           << std::setw(9) << "Rejected"
+           << std::setw(9) << "ZeroArea"
+           << std::setw(10) << "Raster"
+           << std::setw(10) << "Covered"
+           << std::setw(10) << "DepthFail"
+           << std::setw(10) << "FS"
+           << std::setw(8) << "Check" << std::endl;
+    for (size_t i = 0; i < queries.size(); i++) {
+        const PipelineStatistics& stats = queries[i];
+        total += stats;
+
+        // 未被剔除或拒绝的三角形至少拆分为一个三角形；覆盖的像素都做深度测试；每个片元采样一次纹理
+        bool consistent = stats.trianglesRasterized + stats.trianglesZeroArea >=
+                              stats.trianglesSubmitted - stats.trianglesBackfaceCulled - stats.trianglesClipRejected &&
+                          stats.pixelsCovered <= stats.pixelsTested &&
+                          stats.depthTestsPassed + stats.depthTestsFailed == stats.pixelsCovered &&
+                          stats.fragmentsShaded == stats.depthTestsPassed &&
+                          stats.GetTextureSampleCount() == stats.fragmentsShaded;
+        uint64_t mipSamples = 0;
+        for (int level = 0; level < PipelineStatistics::kMipLevels; level++) {
+            mipSamples += stats.mipLevelSamples[level];
+        }
+        consistent = consistent && mipSamples == stats.GetTextureSampleCount();
+
+        report << std::left << std::setw(26) << names[i]
+               << std::right << std::setw(9) << stats.verticesShaded
+               << std::setw(9) << stats.trianglesSubmitted
+               << std::setw(9) << stats.trianglesBackfaceCulled
+               << std::setw(9) << stats.trianglesClipped
+               << std::setw(9) << stats.trianglesClipRejected
+               << std::setw(9) << stats.trianglesZeroArea
+               << std::setw(10) << stats.trianglesRasterized
+               << std::setw(10) << stats.pixelsCovered
+               << std::setw(10) << stats.depthTestsFailed
+               << std::setw(10) << stats.fragmentsShaded
+               << std::setw(8) << (consistent ? "ok" : "FAIL") << std::endl;
+    }
+    PipelineStatistics difference = frame - total;
+    bool sumMatches = difference.verticesShaded == 0 && difference.trianglesSubmitted == 0 &&
+                 difference.trianglesRasterized == 0 && difference.pixelsTested == 0 &&
+                 difference.fragmentsShaded == 0 && difference.GetTextureSampleCount() == 0;
+    report << "Sum of queries == frame:     " << (sumMatches ? "yes" : "NO") << std::endl;
+
+    // 整帧的像素和纹理统计（覆盖率为覆盖的像素数 / 屏幕像素数）
+    double screenPixels = 800.0 * 600.0;
+    report << "Pixels tested / covered:     " << frame.pixelsTested << " / " << frame.pixelsCovered
+           << " (" << frame.pixelsCovered / screenPixels << "x screen)" << std::endl;
+    report << "Depth tests passed / failed: " << frame.depthTestsPassed << " / " << frame.depthTestsFailed << std::endl;
+    report << "Texture samples (N/B/T):     " << frame.textureSamples[static_cast<int>(TextureFilterMode::NEAREST)] << " / "
+           << frame.textureSamples[static_cast<int>(TextureFilterMode::BILINEAR)] << " / "
+           << frame.textureSamples[static_cast<int>(TextureFilterMode::TRILINEAR)] << std::endl;
+    report << "Mip levels hit:             ";
+    for (int level = 0; level < PipelineStatistics::kMipLevels; level++) {
+        if (frame.mipLevelSamples[level] > 0) {
+            report << " L" << level << "=" << frame.mipLevelSamples[level];
+        }
+    }
+    report << std::endl;
+
+    // 多线程计数：每个线程只写自己的计数器，结束前合并到总数
+    const int kThreads = 4;
+    const uint64_t kVerticesPerThread = 1000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([kVerticesPerThread]() {
+            for (uint64_t v = 0; v < kVerticesPerThread; v++) {
+                PipelineCounters::Add(&PipelineStatistics::verticesShaded, 1);
+            }
+            PipelineCounters::FlushLocal();
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    uint64_t merged = renderer.GetPipelineStatistics().verticesShaded - frame.verticesShaded;
+    report << "Thread counters merged:      " << merged << " / " << kThreads * kVerticesPerThread
+           << (merged == kThreads * kVerticesPerThread ? "  (ok)" : "  (MISMATCH)") << std::endl;
+    renderer.SetPipelineStatisticsEnabled(false);
+
+    return report.str();
+}
+
+std::string Benchmark::RunDebugViewBenchmark(const std::string& modelDirectory, int frames) {
+    std::ostringstream report;
+    report << "=== Debug view benchmark ===" << std::endl;
+
+    std::vector<Mesh> meshes;
+    std::vector<Matrix> modelMatrices;
+    if (!LoadBenchmarkScene(report, modelDirectory, meshes, modelMatrices)) {
+        return report.str();
+    }
+
+    Renderer renderer(800, 600);
+    Vector3f eye(0.0f, 0.5f, 3.0f);
+    if (!SetupBenchmarkRenderer(report, renderer, eye)) {
+        return report.str();
+    }
+    BlinnPhongShader shader;
+    shader.SetViewPosition(eye);
+
+    float scale = 0.0f;
+    auto renderFrame = [&]() {
+        renderer.ClearBackBuffer(Color::black);
+        DrawBenchmarkScene(renderer, meshes, modelMatrices, shader);
+        scale = renderer.ResolveDebugView();
+    };
+    report << meshes.size() << " meshes per frame, 800x600, " << frames << " frames" << std::endl;
+
+    renderFrame();
+    double noneSeconds = MeasureSeconds(renderFrame, frames);
+    std::vector<unsigned char> shadedImage = CopyColorBuffer(renderer.GetFrameBuffer());
+
+    report << std::left << std::setw(16) << "View"
+           << std::right << std::setw(12) << "Frame(ms)"
+           << std::setw(10) << "Cost"
+           << std::setw(12) << "Max"
+           << std::setw(12) << "Mean"
+           << std::setw(12) << "Scale"
+           << std::setw(12) << "Saturated" << std::endl;
+    report << std::fixed << std::setprecision(2);
+    report << std::left << std::setw(16) << Renderer::GetDebugViewName(Renderer::DebugView::NONE)
+           << std::right << std::setw(12) << noneSeconds * 1000.0 << std::endl;
+
+    // 计数视图和管线统计对照
+    const Renderer::DebugView views[] = { Renderer::DebugView::OVERDRAW, Renderer::DebugView::DEPTH_COMPLEXITY, Renderer::DebugView::SHADER_COST };
+    std::vector<uint32_t> overdrawCounts;
+    bool countsMatch = true;
+    for (Renderer::DebugView view : views) {
+        renderer.SetDebugView(view);
+        double seconds = MeasureSeconds(renderFrame, frames);
+
+        // 再绘制一帧，与管线统计比较
+        renderer.SetPipelineStatisticsEnabled(true);
+        renderFrame();
+        PipelineStatistics stats = renderer.GetPipelineStatistics();
+        renderer.SetPipelineStatisticsEnabled(false);
+
+        const std::vector<uint32_t>& counts = renderer.GetDebugCounts();
+        uint64_t sum = 0;
+        uint32_t maxCount = 0;
+        size_t touched = 0, saturated = 0;
+        for (uint32_t count : counts) {
+            sum += count;
+            maxCount = (std::max)(maxCount, count);
+            touched += count > 0 ? 1 : 0;
+            saturated += count > scale ? 1 : 0;
+        }
+        if (view == Renderer::DebugView::OVERDRAW) {
+            countsMatch = countsMatch && sum == stats.fragmentsShaded;
+            overdrawCounts = counts;
+        } else if (view == Renderer::DebugView::DEPTH_COMPLEXITY) {
+            // 模板绘制流程中深度测试也在着色之前，每个像素的深度测试次数不少于着色次数
+            countsMatch = countsMatch && sum == stats.depthTestsPassed + stats.depthTestsFailed;
+            for (size_t i = 0; i < counts.size() && i < overdrawCounts.size(); i++) {
+                countsMatch = countsMatch && counts[i] >= overdrawCounts[i];
+            }
+        } else {
+            // 着色过的像素都有周期数
+            size_t shadedPixels = 0;
+            for (uint32_t count : overdrawCounts) {
+                shadedPixels += count > 0 ? 1 : 0;
+            }
+            countsMatch = countsMatch && touched == shadedPixels;
+        }
+
+        report << std::left << std::setw(16) << Renderer::GetDebugViewName(view)
+               << std::right << std::setw(12) << seconds * 1000.0
+               << std::setw(9) << std::showpos << (seconds / (std::max)(noneSeconds, 1e-9) - 1.0) * 100.0 << std::noshowpos << "%"
+               << std::setw(12) << maxCount
+               << std::setw(12) << static_cast<double>(sum) / (std::max)(touched, static_cast<size_t>(1))
+               << std::setw(12) << scale
+               << std::setw(11) << saturated * 100.0 / (std::max)(touched, static_cast<size_t>(1)) << "%" << std::endl;
+    }
+    report << "Counts match statistics:     " << (countsMatch ? "yes" : "NO") << std::endl;
+
+    // 关闭调试视图后恢复正常着色
+    renderer.SetDebugView(Renderer::DebugView::NONE);
+    renderFrame();
+    report << "Image restored after NONE:   " << (CopyColorBuffer(renderer.GetFrameBuffer()) == shadedImage ? "yes" : "NO") << std::endl;
+
+    return report.str();
+}
@@ -56,7 +56,7 @@ void Camera::SetPerspective(float fieldOfView, float aspectRatio, float near, fl
 
 void Camera::UpdateViewMatrix()
 {
-    viewMatrix = Matrix::lookAt(position, target, up);
+    viewTransform = RigidTransform::lookAt(position, target, up);
 }
 
 void Camera::UpdateProjectionMatrix()
@@ -66,7 +66,7 @@ void Camera::UpdateProjectionMatrix()
 
 Matrix Camera::GetViewMatrix() const
 {
-    return viewMatrix;
+    return viewTransform.toMatrix();
 }
 
 Matrix Camera::GetProjectionMatrix() const
@@ -74,6 +74,28 @@ Matrix Camera::GetProjectionMatrix() const
     return projMatrix;
 }
 
+Frustum Camera::GetFrustum() const
+{
+    return Frustum::FromMatrix(projMatrix * GetViewMatrix());
+}
+
+void Camera::ScreenPointToRay(float x, float y, int width, int height, Vector3f& origin, Vector3f& direction) const
+{
+    // 屏幕坐标转换为NDC（与Renderer的视口变换相反，Y轴翻转）
+    float ndcX = x / width * 2.0f - 1.0f;
+    float ndcY = 1.0f - y / height * 2.0f;
+    
+    // 透视投影的逆：相机空间中z = -1平面上的点，射线从近平面出发
+    float tanHalfFov = tanf(fov / 2.0f);
+    Vector3f viewDirection(ndcX * tanHalfFov * aspect, ndcY * tanHalfFov, -1.0f);
+    
+    // 视图变换是刚体变换，逆变换直接转置旋转部分，不需要通用的4x4求逆
+    RigidTransform cameraToWorld = viewTransform.inverse();
+    origin = cameraToWorld.transformPoint(viewDirection * nearZ);
+    direction = cameraToWorld.transformVector(viewDirection);
+    direction.normalize();
+}
+
 void Camera::MoveForward(float distance)
 {
     // 计算前方向（目标点到相机的反方向）
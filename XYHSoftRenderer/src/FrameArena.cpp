@@ -0,0 +1,129 @@
+#include "../include/FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+FrameArena::FrameArena(size_t initialCapacity)
+    : m_currentBlock(0),
+      m_highWaterMark(0),
+      m_mallocCount(0),
+      m_lastFrameHighWaterMark(0),
+      m_lastFrameMallocCount(0)
+{
+    m_blocks.reserve(8);
+    AddBlock((std::max)(initialCapacity, static_cast<size_t>(64)));
+    m_mallocCount = 0;  // 初始块不计入帧统计
+}
+
+FrameArena::~FrameArena()
+{
+    for (Block& block : m_blocks) {
+        std::free(block.data);
+    }
+}
+
+// 分配一个新内存块并设为当前块，失败时抛出std::bad_alloc（已有的块保持不变）
+void FrameArena::AddBlock(size_t size)
+{
+    m_blocks.reserve(m_blocks.size() + 1);
+    Block block;
+    block.data = static_cast<char*>(std::malloc(size));
+    if (!block.data) {
+        throw std::bad_alloc();
+    }
+    block.size = size;
+    block.used = 0;
+    m_blocks.push_back(block);
+    m_currentBlock = m_blocks.size() - 1;
+    m_mallocCount++;
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+    Block* block = &m_blocks[m_currentBlock];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->data);
+    size_t offset = static_cast<size_t>(((base + block->used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - base);
+
+    // 当前块不够时使用后面已有的块（回退后保留下来的），都不够时分配新块
+    while (offset + bytes > block->size) {
+        if (m_currentBlock + 1 < m_blocks.size()) {
+            m_currentBlock++;
+            m_blocks[m_currentBlock].used = 0;
+        } else {
+            AddBlock((std::max)(bytes + alignment, block->size * 2));
+        }
+        block = &m_blocks[m_currentBlock];
+        base = reinterpret_cast<uintptr_t>(block->data);
+        offset = static_cast<size_t>(((base + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - base);
+    }
+
+    block->used = offset + bytes;
+    m_highWaterMark = (std::max)(m_highWaterMark, GetBytesUsed());
+    return block->data + offset;
+}
+
+FrameArena::Marker FrameArena::GetMarker() const
+{
+    Marker marker;
+    marker.block = m_currentBlock;
+    marker.used = m_blocks[m_currentBlock].used;
+    return marker;
+}
+
+void FrameArena::Rewind(const Marker& marker)
+{
+    for (size_t i = marker.block + 1; i <= m_currentBlock; i++) {
+        m_blocks[i].used = 0;
+    }
+    m_currentBlock = marker.block;
+    m_blocks[m_currentBlock].used = marker.used;
+}
+
+void FrameArena::Reset()
+{
+    m_lastFrameHighWaterMark = m_highWaterMark;
+    m_lastFrameMallocCount = m_mallocCount;
+    m_highWaterMark = 0;
+    m_mallocCount = 0;
+
+    // 上一帧容量不足时合并为一个块，之后的帧不再需要malloc（分配失败时继续使用原来的块）
+    if (m_blocks.size() > 1) {
+        size_t capacity = GetCapacity();
+        char* data = static_cast<char*>(std::malloc(capacity));
+        if (data) {
+            for (Block& block : m_blocks) {
+                std::free(block.data);
+            }
+            m_blocks.clear();
+            Block block;
+            block.data = data;
+            block.size = capacity;
+            block.used = 0;
+            m_blocks.push_back(block);
+            m_mallocCount++;
+        }
+    }
+
+    for (Block& block : m_blocks) {
+        block.used = 0;
+    }
+    m_currentBlock = 0;
+}
+
+size_t FrameArena::GetBytesUsed() const
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i <= m_currentBlock; i++) {
+        bytes += m_blocks[i].used;
+    }
+    return bytes;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
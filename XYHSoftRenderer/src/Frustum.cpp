@@ -0,0 +1,101 @@
+#include "../include/Frustum.h"
+#include "../include/MyMath.h"
+#include <algorithm>
+#include <cmath>
+
+Frustum::Frustum()
+{
+    for (int i = 0; i < PLANE_COUNT; i++) {
+        m_planes[i] = Vector4f(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+// Gribb-Hartmann方法：裁剪空间的每个平面对应矩阵第4行与第1-3行的和或差
+Frustum Frustum::FromMatrix(const Matrix& viewProjection)
+{
+    const float (*m)[4] = viewProjection.m;
+    Frustum frustum;
+    for (int i = 0; i < PLANE_COUNT; i++) {
+        int row = i / 2;
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        Vector4f plane(m[3][0] + sign * m[row][0],
+                       m[3][1] + sign * m[row][1],
+                       m[3][2] + sign * m[row][2],
+                       m[3][3] + sign * m[row][3]);
+
+        // 归一化，使平面方程的值等于到平面的距离
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > EPSILON) {
+            plane = plane * (1.0f / length);
+        }
+        frustum.m_planes[i] = plane;
+    }
+    return frustum;
+}
+
+bool Frustum::IntersectsSphere(const Vector3f& center, float radius) const
+{
+    for (const Vector4f& plane : m_planes) {
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        if (distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::IntersectsAABB(const Vector3f& min, const Vector3f& max) const
+{
+    for (const Vector4f& plane : m_planes) {
+        // 沿平面法线方向最远的顶点（p-vertex）在平面外侧时，整个包围盒都在外侧
+        float x = plane.x >= 0.0f ? max.x : min.x;
+        float y = plane.y >= 0.0f ? max.y : min.y;
+        float z = plane.z >= 0.0f ? max.z : min.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::ContainsAABB(const Vector3f& min, const Vector3f& max) const
+{
+    for (const Vector4f& plane : m_planes) {
+        // 沿平面法线方向最近的顶点（n-vertex）也在内侧时，整个包围盒都在内侧
+        float x = plane.x >= 0.0f ? min.x : max.x;
+        float y = plane.y >= 0.0f ? min.y : max.y;
+        float z = plane.z >= 0.0f ? min.z : max.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Arvo方法：中心点直接变换，半长按矩阵元素的绝对值变换
+void TransformAABB(const Vector3f& min, const Vector3f& max, const Matrix& matrix, Vector3f& outMin, Vector3f& outMax)
+{
+    Vector3f center = (min + max) * 0.5f;
+    Vector3f extent = (max - min) * 0.5f;
+    const float (*m)[4] = matrix.m;
+
+    Vector3f newCenter(m[0][0] * center.x + m[0][1] * center.y + m[0][2] * center.z + m[0][3],
+                       m[1][0] * center.x + m[1][1] * center.y + m[1][2] * center.z + m[1][3],
+                       m[2][0] * center.x + m[2][1] * center.y + m[2][2] * center.z + m[2][3]);
+    Vector3f newExtent(std::abs(m[0][0]) * extent.x + std::abs(m[0][1]) * extent.y + std::abs(m[0][2]) * extent.z,
+                       std::abs(m[1][0]) * extent.x + std::abs(m[1][1]) * extent.y + std::abs(m[1][2]) * extent.z,
+                       std::abs(m[2][0]) * extent.x + std::abs(m[2][1]) * extent.y + std::abs(m[2][2]) * extent.z);
+
+    outMin = newCenter - newExtent;
+    outMax = newCenter + newExtent;
+}
+
+// 3x3部分各列长度的最大值
+float GetMaxScale(const Matrix& matrix)
+{
+    const float (*m)[4] = matrix.m;
+    float scaleX = m[0][0] * m[0][0] + m[1][0] * m[1][0] + m[2][0] * m[2][0];
+    float scaleY = m[0][1] * m[0][1] + m[1][1] * m[1][1] + m[2][1] * m[2][1];
+    float scaleZ = m[0][2] * m[0][2] + m[1][2] * m[1][2] + m[2][2] * m[2][2];
+    return std::sqrt((std::max)((std::max)(scaleX, scaleY), scaleZ));
+}
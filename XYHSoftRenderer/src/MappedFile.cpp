@@ -0,0 +1,154 @@
+#include "../include/MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0), m_opened(false),
+#ifdef _WIN32
+      m_fileHandle(nullptr), m_mappingHandle(nullptr)
+#else
+      m_fd(-1)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string& filePath)
+    : MappedFile()
+{
+    Open(filePath);
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    // 路径按UTF-8处理（与文件对话框返回的路径一致）
+    int length = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, NULL, 0);
+    std::wstring wPath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &wPath[0], length);
+
+    HANDLE file = CreateFileW(wPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        // 文件不存在时由调用者决定是否报错（例如缓存文件本来就可能不存在）
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_opened = true;
+
+    // 空文件无法创建映射，直接视为打开成功
+    if (m_size == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        std::cerr << "Failed to create file mapping: " << filePath << std::endl;
+        Close();
+        return false;
+    }
+    m_mappingHandle = mapping;
+
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        std::cerr << "Failed to map view of file: " << filePath << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mappingHandle) {
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+    }
+    if (m_fileHandle) {
+        CloseHandle(m_fileHandle);
+        m_fileHandle = nullptr;
+    }
+    m_size = 0;
+    m_opened = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        // 文件不存在时由调用者决定是否报错（例如缓存文件本来就可能不存在）
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_size = static_cast<size_t>(st.st_size);
+    m_opened = true;
+
+    if (m_size == 0) {
+        return true;
+    }
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << filePath << std::endl;
+        Close();
+        return false;
+    }
+    m_data = static_cast<const char*>(data);
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+    m_opened = false;
+}
+
+#endif
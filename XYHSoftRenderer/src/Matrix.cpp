@@ -1,5 +1,7 @@
 ﻿#include "../include/Matrix.h"
+#include "../include/AffineTransform.h"
 #include "../include/MyMath.h"
+#include "../include/Simd.h"
 
 Matrix::Matrix()
 {
@@ -59,9 +61,41 @@ Matrix Matrix::operator-(const Matrix& matrix) const
 // }
 
 // 优化后的矩阵乘法
+// SIMD版本：结果第i行 = sum(a[i][k] * b的第k行)，每个元素的累加顺序与标量版本相同，结果完全一致
 Matrix Matrix::operator*(const Matrix& matrix) const
 {
     Matrix result;
+
+#if defined(XYH_SIMD_AVX2)
+    // 一次计算两行：a的两行装入一个__m256，a[i][k]在每个128位通道内广播，b的行复制到两个通道
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[0]));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[1]));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[2]));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[3]));
+    for (int i = 0; i < 4; i += 2) {
+        const __m256 a = _mm256_loadu_ps(m[i]);
+        __m256 row = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+        row = _mm256_add_ps(row, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1));
+        row = _mm256_add_ps(row, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), b2));
+        row = _mm256_add_ps(row, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), b3));
+        _mm256_storeu_ps(result.m[i], row);
+    }
+    return result;
+#elif defined(XYH_SIMD_SSE2)
+    const __m128 b0 = _mm_load_ps(matrix.m[0]);
+    const __m128 b1 = _mm_load_ps(matrix.m[1]);
+    const __m128 b2 = _mm_load_ps(matrix.m[2]);
+    const __m128 b3 = _mm_load_ps(matrix.m[3]);
+    for (int i = 0; i < 4; i++) {
+        const __m128 a = _mm_load_ps(m[i]);
+        __m128 row = _mm_mul_ps(_mm_shuffle_ps(a, a, 0x00), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, 0x55), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xAA), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xFF), b3));
+        _mm_store_ps(result.m[i], row);
+    }
+    return result;
+#else
     
     // 使用局部变量缓存行和列，避免重复内存访问
     // 针对4x4矩阵完全展开循环，消除循环开销
@@ -106,10 +140,23 @@ Matrix Matrix::operator*(const Matrix& matrix) const
     result.m[3][3] = a30 * b03 + a31 * b13 + a32 * b23 + a33 * b33;
     
     return result;
+#endif
 }
 
 Vector4f Matrix::operator*(const Vector4f& vector) const
 {
+#if defined(XYH_SIMD_SSE2)
+    // 每行与向量逐元素相乘，转置后按列相加得到四个点积（累加顺序与标量版本相同）
+    const __m128 v = _mm_loadu_ps(&vector.x);
+    __m128 p0 = _mm_mul_ps(_mm_load_ps(m[0]), v);
+    __m128 p1 = _mm_mul_ps(_mm_load_ps(m[1]), v);
+    __m128 p2 = _mm_mul_ps(_mm_load_ps(m[2]), v);
+    __m128 p3 = _mm_mul_ps(_mm_load_ps(m[3]), v);
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    Vector4f result;
+    _mm_storeu_ps(&result.x, _mm_add_ps(_mm_add_ps(_mm_add_ps(p0, p1), p2), p3));
+    return result;
+#else
     // 使用局部变量缓存，减少内存访问
     const float x = vector.x, y = vector.y, z = vector.z, w = vector.w;
     
@@ -125,6 +172,84 @@ Vector4f Matrix::operator*(const Vector4f& vector) const
         m20 * x + m21 * y + m22 * z + m23 * w,
         m30 * x + m31 * y + m32 * z + m33 * w
     );
+#endif
+}
+
+#if defined(XYH_SIMD_SSE2)
+namespace {
+    // 矩阵的四列（转置后按行加载），批量变换时只需要转置一次
+    struct MatrixColumns {
+        __m128 c0, c1, c2, c3;
+    };
+
+    inline MatrixColumns LoadColumns(const Matrix& matrix)
+    {
+        MatrixColumns columns;
+        columns.c0 = _mm_load_ps(matrix.m[0]);
+        columns.c1 = _mm_load_ps(matrix.m[1]);
+        columns.c2 = _mm_load_ps(matrix.m[2]);
+        columns.c3 = _mm_load_ps(matrix.m[3]);
+        _MM_TRANSPOSE4_PS(columns.c0, columns.c1, columns.c2, columns.c3);
+        return columns;
+    }
+}
+#endif
+
+// 批量变换：结果 = 各列按向量分量加权求和，与operator*的结果完全一致
+void Matrix::transformPoints(const Vector4f* points, Vector4f* result, size_t count) const
+{
+    size_t i = 0;
+#if defined(XYH_SIMD_SSE2)
+    const MatrixColumns columns = LoadColumns(*this);
+#if defined(XYH_SIMD_AVX2)
+    // 一次变换两个点：两个点装入一个__m256，分量在每个128位通道内广播
+    const __m256 c0 = _mm256_set_m128(columns.c0, columns.c0);
+    const __m256 c1 = _mm256_set_m128(columns.c1, columns.c1);
+    const __m256 c2 = _mm256_set_m128(columns.c2, columns.c2);
+    const __m256 c3 = _mm256_set_m128(columns.c3, columns.c3);
+    for (; i + 2 <= count; i += 2) {
+        const __m256 p = _mm256_loadu_ps(&points[i].x);
+        __m256 r = _mm256_mul_ps(c0, _mm256_shuffle_ps(p, p, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_shuffle_ps(p, p, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_shuffle_ps(p, p, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_shuffle_ps(p, p, 0xFF)));
+        _mm256_storeu_ps(&result[i].x, r);
+    }
+#endif
+    for (; i < count; i++) {
+        const __m128 p = _mm_loadu_ps(&points[i].x);
+        __m128 r = _mm_mul_ps(columns.c0, _mm_shuffle_ps(p, p, 0x00));
+        r = _mm_add_ps(r, _mm_mul_ps(columns.c1, _mm_shuffle_ps(p, p, 0x55)));
+        r = _mm_add_ps(r, _mm_mul_ps(columns.c2, _mm_shuffle_ps(p, p, 0xAA)));
+        r = _mm_add_ps(r, _mm_mul_ps(columns.c3, _mm_shuffle_ps(p, p, 0xFF)));
+        _mm_storeu_ps(&result[i].x, r);
+    }
+#endif
+    for (; i < count; i++) {
+        result[i] = (*this) * points[i];
+    }
+}
+
+void Matrix::transformPoints(const Vector3f* points, Vector3f* result, size_t count) const
+{
+#if defined(XYH_SIMD_SSE2)
+    // w为1，第四列直接相加
+    const MatrixColumns columns = LoadColumns(*this);
+    for (size_t i = 0; i < count; i++) {
+        __m128 r = _mm_mul_ps(columns.c0, _mm_set1_ps(points[i].x));
+        r = _mm_add_ps(r, _mm_mul_ps(columns.c1, _mm_set1_ps(points[i].y)));
+        r = _mm_add_ps(r, _mm_mul_ps(columns.c2, _mm_set1_ps(points[i].z)));
+        r = _mm_add_ps(r, columns.c3);
+        alignas(16) float transformed[4];
+        _mm_store_ps(transformed, r);
+        result[i] = Vector3f(transformed[0], transformed[1], transformed[2]);
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        Vector4f transformed = (*this) * Vector4f(points[i], 1.0f);
+        result[i] = Vector3f(transformed.x, transformed.y, transformed.z);
+    }
+#endif
 }
 
 Matrix Matrix::operator*(const float& scalar) const
@@ -213,8 +338,8 @@ Matrix Matrix::inverse() const
     // 计算行列式的值
     float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
     
-    // 行列式为0表示矩阵不可逆
-    if (std::abs(det) < EPSILON) {
+    // 行列式为0表示矩阵不可逆（不能与固定阈值比较：缩放s倍的矩阵行列式为s^3，缩小很多的模型矩阵仍然可逆）
+    if (det == 0.0f) {
         // 返回单位矩阵
         return identity();
     }
@@ -246,6 +371,17 @@ Matrix Matrix::inverse() const
     return result;
 }
 
+// 仿射矩阵求逆与法线矩阵：由Affine3计算（不计算最后一行）
+Matrix Matrix::inverseAffine() const
+{
+    return Affine3(*this).inverse().toMatrix();
+}
+
+Matrix Matrix::normalMatrix() const
+{
+    return Affine3(*this).normalMatrix().toMatrix();
+}
+
 // 平移矩阵
 Matrix Matrix::translate(const Vector3f& translation)
 {
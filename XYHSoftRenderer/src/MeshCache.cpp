@@ -0,0 +1,570 @@
+#include "../include/MeshCache.h"
+#include "../include/MappedFile.h"
+#include "../include/MeshletBuilder.h"
+#include "../include/MeshSimplifier.h"
+#include "../include/Profiler.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+// 文件格式版本（格式变化时递增，旧缓存自动失效）
+const uint32_t kMeshCacheVersion = 3;
+const char kMeshCacheMagic[4] = { 'X', 'Y', 'H', 'M' };
+
+// 段数据对齐字节数
+const uint64_t kSectionAlignment = 16;
+
+// 段类型（新的数据作为新的段类型追加）
+enum MeshCacheSectionType : uint32_t {
+    SECTION_POSITIONS = 1,  // float3
+    SECTION_NORMALS = 2,    // float3
+    SECTION_TEXCOORDS = 3,  // float2
+    SECTION_INDICES = 4,    // int3（每个三角形一组）
+    SECTION_SUBMESHES = 5,  // MeshCacheSubMesh
+    SECTION_MATERIAL_LIBRARIES = 6,  // MeshCacheString（mtllib）
+    SECTION_STRINGS = 7,    // 字符串数据（材质名称和材质库路径）
+    SECTION_MESHLETS = 8,   // MeshCacheMeshlet
+    SECTION_MESHLET_VERTICES = 9,  // int32（簇引用的顶点下标）
+    SECTION_LODS = 10       // MeshCacheLod（第0项为原网格，其余为Mesh::lods）
+};
+
+// 文件头
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t contentHash;   // OBJ文件内容哈希
+    uint64_t optionsKey;    // 加载选项
+    uint32_t vertexCount;   // 所有LOD级别的顶点总数
+    uint32_t triangleCount; // 所有LOD级别的三角形总数
+    float boundsMin[3];     // 原网格的包围盒
+    float boundsMax[3];
+    uint32_t sectionCount;
+    uint32_t reserved;
+};
+
+// 段表项
+struct MeshCacheSection {
+    uint32_t type;
+    uint32_t stride;        // 每个元素的字节数
+    uint64_t offset;        // 相对文件开头的偏移
+    uint64_t size;          // 字节数
+};
+
+// 字符串（在SECTION_STRINGS段中的位置）
+struct MeshCacheString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// 子网格（材质只保存名称，加载时从MTL文件读取）
+struct MeshCacheSubMesh {
+    uint32_t triangleStart;
+    uint32_t triangleCount;
+    MeshCacheString materialName;
+};
+
+// 簇（下标都相对所在的LOD级别）
+struct MeshCacheMeshlet {
+    uint32_t triangleStart;
+    uint32_t triangleCount;
+    uint32_t vertexOffset;
+    uint32_t vertexCount;
+    float center[3];
+    float radius;
+    float coneApex[3];
+    float coneAxis[3];
+    float coneCutoff;
+};
+
+// 一个LOD级别在各段中的范围（索引中的顶点下标相对vertexStart）
+struct MeshCacheLod {
+    uint32_t vertexStart;
+    uint32_t vertexCount;
+    uint32_t triangleStart;
+    uint32_t triangleCount;
+    uint32_t subMeshStart;
+    uint32_t subMeshCount;
+    uint32_t meshletStart;
+    uint32_t meshletCount;
+    uint32_t meshletVertexStart;
+    uint32_t meshletVertexCount;
+    float lodError;
+};
+
+// 映射内存中各段数据的位置
+struct MeshCacheView {
+    const float* positions;
+    const float* normals;
+    const float* texcoords;
+    const int32_t* indices;
+    const char* subMeshes;
+    uint64_t subMeshCount;
+    const char* meshlets;
+    uint64_t meshletCount;
+    const int32_t* meshletVertices;
+    uint64_t meshletVertexCount;
+    const char* strings;
+    uint64_t stringsSize;
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 查找指定类型的段，并检查元素大小和数量
+const MeshCacheSection* FindSection(const MeshCacheSection* sections, uint32_t sectionCount,
+                                    uint32_t type, uint32_t stride, uint64_t count, size_t fileSize) {
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        const MeshCacheSection& section = sections[i];
+        if (section.type != type) {
+            continue;
+        }
+        if (section.stride != stride || section.size != stride * count ||
+            section.offset > fileSize || section.size > fileSize - section.offset) {
+            return nullptr;
+        }
+        return &section;
+    }
+    return nullptr;
+}
+
+// 查找元素数量不固定的段（数量由段大小决定）
+const MeshCacheSection* FindArraySection(const MeshCacheSection* sections, uint32_t sectionCount,
+                                         uint32_t type, uint32_t stride, size_t fileSize) {
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        const MeshCacheSection& section = sections[i];
+        if (section.type != type) {
+            continue;
+        }
+        if (section.stride != stride || section.size % stride != 0 ||
+            section.offset > fileSize || section.size > fileSize - section.offset) {
+            return nullptr;
+        }
+        return &section;
+    }
+    return nullptr;
+}
+
+// 将字符串追加到字符串数据中
+MeshCacheString AddString(std::vector<char>& strings, const std::string& text) {
+    MeshCacheString result;
+    result.offset = static_cast<uint32_t>(strings.size());
+    result.length = static_cast<uint32_t>(text.size());
+    strings.insert(strings.end(), text.begin(), text.end());
+    return result;
+}
+
+// 从字符串数据中读取字符串，越界时返回false
+bool ReadString(const char* strings, uint64_t stringsSize, const MeshCacheString& source, std::string& text) {
+    if (source.offset > stringsSize || source.length > stringsSize - source.offset) {
+        return false;
+    }
+    text.assign(strings + source.offset, source.length);
+    return true;
+}
+
+// 检查[start, start + count)在[0, total)之内
+bool IsValidRange(uint64_t start, uint64_t count, uint64_t total) {
+    return start <= total && count <= total - start;
+}
+
+// 从映射的内存组装一个LOD级别（没有任何文本解析），数据越界时返回false
+bool ReadLevel(const MeshCacheView& view, const MeshCacheLod& lod, Mesh& mesh) {
+    if (!IsValidRange(lod.vertexStart, lod.vertexCount, view.vertexCount) ||
+        !IsValidRange(lod.triangleStart, lod.triangleCount, view.triangleCount) ||
+        !IsValidRange(lod.subMeshStart, lod.subMeshCount, view.subMeshCount) ||
+        !IsValidRange(lod.meshletStart, lod.meshletCount, view.meshletCount) ||
+        !IsValidRange(lod.meshletVertexStart, lod.meshletVertexCount, view.meshletVertexCount)) {
+        return false;
+    }
+
+    const float* positionData = view.positions + static_cast<size_t>(lod.vertexStart) * 3;
+    const float* normalData = view.normals + static_cast<size_t>(lod.vertexStart) * 3;
+    const float* texcoordData = view.texcoords + static_cast<size_t>(lod.vertexStart) * 2;
+    mesh.vertices.resize(lod.vertexCount);
+    for (uint32_t i = 0; i < lod.vertexCount; ++i) {
+        Vertex& vertex = mesh.vertices[i];
+        vertex.pos = Vector4f(positionData[i * 3], positionData[i * 3 + 1], positionData[i * 3 + 2], 1.0f);
+        vertex.color = Vector4f(1.0f, 1.0f, 1.0f, 1.0f);
+        vertex.normal = Vector3f(normalData[i * 3], normalData[i * 3 + 1], normalData[i * 3 + 2]);
+        vertex.texcoord = Vector2f(texcoordData[i * 2], texcoordData[i * 2 + 1]);
+    }
+
+    const int32_t* indexData = view.indices + static_cast<size_t>(lod.triangleStart) * 3;
+    mesh.indices.resize(lod.triangleCount);
+    for (uint32_t i = 0; i < lod.triangleCount; ++i) {
+        int32_t i0 = indexData[i * 3];
+        int32_t i1 = indexData[i * 3 + 1];
+        int32_t i2 = indexData[i * 3 + 2];
+        if (static_cast<uint32_t>(i0) >= lod.vertexCount ||
+            static_cast<uint32_t>(i1) >= lod.vertexCount ||
+            static_cast<uint32_t>(i2) >= lod.vertexCount) {
+            return false;
+        }
+        mesh.indices[i] = Vector3i(i0, i1, i2);
+    }
+
+    mesh.subMeshes.resize(lod.subMeshCount);
+    for (uint32_t i = 0; i < lod.subMeshCount; ++i) {
+        MeshCacheSubMesh source;
+        std::memcpy(&source, view.subMeshes + (static_cast<size_t>(lod.subMeshStart) + i) * sizeof(MeshCacheSubMesh), sizeof(source));
+        SubMesh& subMesh = mesh.subMeshes[i];
+        if (!IsValidRange(source.triangleStart, source.triangleCount, lod.triangleCount) ||
+            !ReadString(view.strings, view.stringsSize, source.materialName, subMesh.material.name)) {
+            return false;
+        }
+        subMesh.triangleStart = source.triangleStart;
+        subMesh.triangleCount = source.triangleCount;
+    }
+
+    mesh.meshlets.resize(lod.meshletCount);
+    for (uint32_t i = 0; i < lod.meshletCount; ++i) {
+        MeshCacheMeshlet source;
+        std::memcpy(&source, view.meshlets + (static_cast<size_t>(lod.meshletStart) + i) * sizeof(MeshCacheMeshlet), sizeof(source));
+        if (!IsValidRange(source.triangleStart, source.triangleCount, lod.triangleCount) ||
+            !IsValidRange(source.vertexOffset, source.vertexCount, lod.meshletVertexCount)) {
+            return false;
+        }
+        Meshlet& meshlet = mesh.meshlets[i];
+        meshlet.triangleStart = source.triangleStart;
+        meshlet.triangleCount = source.triangleCount;
+        meshlet.vertexOffset = source.vertexOffset;
+        meshlet.vertexCount = source.vertexCount;
+        meshlet.center = Vector3f(source.center[0], source.center[1], source.center[2]);
+        meshlet.radius = source.radius;
+        meshlet.coneApex = Vector3f(source.coneApex[0], source.coneApex[1], source.coneApex[2]);
+        meshlet.coneAxis = Vector3f(source.coneAxis[0], source.coneAxis[1], source.coneAxis[2]);
+        meshlet.coneCutoff = source.coneCutoff;
+    }
+
+    const int32_t* meshletVertexData = view.meshletVertices + lod.meshletVertexStart;
+    mesh.meshletVertices.resize(lod.meshletVertexCount);
+    for (uint32_t i = 0; i < lod.meshletVertexCount; ++i) {
+        if (static_cast<uint32_t>(meshletVertexData[i]) >= lod.vertexCount) {
+            return false;
+        }
+        mesh.meshletVertices[i] = meshletVertexData[i];
+    }
+
+    mesh.lodError = lod.lodError;
+    return true;
+}
+
+} // namespace
+
+std::string MeshCache::GetCachePath(const std::string& objPath) {
+    return objPath + ".meshcache";
+}
+
+uint64_t MeshCache::HashContent(const char* data, size_t size) {
+    // 每次处理8字节的乘法-异或哈希（非加密用途，只用于检测文件变化）
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+    uint64_t h = 0xCBF29CE484222325ull ^ (size * prime);
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = (h ^ word) * prime;
+        h ^= h >> 29;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t MeshCache::GetOptionsKey(const ObjLoadOptions& options) {
+    uint32_t epsilonBits = 0;
+    if (options.weldVertices) {
+        std::memcpy(&epsilonBits, &options.weldEpsilon, sizeof(epsilonBits));
+    }
+    uint64_t flags = (options.flipNormals ? 1u : 0u) |
+                     (options.flipFaces ? 2u : 0u) |
+                     (options.weldVertices ? 4u : 0u) |
+                     (options.optimizeMesh ? 8u : 0u) |
+                     (options.buildMeshlets ? 16u : 0u) |
+                     (options.buildLods ? 32u : 0u);
+    // 簇和LOD的生成参数（修改后旧缓存自动失效）
+    if (options.buildMeshlets) {
+        flags |= static_cast<uint64_t>(MeshletBuilder::kMaxVertices & 0xFF) << 8;
+        flags |= static_cast<uint64_t>(MeshletBuilder::kMaxTriangles & 0xFF) << 16;
+    }
+    if (options.buildLods) {
+        flags |= static_cast<uint64_t>(MeshSimplifier::kMaxLodLevels & 0xFF) << 24;
+    }
+    return (static_cast<uint64_t>(epsilonBits) << 32) | flags;
+}
+
+bool MeshCache::Load(const std::string& cachePath, uint64_t contentHash, uint64_t optionsKey, Mesh& mesh,
+                     std::vector<std::string>& materialLibraries) {
+    XYH_PROFILE_SCOPE("MeshCache::Load");
+    MappedFile file;
+    if (!file.Open(cachePath)) {
+        return false;
+    }
+
+    // 检查文件头
+    const char* data = file.Data();
+    size_t fileSize = file.Size();
+    if (fileSize < sizeof(MeshCacheHeader)) {
+        return false;
+    }
+    MeshCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMeshCacheMagic, sizeof(kMeshCacheMagic)) != 0 ||
+        header.version != kMeshCacheVersion ||
+        header.contentHash != contentHash ||
+        header.optionsKey != optionsKey) {
+        return false;
+    }
+    if (header.sectionCount > (fileSize - sizeof(MeshCacheHeader)) / sizeof(MeshCacheSection)) {
+        return false;
+    }
+
+    // 段表紧跟在文件头之后（文件头大小是8的倍数，映射地址按页对齐）
+    const MeshCacheSection* sections = reinterpret_cast<const MeshCacheSection*>(data + sizeof(MeshCacheHeader));
+    const MeshCacheSection* positions = FindSection(sections, header.sectionCount, SECTION_POSITIONS,
+                                                    sizeof(float) * 3, header.vertexCount, fileSize);
+    const MeshCacheSection* normals = FindSection(sections, header.sectionCount, SECTION_NORMALS,
+                                                  sizeof(float) * 3, header.vertexCount, fileSize);
+    const MeshCacheSection* texcoords = FindSection(sections, header.sectionCount, SECTION_TEXCOORDS,
+                                                    sizeof(float) * 2, header.vertexCount, fileSize);
+    const MeshCacheSection* indices = FindSection(sections, header.sectionCount, SECTION_INDICES,
+                                                  sizeof(int32_t) * 3, header.triangleCount, fileSize);
+    const MeshCacheSection* subMeshes = FindArraySection(sections, header.sectionCount, SECTION_SUBMESHES,
+                                                         sizeof(MeshCacheSubMesh), fileSize);
+    const MeshCacheSection* libraries = FindArraySection(sections, header.sectionCount, SECTION_MATERIAL_LIBRARIES,
+                                                         sizeof(MeshCacheString), fileSize);
+    const MeshCacheSection* strings = FindArraySection(sections, header.sectionCount, SECTION_STRINGS, 1, fileSize);
+    const MeshCacheSection* meshlets = FindArraySection(sections, header.sectionCount, SECTION_MESHLETS,
+                                                        sizeof(MeshCacheMeshlet), fileSize);
+    const MeshCacheSection* meshletVertices = FindArraySection(sections, header.sectionCount, SECTION_MESHLET_VERTICES,
+                                                               sizeof(int32_t), fileSize);
+    const MeshCacheSection* lods = FindArraySection(sections, header.sectionCount, SECTION_LODS,
+                                                    sizeof(MeshCacheLod), fileSize);
+    if (!positions || !normals || !texcoords || !indices || !subMeshes || !libraries || !strings ||
+        !meshlets || !meshletVertices || !lods || lods->size == 0) {
+        std::cerr << "Mesh cache is corrupted: " << cachePath << std::endl;
+        return false;
+    }
+
+    MeshCacheView view;
+    view.positions = reinterpret_cast<const float*>(data + positions->offset);
+    view.normals = reinterpret_cast<const float*>(data + normals->offset);
+    view.texcoords = reinterpret_cast<const float*>(data + texcoords->offset);
+    view.indices = reinterpret_cast<const int32_t*>(data + indices->offset);
+    view.subMeshes = data + subMeshes->offset;
+    view.subMeshCount = subMeshes->size / sizeof(MeshCacheSubMesh);
+    view.meshlets = data + meshlets->offset;
+    view.meshletCount = meshlets->size / sizeof(MeshCacheMeshlet);
+    view.meshletVertices = reinterpret_cast<const int32_t*>(data + meshletVertices->offset);
+    view.meshletVertexCount = meshletVertices->size / sizeof(int32_t);
+    view.strings = data + strings->offset;
+    view.stringsSize = strings->size;
+    view.vertexCount = header.vertexCount;
+    view.triangleCount = header.triangleCount;
+
+    // 第0级为原网格，其余各级依次放入Mesh::lods
+    mesh.Clear();
+    size_t lodCount = lods->size / sizeof(MeshCacheLod);
+    if (lodCount > 1) {
+        mesh.lods.resize(lodCount - 1);
+    }
+    for (size_t i = 0; i < lodCount; ++i) {
+        MeshCacheLod lod;
+        std::memcpy(&lod, data + lods->offset + i * sizeof(MeshCacheLod), sizeof(lod));
+        if (!ReadLevel(view, lod, i == 0 ? mesh : mesh.lods[i - 1])) {
+            std::cerr << "Mesh cache contains invalid data: " << cachePath << std::endl;
+            mesh.Clear();
+            return false;
+        }
+    }
+
+    materialLibraries.clear();
+    size_t libraryCount = libraries->size / sizeof(MeshCacheString);
+    for (size_t i = 0; i < libraryCount; ++i) {
+        MeshCacheString source;
+        std::memcpy(&source, data + libraries->offset + i * sizeof(MeshCacheString), sizeof(source));
+        std::string library;
+        if (!ReadString(view.strings, view.stringsSize, source, library)) {
+            std::cerr << "Mesh cache contains invalid material libraries: " << cachePath << std::endl;
+            mesh.Clear();
+            return false;
+        }
+        materialLibraries.push_back(library);
+    }
+
+    return true;
+}
+
+bool MeshCache::Save(const std::string& cachePath, uint64_t contentHash, uint64_t optionsKey, const Mesh& mesh,
+                     const std::vector<std::string>& materialLibraries) {
+    XYH_PROFILE_SCOPE("MeshCache::Save");
+    // 原网格和各级LOD依次写入同一组段
+    std::vector<const Mesh*> levels;
+    levels.push_back(&mesh);
+    for (const Mesh& lod : mesh.lods) {
+        levels.push_back(&lod);
+    }
+
+    // 拆分为紧凑的属性流
+    std::vector<float> positionData;
+    std::vector<float> normalData;
+    std::vector<float> texcoordData;
+    std::vector<int32_t> indexData;
+    std::vector<char> stringData;
+    std::vector<MeshCacheSubMesh> subMeshData;
+    std::vector<MeshCacheMeshlet> meshletData;
+    std::vector<int32_t> meshletVertexData;
+    std::vector<MeshCacheLod> lodData(levels.size());
+    for (size_t l = 0; l < levels.size(); ++l) {
+        const Mesh& level = *levels[l];
+        MeshCacheLod& lod = lodData[l];
+        lod.vertexStart = static_cast<uint32_t>(positionData.size() / 3);
+        lod.vertexCount = static_cast<uint32_t>(level.vertices.size());
+        lod.triangleStart = static_cast<uint32_t>(indexData.size() / 3);
+        lod.triangleCount = static_cast<uint32_t>(level.indices.size());
+        lod.subMeshStart = static_cast<uint32_t>(subMeshData.size());
+        lod.subMeshCount = static_cast<uint32_t>(level.subMeshes.size());
+        lod.meshletStart = static_cast<uint32_t>(meshletData.size());
+        lod.meshletCount = static_cast<uint32_t>(level.meshlets.size());
+        lod.meshletVertexStart = static_cast<uint32_t>(meshletVertexData.size());
+        lod.meshletVertexCount = static_cast<uint32_t>(level.meshletVertices.size());
+        lod.lodError = l == 0 ? 0.0f : level.lodError;
+
+        for (const Vertex& vertex : level.vertices) {
+            positionData.push_back(vertex.pos.x);
+            positionData.push_back(vertex.pos.y);
+            positionData.push_back(vertex.pos.z);
+            normalData.push_back(vertex.normal.x);
+            normalData.push_back(vertex.normal.y);
+            normalData.push_back(vertex.normal.z);
+            texcoordData.push_back(vertex.texcoord.x);
+            texcoordData.push_back(vertex.texcoord.y);
+        }
+        for (const Vector3i& index : level.indices) {
+            indexData.push_back(index.x);
+            indexData.push_back(index.y);
+            indexData.push_back(index.z);
+        }
+
+        // 子网格只保存三角形范围和材质名称
+        for (const SubMesh& subMesh : level.subMeshes) {
+            MeshCacheSubMesh target;
+            target.triangleStart = static_cast<uint32_t>(subMesh.triangleStart);
+            target.triangleCount = static_cast<uint32_t>(subMesh.triangleCount);
+            target.materialName = AddString(stringData, subMesh.material.name);
+            subMeshData.push_back(target);
+        }
+
+        for (const Meshlet& meshlet : level.meshlets) {
+            MeshCacheMeshlet target;
+            target.triangleStart = static_cast<uint32_t>(meshlet.triangleStart);
+            target.triangleCount = static_cast<uint32_t>(meshlet.triangleCount);
+            target.vertexOffset = static_cast<uint32_t>(meshlet.vertexOffset);
+            target.vertexCount = static_cast<uint32_t>(meshlet.vertexCount);
+            target.center[0] = meshlet.center.x;
+            target.center[1] = meshlet.center.y;
+            target.center[2] = meshlet.center.z;
+            target.radius = meshlet.radius;
+            target.coneApex[0] = meshlet.coneApex.x;
+            target.coneApex[1] = meshlet.coneApex.y;
+            target.coneApex[2] = meshlet.coneApex.z;
+            target.coneAxis[0] = meshlet.coneAxis.x;
+            target.coneAxis[1] = meshlet.coneAxis.y;
+            target.coneAxis[2] = meshlet.coneAxis.z;
+            target.coneCutoff = meshlet.coneCutoff;
+            meshletData.push_back(target);
+        }
+        meshletVertexData.insert(meshletVertexData.end(), level.meshletVertices.begin(), level.meshletVertices.end());
+    }
+
+    std::vector<MeshCacheString> libraryData;
+    for (const std::string& library : materialLibraries) {
+        libraryData.push_back(AddString(stringData, library));
+    }
+
+    // 文件头
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMeshCacheMagic, sizeof(kMeshCacheMagic));
+    header.version = kMeshCacheVersion;
+    header.contentHash = contentHash;
+    header.optionsKey = optionsKey;
+    header.vertexCount = static_cast<uint32_t>(positionData.size() / 3);
+    header.triangleCount = static_cast<uint32_t>(indexData.size() / 3);
+
+    Vector3f boundsMin, boundsMax;
+    mesh.CalculateBounds(boundsMin, boundsMax);
+    header.boundsMin[0] = boundsMin.x;
+    header.boundsMin[1] = boundsMin.y;
+    header.boundsMin[2] = boundsMin.z;
+    header.boundsMax[0] = boundsMax.x;
+    header.boundsMax[1] = boundsMax.y;
+    header.boundsMax[2] = boundsMax.z;
+
+    // 段表
+    struct SectionSource {
+        uint32_t type;
+        uint32_t stride;
+        const void* data;
+        uint64_t size;
+    };
+    const SectionSource sources[] = {
+        { SECTION_POSITIONS, sizeof(float) * 3, positionData.data(), positionData.size() * sizeof(float) },
+        { SECTION_NORMALS, sizeof(float) * 3, normalData.data(), normalData.size() * sizeof(float) },
+        { SECTION_TEXCOORDS, sizeof(float) * 2, texcoordData.data(), texcoordData.size() * sizeof(float) },
+        { SECTION_INDICES, sizeof(int32_t) * 3, indexData.data(), indexData.size() * sizeof(int32_t) },
+        { SECTION_SUBMESHES, sizeof(MeshCacheSubMesh), subMeshData.data(), subMeshData.size() * sizeof(MeshCacheSubMesh) },
+        { SECTION_MATERIAL_LIBRARIES, sizeof(MeshCacheString), libraryData.data(), libraryData.size() * sizeof(MeshCacheString) },
+        { SECTION_STRINGS, 1, stringData.data(), stringData.size() },
+        { SECTION_MESHLETS, sizeof(MeshCacheMeshlet), meshletData.data(), meshletData.size() * sizeof(MeshCacheMeshlet) },
+        { SECTION_MESHLET_VERTICES, sizeof(int32_t), meshletVertexData.data(), meshletVertexData.size() * sizeof(int32_t) },
+        { SECTION_LODS, sizeof(MeshCacheLod), lodData.data(), lodData.size() * sizeof(MeshCacheLod) }
+    };
+    const uint32_t sectionCount = sizeof(sources) / sizeof(sources[0]);
+    header.sectionCount = sectionCount;
+
+    MeshCacheSection sections[sectionCount];
+    uint64_t offset = AlignUp(sizeof(MeshCacheHeader) + sizeof(sections), kSectionAlignment);
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        sections[i].type = sources[i].type;
+        sections[i].stride = sources[i].stride;
+        sections[i].offset = offset;
+        sections[i].size = sources[i].size;
+        offset = AlignUp(offset + sources[i].size, kSectionAlignment);
+    }
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write mesh cache: " << cachePath << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+    uint64_t written = sizeof(header) + sizeof(sections);
+    const char padding[kSectionAlignment] = {};
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        file.write(padding, static_cast<std::streamsize>(sections[i].offset - written));
+        file.write(static_cast<const char*>(sources[i].data), static_cast<std::streamsize>(sources[i].size));
+        written = sections[i].offset + sources[i].size;
+    }
+
+    if (!file.good()) {
+        std::cerr << "Failed to write mesh cache: " << cachePath << std::endl;
+        file.close();
+        std::remove(cachePath.c_str());
+        return false;
+    }
+    return true;
+}
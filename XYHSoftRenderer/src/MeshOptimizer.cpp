@@ -0,0 +1,461 @@
+#include "../include/MeshOptimizer.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+namespace {
+
+// ==================== Forsyth顶点缓存优化的参数 ====================
+// 模拟的LRU缓存大小
+const int kForsythCacheSize = 32;
+// 缓存中位置越靠前得分越高的衰减指数
+const float kCacheDecayPower = 1.5f;
+// 刚用过的三角形的三个顶点的固定得分（略低，避免总是沿着长条状绘制）
+const float kLastTriangleScore = 0.75f;
+// 剩余三角形越少的顶点得分越高（尽快用完，避免之后重新变换）
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+// 顶点得分：cachePosition为-1表示不在缓存中，remainingValence为尚未输出的相邻三角形数
+float ForsythVertexScore(int cachePosition, int remainingValence) {
+    if (remainingValence == 0) {
+        // 没有剩余三角形的顶点不再影响选择
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = kLastTriangleScore;
+        } else {
+            const float scaler = 1.0f / (kForsythCacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+    score += kValenceBoostScale * std::pow(static_cast<float>(remainingValence), -kValenceBoostPower);
+    return score;
+}
+
+// 用时间戳模拟FIFO缓存：返回三角形中未命中的顶点数
+// timestamp - cacheTimestamps[v] > cacheSize 表示顶点已被挤出缓存（或从未进入）
+inline int SimulateFifoCache(const Vector3i& triangle, std::vector<unsigned int>& cacheTimestamps,
+                             unsigned int& timestamp, unsigned int cacheSize) {
+    const int vertices[3] = { triangle.x, triangle.y, triangle.z };
+    int misses = 0;
+    for (int j = 0; j < 3; ++j) {
+        unsigned int& vertexTimestamp = cacheTimestamps[vertices[j]];
+        if (timestamp - vertexTimestamp > cacheSize) {
+            vertexTimestamp = timestamp++;
+            ++misses;
+        }
+    }
+    return misses;
+}
+
+// 一段三角形的ACMR（FIFO缓存从空开始）
+float CalculateRangeACMR(const Vector3i* triangles, size_t triangleCount, size_t vertexCount, unsigned int cacheSize) {
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+    std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+    unsigned int timestamp = cacheSize + 1;
+    size_t misses = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        misses += SimulateFifoCache(triangles[t], cacheTimestamps, timestamp, cacheSize);
+    }
+    return static_cast<float>(misses) / triangleCount;
+}
+
+// 顶点位置
+inline Vector3f GetPosition(const std::vector<Vertex>& vertices, int index) {
+    const Vector4f& pos = vertices[index].pos;
+    return Vector3f(pos.x, pos.y, pos.z);
+}
+
+// 按坐标轴编号取分量
+inline float GetComponent(const Vector3f& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+} // namespace
+
+void MeshOptimizer::Optimize(Mesh& mesh) {
+    XYH_PROFILE_SCOPE("MeshOptimizer::Optimize");
+    if (mesh.indices.empty()) {
+        return;
+    }
+
+    // 没有子网格时整个网格作为一个范围优化
+    std::vector<SubMesh> ranges = mesh.subMeshes;
+    if (ranges.empty()) {
+        ranges.push_back(SubMesh(0, mesh.indices.size(), Material()));
+    }
+
+    const unsigned int cacheSize = 16;
+    const float overdrawThreshold = 1.05f;
+    for (const SubMesh& range : ranges) {
+        if (range.triangleCount == 0) {
+            continue;
+        }
+        Vector3i* triangles = &mesh.indices[range.triangleStart];
+        size_t count = range.triangleCount;
+        size_t vertexCount = mesh.vertices.size();
+
+        // 原始顺序已经很好时（如按网格生成的模型）保留原始顺序
+        std::vector<Vector3i> original(triangles, triangles + count);
+        float originalACMR = CalculateRangeACMR(triangles, count, vertexCount, cacheSize);
+        OptimizeVertexCache(triangles, count, vertexCount);
+        float cacheACMR = CalculateRangeACMR(triangles, count, vertexCount, cacheSize);
+        if (cacheACMR > originalACMR) {
+            std::copy(original.begin(), original.end(), triangles);
+            cacheACMR = originalACMR;
+        }
+
+        // 簇排序后ACMR的增长超过阈值时（簇之间缓存不连续）放弃重复绘制优化
+        std::vector<Vector3i> cacheOrder(triangles, triangles + count);
+        OptimizeOverdraw(triangles, count, mesh.vertices, overdrawThreshold);
+        if (CalculateRangeACMR(triangles, count, vertexCount, cacheSize) > cacheACMR * overdrawThreshold) {
+            std::copy(cacheOrder.begin(), cacheOrder.end(), triangles);
+        }
+    }
+
+    OptimizeVertexFetch(mesh);
+}
+
+void MeshOptimizer::OptimizeVertexCache(Vector3i* triangles, size_t triangleCount, size_t vertexCount) {
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // 顶点到相邻三角形的邻接表（每个顶点的前remainingValence项为尚未输出的三角形）
+    std::vector<int> valence(vertexCount, 0);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        ++valence[triangles[t].x];
+        ++valence[triangles[t].y];
+        ++valence[triangles[t].z];
+    }
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+    }
+    std::vector<int> adjacency(adjacencyOffsets[vertexCount]);
+    std::vector<int> remainingValence(vertexCount, 0);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const int vertices[3] = { triangles[t].x, triangles[t].y, triangles[t].z };
+        for (int j = 0; j < 3; ++j) {
+            int v = vertices[j];
+            adjacency[adjacencyOffsets[v] + remainingValence[v]++] = static_cast<int>(t);
+        }
+    }
+
+    // 初始得分
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount, 0.0f);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScore[v] = ForsythVertexScore(-1, remainingValence[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[triangles[t].x] + vertexScore[triangles[t].y] + vertexScore[triangles[t].z];
+        if (triangleScore[t] > bestScore) {
+            bestScore = triangleScore[t];
+            bestTriangle = static_cast<int>(t);
+        }
+    }
+
+    std::vector<Vector3i> result;
+    result.reserve(triangleCount);
+    std::vector<int> cache;
+    std::vector<int> newCache;
+    cache.reserve(kForsythCacheSize + 3);
+    newCache.reserve(kForsythCacheSize + 3);
+    size_t scanCursor = 0;
+
+    while (result.size() < triangleCount) {
+        // 缓存中的顶点没有剩余三角形时，按输入顺序取下一个未输出的三角形
+        if (bestTriangle < 0) {
+            while (emitted[scanCursor]) {
+                ++scanCursor;
+            }
+            bestTriangle = static_cast<int>(scanCursor);
+        }
+
+        // 输出三角形，并从三个顶点的邻接表中移除
+        const Vector3i& triangle = triangles[bestTriangle];
+        result.push_back(triangle);
+        emitted[bestTriangle] = true;
+
+        const int triangleVertices[3] = { triangle.x, triangle.y, triangle.z };
+        for (int j = 0; j < 3; ++j) {
+            int v = triangleVertices[j];
+            int* begin = &adjacency[adjacencyOffsets[v]];
+            int* end = begin + remainingValence[v];
+            int* found = std::find(begin, end, bestTriangle);
+            std::swap(*found, *(end - 1));
+            --remainingValence[v];
+        }
+
+        // 更新LRU缓存：三角形的顶点移到最前面
+        newCache.assign(triangleVertices, triangleVertices + 3);
+        for (int v : cache) {
+            if (v != triangleVertices[0] && v != triangleVertices[1] && v != triangleVertices[2]) {
+                newCache.push_back(v);
+            }
+        }
+
+        // 重新计算缓存中顶点（包括被挤出的顶点）的得分，并把变化量累加到相邻三角形上
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            int v = newCache[i];
+            cachePosition[v] = i < static_cast<size_t>(kForsythCacheSize) ? static_cast<int>(i) : -1;
+            float score = ForsythVertexScore(cachePosition[v], remainingValence[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            const int* adjacentTriangles = &adjacency[adjacencyOffsets[v]];
+            for (int k = 0; k < remainingValence[v]; ++k) {
+                triangleScore[adjacentTriangles[k]] += delta;
+            }
+        }
+        if (newCache.size() > static_cast<size_t>(kForsythCacheSize)) {
+            newCache.resize(kForsythCacheSize);
+        }
+        cache.swap(newCache);
+
+        // 只在缓存顶点的相邻三角形中选择得分最高的
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (int v : cache) {
+            const int* adjacentTriangles = &adjacency[adjacencyOffsets[v]];
+            for (int k = 0; k < remainingValence[v]; ++k) {
+                int t = adjacentTriangles[k];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+
+    std::copy(result.begin(), result.end(), triangles);
+}
+
+void MeshOptimizer::OptimizeOverdraw(Vector3i* triangles, size_t triangleCount, const std::vector<Vertex>& vertices,
+                                     float threshold) {
+    if (triangleCount < 2) {
+        return;
+    }
+
+    const unsigned int cacheSize = 16;
+    std::vector<unsigned int> cacheTimestamps(vertices.size(), 0);
+    unsigned int timestamp = cacheSize + 1;
+
+    // 硬边界：三个顶点都未命中的位置（顶点缓存顺序在这里重新开始），在这里切分不会增加ACMR
+    std::vector<size_t> hardBoundaries;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int misses = SimulateFifoCache(triangles[t], cacheTimestamps, timestamp, cacheSize);
+        if (t == 0 || misses == 3) {
+            hardBoundaries.push_back(t);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // 软边界：在硬边界之间继续切分，切分后每个簇的ACMR不超过原来的threshold倍
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h) {
+        size_t start = hardBoundaries[h];
+        size_t end = hardBoundaries[h + 1];
+
+        timestamp += cacheSize + 1;
+        int clusterMisses = 0;
+        for (size_t t = start; t < end; ++t) {
+            clusterMisses += SimulateFifoCache(triangles[t], cacheTimestamps, timestamp, cacheSize);
+        }
+        float targetACMR = static_cast<float>(clusterMisses) / (end - start) * threshold;
+
+        timestamp += cacheSize + 1;
+        clusters.push_back(start);
+        size_t clusterStart = start;
+        int misses = 0;
+        for (size_t t = start; t < end; ++t) {
+            misses += SimulateFifoCache(triangles[t], cacheTimestamps, timestamp, cacheSize);
+            if (t + 1 < end && static_cast<float>(misses) / (t + 1 - clusterStart) <= targetACMR) {
+                // 新簇从空缓存开始
+                clusters.push_back(t + 1);
+                clusterStart = t + 1;
+                misses = 0;
+                timestamp += cacheSize + 1;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // 网格中心（按面积加权）
+    Vector3f meshCentroid = Vector3f::zero;
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        Vector3f p0 = GetPosition(vertices, triangles[t].x);
+        Vector3f p1 = GetPosition(vertices, triangles[t].y);
+        Vector3f p2 = GetPosition(vertices, triangles[t].z);
+        float area = Vector3f::cross(p1 - p0, p2 - p0).magnitude();
+        meshCentroid += (p0 + p1 + p2) * (area / 3.0f);
+        meshArea += area;
+    }
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : Vector3f::zero;
+
+    // 簇的排序键：簇中心相对网格中心沿簇平均法线的距离，朝外的簇更可能遮挡其他簇，先绘制
+    struct ClusterKey {
+        float sortKey;
+        size_t start;
+        size_t end;
+    };
+    std::vector<ClusterKey> keys;
+    keys.reserve(clusters.size() - 1);
+    for (size_t c = 0; c + 1 < clusters.size(); ++c) {
+        Vector3f centroid = Vector3f::zero;
+        Vector3f normal = Vector3f::zero;
+        float clusterArea = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+            Vector3f p0 = GetPosition(vertices, triangles[t].x);
+            Vector3f p1 = GetPosition(vertices, triangles[t].y);
+            Vector3f p2 = GetPosition(vertices, triangles[t].z);
+            Vector3f areaNormal = Vector3f::cross(p1 - p0, p2 - p0);
+            float area = areaNormal.magnitude();
+            centroid += (p0 + p1 + p2) * (area / 3.0f);
+            normal += areaNormal;
+            clusterArea += area;
+        }
+        float normalLength = normal.magnitude();
+        float sortKey = 0.0f;
+        if (clusterArea > 0.0f && normalLength > 0.0f) {
+            sortKey = Vector3f::dot(centroid / clusterArea - meshCentroid, normal / normalLength);
+        }
+        keys.push_back({ sortKey, clusters[c], clusters[c + 1] });
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+                     [](const ClusterKey& a, const ClusterKey& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<Vector3i> result;
+    result.reserve(triangleCount);
+    for (const ClusterKey& key : keys) {
+        result.insert(result.end(), triangles + key.start, triangles + key.end);
+    }
+    std::copy(result.begin(), result.end(), triangles);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(Mesh& mesh) {
+    std::vector<int> remap(mesh.vertices.size(), -1);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (Vector3i& triangle : mesh.indices) {
+        int* indices[3] = { &triangle.x, &triangle.y, &triangle.z };
+        for (int j = 0; j < 3; ++j) {
+            int& index = *indices[j];
+            if (remap[index] < 0) {
+                remap[index] = static_cast<int>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+            index = remap[index];
+        }
+    }
+    mesh.vertices.swap(vertices);
+}
+
+float MeshOptimizer::CalculateACMR(const std::vector<Vector3i>& indices, size_t vertexCount, int cacheSize) {
+    return CalculateRangeACMR(indices.data(), indices.size(), vertexCount, static_cast<unsigned int>(cacheSize));
+}
+
+float MeshOptimizer::CalculateOverdraw(const Mesh& mesh, int resolution) {
+    if (mesh.indices.empty()) {
+        return 0.0f;
+    }
+
+    Vector3f boundsMin, boundsMax;
+    mesh.CalculateBounds(boundsMin, boundsMax);
+    Vector3f extent = boundsMax - boundsMin;
+    float maxExtent = (std::max)((std::max)(extent.x, extent.y), extent.z);
+    if (maxExtent <= 0.0f) {
+        return 0.0f;
+    }
+    // 留出半个像素的边距，避免边缘三角形落在缓冲区外
+    float scale = (resolution - 1) / maxExtent;
+
+    std::vector<float> depthBuffer(static_cast<size_t>(resolution) * resolution);
+    size_t shadedFragments = 0;
+    size_t coveredPixels = 0;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int direction = -1; direction <= 1; direction += 2) {
+            std::fill(depthBuffer.begin(), depthBuffer.end(), FLT_MAX);
+
+            // 相机位于坐标轴的direction一侧，沿轴向看向网格，屏幕坐标取另外两个分量
+            const int uAxis = (axis + 1) % 3;
+            const int vAxis = (axis + 2) % 3;
+
+            for (const Vector3i& triangle : mesh.indices) {
+                Vector3f p[3] = {
+                    GetPosition(mesh.vertices, triangle.x),
+                    GetPosition(mesh.vertices, triangle.y),
+                    GetPosition(mesh.vertices, triangle.z)
+                };
+
+                // 背面剔除（与渲染器一致，逆时针为正面）
+                Vector3f normal = Vector3f::cross(p[1] - p[0], p[2] - p[0]);
+                if (GetComponent(normal, axis) * direction <= 0.0f) {
+                    continue;
+                }
+
+                float sx[3], sy[3], sz[3];
+                for (int j = 0; j < 3; ++j) {
+                    sx[j] = (GetComponent(p[j], uAxis) - GetComponent(boundsMin, uAxis)) * scale + 0.5f;
+                    sy[j] = (GetComponent(p[j], vAxis) - GetComponent(boundsMin, vAxis)) * scale + 0.5f;
+                    sz[j] = -direction * GetComponent(p[j], axis);  // 越小越近
+                }
+
+                float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+                if (std::abs(area) < 1e-8f) {
+                    continue;
+                }
+                float invArea = 1.0f / area;
+
+                int minX = (std::max)(0, static_cast<int>(std::floor((std::min)((std::min)(sx[0], sx[1]), sx[2]))));
+                int maxX = (std::min)(resolution - 1, static_cast<int>(std::ceil((std::max)((std::max)(sx[0], sx[1]), sx[2]))));
+                int minY = (std::max)(0, static_cast<int>(std::floor((std::min)((std::min)(sy[0], sy[1]), sy[2]))));
+                int maxY = (std::min)(resolution - 1, static_cast<int>(std::ceil((std::max)((std::max)(sy[0], sy[1]), sy[2]))));
+
+                for (int y = minY; y <= maxY; ++y) {
+                    float py = y + 0.5f;
+                    for (int x = minX; x <= maxX; ++x) {
+                        float px = x + 0.5f;
+                        // 重心坐标（同时适用于两种环绕方向）
+                        float w0 = ((sx[1] - px) * (sy[2] - py) - (sx[2] - px) * (sy[1] - py)) * invArea;
+                        float w1 = ((sx[2] - px) * (sy[0] - py) - (sx[0] - px) * (sy[2] - py)) * invArea;
+                        float w2 = 1.0f - w0 - w1;
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                            continue;
+                        }
+
+                        float depth = w0 * sz[0] + w1 * sz[1] + w2 * sz[2];
+                        float& stored = depthBuffer[static_cast<size_t>(y) * resolution + x];
+                        if (depth < stored) {
+                            stored = depth;
+                            ++shadedFragments;
+                        }
+                    }
+                }
+            }
+
+            for (float depth : depthBuffer) {
+                if (depth != FLT_MAX) {
+                    ++coveredPixels;
+                }
+            }
+        }
+    }
+
+    return coveredPixels > 0 ? static_cast<float>(shadedFragments) / coveredPixels : 0.0f;
+}
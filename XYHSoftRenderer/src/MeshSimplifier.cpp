@@ -0,0 +1,500 @@
+#include "../include/MeshSimplifier.h"
+#include "../include/MeshletBuilder.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace {
+
+// 顶点位置（忽略w分量）
+inline Vector3f GetPosition(const std::vector<Vertex>& vertices, int index) {
+    const Vector4f& pos = vertices[index].pos;
+    return Vector3f(pos.x, pos.y, pos.z);
+}
+
+// 二次误差矩阵：Q(p)为p到累加的各平面的距离平方的加权和（对称矩阵只保存上三角）
+struct Quadric {
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight;  // 权重之和，Q(p) / weight为平均距离平方
+
+    Quadric() : a00(0), a01(0), a02(0), a11(0), a12(0), a22(0), b0(0), b1(0), b2(0), c(0), weight(0) {}
+
+    // 平面n·p + d = 0（n为单位向量）
+    void AddPlane(const Vector3f& n, float d, double w) {
+        a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+        a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+        b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    void Add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02;
+        a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        weight += q.weight;
+    }
+
+    double Evaluate(const Vector3f& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        return a00 * x * x + a11 * y * y + a22 * z * z
+             + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+             + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    }
+};
+
+// 组的类型：内部顶点可以沿任意边折叠，边界顶点只能沿边界边折叠，锁定的顶点不移动
+enum VertexKind : unsigned char {
+    KIND_MANIFOLD,
+    KIND_BORDER,
+    KIND_LOCKED
+};
+
+// 边界约束平面相对于三角形平面的权重（防止开放边界向内收缩）
+const float kBorderWeight = 10.0f;
+
+// 折叠后三角形法线与原法线的夹角余弦下限（约75度，超过时视为翻转）
+const float kFlipCos = 0.25f;
+
+// 三角形数少于该值时不再生成下一级LOD
+const size_t kMinLodTriangles = 16;
+
+// 一次简化使三角形减少不到该比例时停止生成LOD
+const float kMinLodReduction = 0.1f;
+
+// 第一级LOD的误差上限（相对包围球半径），之后每一级的上限是上一级误差的kLodErrorGrowth倍
+// 不限制误差时，为了达到目标三角形数，最后几次折叠会把大块平面的边界拉过整个模型
+const float kMinLodError = 0.01f;
+const float kLodErrorGrowth = 2.0f;
+
+// 组之间的边（a < b），triangle为使用这条边的三角形
+struct Edge {
+    int a, b;
+    int triangle;
+
+    bool operator<(const Edge& other) const {
+        return a != other.a ? a < other.a : b < other.b;
+    }
+};
+
+// 候选折叠：from组的顶点折叠到to组，cost为误差的平方
+struct Collapse {
+    int from, to;
+    double cost;
+
+    bool operator<(const Collapse& other) const { return cost < other.cost; }
+};
+
+// 收集存活三角形的所有边（按组排序，同一条边的记录相邻）
+void CollectEdges(const std::vector<int>& corners, const std::vector<unsigned char>& alive,
+                  const std::vector<int>& group, std::vector<Edge>& edges) {
+    edges.clear();
+    for (size_t t = 0; t < alive.size(); t++) {
+        if (!alive[t]) continue;
+        for (int k = 0; k < 3; k++) {
+            int g0 = group[corners[t * 3 + k]];
+            int g1 = group[corners[t * 3 + (k + 1) % 3]];
+            Edge edge;
+            edge.a = (std::min)(g0, g1);
+            edge.b = (std::max)(g0, g1);
+            edge.triangle = static_cast<int>(t);
+            edges.push_back(edge);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+}
+
+// 三角形的法线（未归一化，长度为面积的2倍）
+inline Vector3f TriangleNormal(const Vector3f& p0, const Vector3f& p1, const Vector3f& p2) {
+    return Vector3f::cross(p1 - p0, p2 - p0);
+}
+
+// 两个顶点的纹理坐标是否相同
+inline bool SameTexcoord(const Vertex& a, const Vertex& b) {
+    return a.texcoord.x == b.texcoord.x && a.texcoord.y == b.texcoord.y;
+}
+
+// 查找vertex在目标组中的对应顶点（vertex所在的三角形都不与目标组相连时使用）
+// 同组中纹理坐标相同（同一块UV）的顶点已有对应顶点时，在目标组与那个对应顶点纹理坐标相同的顶点中选法线最接近的，
+// 这样法线不连续的硬边可以折叠，UV接缝保持不变；找不到时返回-1
+// 组内的顶点是链表：firstVertex为组的第一个顶点，nextVertex为同组的下一个顶点（-1结束）
+int FindPartner(const std::vector<Vertex>& vertices, int vertex, const std::vector<std::pair<int, int>>& pairs,
+                int firstVertex, const std::vector<int>& nextVertex) {
+    const Vertex& source = vertices[vertex];
+    for (const auto& pair : pairs) {
+        if (pair.second < 0 || !SameTexcoord(vertices[pair.first], source)) continue;
+        int best = -1;
+        float bestDot = -FLT_MAX;
+        for (int v = firstVertex; v >= 0; v = nextVertex[v]) {
+            if (!SameTexcoord(vertices[v], vertices[pair.second])) continue;
+            float d = Vector3f::dot(vertices[v].normal, source.normal);
+            if (d > bestDot) {
+                best = v;
+                bestDot = d;
+            }
+        }
+        return best;
+    }
+    return -1;
+}
+
+} // namespace
+
+Mesh MeshSimplifier::Simplify(const Mesh& mesh, size_t targetTriangleCount, float targetError, float* resultError) {
+    if (resultError) {
+        *resultError = 0.0f;
+    }
+    size_t vertexCount = mesh.vertices.size();
+    size_t triangleCount = mesh.indices.size();
+
+    // 位置相同的顶点归为一组（按位置排序后相邻的相同位置合并）
+    std::vector<int> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&mesh](int lhs, int rhs) {
+        const Vector4f& a = mesh.vertices[lhs].pos;
+        const Vector4f& b = mesh.vertices[rhs].pos;
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        return a.z < b.z;
+    });
+    std::vector<int> group(vertexCount);
+    std::vector<Vector3f> groupPositions;
+    for (size_t i = 0; i < vertexCount; i++) {
+        Vector3f pos = GetPosition(mesh.vertices, order[i]);
+        if (groupPositions.empty() || pos.x != groupPositions.back().x ||
+            pos.y != groupPositions.back().y || pos.z != groupPositions.back().z) {
+            groupPositions.push_back(pos);
+        }
+        group[order[i]] = static_cast<int>(groupPositions.size() - 1);
+    }
+    size_t groupCount = groupPositions.size();
+
+    // 组内的顶点链表（折叠时可能在组中加入复制的顶点）
+    std::vector<Vertex> vertices(mesh.vertices);
+    std::vector<int> firstVertex(groupCount, -1);
+    std::vector<int> nextVertex(vertexCount, -1);
+    for (size_t i = vertexCount; i-- > 0; ) {
+        nextVertex[order[i]] = firstVertex[group[order[i]]];
+        firstVertex[group[order[i]]] = order[i];
+    }
+
+    // 三角形的顶点和所属的子网格（没有子网格时都属于0），退化和越界的三角形直接丢弃
+    std::vector<int> corners(triangleCount * 3);
+    std::vector<int> triangleSubMesh(triangleCount, 0);
+    std::vector<unsigned char> alive(triangleCount, 0);
+    for (size_t s = 0; s < mesh.subMeshes.size(); s++) {
+        size_t end = (std::min)(mesh.subMeshes[s].triangleStart + mesh.subMeshes[s].triangleCount, triangleCount);
+        for (size_t t = mesh.subMeshes[s].triangleStart; t < end; t++) {
+            triangleSubMesh[t] = static_cast<int>(s);
+        }
+    }
+    size_t liveCount = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const Vector3i& index = mesh.indices[t];
+        corners[t * 3 + 0] = index.x;
+        corners[t * 3 + 1] = index.y;
+        corners[t * 3 + 2] = index.z;
+        if (index.x < 0 || index.y < 0 || index.z < 0 ||
+            index.x >= static_cast<int>(vertexCount) || index.y >= static_cast<int>(vertexCount) || index.z >= static_cast<int>(vertexCount)) {
+            continue;
+        }
+        int g0 = group[index.x], g1 = group[index.y], g2 = group[index.z];
+        if (g0 != g1 && g1 != g2 && g0 != g2) {
+            alive[t] = 1;
+            liveCount++;
+        }
+    }
+
+    // 初始误差：每个组累加相邻三角形所在的平面（按面积加权）
+    std::vector<Quadric> quadrics(groupCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (!alive[t]) continue;
+        int g0 = group[corners[t * 3]], g1 = group[corners[t * 3 + 1]], g2 = group[corners[t * 3 + 2]];
+        Vector3f normal = TriangleNormal(groupPositions[g0], groupPositions[g1], groupPositions[g2]);
+        float length = normal.magnitude();
+        if (length <= 0.0f) continue;
+        normal = normal / length;
+        float d = -Vector3f::dot(normal, groupPositions[g0]);
+        double area = length * 0.5;
+        quadrics[g0].AddPlane(normal, d, area);
+        quadrics[g1].AddPlane(normal, d, area);
+        quadrics[g2].AddPlane(normal, d, area);
+    }
+
+    // 开放边界：只被一个三角形使用的边加上过这条边、垂直于三角形的约束平面
+    std::vector<Edge> edges;
+    CollectEdges(corners, alive, group, edges);
+    for (size_t i = 0; i < edges.size(); ) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b) j++;
+        if (j - i == 1) {
+            int t = edges[i].triangle;
+            const Vector3f& pa = groupPositions[edges[i].a];
+            const Vector3f& pb = groupPositions[edges[i].b];
+            Vector3f faceNormal = TriangleNormal(groupPositions[group[corners[t * 3]]],
+                                                 groupPositions[group[corners[t * 3 + 1]]],
+                                                 groupPositions[group[corners[t * 3 + 2]]]);
+            Vector3f edgeVector = pb - pa;
+            Vector3f normal = Vector3f::cross(edgeVector, faceNormal);
+            float length = normal.magnitude();
+            if (length > 0.0f) {
+                normal = normal / length;
+                float d = -Vector3f::dot(normal, pa);
+                double weight = edgeVector.magnitudeSquared() * kBorderWeight;
+                quadrics[edges[i].a].AddPlane(normal, d, weight);
+                quadrics[edges[i].b].AddPlane(normal, d, weight);
+            }
+        }
+        i = j;
+    }
+
+    std::vector<unsigned char> kind(groupCount);
+    std::vector<int> groupSubMesh(groupCount);
+    std::vector<unsigned char> collapsed(groupCount);
+    std::vector<size_t> adjacencyOffsets(groupCount + 1);
+    std::vector<int> adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<std::pair<int, int>> vertexPairs;
+    double maxCost = 0.0;
+    double targetCost = targetError < FLT_MAX ? static_cast<double>(targetError) * targetError : DBL_MAX;
+
+    // 每一轮按误差从小到大折叠互不相邻的边（同一轮中组只参与一次折叠），然后重新计算候选
+    while (liveCount > targetTriangleCount) {
+        // 组到三角形的邻接表（CSR格式）
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (size_t t = 0; t < triangleCount; t++) {
+            if (!alive[t]) continue;
+            for (int k = 0; k < 3; k++) {
+                adjacencyOffsets[group[corners[t * 3 + k]] + 1]++;
+            }
+        }
+        for (size_t g = 0; g < groupCount; g++) {
+            adjacencyOffsets[g + 1] += adjacencyOffsets[g];
+        }
+        adjacency.resize(adjacencyOffsets[groupCount]);
+        std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++) {
+            if (!alive[t]) continue;
+            for (int k = 0; k < 3; k++) {
+                adjacency[fill[group[corners[t * 3 + k]]]++] = static_cast<int>(t);
+            }
+        }
+
+        // 组的类型：跨越子网格的组锁定，开放边界上的组为边界，非流形边（3个以上三角形）的端点锁定
+        std::fill(kind.begin(), kind.end(), static_cast<unsigned char>(KIND_MANIFOLD));
+        std::fill(groupSubMesh.begin(), groupSubMesh.end(), -1);
+        for (size_t t = 0; t < triangleCount; t++) {
+            if (!alive[t]) continue;
+            for (int k = 0; k < 3; k++) {
+                int g = group[corners[t * 3 + k]];
+                if (groupSubMesh[g] < 0) {
+                    groupSubMesh[g] = triangleSubMesh[t];
+                } else if (groupSubMesh[g] != triangleSubMesh[t]) {
+                    kind[g] = KIND_LOCKED;
+                }
+            }
+        }
+        CollectEdges(corners, alive, group, edges);
+        for (size_t i = 0; i < edges.size(); ) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b) j++;
+            if (j - i == 1 || j - i > 2) {
+                unsigned char edgeKind = j - i == 1 ? KIND_BORDER : KIND_LOCKED;
+                kind[edges[i].a] = (std::max)(kind[edges[i].a], edgeKind);
+                kind[edges[i].b] = (std::max)(kind[edges[i].b], edgeKind);
+            }
+            i = j;
+        }
+
+        // 候选折叠：每条边取两个方向中允许且误差较小的一个
+        collapses.clear();
+        for (size_t i = 0; i < edges.size(); ) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b) j++;
+            bool border = j - i == 1;
+            if (j - i <= 2) {
+                int a = edges[i].a, b = edges[i].b;
+                Quadric q = quadrics[a];
+                q.Add(quadrics[b]);
+                double scale = q.weight > 0.0 ? 1.0 / q.weight : 0.0;
+                Collapse best = { -1, -1, DBL_MAX };
+                for (int direction = 0; direction < 2; direction++) {
+                    int from = direction == 0 ? a : b;
+                    int to = direction == 0 ? b : a;
+                    if (kind[from] == KIND_LOCKED || (kind[from] == KIND_BORDER && !border)) continue;
+                    double cost = (std::max)(q.Evaluate(groupPositions[to]) * scale, 0.0);
+                    if (cost < best.cost) {
+                        best.from = from;
+                        best.to = to;
+                        best.cost = cost;
+                    }
+                }
+                if (best.from >= 0) {
+                    collapses.push_back(best);
+                }
+            }
+            i = j;
+        }
+        std::sort(collapses.begin(), collapses.end());
+
+        std::fill(collapsed.begin(), collapsed.end(), 0);
+        size_t collapseCount = 0;
+        for (const Collapse& collapse : collapses) {
+            if (liveCount <= targetTriangleCount || collapse.cost > targetCost) break;
+            int from = collapse.from, to = collapse.to;
+            if (collapsed[from] || collapsed[to]) continue;
+
+            // from组的每个顶点折叠到与它有边相连的to组顶点上，保持接缝两侧的属性各自连续
+            // 删除的三角形（同时包含两个组）给出顶点的对应关系，剩下的三角形的顶点没有直接对应时按UV和法线查找，
+            // 仍然没有时（纹理坐标按面展开，UV块不延伸到to组）复制这个顶点放到to组的位置（对应顶点记为-1，折叠时生成）
+            bool valid = true;
+            vertexPairs.clear();
+            for (size_t i = adjacencyOffsets[from]; valid && i < adjacencyOffsets[from + 1]; i++) {
+                int t = adjacency[i];
+                if (!alive[t]) continue;
+                int fromCorner = -1, toCorner = -1;
+                for (int k = 0; k < 3; k++) {
+                    int g = group[corners[t * 3 + k]];
+                    if (g == from) fromCorner = corners[t * 3 + k];
+                    if (g == to) toCorner = corners[t * 3 + k];
+                }
+                if (fromCorner < 0 || toCorner < 0) continue;
+                for (const auto& pair : vertexPairs) {
+                    if (pair.first == fromCorner && pair.second != toCorner) {
+                        valid = false;
+                    }
+                }
+                vertexPairs.push_back(std::make_pair(fromCorner, toCorner));
+            }
+            for (size_t i = adjacencyOffsets[from]; valid && i < adjacencyOffsets[from + 1]; i++) {
+                int t = adjacency[i];
+                if (!alive[t]) continue;
+                Vector3f p[3];
+                int fromK = -1;
+                bool hasTo = false;
+                for (int k = 0; k < 3; k++) {
+                    int g = group[corners[t * 3 + k]];
+                    p[k] = groupPositions[g];
+                    if (g == from) fromK = k;
+                    if (g == to) hasTo = true;
+                }
+                if (fromK < 0 || hasTo) continue;
+
+                int corner = corners[t * 3 + fromK];
+                bool paired = false;
+                for (const auto& pair : vertexPairs) {
+                    paired = paired || pair.first == corner;
+                }
+                if (!paired) {
+                    vertexPairs.push_back(std::make_pair(corner, FindPartner(vertices, corner, vertexPairs, firstVertex[to], nextVertex)));
+                }
+                // 折叠后三角形翻转或过度倾斜时放弃
+                Vector3f oldNormal = TriangleNormal(p[0], p[1], p[2]);
+                p[fromK] = groupPositions[to];
+                Vector3f newNormal = TriangleNormal(p[0], p[1], p[2]);
+                valid = Vector3f::dot(oldNormal, newNormal) > kFlipCos * oldNormal.magnitude() * newNormal.magnitude();
+            }
+            if (!valid) continue;
+
+            // 执行折叠：同时包含两个组的三角形退化删除，其余三角形的顶点替换为对应的顶点
+            for (size_t i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1]; i++) {
+                int t = adjacency[i];
+                if (!alive[t]) continue;
+                bool hasTo = false;
+                for (int k = 0; k < 3; k++) {
+                    hasTo = hasTo || group[corners[t * 3 + k]] == to;
+                }
+                if (hasTo) {
+                    alive[t] = 0;
+                    liveCount--;
+                    continue;
+                }
+                for (int k = 0; k < 3; k++) {
+                    int& corner = corners[t * 3 + k];
+                    if (group[corner] != from) continue;
+                    for (auto& pair : vertexPairs) {
+                        if (pair.first != corner) continue;
+                        if (pair.second < 0) {
+                            // 复制的顶点保留原来的法线和纹理坐标，位置移动到to组
+                            Vertex copy = vertices[corner];
+                            copy.pos = vertices[firstVertex[to]].pos;
+                            pair.second = static_cast<int>(vertices.size());
+                            vertices.push_back(copy);
+                            group.push_back(to);
+                            nextVertex.push_back(firstVertex[to]);
+                            firstVertex[to] = pair.second;
+                        }
+                        corner = pair.second;
+                        break;
+                    }
+                }
+            }
+            quadrics[to].Add(quadrics[from]);
+            collapsed[from] = collapsed[to] = 1;
+            maxCost = (std::max)(maxCost, collapse.cost);
+            collapseCount++;
+        }
+        if (collapseCount == 0) break;
+    }
+
+    // 按原顺序输出存活的三角形（子网格的三角形仍然连续），只保留用到的顶点（按第一次使用的顺序）
+    Mesh result;
+    std::vector<int> remap(vertices.size(), -1);
+    result.indices.reserve(liveCount);
+    std::vector<size_t> subMeshCounts((std::max)(mesh.subMeshes.size(), static_cast<size_t>(1)), 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (!alive[t]) continue;
+        int index[3];
+        for (int k = 0; k < 3; k++) {
+            int v = corners[t * 3 + k];
+            if (remap[v] < 0) {
+                remap[v] = static_cast<int>(result.vertices.size());
+                result.vertices.push_back(vertices[v]);
+            }
+            index[k] = remap[v];
+        }
+        result.indices.push_back(Vector3i(index[0], index[1], index[2]));
+        subMeshCounts[triangleSubMesh[t]]++;
+    }
+    size_t triangleStart = 0;
+    for (size_t s = 0; s < mesh.subMeshes.size(); s++) {
+        result.subMeshes.push_back(SubMesh(triangleStart, subMeshCounts[s], mesh.subMeshes[s].material));
+        triangleStart += subMeshCounts[s];
+    }
+
+    if (resultError) {
+        *resultError = static_cast<float>(std::sqrt(maxCost));
+    }
+    return result;
+}
+
+void MeshSimplifier::BuildLods(Mesh& mesh, int maxLevels, float ratio) {
+    XYH_PROFILE_SCOPE("MeshSimplifier::BuildLods");
+    mesh.lods.clear();
+    float error = 0.0f;
+    float maxError = mesh.GetBounds().radius * kMinLodError;
+    for (int level = 0; level < maxLevels; level++) {
+        const Mesh& source = level == 0 ? mesh : mesh.lods.back();
+        size_t sourceTriangles = source.GetTriangleCount();
+        size_t target = static_cast<size_t>(sourceTriangles * ratio);
+        if (target < kMinLodTriangles) break;
+
+        float stepError = 0.0f;
+        Mesh lod = Simplify(source, target, (std::max)(maxError, error * kLodErrorGrowth) - error, &stepError);
+        if (lod.GetTriangleCount() > sourceTriangles * (1.0f - kMinLodReduction)) break;
+
+        // 从上一级简化，误差相对原网格累加
+        error += stepError;
+        lod.lodError = error;
+        if (!mesh.meshlets.empty()) {
+            MeshletBuilder::Build(lod);
+        }
+        mesh.lods.push_back(std::move(lod));
+    }
+}
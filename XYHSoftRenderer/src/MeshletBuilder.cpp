@@ -0,0 +1,309 @@
+#include "../include/MeshletBuilder.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 顶点位置（忽略w分量）
+inline Vector3f GetPosition(const std::vector<Vertex>& vertices, int index) {
+    const Vector4f& pos = vertices[index].pos;
+    return Vector3f(pos.x, pos.y, pos.z);
+}
+
+// 法线锥的夹角余弦小于该值时（簇的表面弯曲太大）不做背面锥剔除
+const float kMinConeCos = 0.1f;
+
+// 选择下一个三角形时法线偏差相对于新增顶点数的权重（越大簇越平，法线锥越窄）
+const float kConeWeight = 1.0f;
+
+// 没有相邻三角形时向后查找的未使用三角形数量
+const size_t kSearchWindow = 64;
+
+} // namespace
+
+void MeshletBuilder::Build(Mesh& mesh, int maxVertices, int maxTriangles) {
+    XYH_PROFILE_SCOPE("MeshletBuilder::Build");
+    mesh.meshlets.clear();
+    mesh.meshletVertices.clear();
+    if (mesh.indices.empty() || maxVertices < 3 || maxTriangles < 1) {
+        return;
+    }
+
+    // 在子网格的边界处切分，簇不跨越子网格（子网格之间的空隙也作为单独的范围）
+    std::vector<size_t> splits;
+    splits.push_back(0);
+    splits.push_back(mesh.indices.size());
+    for (const SubMesh& subMesh : mesh.subMeshes) {
+        splits.push_back((std::min)(subMesh.triangleStart, mesh.indices.size()));
+        splits.push_back((std::min)(subMesh.triangleStart + subMesh.triangleCount, mesh.indices.size()));
+    }
+    std::sort(splits.begin(), splits.end());
+    splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+
+    // 顶点到三角形的邻接表（CSR格式）
+    size_t vertexCount = mesh.vertices.size();
+    size_t triangleCount = mesh.indices.size();
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (const Vector3i& index : mesh.indices) {
+        adjacencyOffsets[index.x + 1]++;
+        adjacencyOffsets[index.y + 1]++;
+        adjacencyOffsets[index.z + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<size_t> adjacency(adjacencyOffsets[vertexCount]);
+    std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        const Vector3i& index = mesh.indices[t];
+        adjacency[fill[index.x]++] = t;
+        adjacency[fill[index.y]++] = t;
+        adjacency[fill[index.z]++] = t;
+    }
+
+    // 三角形的单位法线和中心
+    std::vector<Vector3f> normals(triangleCount);
+    std::vector<Vector3f> centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        const Vector3i& index = mesh.indices[t];
+        Vector3f p0 = GetPosition(mesh.vertices, index.x);
+        Vector3f p1 = GetPosition(mesh.vertices, index.y);
+        Vector3f p2 = GetPosition(mesh.vertices, index.z);
+        normals[t] = Vector3f::cross(p1 - p0, p2 - p0);
+        normals[t].normalize();
+        centroids[t] = (p0 + p1 + p2) * (1.0f / 3.0f);
+    }
+
+    std::vector<Vector3i> ordered;
+    ordered.reserve(triangleCount);
+    std::vector<size_t> meshletSizes;
+    meshletSizes.reserve(triangleCount / maxTriangles + splits.size());
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<size_t> vertexMeshlet(vertexCount, static_cast<size_t>(-1));  // 顶点所在的簇编号
+    std::vector<int> meshletVertices;
+    meshletVertices.reserve(maxVertices);
+
+    // 贪心生成簇：从范围内第一个未使用的三角形开始，每次加入与当前簇相邻、新增顶点最少且法线最接近的三角形
+    for (size_t s = 0; s + 1 < splits.size(); s++) {
+        size_t rangeStart = splits[s];
+        size_t rangeEnd = splits[s + 1];
+        size_t seed = rangeStart;
+
+        while (true) {
+            while (seed < rangeEnd && emitted[seed]) {
+                seed++;
+            }
+            if (seed == rangeEnd) {
+                break;
+            }
+
+            size_t meshletIndex = meshletSizes.size();
+            size_t meshletTriangles = 0;
+            Vector3f axis = Vector3f::zero;
+            Vector3f centroidSum = Vector3f::zero;
+            meshletVertices.clear();
+            size_t next = seed;
+
+            while (true) {
+                const Vector3i& index = mesh.indices[next];
+                const int corners[3] = { index.x, index.y, index.z };
+                for (int corner : corners) {
+                    if (vertexMeshlet[corner] != meshletIndex) {
+                        vertexMeshlet[corner] = meshletIndex;
+                        meshletVertices.push_back(corner);
+                    }
+                }
+                emitted[next] = true;
+                ordered.push_back(index);
+                axis += normals[next];
+                centroidSum += centroids[next];
+                meshletTriangles++;
+                if (meshletTriangles >= static_cast<size_t>(maxTriangles)) {
+                    break;
+                }
+
+                Vector3f direction = axis;
+                direction.normalize();
+                size_t best = triangleCount;
+                float bestScore = 0.0f;
+                for (int vertex : meshletVertices) {
+                    for (size_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; a++) {
+                        size_t t = adjacency[a];
+                        if (emitted[t] || t < rangeStart || t >= rangeEnd) {
+                            continue;
+                        }
+                        const Vector3i& candidate = mesh.indices[t];
+                        int newVertices = (vertexMeshlet[candidate.x] != meshletIndex ? 1 : 0) +
+                                          (vertexMeshlet[candidate.y] != meshletIndex ? 1 : 0) +
+                                          (vertexMeshlet[candidate.z] != meshletIndex ? 1 : 0);
+                        if (meshletVertices.size() + newVertices > static_cast<size_t>(maxVertices)) {
+                            continue;
+                        }
+                        // 退化三角形（法线为零）不影响法线锥，不计入法线偏差
+                        float deviation = normals[t].magnitudeSquared() > 0.0f ? 1.0f - Vector3f::dot(normals[t], direction) : 0.0f;
+                        float score = newVertices + deviation * kConeWeight;
+                        if (best == triangleCount || score < bestScore) {
+                            best = t;
+                            bestScore = score;
+                        }
+                    }
+                }
+
+                // 没有相邻的三角形时（如按面拆分顶点的网格）在后面未使用的三角形中选择离簇中心最近且朝向一致的
+                if (best == triangleCount) {
+                    Vector3f center = centroidSum * (1.0f / meshletTriangles);
+                    float bestDistance = 0.0f;
+                    size_t scanned = 0;
+                    for (size_t t = seed; t < rangeEnd && scanned < kSearchWindow; t++) {
+                        if (emitted[t]) {
+                            continue;
+                        }
+                        scanned++;
+                        const Vector3i& candidate = mesh.indices[t];
+                        int newVertices = (vertexMeshlet[candidate.x] != meshletIndex ? 1 : 0) +
+                                          (vertexMeshlet[candidate.y] != meshletIndex ? 1 : 0) +
+                                          (vertexMeshlet[candidate.z] != meshletIndex ? 1 : 0);
+                        if (meshletVertices.size() + newVertices > static_cast<size_t>(maxVertices) ||
+                            Vector3f::dot(normals[t], direction) < kMinConeCos) {
+                            continue;
+                        }
+                        float distance = (centroids[t] - center).magnitudeSquared();
+                        if (best == triangleCount || distance < bestDistance) {
+                            best = t;
+                            bestDistance = distance;
+                        }
+                    }
+                }
+                if (best == triangleCount) {
+                    break;
+                }
+                next = best;
+            }
+            meshletSizes.push_back(meshletTriangles);
+        }
+    }
+
+    // 按簇的顺序重排三角形（子网格的范围不变）
+    std::copy(ordered.begin(), ordered.end(), mesh.indices.begin());
+
+    // 记录每个簇引用的顶点，计算包围球和法线锥
+    mesh.meshlets.reserve(meshletSizes.size());
+    mesh.meshletVertices.reserve(triangleCount * 3 / 2);
+    std::fill(vertexMeshlet.begin(), vertexMeshlet.end(), static_cast<size_t>(-1));
+    size_t triangleStart = 0;
+    for (size_t m = 0; m < meshletSizes.size(); m++) {
+        Meshlet meshlet;
+        meshlet.triangleStart = triangleStart;
+        meshlet.triangleCount = meshletSizes[m];
+        meshlet.vertexOffset = mesh.meshletVertices.size();
+        for (size_t t = triangleStart; t < triangleStart + meshlet.triangleCount; t++) {
+            const Vector3i& index = mesh.indices[t];
+            const int corners[3] = { index.x, index.y, index.z };
+            for (int corner : corners) {
+                if (vertexMeshlet[corner] != m) {
+                    vertexMeshlet[corner] = m;
+                    mesh.meshletVertices.push_back(corner);
+                    meshlet.vertexCount++;
+                }
+            }
+        }
+        ComputeBounds(mesh, meshlet);
+        mesh.meshlets.push_back(meshlet);
+        triangleStart += meshlet.triangleCount;
+    }
+}
+
+void MeshletBuilder::ComputeBounds(const Mesh& mesh, Meshlet& meshlet) {
+    const int* vertexIndices = &mesh.meshletVertices[meshlet.vertexOffset];
+
+    // 包围球：包围盒中心到最远顶点的距离
+    Vector3f minPos = GetPosition(mesh.vertices, vertexIndices[0]);
+    Vector3f maxPos = minPos;
+    for (size_t i = 1; i < meshlet.vertexCount; i++) {
+        Vector3f pos = GetPosition(mesh.vertices, vertexIndices[i]);
+        minPos = Vector3f::Min(minPos, pos);
+        maxPos = Vector3f::Max(maxPos, pos);
+    }
+    meshlet.center = (minPos + maxPos) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < meshlet.vertexCount; i++) {
+        radiusSquared = (std::max)(radiusSquared, (GetPosition(mesh.vertices, vertexIndices[i]) - meshlet.center).magnitudeSquared());
+    }
+    meshlet.radius = std::sqrt(radiusSquared);
+
+    // 法线锥轴：三角形单位法线的平均方向（法线由环绕顺序决定，逆时针为正面）
+    size_t triangleEnd = meshlet.triangleStart + meshlet.triangleCount;
+    Vector3f axis = Vector3f::zero;
+    for (size_t t = meshlet.triangleStart; t < triangleEnd; t++) {
+        const Vector3i& index = mesh.indices[t];
+        Vector3f p0 = GetPosition(mesh.vertices, index.x);
+        Vector3f normal = Vector3f::cross(GetPosition(mesh.vertices, index.y) - p0, GetPosition(mesh.vertices, index.z) - p0);
+        float length = normal.magnitude();
+        if (length > 0.0f) {
+            axis += normal * (1.0f / length);
+        }
+    }
+    meshlet.coneApex = meshlet.center;
+    meshlet.coneAxis = Vector3f::zero;
+    meshlet.coneCutoff = 1.0f;
+    float axisLength = axis.magnitude();
+    if (axisLength <= 0.0f) {
+        return;
+    }
+    axis = axis * (1.0f / axisLength);
+
+    // 锥的半角：法线与轴夹角的最大值
+    float minCos = 1.0f;
+    for (size_t t = meshlet.triangleStart; t < triangleEnd; t++) {
+        const Vector3i& index = mesh.indices[t];
+        Vector3f p0 = GetPosition(mesh.vertices, index.x);
+        Vector3f normal = Vector3f::cross(GetPosition(mesh.vertices, index.y) - p0, GetPosition(mesh.vertices, index.z) - p0);
+        float length = normal.magnitude();
+        if (length > 0.0f) {
+            minCos = (std::min)(minCos, Vector3f::dot(normal, axis) / length);
+        }
+    }
+    if (minCos <= kMinConeCos) {
+        return;
+    }
+
+    // 锥顶点沿轴反方向移动到所有三角形平面的背面：
+    // 相机在以锥顶点为顶点、半角为(90度 - 法线锥半角)的锥内时，相机在所有三角形平面的背面
+    float maxT = 0.0f;
+    for (size_t t = meshlet.triangleStart; t < triangleEnd; t++) {
+        const Vector3i& index = mesh.indices[t];
+        Vector3f p0 = GetPosition(mesh.vertices, index.x);
+        Vector3f normal = Vector3f::cross(GetPosition(mesh.vertices, index.y) - p0, GetPosition(mesh.vertices, index.z) - p0);
+        float dn = Vector3f::dot(axis, normal);
+        if (dn > 0.0f) {
+            maxT = (std::max)(maxT, Vector3f::dot(meshlet.center - p0, normal) / dn);
+        }
+    }
+    meshlet.coneApex = meshlet.center - axis * maxT;
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(1.0f - minCos * minCos);
+}
+
+bool MeshletBuilder::FindMeshlets(const Mesh& mesh, size_t triangleStart, size_t triangleEnd,
+                                  size_t& firstMeshlet, size_t& endMeshlet) {
+    const std::vector<Meshlet>& meshlets = mesh.meshlets;
+    if (meshlets.empty() || triangleStart >= triangleEnd ||
+        meshlets.back().triangleStart + meshlets.back().triangleCount != mesh.indices.size()) {
+        return false;
+    }
+
+    auto compare = [](const Meshlet& meshlet, size_t triangle) { return meshlet.triangleStart < triangle; };
+    auto first = std::lower_bound(meshlets.begin(), meshlets.end(), triangleStart, compare);
+    if (first == meshlets.end() || first->triangleStart != triangleStart) {
+        return false;
+    }
+    auto end = std::lower_bound(first, meshlets.end(), triangleEnd, compare);
+    if (end == first || (end - 1)->triangleStart + (end - 1)->triangleCount != triangleEnd) {
+        return false;
+    }
+
+    firstMeshlet = first - meshlets.begin();
+    endMeshlet = end - meshlets.begin();
+    return true;
+}
@@ -0,0 +1,228 @@
+#include "../include/MtlFileReader.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+#include <cctype>
+
+namespace {
+
+// 去掉首尾空白
+std::string Trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// 转为小写（用于不区分大小写的文件名比较）
+std::string ToLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// 取路径中的文件名（同时识别/和\分隔符）
+std::string GetFileName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// 是否为绝对路径（/开头、\开头或带盘符）
+bool IsAbsolutePath(const std::string& path) {
+    return !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+}
+
+bool IsRegularFile(const std::string& path) {
+    std::error_code error;
+    return std::filesystem::is_regular_file(std::filesystem::path(path), error);
+}
+
+// 是否为数字记号
+bool IsNumber(const std::string& token) {
+    if (token.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    std::strtof(token.c_str(), &end);
+    return end == token.c_str() + token.size();
+}
+
+// 贴图选项的最大参数个数（-o、-s、-t的参数个数为1~3个）
+int GetMapOptionArgumentCount(const std::string& option) {
+    if (option == "-o" || option == "-s" || option == "-t") {
+        return 3;
+    }
+    if (option == "-mm") {
+        return 2;
+    }
+    // -blendu、-blendv、-boost、-bm、-cc、-clamp、-imfchan、-texres、-type
+    return 1;
+}
+
+} // namespace
+
+std::string MtlFileReader::GetDirectory(const std::string& filePath) {
+    size_t slash = filePath.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : filePath.substr(0, slash + 1);
+}
+
+std::string MtlFileReader::StripMapOptions(const std::string& value) {
+    // 文件名可能包含空格，因此返回第一个非选项记号开始到行尾的全部内容
+    size_t pos = 0;
+    while (true) {
+        pos = value.find_first_not_of(" \t", pos);
+        if (pos == std::string::npos) {
+            return std::string();
+        }
+        if (value[pos] != '-') {
+            return Trim(value.substr(pos));
+        }
+
+        size_t optionEnd = value.find_first_of(" \t", pos);
+        if (optionEnd == std::string::npos) {
+            return std::string();
+        }
+        std::string option = value.substr(pos, optionEnd - pos);
+        pos = optionEnd;
+
+        // 跳过选项参数（数值参数个数可变，遇到非数值时停止）
+        int maxArguments = GetMapOptionArgumentCount(option);
+        for (int i = 0; i < maxArguments; ++i) {
+            size_t tokenBegin = value.find_first_not_of(" \t", pos);
+            if (tokenBegin == std::string::npos) {
+                return std::string();
+            }
+            size_t tokenEnd = value.find_first_of(" \t", tokenBegin);
+            std::string token = value.substr(tokenBegin, tokenEnd == std::string::npos ? std::string::npos : tokenEnd - tokenBegin);
+            // 只有数值参数的个数可变，-clamp on、-imfchan r等参数总是跳过
+            if (i > 0 && !IsNumber(token)) {
+                break;
+            }
+            pos = tokenEnd == std::string::npos ? value.size() : tokenEnd;
+        }
+    }
+}
+
+std::string MtlFileReader::ResolveTexturePath(const std::string& directory, const std::string& texturePath,
+                                              FileIndex& fileIndex) {
+    if (texturePath.empty()) {
+        return std::string();
+    }
+
+    // 绝对路径或相对MTL目录的路径
+    std::string normalized = texturePath;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    if (IsAbsolutePath(normalized)) {
+        if (IsRegularFile(normalized)) {
+            return normalized;
+        }
+    } else if (IsRegularFile(directory + normalized)) {
+        return directory + normalized;
+    }
+
+    // 导出的MTL经常带有其他机器上的绝对路径，在MTL目录下按文件名查找
+    if (fileIndex.empty()) {
+        std::error_code error;
+        std::filesystem::path root = (directory.empty() ? std::string(".") : directory);
+        std::filesystem::recursive_directory_iterator it(root, std::filesystem::directory_options::skip_permission_denied, error);
+        for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+            if (it->is_regular_file(error)) {
+                // 同名文件保留第一个找到的
+                fileIndex.emplace(ToLower(it->path().filename().string()), it->path().string());
+            }
+        }
+    }
+
+    auto found = fileIndex.find(ToLower(GetFileName(normalized)));
+    if (found != fileIndex.end()) {
+        return found->second;
+    }
+    return std::string();
+}
+
+bool MtlFileReader::LoadFromFile(const std::string& filePath, std::vector<Material>& materials) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open MTL file: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string directory = GetDirectory(filePath);
+    FileIndex fileIndex;
+    Material* current = nullptr;
+    bool hasDissolve = false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string prefix;
+        if (!(iss >> prefix) || prefix[0] == '#') {
+            continue;
+        }
+
+        if (prefix == "newmtl") {
+            // 新材质（MTL中的颜色默认值与Material不同，未指定的项保持Material的默认值）
+            std::string rest;
+            std::getline(iss, rest);
+            materials.push_back(Material());
+            current = &materials.back();
+            current->name = Trim(rest);
+            hasDissolve = false;
+            continue;
+        }
+        if (!current) {
+            continue;
+        }
+
+        if (prefix == "Ka" || prefix == "Kd" || prefix == "Ks") {
+            // 颜色 (Kd r g b)，只有一个分量时表示灰度
+            float r = 0.0f, g, b;
+            iss >> r;
+            if (!(iss >> g >> b)) {
+                g = b = r;
+            }
+            Color color(r, g, b, 1.0f);
+            if (prefix == "Ka") {
+                current->ambient = color;
+            } else if (prefix == "Kd") {
+                current->diffuse = color;
+            } else {
+                current->specular = color;
+            }
+        }
+        else if (prefix == "Ns") {
+            // 高光指数
+            iss >> current->shininess;
+        }
+        else if (prefix == "d") {
+            // 不透明度
+            iss >> current->opacity;
+            hasDissolve = true;
+        }
+        else if (prefix == "Tr") {
+            // 透明度（d优先）
+            float transparency = 0.0f;
+            if ((iss >> transparency) && !hasDissolve) {
+                current->opacity = 1.0f - transparency;
+            }
+        }
+        else if (prefix == "map_Kd") {
+            // 漫反射贴图
+            std::string rest;
+            std::getline(iss, rest);
+            std::string texturePath = StripMapOptions(rest);
+            current->diffuseMapPath = ResolveTexturePath(directory, texturePath, fileIndex);
+            if (current->diffuseMapPath.empty()) {
+                std::cerr << "MTL texture not found: " << texturePath << " (material " << current->name << ")" << std::endl;
+            }
+        }
+        // 其他命令（Ni、Tf、illum、map_bump等）忽略
+    }
+
+    return true;
+}
@@ -3,6 +3,19 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <cmath>
+#include <cstdint>
+#include "../include/MappedFile.h"
+#include "../include/MeshCache.h"
+#include "../include/MtlFileReader.h"
+#include "../include/MeshOptimizer.h"
+#include "../include/MeshletBuilder.h"
+#include "../include/MeshSimplifier.h"
+#include "../include/Profiler.h"
 
 ObjFileReader::ObjFileReader() {
 }
@@ -16,8 +29,15 @@ Object ObjFileReader::LoadFromFile(const std::string& filePath) {
 }
 
 Object ObjFileReader::LoadFromFileWithOptions(const std::string& filePath, bool flipNormals, bool flipFaces) {
+    ObjLoadOptions options;
+    options.flipNormals = flipNormals;
+    options.flipFaces = flipFaces;
+    return LoadFromFile(filePath, options);
+}
+
+Object ObjFileReader::LoadFromFile(const std::string& filePath, const ObjLoadOptions& options) {
     // 加载Mesh，可以指定是否翻转法线和面片
-    Mesh mesh = LoadMeshFromFileWithOptions(filePath, flipNormals, flipFaces);
+    Mesh mesh = LoadMeshFromFile(filePath, options);
     
     // 创建默认材质和变换
     Material material;
@@ -33,6 +53,84 @@ Mesh ObjFileReader::LoadMeshFromFile(const std::string& filePath) {
 }
 
 Mesh ObjFileReader::LoadMeshFromFileWithOptions(const std::string& filePath, bool flipNormals, bool flipFaces) {
+    ObjLoadOptions options;
+    options.flipNormals = flipNormals;
+    options.flipFaces = flipFaces;
+    return LoadMeshFromFile(filePath, options);
+}
+
+Mesh ObjFileReader::LoadMeshFromFile(const std::string& filePath, const ObjLoadOptions& options) {
+    XYH_PROFILE_SCOPE("LoadMeshFromFile");
+    
+    // 内存映射整个文件，直接在映射的内存上解析
+    MappedFile file;
+    if (!file.Open(filePath)) {
+        std::cerr << "Failed to open OBJ file: " << filePath << std::endl;
+        return Mesh(); // 返回空Mesh
+    }
+    
+    // 优先使用二进制缓存（按文件内容哈希和加载选项匹配），缓存中已经包含簇和LOD链
+    // 材质不写入缓存，每次从MTL文件读取（MTL修改后不需要重新生成缓存）
+    uint64_t contentHash = 0;
+    std::string cachePath;
+    if (options.useMeshCache) {
+        contentHash = MeshCache::HashContent(file.Data(), file.Size());
+        cachePath = MeshCache::GetCachePath(filePath);
+        
+        Mesh cached;
+        std::vector<std::string> materialLibraries;
+        if (MeshCache::Load(cachePath, contentHash, MeshCache::GetOptionsKey(options), cached, materialLibraries)) {
+            std::cout << "Mesh cache loaded: " << cached.vertices.size() << " vertices, "
+                      << cached.indices.size() << " triangles, "
+                      << cached.subMeshes.size() << " submeshes, "
+                      << cached.lods.size() << " lods" << std::endl;
+            AssignMaterials(cached, filePath, materialLibraries);
+            return cached;
+        }
+    }
+    
+    ObjRawData data;
+    int threadCount = options.threadCount;
+    if (threadCount <= 0) {
+        threadCount = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    if (threadCount > 1) {
+        ParseBufferParallel(file.Data(), file.End(), data, threadCount);
+    } else {
+        ParseBuffer(file.Data(), file.End(), data);
+    }
+    
+    // 从数据构建并返回Mesh，可以指定是否翻转法线和面片
+    Mesh mesh = BuildMesh(data.positions, data.texcoords, data.normals, 
+                          data.positionIndices, data.texcoordIndices, data.normalIndices,
+                          options, data.triangleMaterials, data.materialNames);
+    
+    // 以下结果都写入缓存，只在第一次加载时执行
+    // 按顶点缓存和重复绘制优化三角形顺序
+    if (options.optimizeMesh) {
+        MeshOptimizer::Optimize(mesh);
+    }
+    
+    // 生成簇（在子网格内按簇重排三角形）
+    if (options.buildMeshlets) {
+        MeshletBuilder::Build(mesh);
+    }
+    
+    // 生成LOD链（各级复制子网格的材质名称，材质在之后统一设置）
+    if (options.buildLods) {
+        MeshSimplifier::BuildLods(mesh);
+    }
+    
+    // 写入缓存，下次启动直接加载
+    if (options.useMeshCache && !mesh.vertices.empty()) {
+        MeshCache::Save(cachePath, contentHash, MeshCache::GetOptionsKey(options), mesh, data.materialLibraries);
+    }
+    
+    AssignMaterials(mesh, filePath, data.materialLibraries);
+    return mesh;
+}
+
+Mesh ObjFileReader::LoadMeshFromFileLegacy(const std::string& filePath, bool flipNormals, bool flipFaces) {
     // 存储顶点数据
     std::vector<Vector3f> positions;    // v
     std::vector<Vector2f> texcoords;    // vt
@@ -61,9 +159,442 @@ Mesh ObjFileReader::LoadMeshFromFileWithOptions(const std::string& filePath, boo
     file.close();
     
     // 从数据构建并返回Mesh，可以指定是否翻转法线和面片
+    ObjLoadOptions options;
+    options.flipNormals = flipNormals;
+    options.flipFaces = flipFaces;
     return BuildMesh(positions, texcoords, normals, 
                     positionIndices, texcoordIndices, normalIndices,
-                    flipNormals, flipFaces);
+                    options);
+}
+
+namespace {
+
+// 行内空白字符
+inline bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// 跳过行内空白
+inline const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// 跳到下一个空白字符（跳过当前记号）
+inline const char* SkipToken(const char* p, const char* end) {
+    while (p < end && !IsBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// 解析浮点数，解析失败时置0（与std::istream的行为一致）
+inline const char* ParseFloat(const char* p, const char* end, float& value) {
+    p = SkipBlanks(p, end);
+    if (p < end && *p == '+') {
+        ++p;
+    }
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0.0f;
+        return SkipToken(p, end);
+    }
+    return result.ptr;
+}
+
+// 解析整数，没有数字时返回false
+inline bool ParseInt(const char*& p, const char* end, int& value) {
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+// 将OBJ索引（从1开始，负数表示相对当前末尾）转换为从0开始的索引
+inline int ResolveIndex(int index, size_t count) {
+    return index < 0 ? static_cast<int>(count) + index : index - 1;
+}
+
+// OBJ行的类型（只区分需要处理的命令）
+enum class ObjLineType {
+    Ignored,    // 空行、注释及g、o、s等命令
+    Position,   // v
+    Texcoord,   // vt
+    Normal,     // vn
+    Face,       // f
+    UseMaterial,        // usemtl
+    MaterialLibrary     // mtllib
+};
+
+// 读取行首命令，返回命令之后的位置
+inline const char* ReadLineType(const char* p, const char* lineEnd, ObjLineType& type) {
+    p = SkipBlanks(p, lineEnd);
+    type = ObjLineType::Ignored;
+    if (p >= lineEnd || *p == '#') {
+        return p;
+    }
+    
+    const char* keyword = p;
+    p = SkipToken(p, lineEnd);
+    size_t keywordLength = p - keyword;
+    
+    if (keywordLength == 1 && keyword[0] == 'v') {
+        type = ObjLineType::Position;
+    }
+    else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 't') {
+        type = ObjLineType::Texcoord;
+    }
+    else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 'n') {
+        type = ObjLineType::Normal;
+    }
+    else if (keywordLength == 1 && keyword[0] == 'f') {
+        type = ObjLineType::Face;
+    }
+    else if (keywordLength == 6 && std::memcmp(keyword, "usemtl", 6) == 0) {
+        type = ObjLineType::UseMaterial;
+    }
+    else if (keywordLength == 6 && std::memcmp(keyword, "mtllib", 6) == 0) {
+        type = ObjLineType::MaterialLibrary;
+    }
+    return p;
+}
+
+// 读取命令之后的整行内容（去掉首尾空白，名称中可能包含空格）
+inline std::string ReadLineArgument(const char* p, const char* lineEnd) {
+    p = SkipBlanks(p, lineEnd);
+    while (lineEnd > p && IsBlank(lineEnd[-1])) {
+        --lineEnd;
+    }
+    return std::string(p, lineEnd);
+}
+
+// 查找名称的下标，不存在时追加到末尾
+inline int FindOrAddName(std::vector<std::string>& names, const std::string& name) {
+    auto found = std::find(names.begin(), names.end(), name);
+    if (found != names.end()) {
+        return static_cast<int>(found - names.begin());
+    }
+    names.push_back(name);
+    return static_cast<int>(names.size() - 1);
+}
+
+// 取下一行的结束位置
+inline const char* FindLineEnd(const char* p, const char* end) {
+    const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return lineEnd ? lineEnd : end;
+}
+
+// 每个解析块的最小字节数（小文件多线程的开销大于收益）
+const size_t kMinParallelChunkBytes = 512 * 1024;
+
+// 在count个线程上执行func(0..count-1)，第0块在调用线程上执行
+template<typename Func>
+void RunChunksInParallel(size_t count, const Func& func) {
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (size_t i = 1; i < count; ++i) {
+        workers.emplace_back([&func, i]() {
+            Profiler::SetThreadName("ObjParser");
+            func(i);
+        });
+    }
+    func(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// 合并顶点时使用的键：OBJ索引三元组，没有法线索引时使用面法线的位模式
+struct WeldKey {
+    int position;
+    int texcoord;
+    int normal;
+    uint32_t faceNormal[3];
+    
+    bool operator==(const WeldKey& other) const {
+        return position == other.position && texcoord == other.texcoord && normal == other.normal &&
+               faceNormal[0] == other.faceNormal[0] && faceNormal[1] == other.faceNormal[1] &&
+               faceNormal[2] == other.faceNormal[2];
+    }
+};
+
+struct WeldKeyHash {
+    size_t operator()(const WeldKey& key) const {
+        uint64_t h = static_cast<uint32_t>(key.position) * 0x9E3779B97F4A7C15ull;
+        h ^= (static_cast<uint32_t>(key.texcoord) + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2));
+        h ^= (static_cast<uint32_t>(key.normal) + 0x85157AF5ull + (h << 6) + (h >> 2));
+        for (int i = 0; i < 3; ++i) {
+            h ^= (key.faceNormal[i] + 0x9E3779B9ull + (h << 6) + (h >> 2));
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+// 按容差合并位置时使用的网格单元坐标
+struct WeldCell {
+    int64_t x, y, z;
+    
+    bool operator==(const WeldCell& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+struct WeldCellHash {
+    size_t operator()(const WeldCell& cell) const {
+        uint64_t h = static_cast<uint64_t>(cell.x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint64_t>(cell.y) * 0xC2B2AE3D27D4EB4Full + (h >> 29);
+        h ^= static_cast<uint64_t>(cell.z) * 0x165667B19E3779F9ull + (h >> 32);
+        return static_cast<size_t>(h);
+    }
+};
+
+// 浮点数的位模式
+inline uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+void ObjFileReader::ParseBuffer(const char* begin, const char* end, ObjRawData& data,
+                                const ObjElementCounts& base) {
+    XYH_PROFILE_SCOPE("ParseObj");
+    // 面片顶点的临时存储，在各行之间复用，避免逐行分配
+    std::vector<int> facePositionIndices;
+    std::vector<int> faceTexcoordIndices;
+    std::vector<int> faceNormalIndices;
+    
+    // 当前材质（分块解析时，块内第一个usemtl之前的三角形为-1，合并时沿用上一块的材质）
+    int currentMaterial = -1;
+    
+    const char* p = begin;
+    while (p < end) {
+        // 确定当前行的范围，读取行首命令
+        const char* lineEnd = FindLineEnd(p, end);
+        ObjLineType type;
+        const char* cur = ReadLineType(p, lineEnd, type);
+        p = lineEnd + 1;
+        
+        if (type == ObjLineType::Position) {
+            // 顶点位置 (v x y z)
+            float x, y, z;
+            cur = ParseFloat(cur, lineEnd, x);
+            cur = ParseFloat(cur, lineEnd, y);
+            cur = ParseFloat(cur, lineEnd, z);
+            data.positions.push_back(Vector3f(x, y, z));
+        }
+        else if (type == ObjLineType::Texcoord) {
+            // 纹理坐标 (vt u v)
+            float u, v;
+            cur = ParseFloat(cur, lineEnd, u);
+            cur = ParseFloat(cur, lineEnd, v);
+            // 翻转V坐标以匹配DirectX/OpenGL纹理坐标系统
+            data.texcoords.push_back(Vector2f(u, 1.0f - v));
+        }
+        else if (type == ObjLineType::Normal) {
+            // 法线 (vn x y z)
+            float x, y, z;
+            cur = ParseFloat(cur, lineEnd, x);
+            cur = ParseFloat(cur, lineEnd, y);
+            cur = ParseFloat(cur, lineEnd, z);
+            data.normals.push_back(Vector3f(x, y, z));
+        }
+        else if (type == ObjLineType::Face) {
+            // 面 (f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3 ...)
+            facePositionIndices.clear();
+            faceTexcoordIndices.clear();
+            faceNormalIndices.clear();
+            
+            while (true) {
+                cur = SkipBlanks(cur, lineEnd);
+                if (cur >= lineEnd) {
+                    break;
+                }
+                
+                // 读取位置索引（必须有）
+                int pi = 0;
+                if (!ParseInt(cur, lineEnd, pi)) {
+                    cur = SkipToken(cur, lineEnd);
+                    continue;
+                }
+                
+                int ti = -1;
+                int ni = 0; // 没有法线时使用默认法线（与旧实现一致）
+                
+                // 读取纹理坐标索引（可选）
+                if (cur < lineEnd && *cur == '/') {
+                    ++cur;
+                    int value = 0;
+                    if (ParseInt(cur, lineEnd, value)) {
+                        ti = ResolveIndex(value, base.texcoords + data.texcoords.size());
+                    }
+                    
+                    // 读取法线索引（可选）
+                    if (cur < lineEnd && *cur == '/') {
+                        ++cur;
+                        if (ParseInt(cur, lineEnd, value)) {
+                            ni = ResolveIndex(value, base.normals + data.normals.size());
+                        }
+                    }
+                }
+                cur = SkipToken(cur, lineEnd);
+                
+                facePositionIndices.push_back(ResolveIndex(pi, base.positions + data.positions.size()));
+                faceTexcoordIndices.push_back(ti);
+                faceNormalIndices.push_back(ni);
+            }
+            
+            // 以扇形方式三角化（三角形保持原样，四边形拆分为(0,1,2)和(0,2,3)）
+            for (size_t k = 1; k + 1 < facePositionIndices.size(); ++k) {
+                data.positionIndices.push_back(facePositionIndices[0]);
+                data.positionIndices.push_back(facePositionIndices[k]);
+                data.positionIndices.push_back(facePositionIndices[k + 1]);
+                
+                data.texcoordIndices.push_back(faceTexcoordIndices[0]);
+                data.texcoordIndices.push_back(faceTexcoordIndices[k]);
+                data.texcoordIndices.push_back(faceTexcoordIndices[k + 1]);
+                
+                data.normalIndices.push_back(faceNormalIndices[0]);
+                data.normalIndices.push_back(faceNormalIndices[k]);
+                data.normalIndices.push_back(faceNormalIndices[k + 1]);
+                
+                data.triangleMaterials.push_back(currentMaterial);
+            }
+        }
+        else if (type == ObjLineType::UseMaterial) {
+            // 切换材质 (usemtl name)
+            currentMaterial = FindOrAddName(data.materialNames, ReadLineArgument(cur, lineEnd));
+        }
+        else if (type == ObjLineType::MaterialLibrary) {
+            // 材质库 (mtllib file.mtl)
+            FindOrAddName(data.materialLibraries, ReadLineArgument(cur, lineEnd));
+        }
+        // 其他命令（g、o、s等）忽略
+    }
+    data.lastMaterial = currentMaterial;
+}
+
+ObjFileReader::ObjElementCounts ObjFileReader::CountElements(const char* begin, const char* end) {
+    XYH_PROFILE_SCOPE("CountObjElements");
+    ObjElementCounts counts;
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = FindLineEnd(p, end);
+        ObjLineType type;
+        ReadLineType(p, lineEnd, type);
+        p = lineEnd + 1;
+        
+        if (type == ObjLineType::Position) {
+            ++counts.positions;
+        }
+        else if (type == ObjLineType::Texcoord) {
+            ++counts.texcoords;
+        }
+        else if (type == ObjLineType::Normal) {
+            ++counts.normals;
+        }
+    }
+    return counts;
+}
+
+void ObjFileReader::ParseBufferParallel(const char* begin, const char* end, ObjRawData& data, int threadCount) {
+    size_t size = end - begin;
+    size_t chunkCount = (std::min)(static_cast<size_t>(threadCount), size / kMinParallelChunkBytes);
+    if (chunkCount <= 1) {
+        ParseBuffer(begin, end, data);
+        return;
+    }
+    
+    // 按行边界切分，每块从行首开始
+    std::vector<const char*> bounds(chunkCount + 1);
+    bounds[0] = begin;
+    bounds[chunkCount] = end;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char* p = (std::max)(begin + size / chunkCount * i, bounds[i - 1]);
+        const char* lineEnd = FindLineEnd(p, end);
+        bounds[i] = lineEnd < end ? lineEnd + 1 : end;
+    }
+    
+    // 第一遍：统计每块的顶点数据数量
+    std::vector<ObjElementCounts> counts(chunkCount);
+    RunChunksInParallel(chunkCount, [&](size_t i) {
+        counts[i] = CountElements(bounds[i], bounds[i + 1]);
+    });
+    
+    // 前缀和得到每块的起始编号，负索引据此解析为全局索引
+    std::vector<ObjElementCounts> bases(chunkCount);
+    ObjElementCounts total;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        bases[i] = total;
+        total.positions += counts[i].positions;
+        total.texcoords += counts[i].texcoords;
+        total.normals += counts[i].normals;
+    }
+    
+    // 第二遍：各块独立解析
+    std::vector<ObjRawData> chunks(chunkCount);
+    RunChunksInParallel(chunkCount, [&](size_t i) {
+        chunks[i].positions.reserve(counts[i].positions);
+        chunks[i].texcoords.reserve(counts[i].texcoords);
+        chunks[i].normals.reserve(counts[i].normals);
+        ParseBuffer(bounds[i], bounds[i + 1], chunks[i], bases[i]);
+    });
+    
+    // 按顺序合并（索引已是全局索引，直接拼接）
+    std::vector<size_t> indexOffsets(chunkCount);
+    size_t indexCount = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        indexOffsets[i] = indexCount;
+        indexCount += chunks[i].positionIndices.size();
+    }
+    
+    // 材质名称按块的顺序合并为全局编号，块开头未指定材质的三角形沿用上一块最后的材质
+    std::vector<std::vector<int>> materialRemaps(chunkCount);
+    std::vector<int> inheritedMaterials(chunkCount);
+    int lastMaterial = -1;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const ObjRawData& chunk = chunks[i];
+        for (const std::string& library : chunk.materialLibraries) {
+            FindOrAddName(data.materialLibraries, library);
+        }
+        for (const std::string& name : chunk.materialNames) {
+            materialRemaps[i].push_back(FindOrAddName(data.materialNames, name));
+        }
+        inheritedMaterials[i] = lastMaterial;
+        if (chunk.lastMaterial >= 0) {
+            lastMaterial = materialRemaps[i][chunk.lastMaterial];
+        }
+    }
+    data.lastMaterial = lastMaterial;
+    
+    data.positions.resize(total.positions);
+    data.texcoords.resize(total.texcoords);
+    data.normals.resize(total.normals);
+    data.positionIndices.resize(indexCount);
+    data.texcoordIndices.resize(indexCount);
+    data.normalIndices.resize(indexCount);
+    data.triangleMaterials.resize(indexCount / 3);
+    
+    RunChunksInParallel(chunkCount, [&](size_t i) {
+        const ObjRawData& chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), data.positions.begin() + bases[i].positions);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), data.texcoords.begin() + bases[i].texcoords);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), data.normals.begin() + bases[i].normals);
+        std::copy(chunk.positionIndices.begin(), chunk.positionIndices.end(), data.positionIndices.begin() + indexOffsets[i]);
+        std::copy(chunk.texcoordIndices.begin(), chunk.texcoordIndices.end(), data.texcoordIndices.begin() + indexOffsets[i]);
+        std::copy(chunk.normalIndices.begin(), chunk.normalIndices.end(), data.normalIndices.begin() + indexOffsets[i]);
+        
+        int* materials = data.triangleMaterials.data() + indexOffsets[i] / 3;
+        for (size_t t = 0; t < chunk.triangleMaterials.size(); ++t) {
+            int material = chunk.triangleMaterials[t];
+            materials[t] = material >= 0 ? materialRemaps[i][material] : inheritedMaterials[i];
+        }
+    });
 }
 
 void ObjFileReader::ParseLine(const std::string& line, 
@@ -156,16 +687,11 @@ void ObjFileReader::ParseLine(const std::string& line,
                 }
             }
             
-            // 添加纹理坐标索引
+            // 添加纹理坐标索引（缺失时记为-1，由BuildMesh生成UV）
             if (hasTexcoord && ti > 0 && ti <= texcoords.size()) {
                 faceTexcoordIndices.push_back(ti - 1);
             } else {
-                // 如果没有纹理坐标，使用顶点的相对位置作为UV
-                Vector3f pos = positions[facePositionIndices.back()];
-                float u = (pos.x + 1.0f) * 0.5f; // 将x坐标映射到[0,1]
-                float v = (pos.y + 1.0f) * 0.5f; // 将y坐标映射到[0,1]
-                texcoords.push_back(Vector2f(u, v));
-                faceTexcoordIndices.push_back(texcoords.size() - 1);
+                faceTexcoordIndices.push_back(-1);
             }
             
             // 添加法线索引
@@ -213,14 +739,72 @@ void ObjFileReader::ParseLine(const std::string& line,
     }
 }
 
+std::vector<int> ObjFileReader::WeldPositions(const std::vector<Vector3f>& positions, float epsilon) {
+    // 将位置量化到边长为epsilon的网格中，同一单元内的位置合并为第一个出现的位置
+    std::vector<int> remap(positions.size());
+    std::unordered_map<WeldCell, int, WeldCellHash> cells;
+    cells.reserve(positions.size());
+    
+    float inverseEpsilon = 1.0f / epsilon;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const Vector3f& p = positions[i];
+        WeldCell cell = {
+            static_cast<int64_t>(std::floor(p.x * inverseEpsilon)),
+            static_cast<int64_t>(std::floor(p.y * inverseEpsilon)),
+            static_cast<int64_t>(std::floor(p.z * inverseEpsilon))
+        };
+        remap[i] = cells.emplace(cell, static_cast<int>(i)).first->second;
+    }
+    return remap;
+}
+
+void ObjFileReader::AssignMaterials(Mesh& mesh, const std::string& filePath,
+                                   const std::vector<std::string>& materialLibraries) {
+    if (materialLibraries.empty()) {
+        return;
+    }
+    
+    // mtllib中的路径相对OBJ文件所在目录
+    std::vector<Material> materials;
+    std::string directory = MtlFileReader::GetDirectory(filePath);
+    for (const std::string& library : materialLibraries) {
+        MtlFileReader::LoadFromFile(directory + library, materials);
+    }
+    if (materials.empty()) {
+        return;
+    }
+    
+    // LOD的子网格与原网格使用相同的材质名称
+    for (size_t level = 0; level <= mesh.lods.size(); ++level) {
+        Mesh& target = level == 0 ? mesh : mesh.lods[level - 1];
+        for (SubMesh& subMesh : target.subMeshes) {
+            if (subMesh.material.name.empty()) {
+                continue;
+            }
+            auto found = std::find_if(materials.begin(), materials.end(),
+                                      [&subMesh](const Material& material) { return material.name == subMesh.material.name; });
+            if (found != materials.end()) {
+                subMesh.material = *found;
+            } else if (level == 0) {
+                std::cerr << "OBJ material not found in MTL: " << subMesh.material.name << std::endl;
+            }
+        }
+    }
+}
+
 Mesh ObjFileReader::BuildMesh(const std::vector<Vector3f>& positions,
                             const std::vector<Vector2f>& texcoords,
                             const std::vector<Vector3f>& normals,
                             const std::vector<int>& positionIndices,
                             const std::vector<int>& texcoordIndices,
                             const std::vector<int>& normalIndices,
-                            bool flipNormals,
-                            bool flipFaces) {
+                            const ObjLoadOptions& options,
+                            const std::vector<int>& triangleMaterials,
+                            const std::vector<std::string>& materialNames) {
+    XYH_PROFILE_SCOPE("BuildMesh");
+    bool flipNormals = options.flipNormals;
+    bool flipFaces = options.flipFaces;
+    
     // 创建新的Mesh
     Mesh mesh;
     
@@ -230,14 +814,34 @@ Mesh ObjFileReader::BuildMesh(const std::vector<Vector3f>& positions,
         return mesh;
     }
     
-    // 确保有有效的纹理坐标
-    bool hasTexcoords = !texcoords.empty() && !texcoordIndices.empty() && 
-                       texcoords.size() > 0 && texcoordIndices.size() >= positionIndices.size();
+    // 确保每个顶点都有纹理坐标索引（索引为-1时由位置生成UV）
+    bool hasTexcoords = texcoordIndices.size() >= positionIndices.size();
     
     // 确保有有效的法线
     bool hasNormals = !normals.empty() && !normalIndices.empty() && 
                      normals.size() > 0 && normalIndices.size() >= positionIndices.size();
     
+    // 按容差合并位置（只在开启顶点合并时生效）
+    std::vector<int> positionRemap;
+    if (options.weldVertices && options.weldEpsilon > 0.0f) {
+        positionRemap = WeldPositions(positions, options.weldEpsilon);
+    }
+    
+    // (位置,纹理坐标,法线)到已生成顶点的映射
+    std::unordered_map<WeldKey, int, WeldKeyHash> vertexMap;
+    if (options.weldVertices) {
+        vertexMap.reserve(positionIndices.size());
+    }
+    mesh.vertices.reserve(options.weldVertices ? positionIndices.size() / 2 : positionIndices.size());
+    mesh.indices.reserve(positionIndices.size() / 3);
+    
+    // 每个三角形的材质（只在OBJ指定了材质时记录）
+    bool hasMaterials = triangleMaterials.size() >= positionIndices.size() / 3;
+    std::vector<int> meshMaterials;
+    if (hasMaterials) {
+        meshMaterials.reserve(positionIndices.size() / 3);
+    }
+    
     // 添加所有顶点
     for (size_t i = 0; i < positionIndices.size(); i += 3) {
         // 确保有足够的索引来构成一个三角形
@@ -245,6 +849,18 @@ Mesh ObjFileReader::BuildMesh(const std::vector<Vector3f>& positions,
             break;
         }
         
+        // 跳过引用了不存在顶点的三角形
+        bool validTriangle = true;
+        for (int j = 0; j < 3; ++j) {
+            int pIdx = positionIndices[i + j];
+            if (pIdx < 0 || pIdx >= static_cast<int>(positions.size())) {
+                validTriangle = false;
+            }
+        }
+        if (!validTriangle) {
+            continue;
+        }
+        
         // 决定顶点的添加顺序（是否翻转面片）
         int order[3] = {0, 1, 2}; // 默认顺序
         if (flipFaces) {
@@ -254,29 +870,77 @@ Mesh ObjFileReader::BuildMesh(const std::vector<Vector3f>& positions,
             order[2] = 1;
         }
         
-        // 为三角形添加三个顶点（可能按照翻转后的顺序）
+        // 三角形三个顶点的位置索引（可能按容差合并）
+        int trianglePositions[3];
+        for (int j = 0; j < 3; ++j) {
+            int pIdx = positionIndices[i + order[j]];
+            trianglePositions[j] = positionRemap.empty() ? pIdx : positionRemap[pIdx];
+        }
+        
+        // 没有法线时使用面法线
+        Vector3f faceNormal(0.0f, 0.0f, 0.0f);
+        if (!hasNormals) {
+            Vector3f edge1 = positions[trianglePositions[1]] - positions[trianglePositions[0]];
+            Vector3f edge2 = positions[trianglePositions[2]] - positions[trianglePositions[0]];
+            faceNormal = Vector3f::cross(edge1, edge2).normalize();
+            
+            // 如果需要，翻转法线
+            if (flipNormals) {
+                faceNormal = -faceNormal;
+            }
+        }
+        
+        // 为三角形添加三个顶点（可能按照翻转后的顺序），相同的顶点只添加一次
+        int triangleIndices[3];
         for (int j = 0; j < 3; ++j) {
             int vertexIndex = order[j]; // 使用可能翻转后的索引顺序
             
             // 获取当前点的索引
-            int pIdx = positionIndices[i + vertexIndex];
-            int tIdx = hasTexcoords ? texcoordIndices[i + vertexIndex] : 0;
-            int nIdx = hasNormals ? normalIndices[i + vertexIndex] : 0;
+            int pIdx = trianglePositions[j];
+            int tIdx = hasTexcoords ? texcoordIndices[i + vertexIndex] : -1;
+            int nIdx = hasNormals ? normalIndices[i + vertexIndex] : -1;
+            
+            // 无效的索引统一记为-1
+            if (tIdx < 0 || tIdx >= static_cast<int>(texcoords.size())) {
+                tIdx = -1;
+            }
+            if (nIdx < 0 || nIdx >= static_cast<int>(normals.size())) {
+                nIdx = -1;
+            }
+            
+            WeldKey key = { pIdx, tIdx, nIdx, { 0, 0, 0 } };
+            if (options.weldVertices) {
+                if (!hasNormals) {
+                    key.faceNormal[0] = FloatBits(faceNormal.x);
+                    key.faceNormal[1] = FloatBits(faceNormal.y);
+                    key.faceNormal[2] = FloatBits(faceNormal.z);
+                }
+                auto found = vertexMap.find(key);
+                if (found != vertexMap.end()) {
+                    triangleIndices[j] = found->second;
+                    continue;
+                }
+            }
             
             // 获取位置（必须有）
             Vector3f position = positions[pIdx];
             
-            // 获取纹理坐标（如果有）
-            Vector2f texcoord = hasTexcoords && tIdx < texcoords.size() ? 
-                               texcoords[tIdx] : Vector2f(0.0f, 0.0f);
+            // 获取纹理坐标（如果有），没有纹理坐标时使用顶点的相对位置作为UV
+            Vector2f texcoord = tIdx >= 0 ? 
+                               texcoords[tIdx] : 
+                               Vector2f((position.x + 1.0f) * 0.5f, (position.y + 1.0f) * 0.5f);
             
             // 获取法线（如果有），可能需要翻转
-            Vector3f normal = hasNormals && nIdx < normals.size() ? 
-                             normals[nIdx] : Vector3f(0.0f, 1.0f, 0.0f);
-            
-            // 如果需要，翻转法线
-            if (flipNormals) {
-                normal = -normal;
+            Vector3f normal;
+            if (!hasNormals) {
+                normal = faceNormal;
+            } else {
+                normal = nIdx >= 0 ? normals[nIdx] : Vector3f(0.0f, 1.0f, 0.0f);
+                
+                // 如果需要，翻转法线
+                if (flipNormals) {
+                    normal = -normal;
+                }
             }
             
             // 创建顶点并添加到Mesh
@@ -287,55 +951,56 @@ Mesh ObjFileReader::BuildMesh(const std::vector<Vector3f>& positions,
                 texcoord
             );
             
+            triangleIndices[j] = static_cast<int>(mesh.vertices.size());
             mesh.AddVertex(vertex);
+            if (options.weldVertices) {
+                vertexMap.emplace(key, triangleIndices[j]);
+            }
         }
         
         // 添加当前三角形的索引
-        int baseIndex = mesh.vertices.size() - 3;
-        mesh.AddTriangle(baseIndex, baseIndex + 1, baseIndex + 2);
+        mesh.AddTriangle(triangleIndices[0], triangleIndices[1], triangleIndices[2]);
+        if (hasMaterials) {
+            meshMaterials.push_back(triangleMaterials[i / 3]);
+        }
     }
     
-    // 如果没有法线，计算面法线
-    if (!hasNormals) {
-        for (size_t i = 0; i < mesh.indices.size(); ++i) {
-            const Vector3i& index = mesh.indices[i];
-            
-            // 获取三角形的三个顶点
-            Vector3f v0 = Vector3f(
-                mesh.vertices[index.x].pos.x, 
-                mesh.vertices[index.x].pos.y, 
-                mesh.vertices[index.x].pos.z
-            );
-            Vector3f v1 = Vector3f(
-                mesh.vertices[index.y].pos.x, 
-                mesh.vertices[index.y].pos.y, 
-                mesh.vertices[index.y].pos.z
-            );
-            Vector3f v2 = Vector3f(
-                mesh.vertices[index.z].pos.x, 
-                mesh.vertices[index.z].pos.y, 
-                mesh.vertices[index.z].pos.z
-            );
-            
-            // 计算面法线
-            Vector3f edge1 = v1 - v0;
-            Vector3f edge2 = v2 - v0;
-            Vector3f normal = Vector3f::cross(edge1, edge2).normalize();
-            
-            // 如果需要，翻转法线
-            if (flipNormals) {
-                normal = -normal;
+    // 按材质对三角形做稳定的计数排序（未指定材质的排在最前），每种材质生成一个子网格
+    if (!hasMaterials) {
+        mesh.subMeshes.push_back(SubMesh(0, mesh.indices.size(), Material()));
+    } else {
+        size_t groupCount = materialNames.size() + 1;
+        std::vector<size_t> groupStarts(groupCount + 1, 0);
+        for (int material : meshMaterials) {
+            ++groupStarts[material + 2];
+        }
+        for (size_t g = 1; g <= groupCount; ++g) {
+            groupStarts[g] += groupStarts[g - 1];
+        }
+        
+        std::vector<Vector3i> sortedIndices(mesh.indices.size());
+        std::vector<size_t> cursors(groupStarts.begin(), groupStarts.end() - 1);
+        for (size_t t = 0; t < mesh.indices.size(); ++t) {
+            sortedIndices[cursors[meshMaterials[t] + 1]++] = mesh.indices[t];
+        }
+        mesh.indices.swap(sortedIndices);
+        
+        for (size_t g = 0; g < groupCount; ++g) {
+            size_t count = groupStarts[g + 1] - groupStarts[g];
+            if (count == 0) {
+                continue;
             }
-            
-            // 设置三角形每个顶点的法线
-            mesh.vertices[index.x].normal = normal;
-            mesh.vertices[index.y].normal = normal;
-            mesh.vertices[index.z].normal = normal;
+            Material material;
+            if (g > 0) {
+                material.name = materialNames[g - 1];
+            }
+            mesh.subMeshes.push_back(SubMesh(groupStarts[g], count, material));
         }
     }
     
     std::cout << "OBJ Loaded: " << mesh.vertices.size() << " vertices, " 
-              << mesh.indices.size() << " triangles" 
+              << mesh.indices.size() << " triangles, "
+              << mesh.subMeshes.size() << " submeshes"
               << (flipNormals ? " (normals flipped)" : "")
               << (flipFaces ? " (faces flipped)" : "")
               << std::endl;
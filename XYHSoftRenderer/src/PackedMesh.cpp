@@ -0,0 +1,488 @@
+#include "../include/PackedMesh.h"
+#include "../include/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 补齐到一批顶点的整数倍，批量加载时不会越界
+size_t PadToBatch(size_t count) {
+    return (count + VertexBatch::kSize - 1) / VertexBatch::kSize * VertexBatch::kSize;
+}
+
+// float转半精度浮点（就近舍入到偶数）
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t rawExponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // 无穷大和NaN
+    if (rawExponent == 0xFF) {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+
+    int exponent = static_cast<int>(rawExponent) - 127 + 15;
+    if (exponent >= 31) {
+        // 超出范围
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    if (exponent <= 0) {
+        // 非规格化数
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    // 进位可能进入指数位，结果仍然正确
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+// 半精度浮点转float
+float HalfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    if (exponent == 0) {
+        // 零和非规格化数
+        float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    }
+
+    uint32_t bits;
+    if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 八面体映射：单位法线投影到八面体再展开到[-1,1]^2
+void EncodeOctahedral(const Vector3f& normal, int16_t& outX, int16_t& outY) {
+    float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    float x = 0.0f, y = 0.0f;
+    if (sum > 0.0f) {
+        x = normal.x / sum;
+        y = normal.y / sum;
+        if (normal.z < 0.0f) {
+            // 下半球折叠到四个角
+            float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+    }
+    outX = static_cast<int16_t>(std::lround((std::max)(-1.0f, (std::min)(1.0f, x)) * 32767.0f));
+    outY = static_cast<int16_t>(std::lround((std::max)(-1.0f, (std::min)(1.0f, y)) * 32767.0f));
+}
+
+Vector3f DecodeOctahedral(int16_t octX, int16_t octY) {
+    float x = octX / 32767.0f;
+    float y = octY / 32767.0f;
+    float z = 1.0f - std::abs(x) - std::abs(y);
+    float t = (std::max)(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    return Vector3f(x, y, z).normalize();
+}
+
+// 量化到[0,65535]
+uint16_t QuantizeUnorm16(float value, float offset, float range) {
+    if (range <= 0.0f) {
+        return 0;
+    }
+    float normalized = (std::max)(0.0f, (std::min)(1.0f, (value - offset) / range));
+    return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+}
+
+// 颜色分量转8位
+uint32_t ToUnorm8(float value) {
+    return static_cast<uint32_t>(std::lround((std::max)(0.0f, (std::min)(1.0f, value)) * 255.0f));
+}
+
+#if defined(XYH_SIMD_AVX2)
+// 八面体解码（8路）
+inline void DecodeOctahedral8(__m256 x, __m256 y, float* outX, float* outY, float* outZ) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 z = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_andnot_ps(signMask, x)),
+                             _mm256_andnot_ps(signMask, y));
+    __m256 t = _mm256_max_ps(_mm256_sub_ps(_mm256_setzero_ps(), z), _mm256_setzero_ps());
+    // x -= copysign(t, x)
+    x = _mm256_sub_ps(x, _mm256_or_ps(t, _mm256_and_ps(x, signMask)));
+    y = _mm256_sub_ps(y, _mm256_or_ps(t, _mm256_and_ps(y, signMask)));
+    __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+                                                 _mm256_mul_ps(z, z)));
+    __m256 inverseLength = _mm256_div_ps(_mm256_set1_ps(1.0f), length);
+    _mm256_store_ps(outX, _mm256_mul_ps(x, inverseLength));
+    _mm256_store_ps(outY, _mm256_mul_ps(y, inverseLength));
+    _mm256_store_ps(outZ, _mm256_mul_ps(z, inverseLength));
+}
+#elif defined(XYH_SIMD_SSE2)
+// 4个int16符号扩展为int32后转float（SSE2没有pmovsx）
+inline __m128 LoadInt16x4(const int16_t* data) {
+    __m128i value = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16));
+}
+
+// 4个uint16零扩展为int32后转float
+inline __m128 LoadUint16x4(const uint16_t* data) {
+    __m128i value = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(value, _mm_setzero_si128()));
+}
+
+// 八面体解码（4路）
+inline void DecodeOctahedral4(__m128 x, __m128 y, float* outX, float* outY, float* outZ) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 z = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_andnot_ps(signMask, x)), _mm_andnot_ps(signMask, y));
+    __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+    x = _mm_sub_ps(x, _mm_or_ps(t, _mm_and_ps(x, signMask)));
+    y = _mm_sub_ps(y, _mm_or_ps(t, _mm_and_ps(y, signMask)));
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+    __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), length);
+    _mm_store_ps(outX, _mm_mul_ps(x, inverseLength));
+    _mm_store_ps(outY, _mm_mul_ps(y, inverseLength));
+    _mm_store_ps(outZ, _mm_mul_ps(z, inverseLength));
+}
+#endif
+
+} // namespace
+
+void VertexBatch::LoadVertices(const Vertex* vertices, int vertexCount) {
+    count = vertexCount;
+    for (int i = 0; i < kSize; ++i) {
+        const Vertex& vertex = vertices[(std::min)(i, vertexCount - 1)];
+        positionX[i] = vertex.pos.x;
+        positionY[i] = vertex.pos.y;
+        positionZ[i] = vertex.pos.z;
+        normalX[i] = vertex.normal.x;
+        normalY[i] = vertex.normal.y;
+        normalZ[i] = vertex.normal.z;
+        texcoordU[i] = vertex.texcoord.x;
+        texcoordV[i] = vertex.texcoord.y;
+        colorR[i] = vertex.color.x;
+        colorG[i] = vertex.color.y;
+        colorB[i] = vertex.color.z;
+        colorA[i] = vertex.color.w;
+    }
+}
+
+void VertexBatch::LoadVertices(const Vertex* vertices, const int* indices, int vertexCount) {
+    count = vertexCount;
+    for (int i = 0; i < kSize; ++i) {
+        const Vertex& vertex = vertices[indices[(std::min)(i, vertexCount - 1)]];
+        positionX[i] = vertex.pos.x;
+        positionY[i] = vertex.pos.y;
+        positionZ[i] = vertex.pos.z;
+        normalX[i] = vertex.normal.x;
+        normalY[i] = vertex.normal.y;
+        normalZ[i] = vertex.normal.z;
+        texcoordU[i] = vertex.texcoord.x;
+        texcoordV[i] = vertex.texcoord.y;
+        colorR[i] = vertex.color.x;
+        colorG[i] = vertex.color.y;
+        colorB[i] = vertex.color.z;
+        colorA[i] = vertex.color.w;
+    }
+}
+
+PackedMesh::PackedMesh()
+    : indices(), subMeshes(), m_format(), m_vertexCount(0),
+      m_texcoordOffset(0.0f, 0.0f), m_texcoordScale(0.0f, 0.0f) {}
+
+PackedMesh PackedMesh::FromMesh(const Mesh& mesh, const PackedMeshFormat& format) {
+    PackedMesh packed;
+    packed.m_format = format;
+    packed.m_vertexCount = mesh.vertices.size();
+    packed.indices = mesh.indices;
+    packed.subMeshes = mesh.subMeshes;
+
+    size_t count = mesh.vertices.size();
+    size_t padded = PadToBatch(count);
+
+    // 位置
+    packed.m_positionX.assign(padded, 0.0f);
+    packed.m_positionY.assign(padded, 0.0f);
+    packed.m_positionZ.assign(padded, 0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        packed.m_positionX[i] = mesh.vertices[i].pos.x;
+        packed.m_positionY[i] = mesh.vertices[i].pos.y;
+        packed.m_positionZ[i] = mesh.vertices[i].pos.z;
+    }
+
+    // 法线
+    if (format.normalFormat == NormalFormat::Octahedral16) {
+        packed.m_normalOctX.assign(padded, 0);
+        packed.m_normalOctY.assign(padded, 0);
+        for (size_t i = 0; i < count; ++i) {
+            EncodeOctahedral(mesh.vertices[i].normal, packed.m_normalOctX[i], packed.m_normalOctY[i]);
+        }
+    } else {
+        packed.m_normalX.assign(padded, 0.0f);
+        packed.m_normalY.assign(padded, 0.0f);
+        packed.m_normalZ.assign(padded, 0.0f);
+        for (size_t i = 0; i < count; ++i) {
+            packed.m_normalX[i] = mesh.vertices[i].normal.x;
+            packed.m_normalY[i] = mesh.vertices[i].normal.y;
+            packed.m_normalZ[i] = mesh.vertices[i].normal.z;
+        }
+    }
+
+    // 纹理坐标
+    if (format.texcoordFormat == TexcoordFormat::Float2) {
+        packed.m_texcoordU.assign(padded, 0.0f);
+        packed.m_texcoordV.assign(padded, 0.0f);
+        for (size_t i = 0; i < count; ++i) {
+            packed.m_texcoordU[i] = mesh.vertices[i].texcoord.x;
+            packed.m_texcoordV[i] = mesh.vertices[i].texcoord.y;
+        }
+    } else if (format.texcoordFormat == TexcoordFormat::Half2) {
+        packed.m_texcoordQuantizedU.assign(padded, 0);
+        packed.m_texcoordQuantizedV.assign(padded, 0);
+        for (size_t i = 0; i < count; ++i) {
+            packed.m_texcoordQuantizedU[i] = FloatToHalf(mesh.vertices[i].texcoord.x);
+            packed.m_texcoordQuantizedV[i] = FloatToHalf(mesh.vertices[i].texcoord.y);
+        }
+    } else {
+        // 按纹理坐标的范围量化
+        Vector2f uvMin(0.0f, 0.0f), uvMax(0.0f, 0.0f);
+        if (count > 0) {
+            uvMin = uvMax = mesh.vertices[0].texcoord;
+        }
+        for (size_t i = 1; i < count; ++i) {
+            const Vector2f& uv = mesh.vertices[i].texcoord;
+            uvMin = Vector2f((std::min)(uvMin.x, uv.x), (std::min)(uvMin.y, uv.y));
+            uvMax = Vector2f((std::max)(uvMax.x, uv.x), (std::max)(uvMax.y, uv.y));
+        }
+        Vector2f range(uvMax.x - uvMin.x, uvMax.y - uvMin.y);
+        packed.m_texcoordOffset = uvMin;
+        packed.m_texcoordScale = Vector2f(range.x / 65535.0f, range.y / 65535.0f);
+
+        packed.m_texcoordQuantizedU.assign(padded, 0);
+        packed.m_texcoordQuantizedV.assign(padded, 0);
+        for (size_t i = 0; i < count; ++i) {
+            packed.m_texcoordQuantizedU[i] = QuantizeUnorm16(mesh.vertices[i].texcoord.x, uvMin.x, range.x);
+            packed.m_texcoordQuantizedV[i] = QuantizeUnorm16(mesh.vertices[i].texcoord.y, uvMin.y, range.y);
+        }
+    }
+
+    // 颜色
+    if (format.includeColor) {
+        packed.m_colors.assign(padded, 0xFFFFFFFFu);
+        for (size_t i = 0; i < count; ++i) {
+            const Vector4f& color = mesh.vertices[i].color;
+            packed.m_colors[i] = ToUnorm8(color.x) | (ToUnorm8(color.y) << 8) |
+                                 (ToUnorm8(color.z) << 16) | (ToUnorm8(color.w) << 24);
+        }
+    }
+
+    return packed;
+}
+
+Mesh PackedMesh::ToMesh() const {
+    Mesh mesh;
+    mesh.vertices.reserve(m_vertexCount);
+    for (size_t i = 0; i < m_vertexCount; ++i) {
+        mesh.vertices.push_back(GetVertex(i));
+    }
+    mesh.indices = indices;
+    mesh.subMeshes = subMeshes;
+    return mesh;
+}
+
+Vertex PackedMesh::GetVertex(size_t index) const {
+    Vector4f position(m_positionX[index], m_positionY[index], m_positionZ[index], 1.0f);
+
+    Vector3f normal;
+    if (m_format.normalFormat == NormalFormat::Octahedral16) {
+        normal = DecodeOctahedral(m_normalOctX[index], m_normalOctY[index]);
+    } else {
+        normal = Vector3f(m_normalX[index], m_normalY[index], m_normalZ[index]);
+    }
+
+    Vector2f texcoord;
+    if (m_format.texcoordFormat == TexcoordFormat::Float2) {
+        texcoord = Vector2f(m_texcoordU[index], m_texcoordV[index]);
+    } else if (m_format.texcoordFormat == TexcoordFormat::Half2) {
+        texcoord = Vector2f(HalfToFloat(m_texcoordQuantizedU[index]), HalfToFloat(m_texcoordQuantizedV[index]));
+    } else {
+        texcoord = Vector2f(m_texcoordOffset.x + m_texcoordQuantizedU[index] * m_texcoordScale.x,
+                            m_texcoordOffset.y + m_texcoordQuantizedV[index] * m_texcoordScale.y);
+    }
+
+    Vector4f color(1.0f, 1.0f, 1.0f, 1.0f);
+    if (m_format.includeColor) {
+        uint32_t packed = m_colors[index];
+        color = Vector4f((packed & 0xFF) / 255.0f, ((packed >> 8) & 0xFF) / 255.0f,
+                         ((packed >> 16) & 0xFF) / 255.0f, (packed >> 24) / 255.0f);
+    }
+
+    return Vertex(position, color, normal, texcoord);
+}
+
+void PackedMesh::LoadBatch(size_t first, VertexBatch& batch) const {
+    // first必须是VertexBatch::kSize的倍数（数组按批补齐，整批加载不会越界）
+    batch.count = static_cast<int>((std::min)(static_cast<size_t>(VertexBatch::kSize), m_vertexCount - first));
+
+#if defined(XYH_SIMD_AVX2)
+    // 位置
+    _mm256_store_ps(batch.positionX, _mm256_loadu_ps(&m_positionX[first]));
+    _mm256_store_ps(batch.positionY, _mm256_loadu_ps(&m_positionY[first]));
+    _mm256_store_ps(batch.positionZ, _mm256_loadu_ps(&m_positionZ[first]));
+
+    // 法线
+    if (m_format.normalFormat == NormalFormat::Octahedral16) {
+        const __m256 scale = _mm256_set1_ps(1.0f / 32767.0f);
+        __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_normalOctX[first])))), scale);
+        __m256 y = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_normalOctY[first])))), scale);
+        DecodeOctahedral8(x, y, batch.normalX, batch.normalY, batch.normalZ);
+    } else {
+        _mm256_store_ps(batch.normalX, _mm256_loadu_ps(&m_normalX[first]));
+        _mm256_store_ps(batch.normalY, _mm256_loadu_ps(&m_normalY[first]));
+        _mm256_store_ps(batch.normalZ, _mm256_loadu_ps(&m_normalZ[first]));
+    }
+
+    // 纹理坐标
+    if (m_format.texcoordFormat == TexcoordFormat::Float2) {
+        _mm256_store_ps(batch.texcoordU, _mm256_loadu_ps(&m_texcoordU[first]));
+        _mm256_store_ps(batch.texcoordV, _mm256_loadu_ps(&m_texcoordV[first]));
+    } else if (m_format.texcoordFormat == TexcoordFormat::Unorm16) {
+        __m256 u = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_texcoordQuantizedU[first]))));
+        __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_texcoordQuantizedV[first]))));
+        _mm256_store_ps(batch.texcoordU, _mm256_add_ps(_mm256_set1_ps(m_texcoordOffset.x),
+                                                       _mm256_mul_ps(u, _mm256_set1_ps(m_texcoordScale.x))));
+        _mm256_store_ps(batch.texcoordV, _mm256_add_ps(_mm256_set1_ps(m_texcoordOffset.y),
+                                                       _mm256_mul_ps(v, _mm256_set1_ps(m_texcoordScale.y))));
+    } else {
+#if defined(XYH_SIMD_F16C)
+        _mm256_store_ps(batch.texcoordU, _mm256_cvtph_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_texcoordQuantizedU[first]))));
+        _mm256_store_ps(batch.texcoordV, _mm256_cvtph_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_texcoordQuantizedV[first]))));
+#else
+        for (int i = 0; i < VertexBatch::kSize; ++i) {
+            batch.texcoordU[i] = HalfToFloat(m_texcoordQuantizedU[first + i]);
+            batch.texcoordV[i] = HalfToFloat(m_texcoordQuantizedV[first + i]);
+        }
+#endif
+    }
+
+    // 颜色
+    if (m_format.includeColor) {
+        const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+        const __m256i mask = _mm256_set1_epi32(0xFF);
+        __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_colors[first]));
+        _mm256_store_ps(batch.colorR, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(packed, mask)), scale));
+        _mm256_store_ps(batch.colorG, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, 8), mask)), scale));
+        _mm256_store_ps(batch.colorB, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, 16), mask)), scale));
+        _mm256_store_ps(batch.colorA, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(packed, 24)), scale));
+    } else {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        _mm256_store_ps(batch.colorR, one);
+        _mm256_store_ps(batch.colorG, one);
+        _mm256_store_ps(batch.colorB, one);
+        _mm256_store_ps(batch.colorA, one);
+    }
+#elif defined(XYH_SIMD_SSE2)
+    // 每次处理4个顶点
+    for (int lane = 0; lane < VertexBatch::kSize; lane += 4) {
+        size_t i = first + lane;
+
+        _mm_store_ps(batch.positionX + lane, _mm_loadu_ps(&m_positionX[i]));
+        _mm_store_ps(batch.positionY + lane, _mm_loadu_ps(&m_positionY[i]));
+        _mm_store_ps(batch.positionZ + lane, _mm_loadu_ps(&m_positionZ[i]));
+
+        if (m_format.normalFormat == NormalFormat::Octahedral16) {
+            const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+            __m128 x = _mm_mul_ps(LoadInt16x4(&m_normalOctX[i]), scale);
+            __m128 y = _mm_mul_ps(LoadInt16x4(&m_normalOctY[i]), scale);
+            DecodeOctahedral4(x, y, batch.normalX + lane, batch.normalY + lane, batch.normalZ + lane);
+        } else {
+            _mm_store_ps(batch.normalX + lane, _mm_loadu_ps(&m_normalX[i]));
+            _mm_store_ps(batch.normalY + lane, _mm_loadu_ps(&m_normalY[i]));
+            _mm_store_ps(batch.normalZ + lane, _mm_loadu_ps(&m_normalZ[i]));
+        }
+
+        if (m_format.texcoordFormat == TexcoordFormat::Float2) {
+            _mm_store_ps(batch.texcoordU + lane, _mm_loadu_ps(&m_texcoordU[i]));
+            _mm_store_ps(batch.texcoordV + lane, _mm_loadu_ps(&m_texcoordV[i]));
+        } else if (m_format.texcoordFormat == TexcoordFormat::Unorm16) {
+            _mm_store_ps(batch.texcoordU + lane, _mm_add_ps(_mm_set1_ps(m_texcoordOffset.x),
+                                                            _mm_mul_ps(LoadUint16x4(&m_texcoordQuantizedU[i]), _mm_set1_ps(m_texcoordScale.x))));
+            _mm_store_ps(batch.texcoordV + lane, _mm_add_ps(_mm_set1_ps(m_texcoordOffset.y),
+                                                            _mm_mul_ps(LoadUint16x4(&m_texcoordQuantizedV[i]), _mm_set1_ps(m_texcoordScale.y))));
+        } else {
+            for (int k = 0; k < 4; ++k) {
+                batch.texcoordU[lane + k] = HalfToFloat(m_texcoordQuantizedU[i + k]);
+                batch.texcoordV[lane + k] = HalfToFloat(m_texcoordQuantizedV[i + k]);
+            }
+        }
+
+        if (m_format.includeColor) {
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_colors[i]));
+            _mm_store_ps(batch.colorR + lane, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, mask)), scale));
+            _mm_store_ps(batch.colorG + lane, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 8), mask)), scale));
+            _mm_store_ps(batch.colorB + lane, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 16), mask)), scale));
+            _mm_store_ps(batch.colorA + lane, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(packed, 24)), scale));
+        } else {
+            const __m128 one = _mm_set1_ps(1.0f);
+            _mm_store_ps(batch.colorR + lane, one);
+            _mm_store_ps(batch.colorG + lane, one);
+            _mm_store_ps(batch.colorB + lane, one);
+            _mm_store_ps(batch.colorA + lane, one);
+        }
+    }
+#else
+    // 标量实现
+    for (int lane = 0; lane < batch.count; ++lane) {
+        Vertex vertex = GetVertex(first + lane);
+        batch.positionX[lane] = vertex.pos.x;
+        batch.positionY[lane] = vertex.pos.y;
+        batch.positionZ[lane] = vertex.pos.z;
+        batch.normalX[lane] = vertex.normal.x;
+        batch.normalY[lane] = vertex.normal.y;
+        batch.normalZ[lane] = vertex.normal.z;
+        batch.texcoordU[lane] = vertex.texcoord.x;
+        batch.texcoordV[lane] = vertex.texcoord.y;
+        batch.colorR[lane] = vertex.color.x;
+        batch.colorG[lane] = vertex.color.y;
+        batch.colorB[lane] = vertex.color.z;
+        batch.colorA[lane] = vertex.color.w;
+    }
+#endif
+}
+
+size_t PackedMesh::GetMemoryBytes() const {
+    return m_positionX.size() * sizeof(float) * 3 +
+           m_normalX.size() * sizeof(float) * 3 +
+           m_normalOctX.size() * sizeof(int16_t) * 2 +
+           m_texcoordU.size() * sizeof(float) * 2 +
+           m_texcoordQuantizedU.size() * sizeof(uint16_t) * 2 +
+           m_colors.size() * sizeof(uint32_t) +
+           indices.size() * sizeof(Vector3i);
+}
@@ -0,0 +1,119 @@
+#include "../include/PipelineStatistics.h"
+#include <mutex>
+
+std::atomic<bool> PipelineCounters::s_enabled(false);
+
+namespace {
+
+thread_local PipelineStatistics t_localStatistics;
+
+// 各线程合并后的总数
+std::mutex g_totalMutex;
+PipelineStatistics g_totalStatistics;
+
+} // namespace
+
+void PipelineStatistics::Reset()
+{
+    verticesShaded = 0;
+    trianglesSubmitted = 0;
+    trianglesBackfaceCulled = 0;
+    trianglesClipRejected = 0;
+    trianglesClipped = 0;
+    trianglesZeroArea = 0;
+    trianglesRasterized = 0;
+    pixelsTested = 0;
+    pixelsCovered = 0;
+    depthTestsPassed = 0;
+    depthTestsFailed = 0;
+    fragmentsShaded = 0;
+    for (int i = 0; i < kFilterModes; i++) {
+        textureSamples[i] = 0;
+    }
+    for (int i = 0; i < kMipLevels; i++) {
+        mipLevelSamples[i] = 0;
+    }
+}
+
+uint64_t PipelineStatistics::GetTextureSampleCount() const
+{
+    uint64_t count = 0;
+    for (int i = 0; i < kFilterModes; i++) {
+        count += textureSamples[i];
+    }
+    return count;
+}
+
+PipelineStatistics& PipelineStatistics::operator+=(const PipelineStatistics& other)
+{
+    verticesShaded += other.verticesShaded;
+    trianglesSubmitted += other.trianglesSubmitted;
+    trianglesBackfaceCulled += other.trianglesBackfaceCulled;
+    trianglesClipRejected += other.trianglesClipRejected;
+    trianglesClipped += other.trianglesClipped;
+    trianglesZeroArea += other.trianglesZeroArea;
+    trianglesRasterized += other.trianglesRasterized;
+    pixelsTested += other.pixelsTested;
+    pixelsCovered += other.pixelsCovered;
+    depthTestsPassed += other.depthTestsPassed;
+    depthTestsFailed += other.depthTestsFailed;
+    fragmentsShaded += other.fragmentsShaded;
+    for (int i = 0; i < kFilterModes; i++) {
+        textureSamples[i] += other.textureSamples[i];
+    }
+    for (int i = 0; i < kMipLevels; i++) {
+        mipLevelSamples[i] += other.mipLevelSamples[i];
+    }
+    return *this;
+}
+
+PipelineStatistics PipelineStatistics::operator-(const PipelineStatistics& other) const
+{
+    PipelineStatistics result;
+    result.verticesShaded = verticesShaded - other.verticesShaded;
+    result.trianglesSubmitted = trianglesSubmitted - other.trianglesSubmitted;
+    result.trianglesBackfaceCulled = trianglesBackfaceCulled - other.trianglesBackfaceCulled;
+    result.trianglesClipRejected = trianglesClipRejected - other.trianglesClipRejected;
+    result.trianglesClipped = trianglesClipped - other.trianglesClipped;
+    result.trianglesZeroArea = trianglesZeroArea - other.trianglesZeroArea;
+    result.trianglesRasterized = trianglesRasterized - other.trianglesRasterized;
+    result.pixelsTested = pixelsTested - other.pixelsTested;
+    result.pixelsCovered = pixelsCovered - other.pixelsCovered;
+    result.depthTestsPassed = depthTestsPassed - other.depthTestsPassed;
+    result.depthTestsFailed = depthTestsFailed - other.depthTestsFailed;
+    result.fragmentsShaded = fragmentsShaded - other.fragmentsShaded;
+    for (int i = 0; i < kFilterModes; i++) {
+        result.textureSamples[i] = textureSamples[i] - other.textureSamples[i];
+    }
+    for (int i = 0; i < kMipLevels; i++) {
+        result.mipLevelSamples[i] = mipLevelSamples[i] - other.mipLevelSamples[i];
+    }
+    return result;
+}
+
+void PipelineCounters::SetEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+PipelineStatistics& PipelineCounters::Local()
+{
+    return t_localStatistics;
+}
+
+void PipelineCounters::FlushLocal()
+{
+    std::lock_guard<std::mutex> lock(g_totalMutex);
+    g_totalStatistics += t_localStatistics;
+    t_localStatistics.Reset();
+}
+
+PipelineStatistics PipelineCounters::Collect()
+{
+    std::lock_guard<std::mutex> lock(g_totalMutex);
+    g_totalStatistics += t_localStatistics;
+    t_localStatistics.Reset();
+    PipelineStatistics result = g_totalStatistics;
+    g_totalStatistics.Reset();
+    return result;
+}
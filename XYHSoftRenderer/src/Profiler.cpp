@@ -0,0 +1,307 @@
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+std::atomic<bool> Profiler::s_active(false);
+std::atomic<int64_t> Profiler::s_clockOverhead(0);
+
+namespace {
+
+// 一个线程的环形缓冲区：只有所属线程写入，写完事件后再发布写入位置
+struct ThreadBuffer {
+    int id;                             // trace中的tid
+    std::string name;                   // 线程名称（受g_registryMutex保护）
+    bool inUse;                         // 是否属于某个存活的线程（受g_registryMutex保护）
+    std::vector<Profiler::Event> events;
+    std::atomic<uint64_t> writeIndex;   // 已写入的事件总数
+
+    explicit ThreadBuffer(int bufferId)
+        : id(bufferId), inUse(true), events(Profiler::kBufferCapacity), writeIndex(0) {}
+};
+
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+// 线程退出时归还缓冲区，之后创建的线程复用（场景更新和OBJ解析每次都创建新线程，避免缓冲区无限增加）
+struct ThreadBufferHolder {
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadBufferHolder()
+    {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            buffer->inUse = false;
+        }
+    }
+};
+
+thread_local ThreadBufferHolder t_bufferHolder;
+
+// 当前线程的名称（缓冲区在第一次记录事件时才分配，名称先保存在这里）
+thread_local const char* t_threadName = nullptr;
+
+// 当前线程本帧各阶段的总时间
+thread_local int64_t t_stageTimes[static_cast<int>(ProfileStage::Count)] = {};
+thread_local unsigned t_stageSampleCounter = 0;
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+std::atomic<int> g_frameIndex(0);
+int64_t g_frameStart = -1;  // 当前帧的开始时间（只由渲染线程访问）
+
+// 捕获状态
+std::mutex g_captureMutex;
+bool g_enabled = false;     // SetEnabled设置的持续记录
+int g_captureFirst = -1;    // 捕获的帧范围，没有捕获时为-1
+int g_captureLast = -1;
+std::string g_capturePath;
+
+ThreadBuffer& GetThreadBuffer()
+{
+    if (!t_bufferHolder.buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (std::unique_ptr<ThreadBuffer>& buffer : g_buffers) {
+            if (!buffer->inUse) {
+                buffer->inUse = true;
+                t_bufferHolder.buffer = buffer.get();
+                break;
+            }
+        }
+        if (!t_bufferHolder.buffer) {
+            g_buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<int>(g_buffers.size()) + 1));
+            t_bufferHolder.buffer = g_buffers.back().get();
+        }
+        t_bufferHolder.buffer->name = t_threadName ? t_threadName : "";
+    }
+    return *t_bufferHolder.buffer;
+}
+
+void Record(const char* name, int64_t start, int64_t value, int frame, char phase)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    Profiler::Event& event = buffer.events[index % Profiler::kBufferCapacity];
+    event.name = name;
+    event.start = start;
+    event.value = value;
+    event.frame = frame;
+    event.phase = phase;
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+// 复制缓冲区中仍然有效的事件（导出时其他线程可能还在写入）
+void CopyEvents(const ThreadBuffer& buffer, std::vector<Profiler::Event>& events)
+{
+    const uint64_t capacity = Profiler::kBufferCapacity;
+    uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+    size_t offset = events.size();
+    for (uint64_t i = begin; i < end; i++) {
+        events.push_back(buffer.events[i % capacity]);
+    }
+
+    // 复制期间写入位置前进了，被覆盖（或正在写入）的最早的事件丢弃
+    uint64_t newEnd = buffer.writeIndex.load(std::memory_order_acquire);
+    uint64_t firstValid = newEnd + 1 > capacity ? newEnd + 1 - capacity : 0;
+    if (firstValid > begin) {
+        size_t dropped = static_cast<size_t>((std::min)(firstValid - begin, end - begin));
+        events.erase(events.begin() + offset, events.begin() + offset + dropped);
+    }
+}
+
+void WriteEscaped(std::ostringstream& out, const std::string& text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            out << c;
+        }
+    }
+}
+
+} // namespace
+
+void Profiler::SetEnabled(bool enabled)
+{
+    CalibrateClock();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    g_enabled = enabled;
+    s_active.store(g_enabled || g_captureFirst >= 0, std::memory_order_relaxed);
+}
+
+void Profiler::BeginFrame()
+{
+    int64_t now = Now();
+    int frame = g_frameIndex.load(std::memory_order_relaxed);
+    if (IsEnabled() && g_frameStart >= 0) {
+        Record("Frame", g_frameStart, now - g_frameStart, frame, 'X');
+        for (int i = 0; i < static_cast<int>(ProfileStage::Count); i++) {
+            Record(GetStageName(static_cast<ProfileStage>(i)), g_frameStart, t_stageTimes[i], frame, 'C');
+        }
+    }
+    std::fill(std::begin(t_stageTimes), std::end(t_stageTimes), 0);
+    g_frameStart = now;
+    frame++;
+    g_frameIndex.store(frame, std::memory_order_relaxed);
+
+    // 捕获的最后一帧已结束：写入文件，恢复为捕获前的记录状态
+    std::string path;
+    int first, last;
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+        if (g_captureFirst < 0 || frame <= g_captureLast) {
+            return;
+        }
+        path = g_capturePath;
+        first = g_captureFirst;
+        last = g_captureLast;
+        g_captureFirst = g_captureLast = -1;
+        s_active.store(g_enabled, std::memory_order_relaxed);
+    }
+    WriteChromeTrace(path, first, last);
+}
+
+int Profiler::GetFrameIndex()
+{
+    return g_frameIndex.load(std::memory_order_relaxed);
+}
+
+void Profiler::StartCapture(int frameCount, const std::string& path)
+{
+    CalibrateClock();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    g_captureFirst = GetFrameIndex() + 1;
+    g_captureLast = g_captureFirst + (std::max)(frameCount, 1) - 1;
+    g_capturePath = path;
+    s_active.store(true, std::memory_order_relaxed);
+}
+
+bool Profiler::IsCapturing()
+{
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    return g_captureFirst >= 0;
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    t_threadName = name;
+    if (t_bufferHolder.buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_bufferHolder.buffer->name = name;
+    }
+}
+
+std::string Profiler::ExportChromeTrace(int firstFrame, int lastFrame)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[";
+    bool firstEvent = true;
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    std::vector<Event> events;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : g_buffers) {
+        events.clear();
+        CopyEvents(*buffer, events);
+
+        out << (firstEvent ? "\n" : ",\n");
+        firstEvent = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+        if (buffer->name.empty()) {
+            out << "Thread " << buffer->id;
+        } else {
+            WriteEscaped(out, buffer->name);
+        }
+        out << "\"}}";
+
+        for (const Event& event : events) {
+            if (event.frame < firstFrame || event.frame > lastFrame) {
+                continue;
+            }
+            // 时间单位为微秒
+            out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase
+                << "\",\"ts\":" << event.start / 1000.0 << ",\"pid\":1,\"tid\":" << buffer->id;
+            if (event.phase == 'X') {
+                out << ",\"dur\":" << event.value / 1000.0 << ",\"args\":{\"frame\":" << event.frame << "}}";
+            } else {
+                out << ",\"args\":{\"ms\":" << event.value / 1000000.0 << "}}";
+            }
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.str();
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path, int firstFrame, int lastFrame)
+{
+    std::string trace = ExportChromeTrace(firstFrame, lastFrame);
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to write profiler trace: " << path << std::endl;
+        return false;
+    }
+    file.write(trace.data(), trace.size());
+    std::cout << "Profiler trace saved: " << path << " (frames " << firstFrame << "-" << lastFrame << ")" << std::endl;
+    return true;
+}
+
+int64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+// 连续读取时钟，取最快一轮的平均耗时（只测量一次）
+void Profiler::CalibrateClock()
+{
+    static std::once_flag calibrated;
+    std::call_once(calibrated, []() {
+        const int kReads = 256;
+        int64_t best = 0;
+        for (int round = 0; round < 8; round++) {
+            int64_t start = Now();
+            for (int i = 0; i < kReads; i++) {
+                Now();
+            }
+            int64_t elapsed = (Now() - start) / (kReads + 1);
+            best = round == 0 ? elapsed : (std::min)(best, elapsed);
+        }
+        s_clockOverhead.store(best, std::memory_order_relaxed);
+    });
+}
+
+void Profiler::RecordScope(const char* name, int64_t start, int64_t end)
+{
+    Record(name, start, end - start, GetFrameIndex(), 'X');
+}
+
+void Profiler::AddStageTimes(const int64_t* stageTimes, int scale)
+{
+    for (int i = 0; i < static_cast<int>(ProfileStage::Count); i++) {
+        t_stageTimes[i] += stageTimes[i] * scale;
+    }
+}
+
+bool Profiler::NextStageSample(int sampleRate)
+{
+    return ++t_stageSampleCounter % static_cast<unsigned>(sampleRate) == 0;
+}
+
+const char* Profiler::GetStageName(ProfileStage stage)
+{
+    switch (stage) {
+    case ProfileStage::VertexShading: return "VertexShading";
+    case ProfileStage::Clipping: return "Clipping";
+    case ProfileStage::Setup: return "Setup";
+    case ProfileStage::Raster: return "Raster";
+    case ProfileStage::Fragment: return "Fragment";
+    default: return "Unknown";
+    }
+}
@@ -0,0 +1,132 @@
+#include "../include/Quaternion.h"
+#include "../include/MyMath.h"
+#include <cmath>
+
+Quaternion::Quaternion()
+    : x(0.0f), y(0.0f), z(0.0f), w(1.0f)
+{
+}
+
+Quaternion::Quaternion(float x, float y, float z, float w)
+    : x(x), y(y), z(z), w(w)
+{
+}
+
+Quaternion Quaternion::operator*(const Quaternion& q) const
+{
+    return Quaternion(w * q.x + x * q.w + y * q.z - z * q.y,
+                      w * q.y - x * q.z + y * q.w + z * q.x,
+                      w * q.z + x * q.y - y * q.x + z * q.w,
+                      w * q.w - x * q.x - y * q.y - z * q.z);
+}
+
+Quaternion Quaternion::identity()
+{
+    return Quaternion();
+}
+
+// 绕任意轴旋转
+Quaternion Quaternion::fromAxisAngle(const Vector3f& axis, float angle)
+{
+    Vector3f unitAxis = axis;
+    unitAxis.normalize();
+    float halfAngle = toRadians(angle) * 0.5f;
+    float s = sinf(halfAngle);
+    return Quaternion(unitAxis.x * s, unitAxis.y * s, unitAxis.z * s, cosf(halfAngle));
+}
+
+// 欧拉角转四元数：q = qz * qy * qx
+Quaternion Quaternion::fromEuler(const Vector3f& angles)
+{
+    float cx = cosf(toRadians(angles.x) * 0.5f), sx = sinf(toRadians(angles.x) * 0.5f);
+    float cy = cosf(toRadians(angles.y) * 0.5f), sy = sinf(toRadians(angles.y) * 0.5f);
+    float cz = cosf(toRadians(angles.z) * 0.5f), sz = sinf(toRadians(angles.z) * 0.5f);
+    return Quaternion(sx * cy * cz - cx * sy * sz,
+                      cx * sy * cz + sx * cy * sz,
+                      cx * cy * sz - sx * sy * cz,
+                      cx * cy * cz + sx * sy * sz);
+}
+
+// 四元数转欧拉角：由旋转矩阵Rz * Ry * Rx的元素求解
+Vector3f Quaternion::toEuler() const
+{
+    float r20 = 2.0f * (x * z - w * y);
+    float r21 = 2.0f * (y * z + w * x);
+    float r22 = 1.0f - 2.0f * (x * x + y * y);
+    float r10 = 2.0f * (x * y + w * z);
+    float r00 = 1.0f - 2.0f * (y * y + z * z);
+
+    float sinY = -r20;
+    if (sinY >= 1.0f - 1e-6f || sinY <= -1.0f + 1e-6f) {
+        // 万向节锁：X和Z轴的旋转合并为绕Z轴旋转
+        float r01 = 2.0f * (x * y - w * z);
+        float r11 = 1.0f - 2.0f * (x * x + z * z);
+        return Vector3f(0.0f, sinY > 0.0f ? 90.0f : -90.0f, toDegrees(atan2f(-r01, r11)));
+    }
+    return Vector3f(toDegrees(atan2f(r21, r22)), toDegrees(asinf(sinY)), toDegrees(atan2f(r10, r00)));
+}
+
+Quaternion Quaternion::normalize() const
+{
+    float length = sqrtf(x * x + y * y + z * z + w * w);
+    if (length < EPSILON) {
+        return identity();
+    }
+    float inverseLength = 1.0f / length;
+    return Quaternion(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
+}
+
+Quaternion Quaternion::conjugate() const
+{
+    return Quaternion(-x, -y, -z, w);
+}
+
+// 旋转向量：v' = v + 2w(q x v) + 2q x (q x v)
+Vector3f Quaternion::rotate(const Vector3f& vector) const
+{
+    Vector3f q(x, y, z);
+    Vector3f t = Vector3f::cross(q, vector) * 2.0f;
+    return vector + t * w + Vector3f::cross(q, t);
+}
+
+// 四元数转旋转矩阵
+Matrix Quaternion::toMatrix() const
+{
+    Matrix result = Matrix::identity();
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+    result.m[0][0] = 1.0f - 2.0f * (yy + zz);
+    result.m[0][1] = 2.0f * (xy - wz);
+    result.m[0][2] = 2.0f * (xz + wy);
+    result.m[1][0] = 2.0f * (xy + wz);
+    result.m[1][1] = 1.0f - 2.0f * (xx + zz);
+    result.m[1][2] = 2.0f * (yz - wx);
+    result.m[2][0] = 2.0f * (xz - wy);
+    result.m[2][1] = 2.0f * (yz + wx);
+    result.m[2][2] = 1.0f - 2.0f * (xx + yy);
+    return result;
+}
+
+// 球面线性插值，夹角很小时退化为线性插值
+Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float t)
+{
+    float cosTheta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    Quaternion end = b;
+    if (cosTheta < 0.0f) {
+        // q和-q表示同一旋转，取较短的弧
+        cosTheta = -cosTheta;
+        end = Quaternion(-b.x, -b.y, -b.z, -b.w);
+    }
+
+    float weightA = 1.0f - t;
+    float weightB = t;
+    if (cosTheta < 0.9995f) {
+        float theta = acosf(cosTheta);
+        float inverseSin = 1.0f / sinf(theta);
+        weightA = sinf((1.0f - t) * theta) * inverseSin;
+        weightB = sinf(t * theta) * inverseSin;
+    }
+    return Quaternion(a.x * weightA + end.x * weightB, a.y * weightA + end.y * weightB,
+                      a.z * weightA + end.z * weightB, a.w * weightA + end.w * weightB).normalize();
+}
@@ -1,4 +1,7 @@
 ﻿#include "../include/Renderer.h"
+#include "../include/Scene.h"
+#include "../include/MeshletBuilder.h"
+#include "../include/Profiler.h"
 #include <memory>
 #include <algorithm>
 #include <vector>
@@ -6,14 +9,19 @@
 
 Renderer::Renderer(int width, int height)
     : m_width(width), m_height(height),
-    m_memDC(nullptr), m_hOldBitmap(nullptr),
-    m_bufferManager(nullptr), m_currentFrameBuffer(nullptr),
     m_modelMatrix(Matrix::identity()),
     m_viewMatrix(Matrix::identity()),
     m_projMatrix(Matrix::identity()),
     m_viewPosition(0.0f, 0.0f, 10.0f),
+    m_instanceColor(1.0f, 1.0f, 1.0f, 1.0f), m_instanceParams(0.0f, 0.0f, 0.0f, 0.0f),
     m_cullMode(CullMode::CULL_BACK),
-    m_frontFace(FrontFace::COUNTER_CLOCKWISE)
+    m_frontFace(FrontFace::COUNTER_CLOCKWISE),
+    m_frustumCulling(true), m_frustumDirty(true), m_meshletCulling(true),
+    m_lodSelection(true), m_lodPixelError(1.0f), m_lodHysteresis(0.25f),
+    m_debugView(DebugView::NONE), m_debugViewScale(0.0f),
+    m_memDC(nullptr), m_hOldBitmap(nullptr),
+    m_bufferManager(nullptr), m_currentFrameBuffer(nullptr),
+    m_shadedVertices(nullptr), m_vertexShaded(nullptr)
 {
 }
 
@@ -185,17 +193,19 @@ void Renderer::DrawText(int x, int y, const std::wstring& text, const Color& col
     bmi.bmiHeader.biBitCount = 32;
     bmi.bmiHeader.biCompression = BI_RGB;
     
-    // 分配内存
-    std::vector<BYTE> bits(textWidth * textHeight * 4);
+    // 分配内存（从每帧的分配器分配，绘制结束后回退）
+    FrameArena::Marker marker = m_frameArena.GetMarker();
+    size_t bitsSize = static_cast<size_t>(textWidth) * textHeight * 4;
+    BYTE* bits = static_cast<BYTE*>(m_frameArena.Allocate(bitsSize));
     
     // 获取位图数据
-    GetDIBits(hdc, hBitmap, 0, textHeight, bits.data(), &bmi, DIB_RGB_COLORS);
+    GetDIBits(hdc, hBitmap, 0, textHeight, bits, &bmi, DIB_RGB_COLORS);
     
     // 将非黑色像素复制到缓冲区
     for (int i = 0; i < textHeight; i++) {
         for (int j = 0; j < textWidth; j++) {
             int index = (i * textWidth + j) * 4;
-            if (index + 2 < bits.size()) {
+            if (index + 2 < bitsSize) {
                 BYTE b = bits[index];
                 BYTE g = bits[index + 1];
                 BYTE r = bits[index + 2];
@@ -215,6 +225,7 @@ void Renderer::DrawText(int x, int y, const std::wstring& text, const Color& col
             }
         }
     }
+    m_frameArena.Rewind(marker);
     
     // 清理资源
     SelectObject(hdc, hOldBitmap);
@@ -236,23 +247,44 @@ void Renderer::ClearBackBuffer(COLORREF color)
 
 void Renderer::ClearBackBuffer(const Color& color)
 {
+    XYH_PROFILE_SCOPE("ClearBackBuffer");
+    
+    // 新的一帧开始，作废上一帧的临时数据，清零绘制统计
+    m_frameArena.Reset();
+    m_stats = RenderStats();
+    if (PipelineCounters::IsEnabled()) {
+        PipelineCounters::Collect();
+    }
+    m_pipelineStats.Reset();
+    if (m_debugView != DebugView::NONE) {
+        std::fill(m_debugCounts.begin(), m_debugCounts.end(), 0);
+    }
+    
     m_currentFrameBuffer->InitWithColorAndDepth(color, 1.0f);
 }
 
 void Renderer::ClearDepthBuffer(float depth)
 {
+    XYH_PROFILE_SCOPE("ClearDepthBuffer");
     m_currentFrameBuffer->depthBuffer.InitWithDepth(depth);
 }
 
 void Renderer::SwapBuffers(HDC hdc)
 {
     // 交换缓冲区
-    m_bufferManager->SwapBuffers();
+    {
+        XYH_PROFILE_SCOPE("SwapBuffers");
+        m_bufferManager->SwapBuffers();
+    }
     
     // 将前缓冲区呈现到目标设备上下文
-    m_bufferManager->PresentToHDC(hdc);
+    {
+        XYH_PROFILE_SCOPE("Present");
+        m_bufferManager->PresentToHDC(hdc);
+    }
     
-    // 获取新的后缓冲区用于下一帧绘制
+    // 获取新的后缓冲区用于下一帧绘制（BufferManager用背景色清空，与ClearBackBuffer分开统计）
+    XYH_PROFILE_SCOPE("GetBackBuffer");
     m_currentFrameBuffer = m_bufferManager->GetBackBuffer();
 }
 
@@ -333,7 +365,7 @@ bool Renderer::PointInTriangle(float x, float y, const Vector2f& v1, const Vecto
 }
 
 // 插值顶点数据
-VertexOutput Renderer::InterpolateVertex(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, float w1, float w2, float w3)
+VertexOutput Renderer::InterpolateVertex(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, float w1, float w2, float w3, int varyings)
 {
     VertexOutput result;
     
@@ -353,26 +385,35 @@ VertexOutput Renderer::InterpolateVertex(const VertexOutput& v1, const VertexOut
     // 归一化因子
     float normalizer = 1.0f / (correctionW1 + correctionW2 + correctionW3);
     
-    // 透视校正插值颜色
-    result.color.x = (correctionW1 * v1.color.x + correctionW2 * v2.color.x + correctionW3 * v3.color.x) * normalizer;
-    result.color.y = (correctionW1 * v1.color.y + correctionW2 * v2.color.y + correctionW3 * v3.color.y) * normalizer;
-    result.color.z = (correctionW1 * v1.color.z + correctionW2 * v2.color.z + correctionW3 * v3.color.z) * normalizer;
-    result.color.w = (correctionW1 * v1.color.w + correctionW2 * v2.color.w + correctionW3 * v3.color.w) * normalizer;
+    // 只插值着色器使用的属性
+    if (varyings & VARYING_COLOR) {
+        // 透视校正插值颜色
+        result.color.x = (correctionW1 * v1.color.x + correctionW2 * v2.color.x + correctionW3 * v3.color.x) * normalizer;
+        result.color.y = (correctionW1 * v1.color.y + correctionW2 * v2.color.y + correctionW3 * v3.color.y) * normalizer;
+        result.color.z = (correctionW1 * v1.color.z + correctionW2 * v2.color.z + correctionW3 * v3.color.z) * normalizer;
+        result.color.w = (correctionW1 * v1.color.w + correctionW2 * v2.color.w + correctionW3 * v3.color.w) * normalizer;
+    }
     
-    // 透视校正插值法线
-    result.normal.x = (correctionW1 * v1.normal.x + correctionW2 * v2.normal.x + correctionW3 * v3.normal.x) * normalizer;
-    result.normal.y = (correctionW1 * v1.normal.y + correctionW2 * v2.normal.y + correctionW3 * v3.normal.y) * normalizer;
-    result.normal.z = (correctionW1 * v1.normal.z + correctionW2 * v2.normal.z + correctionW3 * v3.normal.z) * normalizer;
-    result.normal = result.normal.normalize();  // 重新归一化
+    if (varyings & VARYING_NORMAL) {
+        // 透视校正插值法线
+        result.normal.x = (correctionW1 * v1.normal.x + correctionW2 * v2.normal.x + correctionW3 * v3.normal.x) * normalizer;
+        result.normal.y = (correctionW1 * v1.normal.y + correctionW2 * v2.normal.y + correctionW3 * v3.normal.y) * normalizer;
+        result.normal.z = (correctionW1 * v1.normal.z + correctionW2 * v2.normal.z + correctionW3 * v3.normal.z) * normalizer;
+        result.normal = result.normal.normalize();  // 重新归一化
+    }
     
-    // 透视校正插值纹理坐标
-    result.texcoord.x = (correctionW1 * v1.texcoord.x + correctionW2 * v2.texcoord.x + correctionW3 * v3.texcoord.x) * normalizer;
-    result.texcoord.y = (correctionW1 * v1.texcoord.y + correctionW2 * v2.texcoord.y + correctionW3 * v3.texcoord.y) * normalizer;
+    if (varyings & VARYING_TEXCOORD) {
+        // 透视校正插值纹理坐标
+        result.texcoord.x = (correctionW1 * v1.texcoord.x + correctionW2 * v2.texcoord.x + correctionW3 * v3.texcoord.x) * normalizer;
+        result.texcoord.y = (correctionW1 * v1.texcoord.y + correctionW2 * v2.texcoord.y + correctionW3 * v3.texcoord.y) * normalizer;
+    }
     
-    // 透视校正插值世界坐标
-    result.worldPos.x = (correctionW1 * v1.worldPos.x + correctionW2 * v2.worldPos.x + correctionW3 * v3.worldPos.x) * normalizer;
-    result.worldPos.y = (correctionW1 * v1.worldPos.y + correctionW2 * v2.worldPos.y + correctionW3 * v3.worldPos.y) * normalizer;
-    result.worldPos.z = (correctionW1 * v1.worldPos.z + correctionW2 * v2.worldPos.z + correctionW3 * v3.worldPos.z) * normalizer;
+    if (varyings & VARYING_WORLD_POS) {
+        // 透视校正插值世界坐标
+        result.worldPos.x = (correctionW1 * v1.worldPos.x + correctionW2 * v2.worldPos.x + correctionW3 * v3.worldPos.x) * normalizer;
+        result.worldPos.y = (correctionW1 * v1.worldPos.y + correctionW2 * v2.worldPos.y + correctionW3 * v3.worldPos.y) * normalizer;
+        result.worldPos.z = (correctionW1 * v1.worldPos.z + correctionW2 * v2.worldPos.z + correctionW3 * v3.worldPos.z) * normalizer;
+    }
     
     // 屏幕坐标
     result.position.x = w1 * v1.position.x + w2 * v2.position.x + w3 * v3.position.x;
@@ -382,128 +423,151 @@ VertexOutput Renderer::InterpolateVertex(const VertexOutput& v1, const VertexOut
     return result;
 }
 
-// 线段与近平面求交点，通过插值计算新顶点
-VertexOutput Renderer::ClipAgainstNearPlane(const VertexOutput& v1, const VertexOutput& v2)
+// 裁剪空间outcode：视锥体的6个平面，以及保护带的4个平面
+enum ClipCode {
+    CLIP_LEFT = 1 << 0,             // x < -w
+    CLIP_RIGHT = 1 << 1,            // x > w
+    CLIP_BOTTOM = 1 << 2,           // y < -w
+    CLIP_TOP = 1 << 3,              // y > w
+    CLIP_NEAR = 1 << 4,             // z < -w（近平面由投影矩阵决定，与相机的nearZ一致）
+    CLIP_FAR = 1 << 5,              // z > w
+    CLIP_GUARD_LEFT = 1 << 6,       // x < -GUARD_BAND * w
+    CLIP_GUARD_RIGHT = 1 << 7,      // x > GUARD_BAND * w
+    CLIP_GUARD_BOTTOM = 1 << 8,     // y < -GUARD_BAND * w
+    CLIP_GUARD_TOP = 1 << 9,        // y > GUARD_BAND * w
+    // 需要真正裁剪的平面（左右上下只在超出保护带时才裁剪）
+    CLIP_NEEDS_CLIPPING = CLIP_NEAR | CLIP_FAR | CLIP_GUARD_LEFT | CLIP_GUARD_RIGHT | CLIP_GUARD_BOTTOM | CLIP_GUARD_TOP
+};
+
+// 保护带大小（NDC坐标范围的倍数）
+// 保护带内的三角形不裁剪，屏幕外的部分由光栅化的边界盒排除；超出保护带时才裁剪，避免屏幕坐标过大损失精度
+const float GUARD_BAND = 8.0f;
+
+// 计算裁剪空间位置的outcode
+inline int ComputeOutcode(const Vector4f& p)
+{
+    float guardW = GUARD_BAND * p.w;
+    int code = 0;
+    if (p.x < -p.w) code |= CLIP_LEFT;
+    if (p.x > p.w) code |= CLIP_RIGHT;
+    if (p.y < -p.w) code |= CLIP_BOTTOM;
+    if (p.y > p.w) code |= CLIP_TOP;
+    if (p.z < -p.w) code |= CLIP_NEAR;
+    if (p.z > p.w) code |= CLIP_FAR;
+    if (p.x < -guardW) code |= CLIP_GUARD_LEFT;
+    if (p.x > guardW) code |= CLIP_GUARD_RIGHT;
+    if (p.y < -guardW) code |= CLIP_GUARD_BOTTOM;
+    if (p.y > guardW) code |= CLIP_GUARD_TOP;
+    return code;
+}
+
+// 顶点到裁剪平面的有向距离（>= 0表示在平面内侧）
+inline float ClipPlaneDistance(const Vector4f& p, int plane)
+{
+    switch (plane) {
+        case CLIP_NEAR: return p.z + p.w;
+        case CLIP_FAR: return p.w - p.z;
+        case CLIP_GUARD_LEFT: return p.x + GUARD_BAND * p.w;
+        case CLIP_GUARD_RIGHT: return GUARD_BAND * p.w - p.x;
+        case CLIP_GUARD_BOTTOM: return p.y + GUARD_BAND * p.w;
+        default: return GUARD_BAND * p.w - p.y;   // CLIP_GUARD_TOP
+    }
+}
+
+// 线段上的裁剪点：v1 + t*(v2-v1)
+VertexOutput Renderer::ClipEdge(const VertexOutput& v1, const VertexOutput& v2, float t, int varyings)
 {
-    // 近平面对应的W值，应与相机设置中的近平面值保持一致
-    // 在投影矩阵应用后，近平面会被映射到w=nearZ的位置
-    const float NEAR_PLANE = 0.1f;
-    
-    // 计算裁剪系数t，使得v1 + t*(v2-v1)位于近平面上
-    float t = (NEAR_PLANE - v1.position.w) / (v2.position.w - v1.position.w);
-    
-    // 插值计算新顶点
     VertexOutput result;
     
     // 裁剪空间位置插值
-    result.position.x = v1.position.x + t * (v2.position.x - v1.position.x);
-    result.position.y = v1.position.y + t * (v2.position.y - v1.position.y);
-    result.position.z = v1.position.z + t * (v2.position.z - v1.position.z);
-    result.position.w = NEAR_PLANE; // 交点正好在近平面上
-    
-    // 世界坐标插值
-    result.worldPos.x = v1.worldPos.x + t * (v2.worldPos.x - v1.worldPos.x);
-    result.worldPos.y = v1.worldPos.y + t * (v2.worldPos.y - v1.worldPos.y);
-    result.worldPos.z = v1.worldPos.z + t * (v2.worldPos.z - v1.worldPos.z);
-    
-    // 纹理坐标插值
-    result.texcoord.x = v1.texcoord.x + t * (v2.texcoord.x - v1.texcoord.x);
-    result.texcoord.y = v1.texcoord.y + t * (v2.texcoord.y - v1.texcoord.y);
-    
-    // 法线插值
-    result.normal.x = v1.normal.x + t * (v2.normal.x - v1.normal.x);
-    result.normal.y = v1.normal.y + t * (v2.normal.y - v1.normal.y);
-    result.normal.z = v1.normal.z + t * (v2.normal.z - v1.normal.z);
-    result.normal = result.normal.normalize(); // 重新归一化
-    
-    // 颜色插值
-    result.color.x = v1.color.x + t * (v2.color.x - v1.color.x);
-    result.color.y = v1.color.y + t * (v2.color.y - v1.color.y);
-    result.color.z = v1.color.z + t * (v2.color.z - v1.color.z);
-    result.color.w = v1.color.w + t * (v2.color.w - v1.color.w);
+    result.position = v1.position + (v2.position - v1.position) * t;
+    
+    // 只插值着色器使用的属性
+    if (varyings & VARYING_WORLD_POS) {
+        // 世界坐标插值
+        result.worldPos = v1.worldPos + (v2.worldPos - v1.worldPos) * t;
+    }
+    
+    if (varyings & VARYING_TEXCOORD) {
+        // 纹理坐标插值
+        result.texcoord = v1.texcoord + (v2.texcoord - v1.texcoord) * t;
+    }
+    
+    if (varyings & VARYING_NORMAL) {
+        // 法线插值（需要归一化）
+        result.normal = (v1.normal + (v2.normal - v1.normal) * t).normalize();
+    }
+    
+    if (varyings & VARYING_COLOR) {
+        // 颜色插值
+        result.color = v1.color + (v2.color - v1.color) * t;
+    }
     
     return result;
 }
 
-// 对三角形进行近平面裁剪，返回0-2个新的三角形
-std::vector<std::array<VertexOutput, 3>> Renderer::ClipTriangleAgainstNearPlane(
-    const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3)
+// 在裁剪空间裁剪三角形，结果为凸多边形，返回false表示三角形被完全剔除
+bool Renderer::ClipTriangle(const VertexOutput& v1, const VertexOutput& v2, const VertexOutput& v3, int varyings, ClipPolygon& polygon)
 {
-    // 存储裁剪后的三角形
-    std::vector<std::array<VertexOutput, 3>> result;
-    
-    // 近平面对应的W值，应与相机设置中的近平面值保持一致
-    const float NEAR_PLANE = 0.1f;
+    int code1 = ComputeOutcode(v1.position);
+    int code2 = ComputeOutcode(v2.position);
+    int code3 = ComputeOutcode(v3.position);
     
-    // 判断每个顶点是否在近平面后面(w >= NEAR_PLANE)
-    bool v1Inside = v1.position.w >= NEAR_PLANE;
-    bool v2Inside = v2.position.w >= NEAR_PLANE;
-    bool v3Inside = v3.position.w >= NEAR_PLANE;
+    // 平凡拒绝：三个顶点都在同一个平面的外侧
+    if (code1 & code2 & code3) {
+        return false;
+    }
     
-    // 统计在近平面后面的顶点数量
-    int insideCount = (v1Inside ? 1 : 0) + (v2Inside ? 1 : 0) + (v3Inside ? 1 : 0);
+    polygon.vertices[0] = v1;
+    polygon.vertices[1] = v2;
+    polygon.vertices[2] = v3;
+    polygon.count = 3;
     
-    // 根据不同情况处理
-    if (insideCount == 0) {
-        // 所有顶点都在近平面前面，整个三角形被裁剪掉
-        return result; // 返回空结果
+    // 平凡接受：没有顶点超出近平面、远平面和保护带
+    int clipCodes = (code1 | code2 | code3) & CLIP_NEEDS_CLIPPING;
+    if (clipCodes == 0) {
+        return true;
     }
-    else if (insideCount == 3) {
-        // 所有顶点都在近平面后面，保留整个三角形
-        std::array<VertexOutput, 3> triangle = {v1, v2, v3};
-        result.push_back(triangle);
-        return result;
-    }
-    else if (insideCount == 1) {
-        // 只有一个顶点在近平面后面，形成一个新三角形
-        if (v1Inside) {
-            VertexOutput newV2 = ClipAgainstNearPlane(v1, v2);
-            VertexOutput newV3 = ClipAgainstNearPlane(v1, v3);
-            std::array<VertexOutput, 3> triangle = {v1, newV2, newV3};
-            result.push_back(triangle);
-        }
-        else if (v2Inside) {
-            VertexOutput newV1 = ClipAgainstNearPlane(v2, v1);
-            VertexOutput newV3 = ClipAgainstNearPlane(v2, v3);
-            std::array<VertexOutput, 3> triangle = {newV1, v2, newV3};
-            result.push_back(triangle);
-        }
-        else { // v3Inside
-            VertexOutput newV1 = ClipAgainstNearPlane(v3, v1);
-            VertexOutput newV2 = ClipAgainstNearPlane(v3, v2);
-            std::array<VertexOutput, 3> triangle = {newV1, newV2, v3};
-            result.push_back(triangle);
-        }
-    }
-    else { // insideCount == 2
-        // 有两个顶点在近平面后面，形成两个新三角形
-        if (!v1Inside) {
-            VertexOutput newV1A = ClipAgainstNearPlane(v2, v1);
-            VertexOutput newV1B = ClipAgainstNearPlane(v3, v1);
-            std::array<VertexOutput, 3> triangle1 = {newV1A, v2, v3};
-            std::array<VertexOutput, 3> triangle2 = {newV1A, v3, newV1B};
-            result.push_back(triangle1);
-            result.push_back(triangle2);
+    PipelineCounters::Add(&PipelineStatistics::trianglesClipped, 1);
+    
+    // 只对跨越的平面进行Sutherland-Hodgman裁剪，两个多边形缓冲区交替使用
+    static const int planes[] = { CLIP_NEAR, CLIP_FAR, CLIP_GUARD_LEFT, CLIP_GUARD_RIGHT, CLIP_GUARD_BOTTOM, CLIP_GUARD_TOP };
+    ClipPolygon temp;
+    ClipPolygon* input = &polygon;
+    ClipPolygon* output = &temp;
+    
+    for (int plane : planes) {
+        if (!(clipCodes & plane)) {
+            continue;
         }
-        else if (!v2Inside) {
-            VertexOutput newV2A = ClipAgainstNearPlane(v1, v2);
-            VertexOutput newV2B = ClipAgainstNearPlane(v3, v2);
-            std::array<VertexOutput, 3> triangle1 = {v1, newV2A, v3};
-            std::array<VertexOutput, 3> triangle2 = {newV2A, newV2B, v3};
-            result.push_back(triangle1);
-            result.push_back(triangle2);
+        
+        output->count = 0;
+        for (int i = 0; i < input->count; i++) {
+            const VertexOutput& current = input->vertices[i];
+            const VertexOutput& next = input->vertices[(i + 1) % input->count];
+            float currentDistance = ClipPlaneDistance(current.position, plane);
+            float nextDistance = ClipPlaneDistance(next.position, plane);
+            
+            if (currentDistance >= 0.0f) {
+                output->vertices[output->count++] = current;
+            }
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+                float t = currentDistance / (currentDistance - nextDistance);
+                output->vertices[output->count++] = ClipEdge(current, next, t, varyings);
+            }
         }
-        else { // !v3Inside
-            VertexOutput newV3A = ClipAgainstNearPlane(v1, v3);
-            VertexOutput newV3B = ClipAgainstNearPlane(v2, v3);
-            std::array<VertexOutput, 3> triangle1 = {v1, v2, newV3A};
-            std::array<VertexOutput, 3> triangle2 = {v2, newV3B, newV3A};
-            result.push_back(triangle1);
-            result.push_back(triangle2);
+        
+        if (output->count < 3) {
+            return false;
         }
+        std::swap(input, output);
     }
     
-    return result;
+    if (input != &polygon) {
+        polygon.count = input->count;
+        std::copy(input->vertices, input->vertices + input->count, polygon.vertices);
+    }
+    return true;
 }
 
 // 绘制三角形
@@ -520,6 +584,8 @@ void Renderer::DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3
     vs_in1.modelMatrix = m_modelMatrix;
     vs_in1.viewMatrix = m_viewMatrix;
     vs_in1.projMatrix = m_projMatrix;
+    vs_in1.instanceColor = m_instanceColor;
+    vs_in1.instanceParams = m_instanceParams;
     
     VertexShaderInput vs_in2;
     vs_in2.position = v2.pos;
@@ -529,6 +595,8 @@ void Renderer::DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3
     vs_in2.modelMatrix = m_modelMatrix;
     vs_in2.viewMatrix = m_viewMatrix;
     vs_in2.projMatrix = m_projMatrix;
+    vs_in2.instanceColor = m_instanceColor;
+    vs_in2.instanceParams = m_instanceParams;
     
     VertexShaderInput vs_in3;
     vs_in3.position = v3.pos;
@@ -538,11 +606,36 @@ void Renderer::DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3
     vs_in3.modelMatrix = m_modelMatrix;
     vs_in3.viewMatrix = m_viewMatrix;
     vs_in3.projMatrix = m_projMatrix;
+    vs_in3.instanceColor = m_instanceColor;
+    vs_in3.instanceParams = m_instanceParams;
     
     // 2.执行顶点着色器
+    XYH_PROFILE_SAMPLED_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, VertexShading);
     VertexOutput vs_out1 = shader->VertexShader(vs_in1);
     VertexOutput vs_out2 = shader->VertexShader(vs_in2);
     VertexOutput vs_out3 = shader->VertexShader(vs_in3);
+    XYH_PROFILE_STAGE_END(stages);
+    PipelineCounters::Add(&PipelineStatistics::verticesShaded, 3);
+    
+    RasterizeTriangle(vs_out1, vs_out2, vs_out3, shader);
+}
+
+// 绘制已执行顶点着色器的三角形（剔除、裁剪、光栅化和片元着色）
+void Renderer::RasterizeTriangle(const VertexOutput& vs_out1, const VertexOutput& vs_out2, const VertexOutput& vs_out3, Shader* shader)
+{
+    // 各阶段的时间累计到每帧的总时间（逐三角形记录事件开销太大，按三角形抽样计时）
+    XYH_PROFILE_SAMPLED_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, Clipping);
+    
+    // 管线统计（关闭时为空，逐quad只多一次判断）
+    PipelineStatistics* statistics = PipelineCounters::IsEnabled() ? &PipelineCounters::Local() : nullptr;
+    if (statistics) {
+        statistics->trianglesSubmitted++;
+    }
+    
+    // 调试视图的逐像素计数（关闭时为空）
+    uint32_t* debugCounts = m_debugView != DebugView::NONE ? m_debugCounts.data() : nullptr;
     
     // 3.执行背面剔除（如果启用）
     if (m_cullMode != Renderer::CullMode::CULL_NONE) {
@@ -572,24 +665,33 @@ void Renderer::DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3
         if ((m_cullMode == Renderer::CullMode::CULL_BACK && !isFrontFacing) ||
             (m_cullMode == Renderer::CullMode::CULL_FRONT && isFrontFacing)) {
             // 需要剔除，跳过渲染
+            if (statistics) {
+                statistics->trianglesBackfaceCulled++;
+            }
             return;
         }
     }
     
-    // 4.执行近平面裁剪
-    auto clippedTriangles = ClipTriangleAgainstNearPlane(vs_out1, vs_out2, vs_out3);
+    // 着色器使用的插值属性，裁剪和插值只处理这些属性
+    int varyings = shader->GetVaryings();
     
-    // 如果三角形完全被裁剪掉，则跳过渲染
-    if (clippedTriangles.empty()) {
+    // 4.执行裁剪（视锥体外的三角形直接剔除）
+    ClipPolygon polygon;
+    if (!ClipTriangle(vs_out1, vs_out2, vs_out3, varyings, polygon)) {
+        if (statistics) {
+            statistics->trianglesClipRejected++;
+        }
         return;
     }
     
-    // 对每个裁剪后的三角形进行渲染
-    for (const auto& triangle : clippedTriangles) {
+    // 对裁剪后的多边形按扇形拆分为三角形进行渲染
+    for (int i = 1; i + 1 < polygon.count; i++) {
+        XYH_PROFILE_STAGE(stages, Setup);
+        
         // 获取裁剪后的三角形顶点
-        const VertexOutput& clipVs_out1 = triangle[0];
-        const VertexOutput& clipVs_out2 = triangle[1];
-        const VertexOutput& clipVs_out3 = triangle[2];
+        const VertexOutput& clipVs_out1 = polygon.vertices[0];
+        const VertexOutput& clipVs_out2 = polygon.vertices[i];
+        const VertexOutput& clipVs_out3 = polygon.vertices[i + 1];
         
         // 保存原始W值用于透视校正插值
         float w1 = clipVs_out1.position.w;
@@ -612,65 +714,106 @@ void Renderer::DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3
         int minY = (std::max)(0, (int)std::floor((std::min)({screenVs_out1.position.y, screenVs_out2.position.y, screenVs_out3.position.y})));
         int maxY = (std::min)(m_height - 1, (int)std::ceil((std::max)({screenVs_out1.position.y, screenVs_out2.position.y, screenVs_out3.position.y})));
         
-        // 5. 决定MipMap级别
         Vector2f v1Pos(screenVs_out1.position.x, screenVs_out1.position.y);
         Vector2f v2Pos(screenVs_out2.position.x, screenVs_out2.position.y);
         Vector2f v3Pos(screenVs_out3.position.x, screenVs_out3.position.y);
         
-        // 计算纹理坐标导数(边缘)
-        Vector2f edge12 = v2Pos - v1Pos;
-        Vector2f edge13 = v3Pos - v1Pos;
-        Vector2f texEdge12 = screenVs_out2.texcoord - screenVs_out1.texcoord;
-        Vector2f texEdge13 = screenVs_out3.texcoord - screenVs_out1.texcoord;
-        float det = edge12.x * edge13.y - edge12.y * edge13.x;
-        float invDet = (abs(det) < EPSILON) ? 1.0f : (1.0f / det);
-        
-        // 计算屏幕空间对纹理坐标的导数(偏导数)
-        float dudx = (edge13.y * texEdge12.x - edge12.y * texEdge13.x) * invDet;
-        float dvdx = (edge13.y * texEdge12.y - edge12.y * texEdge13.y) * invDet;
-        float dudy = (edge12.x * texEdge13.x - edge13.x * texEdge12.x) * invDet;
-        float dvdy = (edge12.x * texEdge13.y - edge13.x * texEdge12.y) * invDet;
+        // 三角形面积（只计算一次）
+        const float area = EdgeFunction(v1Pos, v2Pos, v3Pos);
+        if (std::abs(area) < 0.00001f) {
+            if (statistics) {
+                statistics->trianglesZeroArea++;
+            }
+            continue;
+        }
+        const float invArea = 1.0f / area;
+        if (statistics) {
+            statistics->trianglesRasterized++;
+            statistics->pixelsTested += CountBoundingQuadPixels(minX, maxX, minY, maxY);
+        }
         
-        // 计算导数的大小，这将用于选择MipMap级别
-        float duvdx = std::sqrt(dudx * dudx + dvdx * dvdx);
-        float duvdy = std::sqrt(dudy * dudy + dvdy * dvdy);
+        // 恢复w值用于透视校正插值
+        screenVs_out1.position.w = w1;
+        screenVs_out2.position.w = w2;
+        screenVs_out3.position.w = w3;
         
-        // 6. 光栅化（使用块状遍历）
-        const int BLOCK_SIZE = 8;
-        for (int blockY = minY; blockY <= maxY; blockY += BLOCK_SIZE) {
-            for (int blockX = minX; blockX <= maxX; blockX += BLOCK_SIZE) {
-                // 计算块的边界
-                int endX = (std::min)(blockX + BLOCK_SIZE, maxX + 1);
-                int endY = (std::min)(blockY + BLOCK_SIZE, maxY + 1);
+        // 5. 光栅化（以2x2像素块为单位，MipMap级别由每个quad的纹理坐标导数决定）
+        // quad从偶数坐标开始，与GPU一样保证相邻三角形的quad对齐
+        XYH_PROFILE_STAGE(stages, Raster);
+        for (int quadY = minY & ~1; quadY <= maxY; quadY += 2) {
+            for (int quadX = minX & ~1; quadX <= maxX; quadX += 2) {
+                FragmentQuad quad;
+                quad.coverageMask = 0;
+                float alpha[FragmentQuad::kLanes], beta[FragmentQuad::kLanes], gamma[FragmentQuad::kLanes];
                 
-                // 遍历块内的像素
-                for (int y = blockY; y < endY; y++) {
-                    for (int x = blockX; x < endX; x++) {
-                        float pixelX = x + 0.5f;
-                        float pixelY = y + 0.5f;
-                        
-                        float alpha, beta, gamma;
-                        if (PointInTriangle(pixelX, pixelY, v1Pos, v2Pos, v3Pos, alpha, beta, gamma)) {
-                            // 恢复w值
-                            screenVs_out1.position.w = w1;
-                            screenVs_out2.position.w = w2;
-                            screenVs_out3.position.w = w3;
-                            
-                            // 插值
-                            VertexOutput pixelVertex = InterpolateVertex(screenVs_out1, screenVs_out2, screenVs_out3, alpha, beta, gamma);
-                            
-                            // 深度测试
-                            if (pixelVertex.position.z <= m_currentFrameBuffer->depthBuffer.GetDepth(x, y)) {
-                                // 片元着色器
-                                Color pixelColor = shader->FragmentShader(pixelVertex, duvdx, duvdy);
-                                
-                                // 写入缓冲区
-                                m_currentFrameBuffer->colorBuffer.SetPixel(x, y, pixelColor);
-                                m_currentFrameBuffer->depthBuffer.SetDepth(x, y, pixelVertex.position.z);
-                            }
-                        }
+                // 覆盖测试（quad中所有像素都计算重心坐标，辅助像素的重心坐标可能为负）
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    int x = quadX + (lane & 1);
+                    int y = quadY + (lane >> 1);
+                    Vector2f pixel(x + 0.5f, y + 0.5f);
+                    alpha[lane] = EdgeFunction(v2Pos, v3Pos, pixel) * invArea;
+                    beta[lane] = EdgeFunction(v3Pos, v1Pos, pixel) * invArea;
+                    gamma[lane] = 1.0f - alpha[lane] - beta[lane];
+                    
+                    if (alpha[lane] >= 0.0f && beta[lane] >= 0.0f && gamma[lane] >= 0.0f &&
+                        x >= minX && x <= maxX && y >= minY && y <= maxY) {
+                        quad.coverageMask |= 1 << lane;
                     }
                 }
+                if (quad.coverageMask == 0) {
+                    continue;
+                }
+                int coveredCount = statistics ? quad.CoveredCount() : 0;
+                
+                // 插值（辅助像素也插值，用于求导）
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    quad.lanes[lane] = InterpolateVertex(screenVs_out1, screenVs_out2, screenVs_out3, alpha[lane], beta[lane], gamma[lane], varyings);
+                }
+                
+                // 深度测试，未通过的像素变为辅助像素
+                if (debugCounts && m_debugView == DebugView::DEPTH_COMPLEXITY) {
+                    AddDebugCounts(debugCounts, quad.coverageMask, quadX, quadY, 1);
+                }
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    if (quad.IsCovered(lane) &&
+                        quad.lanes[lane].position.z > m_currentFrameBuffer->depthBuffer.GetDepth(quadX + (lane & 1), quadY + (lane >> 1))) {
+                        quad.coverageMask &= ~(1 << lane);
+                    }
+                }
+                if (statistics) {
+                    int passedCount = quad.CoveredCount();
+                    statistics->pixelsCovered += coveredCount;
+                    statistics->depthTestsPassed += passedCount;
+                    statistics->depthTestsFailed += coveredCount - passedCount;
+                    statistics->fragmentsShaded += passedCount;
+                }
+                if (quad.coverageMask == 0) {
+                    continue;
+                }
+                
+                // 片元着色器
+                XYH_PROFILE_STAGE(stages, Fragment);
+                Color pixelColors[FragmentQuad::kLanes];
+                bool measureShader = debugCounts && m_debugView == DebugView::SHADER_COST;
+                uint64_t shaderStart = measureShader ? Profiler::ReadCycleCounter() : 0;
+                shader->FragmentShaderQuad(quad, pixelColors);
+                if (measureShader) {
+                    uint64_t cycles = (Profiler::ReadCycleCounter() - shaderStart) / quad.CoveredCount();
+                    AddDebugCounts(debugCounts, quad.coverageMask, quadX, quadY, static_cast<uint32_t>(cycles));
+                } else if (debugCounts && m_debugView == DebugView::OVERDRAW) {
+                    AddDebugCounts(debugCounts, quad.coverageMask, quadX, quadY, 1);
+                }
+                
+                // 写入缓冲区
+                for (int lane = 0; lane < FragmentQuad::kLanes; lane++) {
+                    if (quad.IsCovered(lane)) {
+                        int x = quadX + (lane & 1);
+                        int y = quadY + (lane >> 1);
+                        m_currentFrameBuffer->colorBuffer.SetPixel(x, y, pixelColors[lane]);
+                        m_currentFrameBuffer->depthBuffer.SetDepth(x, y, quad.lanes[lane].position.z);
+                    }
+                }
+                XYH_PROFILE_STAGE(stages, Raster);
             }
         }
     }
@@ -678,8 +821,15 @@ void Renderer::DrawTriangle(const Vertex& v1, const Vertex& v2, const Vertex& v3
 
 // 绘制网格
 void Renderer::DrawMesh(const Mesh& mesh, const Matrix& modelMatrix, Shader* shader)
+{
+    DrawMesh(mesh, modelMatrix, shader, 0, mesh.indices.size());
+}
+
+// 绘制网格中的一段三角形（子网格）
+void Renderer::DrawMesh(const Mesh& mesh, const Matrix& modelMatrix, Shader* shader, size_t triangleStart, size_t triangleCount)
 {
     if (!shader) return;  // 安全检查
+    XYH_PROFILE_SCOPE("DrawMesh");
     
     // // 保存当前模型矩阵
     // Matrix oldModelMatrix = m_modelMatrix;
@@ -687,23 +837,565 @@ void Renderer::DrawMesh(const Mesh& mesh, const Matrix& modelMatrix, Shader* sha
     // 设置新的模型矩阵
     m_modelMatrix = modelMatrix;
     
-    // 遍历所有三角形
-    for (size_t i = 0; i < mesh.indices.size(); i++) {
-        const Vector3i& index = mesh.indices[i];
-        const Vertex& v1 = mesh.vertices[index.x];
-        const Vertex& v2 = mesh.vertices[index.y];
-        const Vertex& v3 = mesh.vertices[index.z];
-        
-        // 绘制三角形
-        DrawTriangle(v1, v2, v3, shader);
+    size_t triangleEnd = (std::min)(triangleStart + triangleCount, mesh.indices.size());
+    triangleStart = (std::min)(triangleStart, triangleEnd);
+    
+    // 网格带有簇时先按簇剔除，只对可见簇的顶点执行顶点着色器
+    size_t firstMeshlet, endMeshlet;
+    if (m_meshletCulling && MeshletBuilder::FindMeshlets(mesh, triangleStart, triangleEnd, firstMeshlet, endMeshlet)) {
+        FrameArena::Marker marker = m_frameArena.GetMarker();
+        MeshletDrawState state;
+        BeginMeshlets(mesh, m_cullMode, state);
+        DrawMeshlets(mesh, firstMeshlet, endMeshlet, state, shader);
+        m_frameArena.Rewind(marker);
+        return;
+    }
+    
+    // 范围内的三角形很少时（只引用一小部分顶点）逐三角形执行顶点着色器
+    if ((triangleEnd - triangleStart) * 3 < mesh.vertices.size()) {
+        for (size_t i = triangleStart; i < triangleEnd; i++) {
+            const Vector3i& index = mesh.indices[i];
+            DrawTriangle(mesh.vertices[index.x], mesh.vertices[index.y], mesh.vertices[index.z], shader);
+        }
+        return;
     }
     
+    // 每个顶点只着色一次，再遍历范围内的三角形
+    FrameArena::Marker marker = m_frameArena.GetMarker();
+    ShadeVertices(mesh.vertices, shader);
+    DrawShadedTriangles(mesh.indices, triangleStart, triangleEnd, shader);
+    m_frameArena.Rewind(marker);
+    
     // // 恢复模型矩阵
     // m_modelMatrix = oldModelMatrix;
 }
 
+// 绘制打包网格：按批解码顶点并批量着色后逐三角形绘制
+void Renderer::DrawMesh(const PackedMesh& mesh, const Matrix& modelMatrix, Shader* shader)
+{
+    if (!shader) return;  // 安全检查
+    XYH_PROFILE_SCOPE("DrawMesh");
+    
+    m_modelMatrix = modelMatrix;
+    
+    XYH_PROFILE_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, VertexShading);
+    VertexUniforms uniforms = GetVertexUniforms();
+    size_t vertexCount = mesh.GetVertexCount();
+    FrameArena::Marker marker = m_frameArena.GetMarker();
+    m_shadedVertices = m_frameArena.AllocateArray<VertexOutput>(vertexCount);
+    VertexBatch batch;
+    VertexOutputBatch outputBatch;
+    for (size_t first = 0; first < vertexCount; first += VertexBatch::kSize) {
+        mesh.LoadBatch(first, batch);
+        shader->VertexShaderBatch(batch, uniforms, outputBatch);
+        for (int i = 0; i < outputBatch.count; i++) {
+            m_shadedVertices[first + i] = outputBatch.GetOutput(i);
+        }
+    }
+    XYH_PROFILE_STAGE_END(stages);
+    PipelineCounters::Add(&PipelineStatistics::verticesShaded, vertexCount);
+    
+    DrawShadedTriangles(mesh.indices, 0, mesh.indices.size(), shader);
+    m_frameArena.Rewind(marker);
+}
+
+// 批量执行顶点着色器，结果保存到m_shadedVertices
+void Renderer::ShadeVertices(const std::vector<Vertex>& vertices, Shader* shader)
+{
+    XYH_PROFILE_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, VertexShading);
+    
+    // MVP矩阵和法线矩阵每次绘制只计算一次
+    VertexUniforms uniforms = GetVertexUniforms();
+    m_shadedVertices = m_frameArena.AllocateArray<VertexOutput>(vertices.size());
+    VertexBatch batch;
+    VertexOutputBatch outputBatch;
+    for (size_t first = 0; first < vertices.size(); first += VertexBatch::kSize) {
+        int count = static_cast<int>((std::min)(static_cast<size_t>(VertexBatch::kSize), vertices.size() - first));
+        batch.LoadVertices(&vertices[first], count);
+        shader->VertexShaderBatch(batch, uniforms, outputBatch);
+        for (int i = 0; i < count; i++) {
+            m_shadedVertices[first + i] = outputBatch.GetOutput(i);
+        }
+    }
+    PipelineCounters::Add(&PipelineStatistics::verticesShaded, vertices.size());
+}
+
+// 从已转换为SoA的顶点批执行顶点着色器（实例化绘制的所有实例共用同一组顶点批）
+void Renderer::ShadeVertices(const VertexBatch* batches, size_t vertexCount, Shader* shader)
+{
+    XYH_PROFILE_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, VertexShading);
+    VertexUniforms uniforms = GetVertexUniforms();
+    m_shadedVertices = m_frameArena.AllocateArray<VertexOutput>(vertexCount);
+    VertexOutputBatch outputBatch;
+    for (size_t first = 0; first < vertexCount; first += VertexBatch::kSize) {
+        const VertexBatch& batch = batches[first / VertexBatch::kSize];
+        shader->VertexShaderBatch(batch, uniforms, outputBatch);
+        for (int i = 0; i < batch.count; i++) {
+            m_shadedVertices[first + i] = outputBatch.GetOutput(i);
+        }
+    }
+    PipelineCounters::Add(&PipelineStatistics::verticesShaded, vertexCount);
+}
+
+// 顶点着色器的参数
+VertexUniforms Renderer::GetVertexUniforms() const
+{
+    VertexUniforms uniforms(m_modelMatrix, m_viewMatrix, m_projMatrix);
+    uniforms.instanceColor = m_instanceColor;
+    uniforms.instanceParams = m_instanceParams;
+    return uniforms;
+}
+
+// 使用着色后的顶点绘制一段三角形
+void Renderer::DrawShadedTriangles(const std::vector<Vector3i>& indices, size_t triangleStart, size_t triangleEnd, Shader* shader)
+{
+    for (size_t i = triangleStart; i < triangleEnd; i++) {
+        const Vector3i& index = indices[i];
+        RasterizeTriangle(m_shadedVertices[index.x], m_shadedVertices[index.y], m_shadedVertices[index.z], shader);
+    }
+}
+
+// 准备按簇绘制
+void Renderer::BeginMeshlets(const Mesh& mesh, CullMode cullMode, MeshletDrawState& state)
+{
+    state.uniforms = GetVertexUniforms();
+    m_shadedVertices = m_frameArena.AllocateArray<VertexOutput>(mesh.vertices.size());
+    m_vertexShaded = m_frameArena.AllocateArray<unsigned char>(mesh.vertices.size());
+    
+    // 世界空间平面p变换到物体空间为transpose(M) * p，平面方程的值不变
+    const Frustum& frustum = GetFrustum();
+    const float (*m)[4] = m_modelMatrix.m;
+    for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+        const Vector4f& plane = frustum.GetPlane(i);
+        state.planes[i] = Vector4f(plane.x * m[0][0] + plane.y * m[1][0] + plane.z * m[2][0] + plane.w * m[3][0],
+                                   plane.x * m[0][1] + plane.y * m[1][1] + plane.z * m[2][1] + plane.w * m[3][1],
+                                   plane.x * m[0][2] + plane.y * m[1][2] + plane.z * m[2][2] + plane.w * m[3][2],
+                                   plane.x * m[0][3] + plane.y * m[1][3] + plane.z * m[2][3] + plane.w * m[3][3]);
+    }
+    state.radiusScale = GetMaxScale(m_modelMatrix);
+    
+    // 三角形是否背向相机在仿射变换下不变（镜像变换会反转），因此可以在物体空间用相机位置测试
+    Vector4f viewPosition = m_modelMatrix.inverseAffine() * Vector4f(m_viewPosition, 1.0f);
+    state.viewPosition = Vector3f(viewPosition.x, viewPosition.y, viewPosition.z);
+    Vector3f axisX(m[0][0], m[1][0], m[2][0]);
+    Vector3f axisY(m[0][1], m[1][1], m[2][1]);
+    Vector3f axisZ(m[0][2], m[1][2], m[2][2]);
+    bool mirrored = Vector3f::dot(Vector3f::cross(axisX, axisY), axisZ) < 0.0f;
+    
+    // 法线锥按逆时针环绕计算法线，只有被剔除的正好是法线背向相机的三角形时才能使用
+    bool cullsAwayFacing = (cullMode == CullMode::CULL_BACK) == (m_frontFace == FrontFace::COUNTER_CLOCKWISE);
+    state.coneCulling = cullMode != CullMode::CULL_NONE && cullsAwayFacing != mirrored;
+}
+
+// 簇可见性测试：包围球与视锥体，法线锥与相机位置
+bool Renderer::IsMeshletVisible(const Meshlet& meshlet, const MeshletDrawState& state)
+{
+    float radius = meshlet.radius * state.radiusScale;
+    for (const Vector4f& plane : state.planes) {
+        if (plane.x * meshlet.center.x + plane.y * meshlet.center.y + plane.z * meshlet.center.z + plane.w < -radius) {
+            m_stats.meshletsFrustumCulled++;
+            return false;
+        }
+    }
+    
+    if (state.coneCulling && meshlet.coneCutoff < 1.0f) {
+        Vector3f direction = meshlet.coneApex - state.viewPosition;
+        if (Vector3f::dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * direction.magnitude()) {
+            m_stats.meshletsBackfaceCulled++;
+            return false;
+        }
+    }
+    
+    m_stats.meshletsDrawn++;
+    return true;
+}
+
+// 批量着色簇引用的顶点，与相邻簇共享的顶点只着色一次
+void Renderer::ShadeMeshletVertices(const Mesh& mesh, const Meshlet& meshlet, const MeshletDrawState& state, Shader* shader)
+{
+    XYH_PROFILE_STAGES(stages);
+    XYH_PROFILE_STAGE(stages, VertexShading);
+    const int* vertexIndices = &mesh.meshletVertices[meshlet.vertexOffset];
+    int pending[VertexBatch::kSize];
+    int count = 0;
+    VertexBatch batch;
+    VertexOutputBatch outputBatch;
+    for (size_t i = 0; i <= meshlet.vertexCount; i++) {
+        if (i < meshlet.vertexCount) {
+            int vertexIndex = vertexIndices[i];
+            if (m_vertexShaded[vertexIndex]) {
+                continue;
+            }
+            m_vertexShaded[vertexIndex] = 1;
+            pending[count++] = vertexIndex;
+        }
+        
+        // 凑满一批或处理完全部顶点时执行顶点着色器
+        if (count == VertexBatch::kSize || (i == meshlet.vertexCount && count > 0)) {
+            batch.LoadVertices(mesh.vertices.data(), pending, count);
+            shader->VertexShaderBatch(batch, state.uniforms, outputBatch);
+            for (int j = 0; j < count; j++) {
+                m_shadedVertices[pending[j]] = outputBatch.GetOutput(j);
+            }
+            PipelineCounters::Add(&PipelineStatistics::verticesShaded, count);
+            count = 0;
+        }
+    }
+}
+
+// 按簇绘制
+void Renderer::DrawMeshlets(const Mesh& mesh, size_t firstMeshlet, size_t endMeshlet, const MeshletDrawState& state, Shader* shader)
+{
+    for (size_t i = firstMeshlet; i < endMeshlet; i++) {
+        const Meshlet& meshlet = mesh.meshlets[i];
+        if (!IsMeshletVisible(meshlet, state)) {
+            continue;
+        }
+        ShadeMeshletVertices(mesh, meshlet, state, shader);
+        DrawShadedTriangles(mesh.indices, meshlet.triangleStart, meshlet.triangleStart + meshlet.triangleCount, shader);
+    }
+}
+
+// 当前视图和投影矩阵对应的视锥体
+const Frustum& Renderer::GetFrustum()
+{
+    if (m_frustumDirty) {
+        m_frustum = Frustum::FromMatrix(m_projMatrix * m_viewMatrix);
+        m_frustumDirty = false;
+    }
+    return m_frustum;
+}
+
+// 合并各线程的计数器，返回本帧到目前为止的管线统计
+const PipelineStatistics& Renderer::GetPipelineStatistics()
+{
+    m_pipelineStats += PipelineCounters::Collect();
+    return m_pipelineStats;
+}
+
+void Renderer::BeginPipelineQuery()
+{
+    m_queryStart = GetPipelineStatistics();
+}
+
+PipelineStatistics Renderer::EndPipelineQuery()
+{
+    return GetPipelineStatistics() - m_queryStart;
+}
+
+// 热度调色板：t从0到1依次为黑、蓝、青、绿、黄、红，超过1为白色
+inline Color HeatColor(float t)
+{
+    static const Color stops[] = {
+        Color(0.0f, 0.0f, 0.0f, 1.0f), Color(0.0f, 0.0f, 1.0f, 1.0f), Color(0.0f, 1.0f, 1.0f, 1.0f),
+        Color(0.0f, 1.0f, 0.0f, 1.0f), Color(1.0f, 1.0f, 0.0f, 1.0f), Color(1.0f, 0.0f, 0.0f, 1.0f)
+    };
+    const int segments = static_cast<int>(sizeof(stops) / sizeof(stops[0])) - 1;
+    if (t > 1.0f) {
+        return Color::white;
+    }
+    float position = (std::max)(t, 0.0f) * segments;
+    int index = (std::min)(static_cast<int>(position), segments - 1);
+    return Color::lerp(stops[index], stops[index + 1], position - index);
+}
+
+void Renderer::SetDebugView(DebugView view)
+{
+    // 中途开启时本帧之前的绘制不计数
+    if (view != DebugView::NONE) {
+        m_debugCounts.assign(static_cast<size_t>(m_width) * m_height, 0);
+    }
+    m_debugView = view;
+}
+
+const char* Renderer::GetDebugViewName(DebugView view)
+{
+    switch (view) {
+    case DebugView::NONE: return "None";
+    case DebugView::OVERDRAW: return "Overdraw";
+    case DebugView::DEPTH_COMPLEXITY: return "Depth tests";
+    case DebugView::SHADER_COST: return "Shader cycles";
+    default: return "Unknown";
+    }
+}
+
+// 把逐像素计数按热度调色板写入颜色缓冲区（计数为0的像素为黑色）
+float Renderer::ResolveDebugView()
+{
+    if (m_debugView == DebugView::NONE) {
+        return 0.0f;
+    }
+    XYH_PROFILE_SCOPE("ResolveDebugView");
+    
+    float scale = m_debugViewScale;
+    if (scale <= 0.0f && m_debugView != DebugView::SHADER_COST) {
+        scale = static_cast<float>(kDebugViewCountScale);
+    } else if (scale <= 0.0f) {
+        // 周期数的分布很不均匀（缓存未命中等），用99百分位作为满量程，少数极端像素显示为白色
+        std::vector<uint32_t> values;
+        for (uint32_t count : m_debugCounts) {
+            if (count > 0) {
+                values.push_back(count);
+            }
+        }
+        if (!values.empty()) {
+            std::vector<uint32_t>::iterator percentile = values.begin() + values.size() * 99 / 100;
+            std::nth_element(values.begin(), percentile, values.end());
+            scale = static_cast<float>(*percentile);
+        }
+        scale = (std::max)(scale, 1.0f);
+    }
+    
+    ColorBuffer& colorBuffer = m_currentFrameBuffer->colorBuffer;
+    const float invScale = 1.0f / scale;
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            colorBuffer.SetPixel(x, y, HeatColor(m_debugCounts[y * m_width + x] * invScale));
+        }
+    }
+    return scale;
+}
+
+// 包围体可见性测试：先用包围球快速排除，再用变换后的包围盒测试
+bool Renderer::IsVisible(const MeshBounds& bounds, const Matrix& modelMatrix)
+{
+    const Frustum& frustum = GetFrustum();
+    
+    Vector4f center = modelMatrix * Vector4f(bounds.center, 1.0f);
+    float radius = bounds.radius * GetMaxScale(modelMatrix);
+    if (!frustum.IntersectsSphere(Vector3f(center.x, center.y, center.z), radius)) {
+        return false;
+    }
+    
+    Vector3f worldMin, worldMax;
+    TransformAABB(bounds.min, bounds.max, modelMatrix, worldMin, worldMax);
+    return frustum.IntersectsAABB(worldMin, worldMax);
+}
+
 // 绘制对象
 void Renderer::DrawObject(const Object& object, Shader* shader)
 {
-    DrawMesh(object.mesh, object.GetModelMatrix(), shader);
-} 
\ No newline at end of file
+    if (!shader) return;  // 安全检查
+    
+    // 对象完全在视锥体外时跳过，不做任何逐顶点的工作
+    Matrix modelMatrix = object.GetModelMatrix();
+    if (m_frustumCulling && !IsVisible(object.mesh.GetBounds(), modelMatrix)) {
+        m_stats.objectsCulled++;
+        return;
+    }
+    m_stats.objectsDrawn++;
+    DrawObjectInternal(object, modelMatrix, shader);
+}
+
+// 绘制场景
+void Renderer::DrawScene(Scene& scene, Shader* shader)
+{
+    if (!shader) return;  // 安全检查
+    XYH_PROFILE_SCOPE("DrawScene");
+    
+    m_visibleObjects.clear();
+    if (m_frustumCulling) {
+        // BVH遍历只测试与视锥体相交的节点，完全在视锥体内的子树不再逐个测试
+        scene.QueryFrustum(GetFrustum(), m_visibleObjects);
+    } else {
+        for (size_t id = 0; id < scene.GetObjectCapacity(); id++) {
+            if (scene.GetObjectById(id)) {
+                m_visibleObjects.push_back(id);
+            }
+        }
+    }
+    m_stats.objectsCulled += static_cast<int>(scene.GetObjectCount() - m_visibleObjects.size());
+    m_stats.objectsDrawn += static_cast<int>(m_visibleObjects.size());
+    
+    for (size_t id : m_visibleObjects) {
+        const Object* object = scene.GetObjectById(id);
+        DrawObjectInternal(*object, object->GetModelMatrix(), shader);
+    }
+}
+
+// 实例化绘制（只有模型矩阵）
+void Renderer::DrawMeshInstanced(const Mesh& mesh, const Matrix* modelMatrices, size_t count, Shader* shader)
+{
+    DrawInstances(mesh, modelMatrices, nullptr, count, shader);
+}
+
+// 实例化绘制（带颜色和参数）
+void Renderer::DrawMeshInstanced(const Mesh& mesh, const InstanceData* instances, size_t count, Shader* shader)
+{
+    DrawInstances(mesh, nullptr, instances, count, shader);
+}
+
+// 实例化绘制的实现
+void Renderer::DrawInstances(const Mesh& mesh, const Matrix* modelMatrices, const InstanceData* instances, size_t count, Shader* shader)
+{
+    if (!shader || count == 0 || mesh.indices.empty()) return;  // 安全检查
+    XYH_PROFILE_SCOPE("DrawMeshInstanced");
+    
+    const MeshBounds& bounds = mesh.GetBounds();
+    FrameArena::Marker marker = m_frameArena.GetMarker();
+    
+    // 不能按簇绘制时所有实例都对全部顶点着色：顶点只转换为SoA一次，每个实例只执行顶点着色器
+    VertexBatch* batches = nullptr;
+    if (!CanDrawMeshlets(mesh)) {
+        const std::vector<Vertex>& vertices = mesh.vertices;
+        batches = m_frameArena.AllocateArray<VertexBatch>((vertices.size() + VertexBatch::kSize - 1) / VertexBatch::kSize);
+        for (size_t first = 0; first < vertices.size(); first += VertexBatch::kSize) {
+            int batchCount = static_cast<int>((std::min)(static_cast<size_t>(VertexBatch::kSize), vertices.size() - first));
+            batches[first / VertexBatch::kSize].LoadVertices(&vertices[first], batchCount);
+        }
+    }
+    
+    // 子网格会切换着色器的材质，绘制后恢复为调用者设置的材质（与DrawObjectInternal相同）
+    Material callerMaterial;
+    bool restoreMaterial = !mesh.subMeshes.empty();
+    if (restoreMaterial) {
+        callerMaterial = shader->GetMaterial();
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        const Matrix& modelMatrix = instances ? instances[i].modelMatrix : modelMatrices[i];
+        if (m_frustumCulling && !IsVisible(bounds, modelMatrix)) {
+            m_stats.instancesCulled++;
+            continue;
+        }
+        m_stats.instancesDrawn++;
+        if (instances) {
+            m_instanceColor = instances[i].color;
+            m_instanceParams = instances[i].params;
+        }
+        DrawMeshMaterials(mesh, modelMatrix, batches, shader);
+    }
+    
+    // 恢复为默认的实例数据，避免影响之后的普通绘制
+    m_instanceColor = Vector4f(1.0f, 1.0f, 1.0f, 1.0f);
+    m_instanceParams = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
+    if (restoreMaterial) {
+        shader->SetMaterial(callerMaterial);
+    }
+    m_frameArena.Rewind(marker);
+}
+
+// 选择LOD
+const Mesh& Renderer::SelectLod(const Object& object, const Matrix& modelMatrix)
+{
+    const Mesh& mesh = object.mesh;
+    int lodCount = static_cast<int>(mesh.lods.size());
+    int index = 0;
+    if (m_lodSelection && lodCount > 0) {
+        const MeshBounds& bounds = mesh.GetBounds();
+        Vector4f center = modelMatrix * Vector4f(bounds.center, 1.0f);
+        float radius = bounds.radius * GetMaxScale(modelMatrix);
+        float distance = (Vector3f(center.x, center.y, center.z) - m_viewPosition).magnitude();
+        
+        // 相机在包围球内时使用原网格
+        if (distance > radius && bounds.radius > 0.0f) {
+            // 包围球投影到屏幕上的半径（像素），投影矩阵的m[1][1]为cot(fov / 2)
+            float projectedRadius = radius / distance * m_projMatrix.m[1][1] * 0.5f * m_height;
+            // LOD的误差是物体空间的距离，按包围球半径的比例换算为像素
+            float pixelsPerUnit = projectedRadius / bounds.radius;
+            
+            index = (std::min)((std::max)(object.GetLodIndex(), 0), lodCount);
+            if (index > 0 && mesh.lods[index - 1].lodError * pixelsPerUnit > m_lodPixelError * (1.0f + m_lodHysteresis)) {
+                // 当前LOD误差明显超过阈值：换成误差不超过阈值的最粗糙一级
+                while (index > 0 && mesh.lods[index - 1].lodError * pixelsPerUnit > m_lodPixelError) {
+                    index--;
+                }
+            } else {
+                // 更粗糙的LOD误差明显低于阈值时才换过去
+                while (index < lodCount && mesh.lods[index].lodError * pixelsPerUnit <= m_lodPixelError * (1.0f - m_lodHysteresis)) {
+                    index++;
+                }
+            }
+        }
+    }
+    object.SetLodIndex(index);
+    
+    const Mesh& selected = index > 0 ? mesh.lods[index - 1] : mesh;
+    m_stats.trianglesSubmitted += selected.GetTriangleCount();
+    m_stats.trianglesFullDetail += mesh.GetTriangleCount();
+    return selected;
+}
+
+// 绘制对象（调用方已完成剔除）
+void Renderer::DrawObjectInternal(const Object& object, const Matrix& modelMatrix, Shader* shader)
+{
+    XYH_PROFILE_SCOPE("DrawObject");
+    const Mesh& mesh = SelectLod(object, modelMatrix);
+    
+    // 没有子网格时整个网格使用对象的材质
+    if (mesh.subMeshes.empty()) {
+        shader->SetMaterial(object.material);
+        DrawMesh(mesh, modelMatrix, shader);
+        return;
+    }
+    
+    // 顶点着色与材质无关，所有子网格共用一次顶点着色的结果
+    DrawMeshMaterials(mesh, modelMatrix, nullptr, shader);
+    
+    // 恢复为对象的材质，避免影响之后直接调用DrawMesh的绘制
+    shader->SetMaterial(object.material);
+}
+
+// 网格是否可以整体按簇绘制
+bool Renderer::CanDrawMeshlets(const Mesh& mesh) const
+{
+    if (!m_meshletCulling) {
+        return false;
+    }
+    size_t firstMeshlet, endMeshlet;
+    if (mesh.subMeshes.empty()) {
+        return MeshletBuilder::FindMeshlets(mesh, 0, mesh.indices.size(), firstMeshlet, endMeshlet);
+    }
+    for (const SubMesh& subMesh : mesh.subMeshes) {
+        if (subMesh.triangleCount > 0 &&
+            !MeshletBuilder::FindMeshlets(mesh, subMesh.triangleStart, subMesh.triangleStart + subMesh.triangleCount, firstMeshlet, endMeshlet)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 绘制整个网格，按子网格切换材质
+void Renderer::DrawMeshMaterials(const Mesh& mesh, const Matrix& modelMatrix, const VertexBatch* batches, Shader* shader)
+{
+    m_modelMatrix = modelMatrix;
+    FrameArena::Marker marker = m_frameArena.GetMarker();
+    
+    // 能按簇绘制时顶点只在第一个引用它的可见簇中着色
+    if (!batches && CanDrawMeshlets(mesh)) {
+        MeshletDrawState state;
+        BeginMeshlets(mesh, m_cullMode, state);
+        size_t firstMeshlet, endMeshlet;
+        if (mesh.subMeshes.empty() && MeshletBuilder::FindMeshlets(mesh, 0, mesh.indices.size(), firstMeshlet, endMeshlet)) {
+            DrawMeshlets(mesh, firstMeshlet, endMeshlet, state, shader);
+        }
+        for (const SubMesh& subMesh : mesh.subMeshes) {
+            if (MeshletBuilder::FindMeshlets(mesh, subMesh.triangleStart, subMesh.triangleStart + subMesh.triangleCount, firstMeshlet, endMeshlet)) {
+                shader->SetMaterial(subMesh.material);
+                DrawMeshlets(mesh, firstMeshlet, endMeshlet, state, shader);
+            }
+        }
+        m_frameArena.Rewind(marker);
+        return;
+    }
+    
+    if (batches) {
+        ShadeVertices(batches, mesh.vertices.size(), shader);
+    } else {
+        ShadeVertices(mesh.vertices, shader);
+    }
+    if (mesh.subMeshes.empty()) {
+        DrawShadedTriangles(mesh.indices, 0, mesh.indices.size(), shader);
+    }
+    
+    // 子网格已按材质排序，每个子网格只切换一次材质
+    for (const SubMesh& subMesh : mesh.subMeshes) {
+        shader->SetMaterial(subMesh.material);
+        size_t triangleEnd = (std::min)(subMesh.triangleStart + subMesh.triangleCount, mesh.indices.size());
+        DrawShadedTriangles(mesh.indices, (std::min)(subMesh.triangleStart, triangleEnd), triangleEnd, shader);
+    }
+    m_frameArena.Rewind(marker);
+}
\ No newline at end of file
@@ -0,0 +1,625 @@
+#include "../include/Scene.h"
+#include "../include/MyMath.h"
+#include "../include/Profiler.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 取向量的第axis个分量
+inline float AxisValue(const Vector3f& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// 包围盒表面积（用于判断refit后BVH质量是否下降）
+inline float SurfaceArea(const Vector3f& min, const Vector3f& max)
+{
+    Vector3f size = max - min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+inline bool BoxesOverlap(const Vector3f& minA, const Vector3f& maxA, const Vector3f& minB, const Vector3f& maxB)
+{
+    return minA.x <= maxB.x && maxA.x >= minB.x &&
+           minA.y <= maxB.y && maxA.y >= minB.y &&
+           minA.z <= maxB.z && maxA.z >= minB.z;
+}
+
+// 射线与包围盒的slab测试，相交时返回进入距离
+inline bool RayIntersectsBox(const Vector3f& origin, const Vector3f& inverseDirection, const Vector3f& min, const Vector3f& max,
+                             float maxDistance, float& entryDistance)
+{
+    float t1 = (min.x - origin.x) * inverseDirection.x;
+    float t2 = (max.x - origin.x) * inverseDirection.x;
+    float tMin = (std::min)(t1, t2);
+    float tMax = (std::max)(t1, t2);
+
+    t1 = (min.y - origin.y) * inverseDirection.y;
+    t2 = (max.y - origin.y) * inverseDirection.y;
+    tMin = (std::max)(tMin, (std::min)(t1, t2));
+    tMax = (std::min)(tMax, (std::max)(t1, t2));
+
+    t1 = (min.z - origin.z) * inverseDirection.z;
+    t2 = (max.z - origin.z) * inverseDirection.z;
+    tMin = (std::max)(tMin, (std::min)(t1, t2));
+    tMax = (std::min)(tMax, (std::max)(t1, t2));
+
+    entryDistance = (std::max)(tMin, 0.0f);
+    return tMax >= entryDistance && entryDistance <= maxDistance;
+}
+
+// Moller-Trumbore射线三角形求交，返回射线参数t
+inline bool RayIntersectsTriangle(const Vector3f& origin, const Vector3f& direction,
+                                  const Vector3f& p0, const Vector3f& p1, const Vector3f& p2, float& t)
+{
+    Vector3f edge1 = p1 - p0;
+    Vector3f edge2 = p2 - p0;
+    Vector3f h = Vector3f::cross(direction, edge2);
+    float det = Vector3f::dot(edge1, h);
+    if (std::abs(det) < 1e-12f) {
+        return false;
+    }
+    float inverseDet = 1.0f / det;
+    Vector3f s = origin - p0;
+    float u = Vector3f::dot(s, h) * inverseDet;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+    Vector3f q = Vector3f::cross(s, edge1);
+    float v = Vector3f::dot(direction, q) * inverseDet;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+    t = Vector3f::dot(edge2, q) * inverseDet;
+    return t >= 0.0f;
+}
+
+} // namespace
+
+Scene::Scene()
+    : m_objectCount(0),
+      m_needsRebuild(false),
+      m_builtRootArea(0.0f),
+      m_rebuildCount(0),
+      m_refitCount(0)
+{
+}
+
+size_t Scene::AddObject(const Object& object)
+{
+    return AddObject(Object(object));
+}
+
+size_t Scene::AddObject(Object&& object)
+{
+    size_t id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = m_entries.size();
+        m_entries.push_back(Entry());
+    }
+
+    Entry& entry = m_entries[id];
+    entry.object.reset(new Object(std::move(object)));
+    entry.object->ClearParentMatrix();
+    entry.leaf = -1;
+    entry.dirty = false;
+    entry.parent = kInvalidId;
+    entry.children.clear();
+    entry.transformDirty = false;
+    UpdateWorldBounds(entry);
+
+    m_objectCount++;
+    m_needsRebuild = true;
+    return id;
+}
+
+void Scene::RemoveObject(size_t id)
+{
+    if (id >= m_entries.size() || !m_entries[id].object) {
+        return;
+    }
+
+    // 子对象成为没有父对象的对象，模型矩阵恢复为局部矩阵
+    SetParent(id, kInvalidId);
+    for (size_t child : m_entries[id].children) {
+        m_entries[child].parent = kInvalidId;
+        m_entries[child].object->ClearParentMatrix();
+        MarkTransformChanged(child);
+    }
+    m_entries[id].children.clear();
+    m_entries[id].transformDirty = false;
+
+    m_entries[id].object.reset();
+    m_entries[id].leaf = -1;
+    m_freeIds.push_back(id);
+    m_objectCount--;
+    m_needsRebuild = true;
+}
+
+void Scene::Clear()
+{
+    m_entries.clear();
+    m_freeIds.clear();
+    m_objectCount = 0;
+    m_nodes.clear();
+    m_leafObjects.clear();
+    m_dirtyObjects.clear();
+    m_dirtyTransforms.clear();
+    m_updatedTransforms.clear();
+    m_needsRebuild = false;
+}
+
+Object* Scene::GetObjectById(size_t id)
+{
+    return id < m_entries.size() ? m_entries[id].object.get() : nullptr;
+}
+
+const Object* Scene::GetObjectById(size_t id) const
+{
+    return id < m_entries.size() ? m_entries[id].object.get() : nullptr;
+}
+
+void Scene::SetTransform(size_t id, const Transformer& transform)
+{
+    Object* object = GetObjectById(id);
+    if (!object) {
+        return;
+    }
+    object->transform = transform;
+    MarkTransformChanged(id);
+}
+
+void Scene::MarkTransformChanged(size_t id)
+{
+    if (id >= m_entries.size() || !m_entries[id].object || m_entries[id].transformDirty) {
+        return;
+    }
+    m_entries[id].transformDirty = true;
+    m_dirtyTransforms.push_back(id);
+}
+
+bool Scene::SetParent(size_t id, size_t parent)
+{
+    if (!GetObjectById(id) || (parent != kInvalidId && !GetObjectById(parent))) {
+        return false;
+    }
+    // 不能挂到自己的子树下
+    for (size_t ancestor = parent; ancestor != kInvalidId; ancestor = m_entries[ancestor].parent) {
+        if (ancestor == id) {
+            return false;
+        }
+    }
+
+    Entry& entry = m_entries[id];
+    if (entry.parent == parent) {
+        return true;
+    }
+    if (entry.parent != kInvalidId) {
+        std::vector<size_t>& siblings = m_entries[entry.parent].children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+    }
+    entry.parent = parent;
+    if (parent != kInvalidId) {
+        m_entries[parent].children.push_back(id);
+    } else {
+        entry.object->ClearParentMatrix();
+    }
+    MarkTransformChanged(id);
+    return true;
+}
+
+size_t Scene::GetParent(size_t id) const
+{
+    return GetObjectById(id) ? m_entries[id].parent : kInvalidId;
+}
+
+const std::vector<size_t>& Scene::GetChildren(size_t id) const
+{
+    static const std::vector<size_t> kNoChildren;
+    return GetObjectById(id) ? m_entries[id].children : kNoChildren;
+}
+
+void Scene::UpdateWorldMatrix(Entry& entry)
+{
+    if (entry.parent != kInvalidId) {
+        entry.object->SetParentMatrix(m_entries[entry.parent].object->GetModelMatrix());
+    } else {
+        // 没有父对象时只需要更新局部矩阵的缓存（之后多线程读取时不再修改缓存）
+        entry.object->transform.GetModelMatrix();
+    }
+    entry.transformDirty = false;
+}
+
+// 深度优先遍历，父对象总是先于子对象更新
+void Scene::UpdateSubtrees(const size_t* roots, size_t count, std::vector<size_t>& updated)
+{
+    std::vector<size_t> stack(roots, roots + count);
+    while (!stack.empty()) {
+        size_t id = stack.back();
+        stack.pop_back();
+        Entry& entry = m_entries[id];
+        UpdateWorldMatrix(entry);
+        updated.push_back(id);
+        stack.insert(stack.end(), entry.children.begin(), entry.children.end());
+    }
+}
+
+void Scene::UpdateTransforms()
+{
+    if (m_dirtyTransforms.empty()) {
+        return;
+    }
+    m_updatedTransforms.clear();
+
+    // 只从最上层的改变的对象开始：祖先也改变了的对象会在祖先的子树中一起更新
+    std::sort(m_dirtyTransforms.begin(), m_dirtyTransforms.end());
+    m_dirtyTransforms.erase(std::unique(m_dirtyTransforms.begin(), m_dirtyTransforms.end()), m_dirtyTransforms.end());
+    m_transformRoots.clear();
+    for (size_t id : m_dirtyTransforms) {
+        const Entry& entry = m_entries[id];
+        if (!entry.object || !entry.transformDirty) {
+            continue;
+        }
+        bool ancestorDirty = false;
+        for (size_t ancestor = entry.parent; ancestor != kInvalidId && !ancestorDirty; ancestor = m_entries[ancestor].parent) {
+            ancestorDirty = m_entries[ancestor].transformDirty;
+        }
+        if (!ancestorDirty) {
+            m_transformRoots.push_back(id);
+        }
+    }
+    m_dirtyTransforms.clear();
+
+    // 子树较少时逐层展开：串行更新这一层的对象，把它们的子对象作为新的子树，直到子树足够多或全部更新完
+    while (!m_transformRoots.empty() && m_transformRoots.size() < kParallelTransformSubtrees) {
+        m_nextTransformRoots.clear();
+        for (size_t id : m_transformRoots) {
+            Entry& entry = m_entries[id];
+            UpdateWorldMatrix(entry);
+            m_updatedTransforms.push_back(id);
+            m_nextTransformRoots.insert(m_nextTransformRoots.end(), entry.children.begin(), entry.children.end());
+        }
+        m_transformRoots.swap(m_nextTransformRoots);
+    }
+
+    // 子树互不相交，且父对象的世界矩阵都已更新：线程池中的每个线程（包括调用线程）更新一段子树
+    if (!m_transformRoots.empty()) {
+        size_t rootCount = m_transformRoots.size();
+        ThreadPool* pool = ThreadPool::GetInstance();
+        size_t poolThreads = static_cast<size_t>(pool->GetThreadCount()) + 1;
+        size_t threadCount = (std::min)(poolThreads, rootCount / (kParallelTransformSubtrees / 4));
+        if (threadCount <= 1) {
+            UpdateSubtrees(m_transformRoots.data(), rootCount, m_updatedTransforms);
+        } else {
+            std::vector<std::vector<size_t>> updated(threadCount);
+            auto updateChunk = [&](size_t chunk) {
+                size_t first = rootCount * chunk / threadCount;
+                size_t last = rootCount * (chunk + 1) / threadCount;
+                XYH_PROFILE_SCOPE("UpdateSubtrees");
+                UpdateSubtrees(m_transformRoots.data() + first, last - first, updated[chunk]);
+            };
+            pool->ParallelFor(threadCount, updateChunk);
+            for (const std::vector<size_t>& chunkUpdated : updated) {
+                m_updatedTransforms.insert(m_updatedTransforms.end(), chunkUpdated.begin(), chunkUpdated.end());
+            }
+        }
+    }
+
+    // 世界矩阵改变的对象等待refit
+    for (size_t id : m_updatedTransforms) {
+        Entry& entry = m_entries[id];
+        if (!entry.dirty) {
+            entry.dirty = true;
+            m_dirtyObjects.push_back(id);
+        }
+    }
+}
+
+void Scene::GetWorldBounds(size_t id, Vector3f& min, Vector3f& max) const
+{
+    min = m_entries[id].worldMin;
+    max = m_entries[id].worldMax;
+}
+
+void Scene::UpdateWorldBounds(Entry& entry)
+{
+    const MeshBounds& bounds = entry.object->mesh.GetBounds();
+    TransformAABB(bounds.min, bounds.max, entry.object->GetModelMatrix(), entry.worldMin, entry.worldMax);
+}
+
+void Scene::Update()
+{
+    XYH_PROFILE_SCOPE("Scene::Update");
+    UpdateTransforms();
+    if (m_needsRebuild) {
+        Rebuild();
+    } else if (!m_dirtyObjects.empty()) {
+        Refit();
+    }
+}
+
+void Scene::Rebuild()
+{
+    // 重建会重新计算全部包围盒，不再需要refit
+    UpdateTransforms();
+    for (size_t id : m_dirtyObjects) {
+        m_entries[id].dirty = false;
+    }
+    m_dirtyObjects.clear();
+
+    m_leafObjects.clear();
+    for (size_t id = 0; id < m_entries.size(); id++) {
+        if (m_entries[id].object) {
+            UpdateWorldBounds(m_entries[id]);
+            m_leafObjects.push_back(id);
+        }
+    }
+
+    m_nodes.clear();
+    m_needsRebuild = false;
+    m_rebuildCount++;
+    if (m_leafObjects.empty()) {
+        m_builtRootArea = 0.0f;
+        return;
+    }
+
+    m_nodes.reserve(m_leafObjects.size() * 2);
+    Node root;
+    root.parent = -1;
+    m_nodes.push_back(root);
+    BuildNode(0, 0, static_cast<int>(m_leafObjects.size()));
+    m_builtRootArea = SurfaceArea(m_nodes[0].min, m_nodes[0].max);
+}
+
+// 自顶向下构建：按包围盒中心在最长轴上的中位数划分
+void Scene::BuildNode(int nodeIndex, int first, int count)
+{
+    Vector3f nodeMin = m_entries[m_leafObjects[first]].worldMin;
+    Vector3f nodeMax = m_entries[m_leafObjects[first]].worldMax;
+    Vector3f centerMin = (nodeMin + nodeMax) * 0.5f;
+    Vector3f centerMax = centerMin;
+    for (int i = first + 1; i < first + count; i++) {
+        const Entry& entry = m_entries[m_leafObjects[i]];
+        nodeMin = Vector3f::Min(nodeMin, entry.worldMin);
+        nodeMax = Vector3f::Max(nodeMax, entry.worldMax);
+        Vector3f center = (entry.worldMin + entry.worldMax) * 0.5f;
+        centerMin = Vector3f::Min(centerMin, center);
+        centerMax = Vector3f::Max(centerMax, center);
+    }
+    m_nodes[nodeIndex].min = nodeMin;
+    m_nodes[nodeIndex].max = nodeMax;
+
+    if (count <= kMaxLeafObjects) {
+        m_nodes[nodeIndex].left = -1;
+        m_nodes[nodeIndex].first = first;
+        m_nodes[nodeIndex].count = count;
+        for (int i = first; i < first + count; i++) {
+            m_entries[m_leafObjects[i]].leaf = nodeIndex;
+        }
+        return;
+    }
+
+    Vector3f extent = centerMax - centerMin;
+    int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > AxisValue(extent, axis)) axis = 2;
+
+    int half = count / 2;
+    std::nth_element(m_leafObjects.begin() + first, m_leafObjects.begin() + first + half, m_leafObjects.begin() + first + count,
+        [this, axis](size_t a, size_t b) {
+            return AxisValue(m_entries[a].worldMin + m_entries[a].worldMax, axis) <
+                   AxisValue(m_entries[b].worldMin + m_entries[b].worldMax, axis);
+        });
+
+    int left = static_cast<int>(m_nodes.size());
+    Node child;
+    child.parent = nodeIndex;
+    m_nodes.push_back(child);
+    m_nodes.push_back(child);
+    m_nodes[nodeIndex].left = left;
+    m_nodes[nodeIndex].first = 0;
+    m_nodes[nodeIndex].count = 0;
+
+    BuildNode(left, first, half);
+    BuildNode(left + 1, first + half, count - half);
+}
+
+void Scene::RecomputeNodeBounds(int nodeIndex)
+{
+    Node& node = m_nodes[nodeIndex];
+    if (node.IsLeaf()) {
+        node.min = m_entries[m_leafObjects[node.first]].worldMin;
+        node.max = m_entries[m_leafObjects[node.first]].worldMax;
+        for (int i = node.first + 1; i < node.first + node.count; i++) {
+            node.min = Vector3f::Min(node.min, m_entries[m_leafObjects[i]].worldMin);
+            node.max = Vector3f::Max(node.max, m_entries[m_leafObjects[i]].worldMax);
+        }
+    } else {
+        node.min = Vector3f::Min(m_nodes[node.left].min, m_nodes[node.left + 1].min);
+        node.max = Vector3f::Max(m_nodes[node.left].max, m_nodes[node.left + 1].max);
+    }
+}
+
+// 只更新变化对象所在叶子到根的路径，节点包围盒不变时提前结束
+void Scene::Refit()
+{
+    for (size_t id : m_dirtyObjects) {
+        Entry& entry = m_entries[id];
+        entry.dirty = false;
+        if (!entry.object || entry.leaf < 0) {
+            continue;
+        }
+        UpdateWorldBounds(entry);
+
+        for (int nodeIndex = entry.leaf; nodeIndex >= 0; nodeIndex = m_nodes[nodeIndex].parent) {
+            Vector3f oldMin = m_nodes[nodeIndex].min;
+            Vector3f oldMax = m_nodes[nodeIndex].max;
+            RecomputeNodeBounds(nodeIndex);
+            const Node& node = m_nodes[nodeIndex];
+            if (node.min.x == oldMin.x && node.min.y == oldMin.y && node.min.z == oldMin.z &&
+                node.max.x == oldMax.x && node.max.y == oldMax.y && node.max.z == oldMax.z) {
+                break;
+            }
+        }
+    }
+    m_dirtyObjects.clear();
+    m_refitCount++;
+
+    // 对象移动较多后子树重叠变大，遍历效率下降，此时重建
+    if (!m_nodes.empty() && SurfaceArea(m_nodes[0].min, m_nodes[0].max) > 2.0f * m_builtRootArea) {
+        Rebuild();
+    }
+}
+
+void Scene::QueryFrustum(const Frustum& frustum, std::vector<size_t>& result)
+{
+    Update();
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    // 栈中的节点编码为index * 2 + inside，inside表示节点已完全在视锥体内，子树不需要再测试
+    m_traversalStack.clear();
+    m_traversalStack.push_back(0);
+    while (!m_traversalStack.empty()) {
+        int item = m_traversalStack.back();
+        m_traversalStack.pop_back();
+        const Node& node = m_nodes[item >> 1];
+        bool inside = (item & 1) != 0;
+
+        if (!inside) {
+            if (!frustum.IntersectsAABB(node.min, node.max)) {
+                continue;
+            }
+            inside = frustum.ContainsAABB(node.min, node.max);
+        }
+
+        if (node.IsLeaf()) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                size_t id = m_leafObjects[i];
+                if (inside || frustum.IntersectsAABB(m_entries[id].worldMin, m_entries[id].worldMax)) {
+                    result.push_back(id);
+                }
+            }
+        } else {
+            m_traversalStack.push_back((node.left + 1) * 2 + (inside ? 1 : 0));
+            m_traversalStack.push_back(node.left * 2 + (inside ? 1 : 0));
+        }
+    }
+}
+
+void Scene::QueryBox(const Vector3f& min, const Vector3f& max, std::vector<size_t>& result)
+{
+    Update();
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    m_traversalStack.clear();
+    m_traversalStack.push_back(0);
+    while (!m_traversalStack.empty()) {
+        const Node& node = m_nodes[m_traversalStack.back()];
+        m_traversalStack.pop_back();
+        if (!BoxesOverlap(node.min, node.max, min, max)) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                size_t id = m_leafObjects[i];
+                if (BoxesOverlap(m_entries[id].worldMin, m_entries[id].worldMax, min, max)) {
+                    result.push_back(id);
+                }
+            }
+        } else {
+            m_traversalStack.push_back(node.left + 1);
+            m_traversalStack.push_back(node.left);
+        }
+    }
+}
+
+bool Scene::Raycast(const Vector3f& origin, const Vector3f& direction, RaycastHit& hit, float maxDistance)
+{
+    Update();
+    Vector3f rayDirection = direction;
+    rayDirection.normalize();
+    if (m_nodes.empty() || rayDirection.magnitude() < EPSILON) {
+        return false;
+    }
+
+    // 除以0得到无穷大，slab测试仍然正确
+    Vector3f inverseDirection(1.0f / rayDirection.x, 1.0f / rayDirection.y, 1.0f / rayDirection.z);
+    float closest = maxDistance;
+    bool found = false;
+
+    m_traversalStack.clear();
+    m_traversalStack.push_back(0);
+    while (!m_traversalStack.empty()) {
+        const Node& node = m_nodes[m_traversalStack.back()];
+        m_traversalStack.pop_back();
+        float entryDistance;
+        if (!RayIntersectsBox(origin, inverseDirection, node.min, node.max, closest, entryDistance)) {
+            continue;
+        }
+
+        if (!node.IsLeaf()) {
+            // 先访问较近的子节点，找到交点后可以排除更远的节点
+            float leftDistance, rightDistance;
+            bool hitLeft = RayIntersectsBox(origin, inverseDirection, m_nodes[node.left].min, m_nodes[node.left].max, closest, leftDistance);
+            bool hitRight = RayIntersectsBox(origin, inverseDirection, m_nodes[node.left + 1].min, m_nodes[node.left + 1].max, closest, rightDistance);
+            int left = node.left;
+            if (hitLeft && hitRight) {
+                bool leftFirst = leftDistance <= rightDistance;
+                m_traversalStack.push_back(leftFirst ? left + 1 : left);
+                m_traversalStack.push_back(leftFirst ? left : left + 1);
+            } else if (hitLeft) {
+                m_traversalStack.push_back(left);
+            } else if (hitRight) {
+                m_traversalStack.push_back(left + 1);
+            }
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++) {
+            size_t id = m_leafObjects[i];
+            const Entry& entry = m_entries[id];
+            if (!RayIntersectsBox(origin, inverseDirection, entry.worldMin, entry.worldMax, closest, entryDistance)) {
+                continue;
+            }
+
+            // 射线变换到物体空间求交：仿射变换不改变射线参数t，因此t仍是世界空间距离
+            Matrix inverseModel = entry.object->GetModelMatrix().inverseAffine();
+            Vector4f localOrigin = inverseModel * Vector4f(origin, 1.0f);
+            Vector4f localDirection = inverseModel * Vector4f(rayDirection, 0.0f);
+            Vector3f o(localOrigin.x, localOrigin.y, localOrigin.z);
+            Vector3f d(localDirection.x, localDirection.y, localDirection.z);
+
+            const Mesh& mesh = entry.object->mesh;
+            for (size_t t = 0; t < mesh.indices.size(); t++) {
+                const Vector3i& index = mesh.indices[t];
+                const Vector4f& p0 = mesh.vertices[index.x].pos;
+                const Vector4f& p1 = mesh.vertices[index.y].pos;
+                const Vector4f& p2 = mesh.vertices[index.z].pos;
+                float distance;
+                if (RayIntersectsTriangle(o, d, Vector3f(p0.x, p0.y, p0.z), Vector3f(p1.x, p1.y, p1.z), Vector3f(p2.x, p2.y, p2.z), distance) &&
+                    distance < closest) {
+                    closest = distance;
+                    found = true;
+                    hit.objectId = id;
+                    hit.triangleIndex = t;
+                }
+            }
+        }
+    }
+
+    if (found) {
+        hit.distance = closest;
+        hit.point = origin + rayDirection * closest;
+    }
+    return found;
+}
@@ -1,4 +1,162 @@
 #include "../include/Shader.h"
+#include "../include/Simd.h"
 #include <cmath>
 
-// 着色器辅助函数，后续可以根据需要添加 
\ No newline at end of file
+// 着色器辅助函数，后续可以根据需要添加
+
+void TransformVertexBatch(const VertexBatch& input, const VertexUniforms& uniforms, bool transformNormal,
+                          VertexOutputBatch& output)
+{
+    const Matrix& mvp = uniforms.mvpMatrix;
+    const Matrix& model = uniforms.modelMatrix;
+    const Matrix& normalMatrix = uniforms.normalMatrix;
+    const Vector4f& instanceColor = uniforms.instanceColor;
+    output.count = input.count;
+
+#if defined(XYH_SIMD_AVX2)
+    // 一次处理8个顶点：矩阵元素广播到8个通道，位置的w分量为1
+    __m256 x = _mm256_load_ps(input.positionX);
+    __m256 y = _mm256_load_ps(input.positionY);
+    __m256 z = _mm256_load_ps(input.positionZ);
+
+    // 裁剪空间位置
+    for (int row = 0; row < 4; row++) {
+        __m256 value = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(mvp.m[row][0]), x), _mm256_mul_ps(_mm256_set1_ps(mvp.m[row][1]), y)),
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(mvp.m[row][2]), z), _mm256_set1_ps(mvp.m[row][3])));
+        float* target = row == 0 ? output.positionX : row == 1 ? output.positionY : row == 2 ? output.positionZ : output.positionW;
+        _mm256_store_ps(target, value);
+    }
+
+    // 世界空间位置
+    for (int row = 0; row < 3; row++) {
+        __m256 value = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(model.m[row][0]), x), _mm256_mul_ps(_mm256_set1_ps(model.m[row][1]), y)),
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(model.m[row][2]), z), _mm256_set1_ps(model.m[row][3])));
+        float* target = row == 0 ? output.worldX : row == 1 ? output.worldY : output.worldZ;
+        _mm256_store_ps(target, value);
+    }
+
+    // 法线
+    __m256 nx = _mm256_load_ps(input.normalX);
+    __m256 ny = _mm256_load_ps(input.normalY);
+    __m256 nz = _mm256_load_ps(input.normalZ);
+    if (transformNormal) {
+        __m256 tx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[0][0]), nx),
+                                                _mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[0][1]), ny)),
+                                  _mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[0][2]), nz));
+        __m256 ty = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[1][0]), nx),
+                                                _mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[1][1]), ny)),
+                                  _mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[1][2]), nz));
+        __m256 tz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[2][0]), nx),
+                                                _mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[2][1]), ny)),
+                                  _mm256_mul_ps(_mm256_set1_ps(normalMatrix.m[2][2]), nz));
+        // 与Vector3f::normalize一致：长度太小时保持不变
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, tx), _mm256_mul_ps(ty, ty)),
+                                                     _mm256_mul_ps(tz, tz)));
+        __m256 valid = _mm256_cmp_ps(length, _mm256_set1_ps(EPSILON), _CMP_GE_OQ);
+        __m256 inverseLength = _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_div_ps(_mm256_set1_ps(1.0f), length), valid);
+        nx = _mm256_mul_ps(tx, inverseLength);
+        ny = _mm256_mul_ps(ty, inverseLength);
+        nz = _mm256_mul_ps(tz, inverseLength);
+    }
+    _mm256_store_ps(output.normalX, nx);
+    _mm256_store_ps(output.normalY, ny);
+    _mm256_store_ps(output.normalZ, nz);
+
+    // 纹理坐标原样传递，颜色乘以实例颜色
+    _mm256_store_ps(output.texcoordU, _mm256_load_ps(input.texcoordU));
+    _mm256_store_ps(output.texcoordV, _mm256_load_ps(input.texcoordV));
+    _mm256_store_ps(output.colorR, _mm256_mul_ps(_mm256_load_ps(input.colorR), _mm256_set1_ps(instanceColor.x)));
+    _mm256_store_ps(output.colorG, _mm256_mul_ps(_mm256_load_ps(input.colorG), _mm256_set1_ps(instanceColor.y)));
+    _mm256_store_ps(output.colorB, _mm256_mul_ps(_mm256_load_ps(input.colorB), _mm256_set1_ps(instanceColor.z)));
+    _mm256_store_ps(output.colorA, _mm256_mul_ps(_mm256_load_ps(input.colorA), _mm256_set1_ps(instanceColor.w)));
+#elif defined(XYH_SIMD_SSE2)
+    // 每次处理4个顶点
+    for (int lane = 0; lane < VertexBatch::kSize; lane += 4) {
+        __m128 x = _mm_load_ps(input.positionX + lane);
+        __m128 y = _mm_load_ps(input.positionY + lane);
+        __m128 z = _mm_load_ps(input.positionZ + lane);
+
+        // 裁剪空间位置
+        for (int row = 0; row < 4; row++) {
+            __m128 value = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mvp.m[row][0]), x), _mm_mul_ps(_mm_set1_ps(mvp.m[row][1]), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mvp.m[row][2]), z), _mm_set1_ps(mvp.m[row][3])));
+            float* target = row == 0 ? output.positionX : row == 1 ? output.positionY : row == 2 ? output.positionZ : output.positionW;
+            _mm_store_ps(target + lane, value);
+        }
+
+        // 世界空间位置
+        for (int row = 0; row < 3; row++) {
+            __m128 value = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(model.m[row][0]), x), _mm_mul_ps(_mm_set1_ps(model.m[row][1]), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(model.m[row][2]), z), _mm_set1_ps(model.m[row][3])));
+            float* target = row == 0 ? output.worldX : row == 1 ? output.worldY : output.worldZ;
+            _mm_store_ps(target + lane, value);
+        }
+
+        // 法线
+        __m128 nx = _mm_load_ps(input.normalX + lane);
+        __m128 ny = _mm_load_ps(input.normalY + lane);
+        __m128 nz = _mm_load_ps(input.normalZ + lane);
+        if (transformNormal) {
+            __m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(normalMatrix.m[0][0]), nx),
+                                              _mm_mul_ps(_mm_set1_ps(normalMatrix.m[0][1]), ny)),
+                                   _mm_mul_ps(_mm_set1_ps(normalMatrix.m[0][2]), nz));
+            __m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(normalMatrix.m[1][0]), nx),
+                                              _mm_mul_ps(_mm_set1_ps(normalMatrix.m[1][1]), ny)),
+                                   _mm_mul_ps(_mm_set1_ps(normalMatrix.m[1][2]), nz));
+            __m128 tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(normalMatrix.m[2][0]), nx),
+                                              _mm_mul_ps(_mm_set1_ps(normalMatrix.m[2][1]), ny)),
+                                   _mm_mul_ps(_mm_set1_ps(normalMatrix.m[2][2]), nz));
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz)));
+            __m128 valid = _mm_cmpge_ps(length, _mm_set1_ps(EPSILON));
+            __m128 inverseLength = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), length)),
+                                             _mm_andnot_ps(valid, _mm_set1_ps(1.0f)));
+            nx = _mm_mul_ps(tx, inverseLength);
+            ny = _mm_mul_ps(ty, inverseLength);
+            nz = _mm_mul_ps(tz, inverseLength);
+        }
+        _mm_store_ps(output.normalX + lane, nx);
+        _mm_store_ps(output.normalY + lane, ny);
+        _mm_store_ps(output.normalZ + lane, nz);
+
+        _mm_store_ps(output.texcoordU + lane, _mm_load_ps(input.texcoordU + lane));
+        _mm_store_ps(output.texcoordV + lane, _mm_load_ps(input.texcoordV + lane));
+        _mm_store_ps(output.colorR + lane, _mm_mul_ps(_mm_load_ps(input.colorR + lane), _mm_set1_ps(instanceColor.x)));
+        _mm_store_ps(output.colorG + lane, _mm_mul_ps(_mm_load_ps(input.colorG + lane), _mm_set1_ps(instanceColor.y)));
+        _mm_store_ps(output.colorB + lane, _mm_mul_ps(_mm_load_ps(input.colorB + lane), _mm_set1_ps(instanceColor.z)));
+        _mm_store_ps(output.colorA + lane, _mm_mul_ps(_mm_load_ps(input.colorA + lane), _mm_set1_ps(instanceColor.w)));
+    }
+#else
+    // 标量实现
+    for (int i = 0; i < input.count; i++) {
+        Vector4f position(input.positionX[i], input.positionY[i], input.positionZ[i], 1.0f);
+        Vector4f clipPos = mvp * position;
+        Vector4f worldPos = model * position;
+        Vector3f normal(input.normalX[i], input.normalY[i], input.normalZ[i]);
+        if (transformNormal) {
+            Vector4f worldNormal = normalMatrix * Vector4f(normal, 0.0f);
+            normal = Vector3f(worldNormal.x, worldNormal.y, worldNormal.z).normalize();
+        }
+
+        output.positionX[i] = clipPos.x;
+        output.positionY[i] = clipPos.y;
+        output.positionZ[i] = clipPos.z;
+        output.positionW[i] = clipPos.w;
+        output.worldX[i] = worldPos.x;
+        output.worldY[i] = worldPos.y;
+        output.worldZ[i] = worldPos.z;
+        output.normalX[i] = normal.x;
+        output.normalY[i] = normal.y;
+        output.normalZ[i] = normal.z;
+        output.texcoordU[i] = input.texcoordU[i];
+        output.texcoordV[i] = input.texcoordV[i];
+        output.colorR[i] = input.colorR[i] * instanceColor.x;
+        output.colorG[i] = input.colorG[i] * instanceColor.y;
+        output.colorB[i] = input.colorB[i] * instanceColor.z;
+        output.colorA[i] = input.colorA[i] * instanceColor.w;
+    }
+#endif
+}
@@ -1,10 +1,13 @@
 #include "../include/Texture.h"
 #include "../include/MyMath.h"
+#include "../include/Profiler.h"
+#include "../include/PipelineStatistics.h"
 #include <cstring>
 #include <cmath>
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <utility>
 #include <windows.h>
 #include <gdiplus.h>
 #pragma comment(lib, "gdiplus.lib")
@@ -12,6 +15,23 @@
 // 在文件顶部添加此函数的声明
 int GetEncoderClsid(const WCHAR* format, CLSID* pClsid);
 
+namespace {
+
+// 管线统计：按实际使用的过滤方式和Mipmap级别计数（每次采样只在最外层计数一次）
+// level在转换为下标前限制到[0, kMipLevels - 1]，NaN（导数异常时）计入第0级
+void CountTextureSample(TextureFilterMode filter, float level)
+{
+    if (PipelineCounters::IsEnabled()) {
+        PipelineStatistics& statistics = PipelineCounters::Local();
+        statistics.textureSamples[static_cast<int>(filter)]++;
+        const float maxLevel = static_cast<float>(PipelineStatistics::kMipLevels - 1);
+        int index = level > 0.0f ? static_cast<int>((std::min)(level, maxLevel)) : 0;
+        statistics.mipLevelSamples[(std::max)(0, (std::min)(index, PipelineStatistics::kMipLevels - 1))]++;
+    }
+}
+
+} // namespace
+
 // 默认构造函数
 Texture::Texture()
     : width(0), height(0), textureData(nullptr), 
@@ -77,6 +97,42 @@ Texture& Texture::operator=(const Texture& other)
     return *this;
 }
 
+// 移动构造函数
+Texture::Texture(Texture&& other) noexcept
+    : width(other.width), height(other.height), textureData(other.textureData),
+    filterMode(other.filterMode), wrapMode(other.wrapMode),
+    mipmaps(std::move(other.mipmaps)), hasMipmaps(other.hasMipmaps)
+{
+    other.width = 0;
+    other.height = 0;
+    other.textureData = nullptr;
+    other.mipmaps.clear();
+    other.hasMipmaps = false;
+}
+
+// 移动赋值运算符
+Texture& Texture::operator=(Texture&& other) noexcept
+{
+    if (this != &other) {
+        Clear();
+        
+        width = other.width;
+        height = other.height;
+        textureData = other.textureData;
+        filterMode = other.filterMode;
+        wrapMode = other.wrapMode;
+        mipmaps = std::move(other.mipmaps);
+        hasMipmaps = other.hasMipmaps;
+        
+        other.width = 0;
+        other.height = 0;
+        other.textureData = nullptr;
+        other.mipmaps.clear();
+        other.hasMipmaps = false;
+    }
+    return *this;
+}
+
 // 析构函数
 Texture::~Texture()
 {
@@ -130,6 +186,7 @@ void Texture::Clear()
 // 从文件加载纹理 - 根据文件扩展名自动选择加载方法
 bool Texture::LoadFromFile(const char* path)
 {
+    XYH_PROFILE_SCOPE("LoadTexture");
     std::string pathStr(path);
     std::string extension = pathStr.substr(pathStr.find_last_of('.') + 1);
     
@@ -412,6 +469,7 @@ Color Texture::Sample(float u, float v, float dudx, float dvdy) const
     // 如果开启了Mipmap且支持三线性过滤
     if (hasMipmaps && filterMode == TextureFilterMode::TRILINEAR && mipmaps.size() > 0) {
         float level = CalculateMipmapLevel(dudx, dvdy);
+        CountTextureSample(TextureFilterMode::TRILINEAR, level);
         return TrilinearSample(u, v, level);
     }
     
@@ -665,7 +723,8 @@ Color Texture::Sample(float u, float v) const
         return Color::black;
     }
     
-    // 根据过滤模式选择采样方法
+    // 根据过滤模式选择采样方法（没有导数时三线性过滤实际使用第0级的双线性采样）
+    CountTextureSample(filterMode == TextureFilterMode::NEAREST ? TextureFilterMode::NEAREST : TextureFilterMode::BILINEAR, 0.0f);
     switch (filterMode) {
         case TextureFilterMode::NEAREST:
             return NearestSample(u, v);
@@ -0,0 +1,101 @@
+#include "../include/ThreadPool.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+
+// ==================== ThreadPool 类 ====================
+// 常驻工作线程池（单例类）
+ThreadPool* ThreadPool::s_instance = nullptr;
+
+ThreadPool::ThreadPool(int threadCount)
+    : m_task(nullptr), m_taskCount(0), m_nextIndex(0), m_remaining(0), m_stopping(false)
+{
+    for (int i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workCondition.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+ThreadPool* ThreadPool::GetInstance()
+{
+    if (s_instance == nullptr)
+    {
+        // 调用线程也参与计算，工作线程比硬件线程少一个
+        s_instance = new ThreadPool((std::max)(0, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+    }
+    return s_instance;
+}
+
+void ThreadPool::DeleteInstance()
+{
+    if (s_instance != nullptr)
+    {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    Profiler::SetThreadName("PoolWorker");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_workCondition.wait(lock, [this]() {
+            return m_stopping || (m_task && m_nextIndex < m_taskCount);
+        });
+        if (m_stopping) {
+            return;
+        }
+        RunTasks(lock);
+    }
+}
+
+void ThreadPool::RunTasks(std::unique_lock<std::mutex>& lock)
+{
+    while (m_task && m_nextIndex < m_taskCount) {
+        size_t index = m_nextIndex++;
+        const std::function<void(size_t)>& task = *m_task;
+        lock.unlock();
+        task(index);
+        lock.lock();
+        if (--m_remaining == 0) {
+            m_doneCondition.notify_all();
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    if (count == 0) {
+        return;
+    }
+    if (m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_taskCount = count;
+    m_nextIndex = 0;
+    m_remaining = count;
+    m_workCondition.notify_all();
+
+    // 调用线程也领取下标，之后等待工作线程执行完已领取的下标
+    RunTasks(lock);
+    m_doneCondition.wait(lock, [this]() { return m_remaining == 0; });
+    m_task = nullptr;
+}
@@ -12,6 +12,11 @@
 #include "../include/Camera.h"
 #include "../include/Texture.h"
 #include "../include/ObjFileReader.h" // 添加ObjFileReader头文件
+#include "../include/Benchmark.h"
+#include "../include/AssetManager.h"
+#include "../include/ThreadPool.h"
+#include "../include/Profiler.h"
+#include <fstream>
 
 // 当前绘制模式
 enum class DrawMode {
@@ -35,6 +40,8 @@ Object g_cube; // 添加立方体对象
 // OBJ模型
 Object g_objModel; // 添加OBJ模型对象
 bool g_objModelLoaded = false; // OBJ模型是否已加载
+bool g_objModelLoading = false; // OBJ模型是否正在后台加载
+int g_objModelRequestId = 0; // 最近一次模型加载请求的编号（忽略过期的加载结果）
 
 // 着色器
 ColorShader g_colorShader;  // 添加ColorShader实例
@@ -45,6 +52,7 @@ TexturedBlinnPhongShader g_texturedBlinnPhongShader; // 添加TexturedBlinnPhong
 
 // 纹理
 Texture g_texture;          // 添加纹理实例
+int g_textureRequestId = 0; // 最近一次纹理加载请求的编号（忽略过期的加载结果）
 
 // 相机
 Camera g_camera;            // 添加相机实例
@@ -82,6 +90,7 @@ bool InitShaderDemo(Window& window);
 void UpdateCameraDirectionWithMouse(float xpos, float ypos);
 void HandleKeyDown(HWND hwnd, WPARAM wParam);
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+void RunBenchmarks(const std::string& arguments);
 
 //=================================
 // 辅助函数
@@ -135,9 +144,9 @@ std::wstring CreateVectorString(const Vector3f& vector, const std::wstring& name
 
 // 绘制物体信息
 void DrawObjectInfo(Renderer* renderer, const Object& object, int startY = 70) {
-    std::wstring posInfo = CreateVectorString(object.transform.position, L"Position");
-    std::wstring rotInfo = CreateVectorString(object.transform.rotation, L"Rotation");
-    std::wstring scaleInfo = CreateVectorString(object.transform.scale, L"Scale");
+    std::wstring posInfo = CreateVectorString(object.transform.GetPosition(), L"Position");
+    std::wstring rotInfo = CreateVectorString(object.transform.GetRotation(), L"Rotation");
+    std::wstring scaleInfo = CreateVectorString(object.transform.GetScale(), L"Scale");
     
     renderer->DrawText(10, startY, posInfo, Color::white);
     renderer->DrawText(10, startY + 20, rotInfo, Color::white);
@@ -164,8 +173,13 @@ void DrawTextureInfo(Renderer* renderer, const Texture& texture, int y = 170, co
 
 // 绘制标准操作提示
 void DrawStandardControls(Renderer* renderer, const std::wstring& currentMode, int y = 10) {
-    renderer->DrawText(10, y, L"Space: Switch mode, WASD: Move camera", Color::white);
-    renderer->DrawText(10, y + 20, L"Current mode: " + currentMode, Color::yellow);
+    renderer->DrawText(10, y, L"Space: Switch mode, WASD: Move camera, C: Capture profile, H: Switch debug view", Color::white);
+    std::wstring modeInfo = L"Current mode: " + currentMode;
+    if (renderer->GetDebugView() != Renderer::DebugView::NONE) {
+        std::string viewName = Renderer::GetDebugViewName(renderer->GetDebugView());
+        modeInfo += L" (debug view: " + std::wstring(viewName.begin(), viewName.end()) + L")";
+    }
+    renderer->DrawText(10, y + 20, modeInfo, Color::yellow);
 }
 
 // 更新物体旋转
@@ -177,7 +191,7 @@ void UpdateObjectRotation(Object& object, float angleIncrement = 0.5f, bool rota
     }
     
     // 获取当前旋转角度
-    Vector3f currentRotation = object.transform.rotation;
+    Vector3f currentRotation = object.transform.GetRotation();
     
     // 在当前角度的基础上增加旋转
     if (rotateX) {
@@ -365,28 +379,88 @@ void DrawTestPattern(Window& window)
     window.DrawFPS();
 }
 
-// 加载OBJ模型
-bool LoadObjModel(const std::string& filePath) {
-    try {
-        // 使用ObjFileReader加载模型，应用当前的法线和面片翻转设置
-        g_objModel = ObjFileReader::LoadFromFileWithOptions(filePath, g_flipNormals, g_flipFaces);
-        
-        // 设置模型的变换信息
-        g_objModel.transform.SetPosition(Vector3f(0.0f, 0.0f, 0.0f));
-        g_objModel.transform.SetScale(Vector3f(1.0f, 1.0f, 1.0f));
-        g_objModel.transform.SetRotation(Vector3f(0.0f, 0.0f, 0.0f));
-        
-        g_objModelLoaded = true;
-        std::cout << "OBJ model loaded successfully: " << filePath 
-                  << (g_flipNormals ? " (normals flipped)" : "")
-                  << (g_flipFaces ? " (faces flipped)" : "")
-                  << std::endl;
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to load OBJ model: " << e.what() << std::endl;
-        g_objModelLoaded = false;
+// 检查文件是否存在
+bool FileExists(const std::string& filePath) {
+    std::ifstream file(filePath);
+    return file.is_open();
+}
+
+// 通过资源管理器加载子网格材质引用的贴图（加载完成前使用棋盘格纹理，相同路径的贴图只加载一次）
+void LoadMaterialTextures(Mesh& mesh) {
+    for (SubMesh& subMesh : mesh.subMeshes) {
+        Material& material = subMesh.material;
+        if (material.diffuseMapPath.empty()) {
+            continue;
+        }
+        std::shared_ptr<TextureAsset> asset = AssetManager::GetInstance()->LoadTextureAsync(material.diffuseMapPath, true,
+            [](TextureAsset& asset) {
+                asset.texture.SetFilterMode(TextureFilterMode::TRILINEAR);
+                asset.texture.SetWrapMode(TextureWrapMode::REPEAT);
+            });
+        // 纹理由资源管理器持有，加载完成后原地替换，指针保持有效
+        material.diffuseMap = &asset->texture;
+    }
+    
+    // LOD的子网格复制了原网格的材质
+    for (Mesh& lod : mesh.lods) {
+        LoadMaterialTextures(lod);
+    }
+}
+
+// 加载OBJ模型（在后台线程加载，加载完成前模型为空网格）
+// notifyWindow不为空时，加载完成后弹出提示框
+bool LoadObjModel(const std::string& filePath, HWND notifyWindow = NULL) {
+    if (!FileExists(filePath)) {
+        std::cerr << "Failed to load OBJ model: " << filePath << std::endl;
         return false;
     }
+    
+    // 使用ObjFileReader加载模型，应用当前的法线和面片翻转设置（大文件使用全部核心并行解析，并使用二进制缓存）
+    ObjLoadOptions options;
+    options.flipNormals = g_flipNormals;
+    options.flipFaces = g_flipFaces;
+    options.threadCount = 0;
+    options.useMeshCache = true;
+    
+    // 设置模型的变换信息，网格在加载完成后替换
+    g_objModel = Object();
+    g_objModel.transform.SetPosition(Vector3f(0.0f, 0.0f, 0.0f));
+    g_objModel.transform.SetScale(Vector3f(1.0f, 1.0f, 1.0f));
+    g_objModel.transform.SetRotation(Vector3f(0.0f, 0.0f, 0.0f));
+    
+    g_objModelLoaded = true;
+    g_objModelLoading = true;
+    int requestId = ++g_objModelRequestId;
+    bool flipNormals = g_flipNormals;
+    bool flipFaces = g_flipFaces;
+    
+    AssetManager::GetInstance()->LoadMeshAsync(filePath, options,
+        [requestId, filePath, flipNormals, flipFaces, notifyWindow](MeshAsset& asset) {
+            // 已经请求了其他模型，忽略这次的结果
+            if (requestId != g_objModelRequestId) {
+                return;
+            }
+            g_objModelLoading = false;
+            
+            if (asset.state == AssetState::Ready) {
+                g_objModel.mesh = asset.mesh;
+                LoadMaterialTextures(g_objModel.mesh);
+                std::cout << "OBJ model loaded successfully: " << filePath 
+                          << (flipNormals ? " (normals flipped)" : "")
+                          << (flipFaces ? " (faces flipped)" : "")
+                          << std::endl;
+                if (notifyWindow) {
+                    MessageBox(notifyWindow, L"OBJ model loaded successfully!", L"Success", MB_OK | MB_ICONINFORMATION);
+                }
+            } else {
+                std::cerr << "Failed to load OBJ model: " << filePath << std::endl;
+                g_objModelLoaded = false;
+                if (notifyWindow) {
+                    MessageBox(notifyWindow, L"Failed to load OBJ model!", L"Error", MB_OK | MB_ICONERROR);
+                }
+            }
+        });
+    return true;
 }
 
 // 配置纹理设置
@@ -399,58 +473,67 @@ void ConfigureTexture(TextureFilterMode filterMode, TextureWrapMode wrapMode, bo
     }
 }
 
-// 加载默认纹理
-bool LoadDefaultTexture(Window& window, const std::string& texturePath) {
-    bool textureLoaded = g_texture.LoadFromFile(texturePath);
-    if (!textureLoaded) {
-        // 如果加载失败，使用默认棋盘格纹理
-        MessageBox(window.GetHWND(), L"Failed to load texture.\nUsing default checkerboard texture instead.", L"Texture Load Error", MB_OK | MB_ICONWARNING);
-        g_texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color::black);
-    }
-
-    // 设置纹理参数
-    ConfigureTexture(TextureFilterMode::TRILINEAR, TextureWrapMode::REPEAT);
+// 在后台线程加载图像纹理（解码和Mipmap生成都在后台完成），加载完成前使用棋盘格纹理
+// 加载完成后在渲染线程调用onLoaded，参数为是否加载成功
+void LoadTextureInBackground(const std::string& texturePath, TextureFilterMode filterMode, TextureWrapMode wrapMode,
+                             const std::function<void(bool)>& onLoaded = std::function<void(bool)>()) {
+    g_texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color::black);
+    ConfigureTexture(filterMode, wrapMode);
     
     // 设置纹理给着色器
     g_textureShader.SetTexture(&g_texture);
     g_texturedBlinnPhongShader.SetTexture(&g_texture);
     
-    return textureLoaded;
+    int requestId = ++g_textureRequestId;
+    bool generateMipmaps = filterMode == TextureFilterMode::TRILINEAR;
+    AssetManager::GetInstance()->LoadTextureAsync(texturePath, generateMipmaps,
+        [requestId, filterMode, wrapMode, onLoaded](TextureAsset& asset) {
+            // 已经切换到其他纹理，忽略这次的结果
+            if (requestId != g_textureRequestId) {
+                return;
+            }
+            bool success = asset.state == AssetState::Ready;
+            if (success) {
+                g_texture = asset.texture;
+                ConfigureTexture(filterMode, wrapMode, false);
+            }
+            if (onLoaded) {
+                onLoaded(success);
+            }
+        });
 }
 
-// 加载带纹理的OBJ模型
-bool LoadTexturedObjModel(const std::string& objPath, const std::string& texturePath) {
-    try {
-        // 先加载模型
-        if (!LoadObjModel(objPath)) {
-            return false;
-        }
-        
-        // 手动加载并关联纹理
-        if (!g_texture.LoadFromFile(texturePath)) {
-            std::cerr << "无法加载模型贴图: " << texturePath << std::endl;
-            // 使用默认棋盘格纹理
-            g_texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color::black);
+// 加载默认纹理
+void LoadDefaultTexture(Window& window, const std::string& texturePath) {
+    HWND hwnd = window.GetHWND();
+    LoadTextureInBackground(texturePath, TextureFilterMode::TRILINEAR, TextureWrapMode::REPEAT, [hwnd](bool success) {
+        if (!success) {
+            // 如果加载失败，继续使用默认棋盘格纹理
+            MessageBox(hwnd, L"Failed to load texture.\nUsing default checkerboard texture instead.", L"Texture Load Error", MB_OK | MB_ICONWARNING);
         }
-        
-        // 设置纹理参数
-        ConfigureTexture(TextureFilterMode::TRILINEAR, TextureWrapMode::REPEAT);
-        
-        // 设置纹理给着色器
-        g_textureShader.SetTexture(&g_texture);
-        g_texturedBlinnPhongShader.SetTexture(&g_texture);
-        
-        std::cout << "Texture OBJ model loaded successfully: " << objPath 
-                  << " Texture: " << texturePath 
-                  << (g_flipNormals ? " (normals flipped)" : "")
-                  << (g_flipFaces ? " (faces flipped)" : "")
-                  << std::endl;
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to load textured OBJ model: " << e.what() << std::endl;
-        g_objModelLoaded = false;
+    });
+}
+
+// 加载带纹理的OBJ模型
+bool LoadTexturedObjModel(const std::string& objPath, const std::string& texturePath, HWND notifyWindow = NULL) {
+    // 先加载模型
+    if (!LoadObjModel(objPath, notifyWindow)) {
         return false;
     }
+    
+    // 加载并关联纹理，失败时使用默认棋盘格纹理
+    LoadTextureInBackground(texturePath, TextureFilterMode::TRILINEAR, TextureWrapMode::REPEAT, [texturePath](bool success) {
+        if (!success) {
+            std::cerr << "无法加载模型贴图: " << texturePath << std::endl;
+        }
+    });
+    
+    std::cout << "Texture OBJ model loading: " << objPath 
+              << " Texture: " << texturePath 
+              << (g_flipNormals ? " (normals flipped)" : "")
+              << (g_flipFaces ? " (faces flipped)" : "")
+              << std::endl;
+    return true;
 }
 
 // 设置着色器参数
@@ -499,7 +582,7 @@ bool InitShaderDemo(Window& window)
     if (LoadTexturedObjModel("D:/VisualStudioProjects/XYHSoftRenderer/TestModel/Cat/cat.obj", "D:/VisualStudioProjects/XYHSoftRenderer/TestModel/Cat/Cat_diffuse.jpg")) {
         g_currentMode = DrawMode::ObjModel3D;
         g_useTextureShaderForObj = true; // 设置为使用带纹理Obj着色器
-        std::cout << "Model with texture has been loaded successfully" << std::endl;
+        std::cout << "Model with texture is loading in background" << std::endl;
         
         // 调整模型的变换
         g_objModel.transform.SetPosition(Vector3f(0.0f, 0.0f, 0.0f));
@@ -508,7 +591,7 @@ bool InitShaderDemo(Window& window)
     } else {
         // 如果加载失败，尝试加载茶壶模型作为后备
         if (LoadObjModel("C:\\Users\\Administrator\\Desktop\\teapot.obj")) {
-            std::cout << "Utah Teapot OBJ has been loaded as fallback" << std::endl;
+            std::cout << "Utah Teapot OBJ is loading as fallback" << std::endl;
         } else {
             std::cerr << "Failed to load any models" << std::endl;
         }
@@ -563,6 +646,7 @@ void DrawShaderDemo(Window& window)
     
     // 使用BlinnPhongShader绘制立方体
     renderer->DrawObject(g_cube, &g_blinnPhongShader);
+    renderer->ResolveDebugView();
     
     // 显示场景信息
     std::wstring bgColor = L"background color: (" + 
@@ -595,6 +679,7 @@ void DrawTextureShaderDemo(Window& window)
     
     // 使用纹理着色器绘制立方体
     renderer->DrawObject(g_cube, &g_textureShader);
+    renderer->ResolveDebugView();
     
     // 显示场景信息
     std::wstring bgColor = L"background color: (" + 
@@ -632,6 +717,7 @@ void DrawTextureBlinnPhongShaderDemo(Window& window)
     
     // 使用纹理Blinn-Phong着色器绘制立方体
     renderer->DrawObject(g_cube, &g_texturedBlinnPhongShader);
+    renderer->ResolveDebugView();
     
     // 显示场景信息
     std::wstring bgColor = L"background color: (" + 
@@ -669,6 +755,9 @@ void DrawObjModel(Window& window) {
         window.DrawFPS();
         return;
     }
+    if (g_objModelLoading) {
+        renderer->DrawText(10, 250, L"Loading model in background...", Color::yellow);
+    }
     
     // 更新模型旋转
     UpdateObjectRotation(g_objModel, 0.5f, false, true, false);
@@ -684,17 +773,20 @@ void DrawObjModel(Window& window) {
     if (g_useTextureShaderForObj) {
         // 使用带纹理的Blinn-Phong着色器
         renderer->DrawObject(g_objModel, &g_texturedBlinnPhongShader);
+        renderer->ResolveDebugView();
         renderer->DrawText(10, 190, L"Use textured Blinn-Phong shader (press M to switch)", Color::white);
     } else {
         // 使用普通Blinn-Phong着色器
         // renderer->DrawObject(g_objModel, &g_blinnPhongShader);
         renderer->DrawObject(g_objModel, &g_textureShader); // 使用普通纹理着色器
+        renderer->ResolveDebugView();
         renderer->DrawText(10, 190, L"Use normal Blinn-Phong shader (press M to switch)", Color::white);
     }
     
     // 显示模型信息
     std::wstring meshInfo = L"Vertices: " + std::to_wstring(g_objModel.mesh.vertices.size()) + 
-                           L", Triangles: " + std::to_wstring(g_objModel.mesh.indices.size());
+                           L", Triangles: " + std::to_wstring(g_objModel.mesh.indices.size()) +
+                           L", Submeshes: " + std::to_wstring(g_objModel.mesh.subMeshes.size());
     
     DrawObjectInfo(renderer, g_objModel);
     DrawCameraInfo(renderer, 150);
@@ -713,11 +805,30 @@ void DrawObjModel(Window& window) {
     
     renderer->DrawText(10, 210, meshOptions, Color::white);
     
+    // 管线统计（I键开关，统计本帧到目前为止的绘制）
+    if (renderer->IsPipelineStatisticsEnabled()) {
+        const PipelineStatistics& stats = renderer->GetPipelineStatistics();
+        std::wstring triangleInfo = L"VS: " + std::to_wstring(stats.verticesShaded) +
+            L", Tris: " + std::to_wstring(stats.trianglesSubmitted) +
+            L" (culled " + std::to_wstring(stats.trianglesBackfaceCulled) +
+            L", clipped " + std::to_wstring(stats.trianglesClipped) +
+            L", rejected " + std::to_wstring(stats.trianglesClipRejected) +
+            L", zero-area " + std::to_wstring(stats.trianglesZeroArea) +
+            L", rasterized " + std::to_wstring(stats.trianglesRasterized) + L")";
+        std::wstring pixelInfo = L"Pixels tested: " + std::to_wstring(stats.pixelsTested) +
+            L", covered: " + std::to_wstring(stats.pixelsCovered) +
+            L", depth pass/fail: " + std::to_wstring(stats.depthTestsPassed) + L"/" + std::to_wstring(stats.depthTestsFailed) +
+            L", FS: " + std::to_wstring(stats.fragmentsShaded) +
+            L", tex samples: " + std::to_wstring(stats.GetTextureSampleCount());
+        renderer->DrawText(10, 270, triangleInfo, Color::yellow);
+        renderer->DrawText(10, 290, pixelInfo, Color::yellow);
+    }
+    
     // 绘制FPS和操作提示
     //window.DrawFPS();
     DrawStandardControls(renderer, L"3D OBJ Model Demo");
     renderer->DrawText(10, 30, L"L: Load model, P: Load model with texture, M: Switch shader", Color::white);
-    renderer->DrawText(10, 230, L"N: Flip normals, V: Flip faces, B: Toggle backface culling", Color::white);
+    renderer->DrawText(10, 230, L"N: Flip normals, V: Flip faces, B: Toggle backface culling, I: Pipeline statistics", Color::white);
 }
 
 // 纹理相关操作函数
@@ -754,6 +865,7 @@ void SwitchWrapMode(HWND hwnd) {
 
 // 加载棋盘格纹理
 void LoadCheckerboardTexture(HWND hwnd) {
+    ++g_textureRequestId; // 取消正在进行的纹理加载
     g_texture = Texture::CreateCheckerboard(256, 256, 32, Color::white, Color::black);
     g_texture.SetFilterMode(g_texture.filterMode); // 保持当前过滤模式
     if (g_texture.filterMode == TextureFilterMode::TRILINEAR) {
@@ -766,6 +878,7 @@ void LoadCheckerboardTexture(HWND hwnd) {
 
 // 加载渐变纹理
 void LoadGradientTexture(HWND hwnd) {
+    ++g_textureRequestId; // 取消正在进行的纹理加载
     g_texture = Texture::CreateGradient(256, 256, Color::red, Color::blue, true);
     g_texture.SetFilterMode(TextureFilterMode::BILINEAR);
     g_texture.SetWrapMode(TextureWrapMode::REPEAT);
@@ -776,17 +889,13 @@ void LoadGradientTexture(HWND hwnd) {
 
 // 加载指定图像纹理
 void LoadImageTexture(HWND hwnd, const std::string& texturePath) {
-    bool success = g_texture.LoadFromFile(texturePath);
-    g_texture.SetFilterMode(TextureFilterMode::BILINEAR);
-    g_texture.SetWrapMode(TextureWrapMode::REPEAT);
-    g_textureShader.SetTexture(&g_texture);
-    g_texturedBlinnPhongShader.SetTexture(&g_texture);
-    
-    if (success) {
-        MessageBox(hwnd, L"Texture loaded successfully", L"Texture Switch", MB_OK | MB_ICONINFORMATION);
-    } else {
-        MessageBox(hwnd, L"Failed to load texture", L"Texture Load Error", MB_OK | MB_ICONERROR);
-    }
+    LoadTextureInBackground(texturePath, TextureFilterMode::BILINEAR, TextureWrapMode::REPEAT, [hwnd](bool success) {
+        if (success) {
+            MessageBox(hwnd, L"Texture loaded successfully", L"Texture Switch", MB_OK | MB_ICONINFORMATION);
+        } else {
+            MessageBox(hwnd, L"Failed to load texture", L"Texture Load Error", MB_OK | MB_ICONERROR);
+        }
+    });
 }
 
 // 打开文件对话框加载OBJ模型
@@ -813,10 +922,9 @@ bool OpenFileDialogAndLoadObjModel(HWND hwnd) {
         WideCharToMultiByte(CP_UTF8, 0, szFile, -1, &filePath[0], size_needed, NULL, NULL);
         filePath.resize(size_needed - 1);  // 去掉结尾的空字符
         
-        // 加载模型
-        if (LoadObjModel(filePath)) {
+        // 在后台加载模型（加载完成后提示）
+        if (LoadObjModel(filePath, hwnd)) {
             g_currentMode = DrawMode::ObjModel3D;
-            MessageBox(hwnd, L"OBJ model loaded successfully!", L"Success", MB_OK | MB_ICONINFORMATION);
             return true;
         } else {
             MessageBox(hwnd, L"Failed to load OBJ model!", L"Error", MB_OK | MB_ICONERROR);
@@ -872,11 +980,10 @@ bool OpenFileDialogAndLoadTexturedObjModel(HWND hwnd) {
             WideCharToMultiByte(CP_UTF8, 0, szTextureFile, -1, &texturePath[0], tex_size_needed, NULL, NULL);
             texturePath.resize(tex_size_needed - 1);  // 去掉结尾的空字符
             
-            // 加载带纹理的模型
-            if (LoadTexturedObjModel(objPath, texturePath)) {
+            // 在后台加载带纹理的模型（加载完成后提示）
+            if (LoadTexturedObjModel(objPath, texturePath, hwnd)) {
                 g_currentMode = DrawMode::ObjModel3D;
                 g_useTextureShaderForObj = true;  // 自动切换到纹理着色器
-                MessageBox(hwnd, L"Texture OBJ model loaded successfully!", L"Success", MB_OK | MB_ICONINFORMATION);
                 return true;
             } else {
                 MessageBox(hwnd, L"Failed to load textured OBJ model!", L"Error", MB_OK | MB_ICONERROR);
@@ -976,14 +1083,14 @@ void HandleKeyDown(HWND hwnd, WPARAM wParam) {
     // +/-键：缩放OBJ模型
     else if (wParam == VK_ADD || wParam == VK_OEM_PLUS) {
         if (g_objModelLoaded) {
-            Vector3f scale = g_objModel.transform.scale;
+            Vector3f scale = g_objModel.transform.GetScale();
             scale = scale * 1.1f;  // 放大10%
             g_objModel.transform.SetScale(scale);
         }
     }
     else if (wParam == VK_SUBTRACT || wParam == VK_OEM_MINUS) {
         if (g_objModelLoaded) {
-            Vector3f scale = g_objModel.transform.scale;
+            Vector3f scale = g_objModel.transform.GetScale();
             scale = scale * 0.9f;  // 缩小10%
             g_objModel.transform.SetScale(scale);
         }
@@ -1089,6 +1196,42 @@ void HandleKeyDown(HWND hwnd, WPARAM wParam) {
             g_cullMode = renderer->GetCullMode();
         }
     }
+    // C键：捕获之后60帧的CPU性能数据，写入Chrome trace文件
+    else if (wParam == 'C' || wParam == 'c') {
+        if (!Profiler::IsCapturing()) {
+            Profiler::StartCapture(60, "profile_trace.json");
+            MessageBox(hwnd, L"Capturing the next 60 frames to profile_trace.json\n(open it in chrome://tracing or Perfetto)", L"Profiler", MB_OK | MB_ICONINFORMATION);
+        }
+    }
+    // H键：切换调试视图（着色结果、片元着色次数、深度测试次数、片元着色器周期）
+    else if (wParam == 'H' || wParam == 'h') {
+        Window* windowPtr = reinterpret_cast<Window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+        if (windowPtr) {
+            Renderer* renderer = windowPtr->GetRenderer();
+            switch (renderer->GetDebugView()) {
+                case Renderer::DebugView::NONE:
+                    renderer->SetDebugView(Renderer::DebugView::OVERDRAW);
+                    break;
+                case Renderer::DebugView::OVERDRAW:
+                    renderer->SetDebugView(Renderer::DebugView::DEPTH_COMPLEXITY);
+                    break;
+                case Renderer::DebugView::DEPTH_COMPLEXITY:
+                    renderer->SetDebugView(Renderer::DebugView::SHADER_COST);
+                    break;
+                default:
+                    renderer->SetDebugView(Renderer::DebugView::NONE);
+                    break;
+            }
+        }
+    }
+    // I键：开关管线统计（显示在OBJ模型模式中）
+    else if (wParam == 'I' || wParam == 'i') {
+        Window* windowPtr = reinterpret_cast<Window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+        if (windowPtr) {
+            Renderer* renderer = windowPtr->GetRenderer();
+            renderer->SetPipelineStatisticsEnabled(!renderer->IsPipelineStatisticsEnabled());
+        }
+    }
 }
 
 // 窗口消息处理函数
@@ -1141,6 +1284,15 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 // 主函数
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
+    // 命令行参数 --benchmark [模型目录]：运行性能测试后退出
+    std::string commandLine = lpCmdLine ? lpCmdLine : "";
+    size_t benchmarkPos = commandLine.find("--benchmark");
+    if (benchmarkPos != std::string::npos) {
+        RunBenchmarks(commandLine.substr(benchmarkPos + std::string("--benchmark").size()));
+        ThreadPool::DeleteInstance();
+        return 0;
+    }
+    
     // 创建800x600窗口
     Window window(800, 600, L"XYH Soft Renderer");
     
@@ -1170,9 +1322,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     HDC hdc = GetDC(window.GetHWND());
     
     // 主循环
+    Profiler::SetThreadName("Main");
     bool running = true;
     while (running)
     {
+        // 新的一帧（性能分析按帧记录）
+        Profiler::BeginFrame();
+        
         // 处理窗口消息
         if (!window.ProcessMessages())
         {
@@ -1180,6 +1336,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             break;
         }
         
+        // 交付后台加载完成的资源
+        AssetManager::GetInstance()->Update();
+        
         // 根据当前模式绘制
         RenderCurrentScene(window);
         
@@ -1193,6 +1352,10 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     // 释放DC
     ReleaseDC(window.GetHWND(), hdc);
     
+    // 停止后台加载线程和工作线程池
+    AssetManager::DeleteInstance();
+    ThreadPool::DeleteInstance();
+    
     return 0;
 }
 
@@ -1218,3 +1381,24 @@ void RenderCurrentScene(Window& window)
         break;
     }
 }
+
+// 运行性能测试，报告输出到控制台和benchmark_report.txt
+void RunBenchmarks(const std::string& arguments)
+{
+    // 模型目录默认为工程目录旁的TestModel
+    std::string modelDirectory = arguments;
+    modelDirectory.erase(0, modelDirectory.find_first_not_of(" \t\""));
+    modelDirectory.erase(modelDirectory.find_last_not_of(" \t\"") + 1);
+    if (modelDirectory.empty()) {
+        modelDirectory = "../TestModel/";
+    }
+    if (modelDirectory.back() != '/' && modelDirectory.back() != '\\') {
+        modelDirectory += '/';
+    }
+    
+    std::string report = Benchmark::RunAll(modelDirectory);
+    std::cout << report << std::endl;
+    
+    std::ofstream reportFile("benchmark_report.txt");
+    reportFile << report;
+}